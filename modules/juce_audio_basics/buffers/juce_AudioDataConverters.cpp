@@ -35,6 +35,374 @@
 namespace juce
 {
 
+//==============================================================================
+namespace AudioDataHelpers
+{
+    // Conversions to and from float go through a temporary buffer of this many samples
+    constexpr int chunkSize = 256;
+
+    template <int numBytes, bool isBigEndian>
+    struct PackedSample
+    {
+        static constexpr int bytesPerSample = numBytes;
+        static constexpr bool isBigEndianFormat = isBigEndian;
+
+        // Returns the sample scaled up to fill an int32, like AudioData::Pointer::getAsInt32()
+        static int32 read (const char* p) noexcept
+        {
+            if constexpr (numBytes == 2)
+            {
+                const auto v = readUnaligned<uint16> (p);
+                return (int32) ((uint32) (isBigEndian ? ByteOrder::swapIfLittleEndian (v) : ByteOrder::swapIfBigEndian (v)) << 16);
+            }
+            else if constexpr (numBytes == 3)
+            {
+                const auto* b = reinterpret_cast<const uint8*> (p);
+
+                if constexpr (isBigEndian)
+                    return (int32) (((uint32) b[0] << 24) | ((uint32) b[1] << 16) | ((uint32) b[2] << 8));
+                else
+                    return (int32) (((uint32) b[2] << 24) | ((uint32) b[1] << 16) | ((uint32) b[0] << 8));
+            }
+            else
+            {
+                const auto v = readUnaligned<uint32> (p);
+                return (int32) (isBigEndian ? ByteOrder::swapIfLittleEndian (v) : ByteOrder::swapIfBigEndian (v));
+            }
+        }
+
+        // Writes the top bits of a sample that fills an int32, like AudioData::Pointer::setAsInt32()
+        static void write (char* p, int32 value) noexcept
+        {
+            const auto v = (uint32) value;
+
+            if constexpr (numBytes == 2)
+            {
+                const auto top = (uint16) (v >> 16);
+                writeUnaligned<uint16> (p, isBigEndian ? ByteOrder::swapIfLittleEndian (top) : ByteOrder::swapIfBigEndian (top));
+            }
+            else if constexpr (numBytes == 3)
+            {
+                auto* b = reinterpret_cast<uint8*> (p);
+
+                b[isBigEndian ? 2 : 0] = (uint8) (v >> 8);
+                b[1]                   = (uint8) (v >> 16);
+                b[isBigEndian ? 0 : 2] = (uint8) (v >> 24);
+            }
+            else
+            {
+                writeUnaligned<uint32> (p, isBigEndian ? ByteOrder::swapIfLittleEndian (v) : ByteOrder::swapIfBigEndian (v));
+            }
+        }
+    };
+
+    template <typename PackedFormat, typename Callback>
+    static void withPackedSample (PackedFormat format, Callback&& callback)
+    {
+        switch (format)
+        {
+            case PackedFormat::int16LE:  callback (PackedSample<2, false>()); break;
+            case PackedFormat::int16BE:  callback (PackedSample<2, true>());  break;
+            case PackedFormat::int24LE:  callback (PackedSample<3, false>()); break;
+            case PackedFormat::int24BE:  callback (PackedSample<3, true>());  break;
+            case PackedFormat::int32LE:  callback (PackedSample<4, false>()); break;
+            case PackedFormat::int32BE:  callback (PackedSample<4, true>());  break;
+            default:                     jassertfalse; break;
+        }
+    }
+
+    // Making the stride of mono or interleaved stereo, quad or 8-channel data a constant
+    // lets the compiler unroll and vectorise the loads and stores
+    template <int bytesPerSample, typename Callback>
+    static void withStride (int stride, Callback&& callback)
+    {
+        switch (stride)
+        {
+            case 1 * bytesPerSample:  callback (std::integral_constant<int, 1 * bytesPerSample>()); break;
+            case 2 * bytesPerSample:  callback (std::integral_constant<int, 2 * bytesPerSample>()); break;
+            case 4 * bytesPerSample:  callback (std::integral_constant<int, 4 * bytesPerSample>()); break;
+            case 8 * bytesPerSample:  callback (std::integral_constant<int, 8 * bytesPerSample>()); break;
+            default:                  callback (stride); break;
+        }
+    }
+
+    // numAvailable is the number of samples that can be read from the source, which may
+    // be more than the number being converted
+    template <typename Sample, typename Stride>
+    static void readPacked (const char* source, Stride stride, int32* dest, int numSamples, int numAvailable) noexcept
+    {
+        int i = 0;
+
+        // Reading a whole word at a time is fine, as long as it doesn't go past the end
+        const auto canReadBytes = [&] (int index, int numBytes)
+        {
+            return index * (int) stride + numBytes <= (numAvailable - 1) * (int) stride + Sample::bytesPerSample;
+        };
+
+       #if JUCE_USE_SSE_INTRINSICS && JUCE_LITTLE_ENDIAN
+        if constexpr (Sample::bytesPerSample == 2 && (std::is_same_v<Stride, std::integral_constant<int, 2>>
+                                                      || std::is_same_v<Stride, std::integral_constant<int, 4>>))
+        {
+            constexpr auto samplesPerRead = 16 / Stride::value;
+            const auto zero = _mm_setzero_si128();
+
+            for (; i + samplesPerRead <= numSamples && canReadBytes (i, 16); i += samplesPerRead)
+            {
+                auto v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + i * Stride::value));
+
+                if constexpr (Sample::isBigEndianFormat)
+                    v = _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+
+                if constexpr (Stride::value == 2)
+                {
+                    _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i),     _mm_unpacklo_epi16 (zero, v));
+                    _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i + 4), _mm_unpackhi_epi16 (zero, v));
+                }
+                else
+                {
+                    _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i), _mm_slli_epi32 (v, 16));
+                }
+            }
+        }
+        else if constexpr (Sample::bytesPerSample == 4 && std::is_same_v<Stride, std::integral_constant<int, 4>>)
+        {
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                auto v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + i * 4));
+
+                if constexpr (Sample::isBigEndianFormat)
+                {
+                    v = _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+                    v = _mm_or_si128 (_mm_slli_epi32 (v, 16), _mm_srli_epi32 (v, 16));
+                }
+
+                _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i), v);
+            }
+        }
+       #endif
+
+        if constexpr (Sample::bytesPerSample == 3)
+        {
+            // A single unaligned word read is cheaper than assembling three bytes
+            for (; i < numSamples && canReadBytes (i, 4); ++i)
+            {
+                const auto v = readUnaligned<uint32> (source + i * (int) stride);
+
+                if constexpr (Sample::isBigEndianFormat)
+                    dest[i] = (int32) (ByteOrder::swapIfLittleEndian (v) & 0xffffff00u);
+                else
+                    dest[i] = (int32) (ByteOrder::swapIfBigEndian (v) << 8);
+            }
+        }
+
+        for (; i < numSamples; ++i)
+            dest[i] = Sample::read (source + i * (int) stride);
+    }
+
+    template <typename Sample, typename Stride>
+    static void writePacked (const int32* source, char* dest, Stride stride, int numSamples) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS && JUCE_LITTLE_ENDIAN
+        if constexpr (Sample::bytesPerSample == 2 && std::is_same_v<Stride, std::integral_constant<int, 2>>)
+        {
+            for (; i + 8 <= numSamples; i += 8)
+            {
+                const auto a = _mm_srai_epi32 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + i)), 16);
+                const auto b = _mm_srai_epi32 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + i + 4)), 16);
+                auto v = _mm_packs_epi32 (a, b);
+
+                if constexpr (Sample::isBigEndianFormat)
+                    v = _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+
+                _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i * 2), v);
+            }
+        }
+        else if constexpr (Sample::bytesPerSample == 4 && std::is_same_v<Stride, std::integral_constant<int, 4>>)
+        {
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                auto v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + i));
+
+                if constexpr (Sample::isBigEndianFormat)
+                {
+                    v = _mm_or_si128 (_mm_slli_epi16 (v, 8), _mm_srli_epi16 (v, 8));
+                    v = _mm_or_si128 (_mm_slli_epi32 (v, 16), _mm_srli_epi32 (v, 16));
+                }
+
+                _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i * 4), v);
+            }
+        }
+       #endif
+
+        if constexpr (Sample::bytesPerSample == 3 && std::is_same_v<Stride, std::integral_constant<int, 3>>)
+        {
+            // When the samples are packed together, each word that's written only overwrites
+            // the first byte of the next sample, which then gets written afterwards
+            for (; i < numSamples - 1; ++i)
+            {
+                const auto v = (uint32) source[i];
+
+                if constexpr (Sample::isBigEndianFormat)
+                    writeUnaligned<uint32> (dest + i * 3, ByteOrder::swapIfLittleEndian (v));
+                else
+                    writeUnaligned<uint32> (dest + i * 3, ByteOrder::swapIfBigEndian (v >> 8));
+            }
+        }
+
+        for (; i < numSamples; ++i)
+            Sample::write (dest + i * (int) stride, source[i]);
+    }
+
+    // Converts samples that fill an int32 to floats, like AudioData::Pointer::getAsFloat()
+    static void convertInt32ToFloats (const int32* source, float* dest, int numSamples) noexcept
+    {
+        constexpr auto scale = 1.0f / (float) 0x80000000u;
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto scaleVec = _mm_set1_ps (scale);
+
+        for (; i + 4 <= numSamples; i += 4)
+            _mm_storeu_ps (dest + i, _mm_mul_ps (_mm_cvtepi32_ps (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (source + i))), scaleVec));
+       #elif JUCE_USE_ARM_NEON
+        for (; i + 4 <= numSamples; i += 4)
+            vst1q_f32 (dest + i, vmulq_n_f32 (vcvtq_f32_s32 (vld1q_s32 (source + i)), scale));
+       #endif
+
+        for (; i < numSamples; ++i)
+            dest[i] = (float) source[i] * scale;
+    }
+
+    // Clips and rounds some floats to the given number of bytes, and scales the results
+    // up to fill an int32. This matches AudioData::Pointer::setAsFloat(), except that
+    // values which overflow an int when scaled are clipped instead of wrapping around.
+    static void convertFloatsToInt32 (const float* source, int32* dest, int numSamples, int bytesPerSample) noexcept
+    {
+        int i = 0;
+
+        if (bytesPerSample == 4)
+        {
+            constexpr auto maxValue = (double) 0x7fffffff;
+
+           #if JUCE_USE_SSE_INTRINSICS
+            const auto lo = _mm_set1_ps (-1.0f), hi = _mm_set1_ps (1.0f);
+            const auto scale = _mm_set1_pd (maxValue);
+
+            for (; i + 4 <= numSamples; i += 4)
+            {
+                const auto clipped = _mm_min_ps (_mm_max_ps (_mm_loadu_ps (source + i), lo), hi);
+                const auto first  = _mm_cvttpd_epi32 (_mm_mul_pd (_mm_cvtps_pd (clipped), scale));
+                const auto second = _mm_cvttpd_epi32 (_mm_mul_pd (_mm_cvtps_pd (_mm_movehl_ps (clipped, clipped)), scale));
+                _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i), _mm_unpacklo_epi64 (first, second));
+            }
+           #endif
+
+            for (; i < numSamples; ++i)
+                dest[i] = (int32) (maxValue * jlimit (-1.0, 1.0, (double) source[i]));
+
+            return;
+        }
+
+        const auto shift = 32 - 8 * bytesPerSample;
+        const auto scale = (float) (1 << (8 * bytesPerSample - 1));
+        const auto limit = scale - 1.0f;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const auto scaleVec = _mm_set1_ps (scale), lo = _mm_set1_ps (-limit), hi = _mm_set1_ps (limit);
+        const auto shiftVec = _mm_cvtsi32_si128 (shift);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const auto clipped = _mm_min_ps (_mm_max_ps (_mm_mul_ps (_mm_loadu_ps (source + i), scaleVec), lo), hi);
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i), _mm_sll_epi32 (_mm_cvtps_epi32 (clipped), shiftVec));
+        }
+       #elif JUCE_USE_ARM_NEON && defined (__aarch64__)
+        const auto lo = vdupq_n_f32 (-limit), hi = vdupq_n_f32 (limit);
+        const auto shiftVec = vdupq_n_s32 (shift);
+
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            const auto clipped = vminq_f32 (vmaxq_f32 (vmulq_n_f32 (vld1q_f32 (source + i), scale), lo), hi);
+            vst1q_s32 (dest + i, vshlq_s32 (vcvtnq_s32_f32 (clipped), shiftVec));
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+            dest[i] = (int32) ((uint32) roundToInt (jlimit (-limit, limit, source[i] * scale)) << shift);
+    }
+}
+
+void AudioData::convertPackedToFloat (PackedFormat format, const void* source, int sourceStride, float* dest, int numSamples) noexcept
+{
+    AudioDataHelpers::withPackedSample (format, [&] (auto sample)
+    {
+        using Sample = decltype (sample);
+
+        AudioDataHelpers::withStride<Sample::bytesPerSample> (sourceStride, [&] (auto stride)
+        {
+            int32 temp[AudioDataHelpers::chunkSize];
+            auto* src = static_cast<const char*> (source);
+
+            for (int i = 0; i < numSamples; i += AudioDataHelpers::chunkSize)
+            {
+                const auto num = jmin (AudioDataHelpers::chunkSize, numSamples - i);
+                AudioDataHelpers::readPacked<Sample> (src + i * (int) stride, stride, temp, num, numSamples - i);
+                AudioDataHelpers::convertInt32ToFloats (temp, dest + i, num);
+            }
+        });
+    });
+}
+
+void AudioData::convertPackedToInt32 (PackedFormat format, const void* source, int sourceStride, int32* dest, int numSamples) noexcept
+{
+    AudioDataHelpers::withPackedSample (format, [&] (auto sample)
+    {
+        using Sample = decltype (sample);
+
+        AudioDataHelpers::withStride<Sample::bytesPerSample> (sourceStride, [&] (auto stride)
+        {
+            AudioDataHelpers::readPacked<Sample> (static_cast<const char*> (source), stride, dest, numSamples, numSamples);
+        });
+    });
+}
+
+void AudioData::convertFloatToPacked (PackedFormat format, const float* source, void* dest, int destStride, int numSamples) noexcept
+{
+    AudioDataHelpers::withPackedSample (format, [&] (auto sample)
+    {
+        using Sample = decltype (sample);
+
+        AudioDataHelpers::withStride<Sample::bytesPerSample> (destStride, [&] (auto stride)
+        {
+            int32 temp[AudioDataHelpers::chunkSize];
+            auto* dst = static_cast<char*> (dest);
+
+            for (int i = 0; i < numSamples; i += AudioDataHelpers::chunkSize)
+            {
+                const auto num = jmin (AudioDataHelpers::chunkSize, numSamples - i);
+                AudioDataHelpers::convertFloatsToInt32 (source + i, temp, num, Sample::bytesPerSample);
+                AudioDataHelpers::writePacked<Sample> (temp, dst + i * (int) stride, stride, num);
+            }
+        });
+    });
+}
+
+void AudioData::convertInt32ToPacked (PackedFormat format, const int32* source, void* dest, int destStride, int numSamples) noexcept
+{
+    AudioDataHelpers::withPackedSample (format, [&] (auto sample)
+    {
+        using Sample = decltype (sample);
+
+        AudioDataHelpers::withStride<Sample::bytesPerSample> (destStride, [&] (auto stride)
+        {
+            AudioDataHelpers::writePacked<Sample> (source, static_cast<char*> (dest), stride, numSamples);
+        });
+    });
+}
+
+//==============================================================================
 JUCE_BEGIN_IGNORE_DEPRECATION_WARNINGS
 
 void AudioDataConverters::convertFloatToInt16LE (const float* source, void* dest, int numSamples, int destBytesPerSample)
@@ -576,6 +944,75 @@ public:
         }
     };
 
+    // Checks that converting blocks of interleaved samples gives exactly the same results
+    // as converting the samples one at a time, and leaves the other channels alone
+    template <class FormatType, class Endianness>
+    static void testBlockConversions (UnitTest& unitTest, Random& r)
+    {
+        using Packed      = AudioData::Pointer<FormatType, Endianness, AudioData::Interleaved, AudioData::NonConst>;
+        using ConstPacked = AudioData::Pointer<FormatType, Endianness, AudioData::Interleaved, AudioData::Const>;
+        using Float       = AudioData::Pointer<AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst>;
+        using Int         = AudioData::Pointer<AudioData::Int32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::NonConst>;
+
+        for (auto numChannels : { 1, 2, 3, 4, 8 })
+        {
+            for (auto numSamples : { 0, 1, 5, 17, 300, 1000 })
+            {
+                const auto numBytes = (size_t) (numChannels * numSamples * FormatType::bytesPerSample);
+                HeapBlock<uint8> packed (numBytes), expectedPacked (numBytes);
+                HeapBlock<float> floats ((size_t) numSamples);
+                HeapBlock<int32> ints ((size_t) numSamples);
+
+                for (size_t i = 0; i < numBytes; ++i)
+                    packed[i] = (uint8) r.nextInt (256);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    const auto offset = channel * FormatType::bytesPerSample;
+                    bool readsMatch = true, writesMatch = true;
+
+                    Float (floats.get()).convertSamples (ConstPacked (packed + offset, numChannels), numSamples);
+                    Int (ints.get()).convertSamples (ConstPacked (packed + offset, numChannels), numSamples);
+
+                    ConstPacked source (packed + offset, numChannels);
+
+                    for (int i = 0; i < numSamples; ++i, ++source)
+                        readsMatch = readsMatch && exactlyEqual (floats[i], source.getAsFloat()) && ints[i] == source.getAsInt32();
+
+                    for (int i = 0; i < numSamples; ++i)
+                        floats[i] = i % 7 == 0 ? (float) (i % 3 - 1) : r.nextFloat() * 2.4f - 1.2f;
+
+                    std::copy (packed.get(), packed + numBytes, expectedPacked.get());
+                    Packed (packed + offset, numChannels).convertSamples (AudioData::Pointer<AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::Const> (floats.get()),
+                                                                          numSamples);
+
+                    Packed expected (expectedPacked + offset, numChannels);
+
+                    for (int i = 0; i < numSamples; ++i, ++expected)
+                        expected.setAsFloat (floats[i]);
+
+                    writesMatch = std::equal (packed.get(), packed + numBytes, expectedPacked.get());
+
+                    for (int i = 0; i < numSamples; ++i)
+                        ints[i] = r.nextInt();
+
+                    Packed (packed + offset, numChannels).convertSamples (AudioData::Pointer<AudioData::Int32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::Const> (ints.get()),
+                                                                          numSamples);
+
+                    expected = Packed (expectedPacked + offset, numChannels);
+
+                    for (int i = 0; i < numSamples; ++i, ++expected)
+                        expected.setAsInt32 (ints[i]);
+
+                    writesMatch = writesMatch && std::equal (packed.get(), packed + numBytes, expectedPacked.get());
+
+                    unitTest.expect (readsMatch);
+                    unitTest.expect (writesMatch);
+                }
+            }
+        }
+    }
+
     void runTest() override
     {
         auto r = getRandom();
@@ -590,6 +1027,14 @@ public:
         beginTest ("Round-trip conversion: Float32");
         Test1 <AudioData::Float32>::test (*this, r);
 
+        beginTest ("Block conversions match single sample conversions");
+        testBlockConversions<AudioData::Int16, AudioData::LittleEndian> (*this, r);
+        testBlockConversions<AudioData::Int16, AudioData::BigEndian>    (*this, r);
+        testBlockConversions<AudioData::Int24, AudioData::LittleEndian> (*this, r);
+        testBlockConversions<AudioData::Int24, AudioData::BigEndian>    (*this, r);
+        testBlockConversions<AudioData::Int32, AudioData::LittleEndian> (*this, r);
+        testBlockConversions<AudioData::Int32, AudioData::BigEndian>    (*this, r);
+
         using Format = AudioData::Format<AudioData::Float32, AudioData::NativeEndian>;
 
         beginTest ("Interleaving");
@@ -480,6 +480,9 @@ public:
 
             if (source.getRawData() != getRawData() || source.getNumBytesBetweenSamples() >= getNumBytesBetweenSamples())
             {
+                if (convertPackedSamples (source, numSamples))
+                    return;
+
                 while (--numSamples >= 0)
                 {
                     Endianness::copyFrom (dest.data, source);
@@ -582,10 +585,66 @@ public:
 
     private:
         //==============================================================================
+        template <typename, typename, typename, typename>
+        friend class Pointer;
+
+        using SampleFormatType = SampleFormat;
+        using EndiannessType = Endianness;
+
         SampleFormat data;
 
         inline void advance() noexcept                          { this->advanceData (data); }
 
+        // Uses one of the vectorised conversions if there's one for this pair of formats.
+        // The float or int32 side has to be native-endian and contiguous, but the other
+        // side can be interleaved.
+        template <class OtherPointerType>
+        bool convertPackedSamples (const OtherPointerType& source, int numSamples) const noexcept
+        {
+            using OtherFormat     = typename OtherPointerType::SampleFormatType;
+            using OtherEndianness = typename OtherPointerType::EndiannessType;
+            using SourceFormat    = PackedFormatOf<OtherFormat, OtherEndianness>;
+            using DestFormat      = PackedFormatOf<SampleFormat, Endianness>;
+
+            if constexpr (isNative<SampleFormat, Endianness, Float32> && SourceFormat::isPacked)
+            {
+                if (getNumBytesBetweenSamples() != (int) sizeof (float))
+                    return false;
+
+                convertPackedToFloat (SourceFormat::format, source.getRawData(), source.getNumBytesBetweenSamples(), data.data, numSamples);
+                return true;
+            }
+            else if constexpr (isNative<SampleFormat, Endianness, Int32> && SourceFormat::isPacked)
+            {
+                if (getNumBytesBetweenSamples() != (int) sizeof (int32))
+                    return false;
+
+                convertPackedToInt32 (SourceFormat::format, source.getRawData(), source.getNumBytesBetweenSamples(), reinterpret_cast<int32*> (data.data), numSamples);
+                return true;
+            }
+            else if constexpr (isNative<OtherFormat, OtherEndianness, Float32> && DestFormat::isPacked)
+            {
+                if (source.getNumBytesBetweenSamples() != (int) sizeof (float))
+                    return false;
+
+                convertFloatToPacked (DestFormat::format, static_cast<const float*> (source.getRawData()), data.data, getNumBytesBetweenSamples(), numSamples);
+                return true;
+            }
+            else if constexpr (isNative<OtherFormat, OtherEndianness, Int32> && DestFormat::isPacked)
+            {
+                if (source.getNumBytesBetweenSamples() != (int) sizeof (int32))
+                    return false;
+
+                convertInt32ToPacked (DestFormat::format, static_cast<const int32*> (source.getRawData()), data.data, getNumBytesBetweenSamples(), numSamples);
+                return true;
+            }
+            else
+            {
+                ignoreUnused (source, numSamples);
+                return false;
+            }
+        }
+
         Pointer operator++ (int); // private to force you to use the more efficient pre-increment!
         Pointer operator-- (int);
     };
@@ -669,6 +728,48 @@ public:
     };
 
 private:
+    //==============================================================================
+    enum class PackedFormat { int16LE, int16BE, int24LE, int24BE, int32LE, int32BE };
+
+    template <typename SampleFormat, typename Endianness>
+    struct PackedFormatOf
+    {
+        static constexpr bool isPacked = false;
+    };
+
+    template <typename Endianness>
+    struct PackedFormatOf<Int16, Endianness>
+    {
+        static constexpr bool isPacked = true;
+        static constexpr auto format = Endianness::isBigEndian ? PackedFormat::int16BE : PackedFormat::int16LE;
+    };
+
+    template <typename Endianness>
+    struct PackedFormatOf<Int24, Endianness>
+    {
+        static constexpr bool isPacked = true;
+        static constexpr auto format = Endianness::isBigEndian ? PackedFormat::int24BE : PackedFormat::int24LE;
+    };
+
+    template <typename Endianness>
+    struct PackedFormatOf<Int32, Endianness>
+    {
+        static constexpr bool isPacked = true;
+        static constexpr auto format = Endianness::isBigEndian ? PackedFormat::int32BE : PackedFormat::int32LE;
+    };
+
+    template <typename SampleFormat, typename Endianness, typename NativeFormat>
+    static constexpr bool isNative = std::is_same_v<SampleFormat, NativeFormat>
+                                      && (bool) Endianness::isBigEndian == (bool) NativeEndian::isBigEndian;
+
+    // These produce exactly the same results as converting one sample at a time. The
+    // strides are the number of bytes between the packed samples.
+    static void convertPackedToFloat (PackedFormat, const void* source, int sourceStride, float* dest, int numSamples) noexcept;
+    static void convertPackedToInt32 (PackedFormat, const void* source, int sourceStride, int32* dest, int numSamples) noexcept;
+    static void convertFloatToPacked (PackedFormat, const float* source, void* dest, int destStride, int numSamples) noexcept;
+    static void convertInt32ToPacked (PackedFormat, const int32* source, void* dest, int destStride, int numSamples) noexcept;
+
+    //==============================================================================
     template <bool IsInterleaved, bool IsConst, typename...>
     struct ChannelDataSubtypes;
 
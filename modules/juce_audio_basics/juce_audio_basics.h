@@ -108,6 +108,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "midi/juce_MidiBuffer.h"
 #include "midi/juce_MidiMessageSequence.h"
 #include "midi/juce_MidiFile.h"
+#include "midi/juce_MidiFileView.h"
 #include "midi/juce_MidiKeyboardState.h"
 #include "midi/juce_MidiRPN.h"
 #include "mpe/juce_MPEValue.h"
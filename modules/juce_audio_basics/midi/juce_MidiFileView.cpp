@@ -0,0 +1,619 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace MidiFileViewHelpers
+{
+    // Decodes the event at the start of data, in the same way as MidiFileHelpers::readTrack().
+    // The delta time is added to event.tick. Returns the number of bytes used, or 0 if there
+    // isn't a complete event.
+    static int decodeEvent (const uint8* data, int size, uint8& runningStatus, MidiFileView::Event& event) noexcept
+    {
+        const auto delay = MidiMessage::readVariableLengthValue (data, size);
+
+        if (! delay.isValid() || delay.bytesUsed >= size)
+            return 0;
+
+        const auto* start = data + delay.bytesUsed;
+        const auto* end = data + size;
+        auto* src = start;
+        auto status = *src;
+
+        if (status < 0x80)
+        {
+            if (runningStatus == 0)
+                return 0;
+
+            status = runningStatus;
+        }
+        else
+        {
+            ++src;
+        }
+
+        const auto available = (int) (end - src);
+
+        if (status == 0xf0)
+        {
+            // Like MidiMessage, this skips the length and then looks for the terminating 0xf7
+            auto* d = src;
+            auto haveReadAllLengthBytes = false;
+            int numLengthBytes = 0;
+
+            for (; d < end; ++d)
+            {
+                if (*d >= 0x80)
+                {
+                    if (*d == 0xf7)
+                    {
+                        ++d;
+                        break;
+                    }
+
+                    if (haveReadAllLengthBytes)
+                        break;
+
+                    ++numLengthBytes;
+                }
+                else if (! haveReadAllLengthBytes)
+                {
+                    haveReadAllLengthBytes = true;
+                    ++numLengthBytes;
+                }
+            }
+
+            event.data = src + numLengthBytes;
+            event.dataSize = (int) (d - event.data);
+            src = d;
+        }
+        else if (status == 0xff)
+        {
+            const auto length = MidiMessage::readVariableLengthValue (src + 1, available - 1);
+            event.data = src;
+            event.dataSize = jmin (available, length.bytesUsed + 1 + length.value);
+            src += event.dataSize;
+        }
+        else
+        {
+            event.data = src;
+            event.dataSize = jmin (MidiMessage::getMessageLengthFromFirstByte (status) - 1, available);
+            src += event.dataSize;
+        }
+
+        if ((status & 0xf0) != 0xf0)
+            runningStatus = status;
+
+        event.status = status;
+        event.tick += delay.value;
+        return (int) (src - data);
+    }
+}
+
+//==============================================================================
+MidiMessage MidiFileView::Event::toMidiMessage() const
+{
+    if (status == 0xf0 || status == 0xff)
+    {
+        HeapBlock<uint8> bytes ((size_t) dataSize + 1);
+        bytes[0] = status;
+        memcpy (bytes + 1, data, (size_t) dataSize);
+        return MidiMessage (bytes, dataSize + 1, (double) tick);
+    }
+
+    // missing data bytes at the end of a truncated track are read as zeros, as in MidiFile
+    uint8 bytes[3] = { status, 0, 0 };
+    memcpy (bytes + 1, data, (size_t) jlimit (0, 2, dataSize));
+    return MidiMessage (bytes, MidiMessage::getMessageLengthFromFirstByte (status), (double) tick);
+}
+
+//==============================================================================
+MidiFileView::Iterator::Iterator (const uint8* trackDataIn, int trackSizeIn, int offsetIn,
+                                  int64 tick, uint8 runningStatusIn, int64 endTickIn)
+    : trackData (trackDataIn), trackSize (trackSizeIn), offset (offsetIn), nextOffset (offsetIn),
+      endTick (endTickIn), runningStatus (runningStatusIn)
+{
+    event.tick = tick;
+    ++*this;
+}
+
+MidiFileView::Iterator& MidiFileView::Iterator::operator++()
+{
+    offset = nextOffset;
+
+    if (offset >= trackSize)
+    {
+        moveToEnd();
+        return *this;
+    }
+
+    const auto numBytes = MidiFileViewHelpers::decodeEvent (trackData + offset, trackSize - offset, runningStatus, event);
+
+    if (numBytes <= 0 || event.tick >= endTick)
+        moveToEnd();
+    else
+        nextOffset = offset + numBytes;
+
+    return *this;
+}
+
+//==============================================================================
+MidiFileView::MidiFileView() = default;
+MidiFileView::~MidiFileView() = default;
+
+bool MidiFileView::open (const File& file)
+{
+    close();
+
+    mappedFile = std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly);
+    data = static_cast<const uint8*> (mappedFile->getData());
+
+    if (data != nullptr && indexTracks (mappedFile->getSize()))
+        return true;
+
+    close();
+    return false;
+}
+
+bool MidiFileView::open (const void* midiFileData, size_t numBytes)
+{
+    close();
+
+    data = static_cast<const uint8*> (midiFileData);
+
+    if (data != nullptr && indexTracks (numBytes))
+        return true;
+
+    close();
+    return false;
+}
+
+void MidiFileView::close()
+{
+    tracks.clear();
+    tempoChanges.clear();
+    data = nullptr;
+    mappedFile.reset();
+    timeFormat = 0;
+    fileType = 0;
+}
+
+bool MidiFileView::indexTracks (size_t size)
+{
+    auto* d = data;
+
+    const auto optHeader = MidiFileHelpers::parseMidiHeader (d, size);
+
+    if (! optHeader.hasValue())
+        return false;
+
+    const auto header = *optHeader;
+    timeFormat = header.timeFormat;
+    fileType = header.fileType;
+
+    d += header.bytesRead;
+    size -= header.bytesRead;
+
+    std::vector<TempoChange> tempoEvents;
+
+    for (int track = 0; track < header.numberOfTracks; ++track)
+    {
+        const auto optChunkType = MidiFileHelpers::tryRead<uint32> (d, size);
+        const auto optChunkSize = MidiFileHelpers::tryRead<uint32> (d, size);
+
+        if (! optChunkType.hasValue() || ! optChunkSize.hasValue() || size < *optChunkSize)
+            return false;
+
+        const auto chunkSize = *optChunkSize;
+
+        if (*optChunkType == ByteOrder::bigEndianInt ("MTrk"))
+            tracks.push_back (indexTrack (d, (int) chunkSize, tempoEvents));
+
+        size -= chunkSize;
+        d += chunkSize;
+    }
+
+    if (size != 0)
+        return false;
+
+    // Work out the time at each tempo change, so that converting a time only needs a search
+    std::stable_sort (tempoEvents.begin(), tempoEvents.end(), [] (const auto& a, const auto& b) { return a.tick < b.tick; });
+
+    const auto tickLength = 1.0 / (timeFormat & 0x7fff);
+    double seconds = 0, secondsPerTick = 0.5 * tickLength;
+    int64 lastTick = 0;
+
+    for (auto& change : tempoEvents)
+    {
+        seconds += (double) (change.tick - lastTick) * secondsPerTick;
+        secondsPerTick = tickLength * change.secondsPerTick;
+        lastTick = change.tick;
+
+        if (! tempoChanges.empty() && tempoChanges.back().tick == change.tick)
+            tempoChanges.back().secondsPerTick = secondsPerTick;
+        else
+            tempoChanges.push_back ({ change.tick, seconds, secondsPerTick });
+    }
+
+    return true;
+}
+
+MidiFileView::Track MidiFileView::indexTrack (const uint8* trackData, int size, std::vector<TempoChange>& tempoEvents) const
+{
+    // A checkpoint every this many events means that finding a position only needs
+    // a few events to be decoded, while keeping the index tiny
+    constexpr int eventsPerCheckpoint = 64;
+
+    Track track { trackData, size, 0, 0, {} };
+    Event event;
+    uint8 runningStatus = 0;
+
+    for (int offset = 0; offset < size;)
+    {
+        const auto previousTick = event.tick;
+        const auto previousRunningStatus = runningStatus;
+        const auto numBytes = MidiFileViewHelpers::decodeEvent (trackData + offset, size - offset, runningStatus, event);
+
+        if (numBytes <= 0)
+            break;
+
+        if (track.numEvents % eventsPerCheckpoint == 0)
+            track.checkpoints.push_back ({ event.tick, previousTick, offset, previousRunningStatus });
+
+        if (event.isMetaEvent() && event.dataSize > 0 && event.data[0] == 0x51)
+        {
+            const auto message = event.toMidiMessage();
+
+            // (the seconds per quarter note is kept here until the times are worked out)
+            if (message.isTempoMetaEvent())
+                tempoEvents.push_back ({ event.tick, 0.0, message.getTempoSecondsPerQuarterNote() });
+        }
+
+        ++track.numEvents;
+        track.lastTick = event.tick;
+        offset += numBytes;
+    }
+
+    return track;
+}
+
+//==============================================================================
+int MidiFileView::getNumEvents (int trackIndex) const noexcept
+{
+    return isPositiveAndBelow (trackIndex, getNumTracks()) ? tracks[(size_t) trackIndex].numEvents : 0;
+}
+
+int64 MidiFileView::getLastTick() const noexcept
+{
+    int64 lastTick = 0;
+
+    for (auto& track : tracks)
+        lastTick = jmax (lastTick, track.lastTick);
+
+    return lastTick;
+}
+
+double MidiFileView::ticksToSeconds (double tick) const
+{
+    if (timeFormat == 0)
+        return tick;
+
+    if (timeFormat < 0)
+        return tick / (-(timeFormat >> 8) * (timeFormat & 0xff));
+
+    // find the last tempo change before this time
+    const auto next = std::lower_bound (tempoChanges.begin(), tempoChanges.end(), tick,
+                                        [] (const TempoChange& c, double t) { return (double) c.tick < t; });
+
+    if (next == tempoChanges.begin())
+        return tick * 0.5 / (timeFormat & 0x7fff);
+
+    const auto& change = *std::prev (next);
+    return change.seconds + (tick - (double) change.tick) * change.secondsPerTick;
+}
+
+MidiFileView::EventRange MidiFileView::getEvents (int trackIndex, int64 startTick, int64 endTick) const
+{
+    if (! isPositiveAndBelow (trackIndex, getNumTracks()))
+        return {};
+
+    const auto& track = tracks[(size_t) trackIndex];
+
+    EventRange range;
+    range.last.trackData = track.data;
+    range.last.trackSize = track.size;
+    range.last.moveToEnd();
+
+    if (track.checkpoints.empty())
+    {
+        range.first = range.last;
+        return range;
+    }
+
+    // start from the last checkpoint before startTick, and skip forwards from there
+    auto checkpoint = std::partition_point (track.checkpoints.begin(), track.checkpoints.end(),
+                                            [startTick] (const Checkpoint& c) { return c.eventTick < startTick; });
+
+    if (checkpoint != track.checkpoints.begin())
+        --checkpoint;
+
+    range.first = Iterator (track.data, track.size, checkpoint->offset,
+                            checkpoint->previousTick, checkpoint->runningStatus, endTick);
+
+    while (range.first != range.last && range.first->tick < startTick)
+        ++range.first;
+
+    return range;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct MidiFileViewTest final : public UnitTest
+{
+    MidiFileViewTest()
+        : UnitTest ("MidiFileView", UnitTestCategories::midi)
+    {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+
+        beginTest ("Events match the tracks that were written");
+        {
+            const auto sequences = createRandomTracks (random);
+            const auto fileData = writeFile (sequences);
+
+            MidiFileView view;
+            expect (view.open (fileData.getData(), fileData.getSize()));
+            expectEquals (view.getNumTracks(), (int) sequences.size());
+            expectEquals ((int) view.getTimeFormat(), 960);
+            expectEquals (view.getFileType(), 1);
+
+            for (int t = 0; t < view.getNumTracks(); ++t)
+            {
+                const auto& expected = sequences[(size_t) t];
+
+                // the writer adds an end-of-track event
+                expectEquals (view.getNumEvents (t), expected.getNumEvents() + 1);
+
+                int index = 0;
+
+                for (auto& event : view.getEvents (t))
+                {
+                    if (index < expected.getNumEvents())
+                        expect (matches (event, expected.getEventPointer (index)->message));
+                    else
+                        expect (event.toMidiMessage().isEndOfTrackMetaEvent());
+
+                    ++index;
+                }
+
+                expectEquals (index, view.getNumEvents (t));
+            }
+        }
+
+        beginTest ("Time ranges contain the right events");
+        {
+            const auto sequences = createRandomTracks (random);
+            const auto fileData = writeFile (sequences);
+
+            MidiFileView view;
+            expect (view.open (fileData.getData(), fileData.getSize()));
+
+            for (int i = 0; i < 100; ++i)
+            {
+                const auto t = random.nextInt ((int) sequences.size());
+                const auto& sequence = sequences[(size_t) t];
+                const auto start = (int64) random.nextInt ((int) view.getLastTick() + 10);
+                const auto end = start + random.nextInt (5000);
+
+                Array<const MidiMessage*> expected;
+
+                for (auto* holder : sequence)
+                    if (holder->message.getTimeStamp() >= (double) start && holder->message.getTimeStamp() < (double) end)
+                        expected.add (&holder->message);
+
+                Array<MidiFileView::Event> events;
+
+                for (auto& event : view.getEvents (t, start, end))
+                    if (! event.isMetaEvent() || event.data[0] != 0x2f)
+                        events.add (event);
+
+                expectEquals (events.size(), expected.size());
+
+                for (int j = 0; j < jmin (events.size(), expected.size()); ++j)
+                    expect (matches (events.getReference (j), *expected.getUnchecked (j)));
+            }
+        }
+
+        beginTest ("Converting to seconds matches MidiFile");
+        {
+            const auto sequences = createRandomTracks (random);
+            const auto fileData = writeFile (sequences);
+
+            MidiFileView view;
+            expect (view.open (fileData.getData(), fileData.getSize()));
+
+            MidiFile file;
+            MemoryInputStream stream (fileData, false);
+            expect (file.readFrom (stream, false));
+
+            MidiFile ticksFile (file);
+            file.convertTimestampTicksToSeconds();
+
+            for (int t = 0; t < file.getNumTracks(); ++t)
+            {
+                for (int i = 0; i < file.getTrack (t)->getNumEvents(); ++i)
+                {
+                    const auto ticks = ticksFile.getTrack (t)->getEventPointer (i)->message.getTimeStamp();
+                    const auto seconds = file.getTrack (t)->getEventPointer (i)->message.getTimeStamp();
+                    expectWithinAbsoluteError (view.ticksToSeconds (ticks), seconds, 1.0e-9);
+                }
+            }
+        }
+
+        beginTest ("Running status and truncated tracks are read like MidiFile");
+        {
+            for (const auto& trackBytes : { std::vector<uint8> { 0x81, 0x00, 0x90, 0x40, 0x40, 0x10, 0x41, 0x40, 0x00, 0xc0, 0x05, 0x00, 0x06 },
+                                            std::vector<uint8> { 0x00, 0xf0, 0x03, 0x01, 0x02, 0xf7, 0x00, 0xb1, 0x07, 0x7f, 0x00, 0xff, 0x2f, 0x00 },
+                                            std::vector<uint8> { 0x00, 0x40, 0x40 },
+                                            std::vector<uint8> { 0x00, 0x90, 0x40 },
+                                            std::vector<uint8> { 0x10, 0xff, 0x01, 0x08, 0x61 },
+                                            std::vector<uint8> { 0xff } })
+            {
+                const auto expected = MidiFileHelpers::readTrack (trackBytes.data(), (int) trackBytes.size());
+                const auto fileData = createFile (trackBytes);
+
+                MidiFileView view;
+                expect (view.open (fileData.getData(), fileData.getSize()));
+                expectEquals (view.getNumEvents (0), expected.getNumEvents());
+
+                int index = 0;
+
+                for (auto& event : view.getEvents (0))
+                    expect (index < expected.getNumEvents() && matches (event, expected.getEventPointer (index++)->message));
+            }
+        }
+
+        beginTest ("Invalid files are rejected");
+        {
+            MidiFileView view;
+            const uint8 junk[] = { 'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 1 };
+            expect (! view.open (junk, sizeof (junk)));
+            expect (! view.isOpen());
+            expectEquals (view.getNumTracks(), 0);
+
+            // a track chunk that claims to be longer than the file
+            auto fileData = createFile ({ 0x00, 0x90, 0x40, 0x40 });
+            expect (! view.open (fileData.getData(), fileData.getSize() - 1));
+        }
+
+        beginTest ("Files can be memory-mapped");
+        {
+            const auto sequences = createRandomTracks (random);
+            const auto fileData = writeFile (sequences);
+
+            TemporaryFile tempFile (".mid");
+            expect (tempFile.getFile().replaceWithData (fileData.getData(), fileData.getSize()));
+
+            MidiFileView view;
+            expect (view.open (tempFile.getFile()));
+            expectEquals (view.getNumTracks(), (int) sequences.size());
+            expectEquals (view.getNumEvents (0), sequences[0].getNumEvents() + 1);
+
+            view.close();
+            expect (! view.open (File()));
+        }
+    }
+
+    static bool matches (const MidiFileView::Event& event, const MidiMessage& message)
+    {
+        const auto converted = event.toMidiMessage();
+
+        return exactlyEqual ((double) event.tick, message.getTimeStamp())
+            && converted.getRawDataSize() == message.getRawDataSize()
+            && std::equal (converted.getRawData(), converted.getRawData() + converted.getRawDataSize(), message.getRawData());
+    }
+
+    static std::vector<MidiMessageSequence> createRandomTracks (Random& random)
+    {
+        std::vector<MidiMessageSequence> result (3);
+
+        for (auto& sequence : result)
+        {
+            double time = 0;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                time += random.nextInt (3) == 0 ? 0 : random.nextInt (200);
+                const auto channel = 1 + random.nextInt (2);
+
+                switch (random.nextInt (7))
+                {
+                    case 0:  sequence.addEvent (MidiMessage::noteOn (channel, random.nextInt (128), (uint8) (1 + random.nextInt (127))), time); break;
+                    case 1:  sequence.addEvent (MidiMessage::noteOff (channel, random.nextInt (128), (uint8) random.nextInt (128)), time); break;
+                    case 2:  sequence.addEvent (MidiMessage::controllerEvent (channel, random.nextInt (128), random.nextInt (128)), time); break;
+                    case 3:  sequence.addEvent (MidiMessage::programChange (channel, random.nextInt (128)), time); break;
+                    case 4:  sequence.addEvent (MidiMessage::tempoMetaEvent (200000 + random.nextInt (800000)), time); break;
+                    case 5:  sequence.addEvent (MidiMessage::textMetaEvent (1, "event " + String (i)), time); break;
+
+                    default:
+                    {
+                        const uint8 sysex[] = { 0x7e, (uint8) random.nextInt (128), 0x06, 0x01 };
+                        sequence.addEvent (MidiMessage::createSysExMessage (sysex, (int) sizeof (sysex)), time);
+                        break;
+                    }
+                }
+            }
+        }
+
+        return result;
+    }
+
+    static MemoryBlock writeFile (const std::vector<MidiMessageSequence>& sequences)
+    {
+        MidiFile file;
+        file.setTicksPerQuarterNote (960);
+
+        for (auto& sequence : sequences)
+            file.addTrack (sequence);
+
+        MemoryOutputStream os;
+        file.writeTo (os);
+        return os.getMemoryBlock();
+    }
+
+    static MemoryBlock createFile (const std::vector<uint8>& trackBytes)
+    {
+        MemoryOutputStream os;
+        os.writeIntBigEndian ((int) ByteOrder::bigEndianInt ("MThd"));
+        os.writeIntBigEndian (6);
+        os.writeShortBigEndian (0);
+        os.writeShortBigEndian (1);
+        os.writeShortBigEndian (96);
+        os.writeIntBigEndian ((int) ByteOrder::bigEndianInt ("MTrk"));
+        os.writeIntBigEndian ((int) trackBytes.size());
+        os.write (trackBytes.data(), trackBytes.size());
+        return os.getMemoryBlock();
+    }
+};
+
+static MidiFileViewTest midiFileViewTest;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A read-only view of a standard midi file, which decodes events on demand.
+
+    MidiFile::readFrom() creates a MidiMessage for every event in the file, which
+    for very large files takes a long time and a lot of memory. A MidiFileView
+    instead memory-maps the file (or uses a block of data that you supply), makes a
+    single pass over it to build a small index of each track, and then decodes events
+    only as you iterate over them.
+
+    @code
+    MidiFileView view;
+
+    if (view.open (file))
+        for (auto& event : view.getEvents (0, startTick, endTick))
+            handleEvent (event.tick, event.getStatusByte(), event.data, event.dataSize);
+    @endcode
+
+    Events are returned in the order they appear in the file. That's in time order,
+    but unlike MidiFile::readFrom(), note-offs aren't moved ahead of note-ons that
+    have the same timestamp, and missing note-offs aren't added.
+
+    @see MidiFile
+
+    @tags{Audio}
+*/
+class JUCE_API  MidiFileView
+{
+public:
+    //==============================================================================
+    /** Creates an empty view. Call open() to use it. */
+    MidiFileView();
+
+    /** Destructor. */
+    ~MidiFileView();
+
+    //==============================================================================
+    /** Memory-maps a midi file and indexes it.
+        @returns true if the file was opened and is a valid midi file
+    */
+    bool open (const File& file);
+
+    /** Indexes a block of midi file data.
+
+        The data isn't copied, so it must stay valid until the view is closed or deleted.
+        @returns true if the data is a valid midi file
+    */
+    bool open (const void* midiFileData, size_t numBytes);
+
+    /** Releases the file or data that the view was using. */
+    void close();
+
+    /** Returns true if a file was opened successfully. */
+    bool isOpen() const noexcept                    { return data != nullptr; }
+
+    //==============================================================================
+    /** Returns the file's type: 0, 1 or 2. */
+    int getFileType() const noexcept                { return fileType; }
+
+    /** Returns the raw time format code from the file's header.
+        @see MidiFile::getTimeFormat
+    */
+    short getTimeFormat() const noexcept            { return timeFormat; }
+
+    /** Returns the number of tracks in the file. */
+    int getNumTracks() const noexcept               { return (int) tracks.size(); }
+
+    /** Returns the number of events in one of the tracks. */
+    int getNumEvents (int trackIndex) const noexcept;
+
+    /** Returns the time, in ticks, of the last event in any of the tracks. */
+    int64 getLastTick() const noexcept;
+
+    /** Converts a time in ticks to seconds, using the tempo changes in all the tracks.
+
+        This gives the same results as MidiFile::convertTimestampTicksToSeconds().
+    */
+    double ticksToSeconds (double tick) const;
+
+    //==============================================================================
+    /** An event from the file.
+
+        The data points into the file, so it's only valid while the view is open.
+    */
+    struct Event
+    {
+        /** The time of the event, in ticks. */
+        int64 tick = 0;
+
+        /** The status byte. For running-status messages, this is the status of the
+            message that set it.
+        */
+        uint8 status = 0;
+
+        /** The bytes after the status byte. For sysex messages, the length that precedes
+            the data in the file isn't included.
+        */
+        const uint8* data = nullptr;
+
+        /** The number of bytes that data points to. */
+        int dataSize = 0;
+
+        /** Returns the status byte. */
+        uint8 getStatusByte() const noexcept        { return status; }
+
+        /** Returns true if this is a meta-event. */
+        bool isMetaEvent() const noexcept           { return status == 0xff; }
+
+        /** Creates a MidiMessage from this event, with its tick as the timestamp. */
+        MidiMessage toMidiMessage() const;
+    };
+
+    //==============================================================================
+    /** Iterates over the events in one track of a MidiFileView. */
+    class JUCE_API  Iterator
+    {
+    public:
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = Event;
+        using reference         = const Event&;
+        using pointer           = const Event*;
+        using iterator_category = std::forward_iterator_tag;
+
+        Iterator() = default;
+
+        reference operator*() const noexcept        { return event; }
+        pointer operator->() const noexcept         { return &event; }
+
+        Iterator& operator++();
+        Iterator operator++ (int)                   { auto copy = *this; ++*this; return copy; }
+
+        bool operator== (const Iterator& other) const noexcept  { return trackData == other.trackData && offset == other.offset; }
+        bool operator!= (const Iterator& other) const noexcept  { return ! operator== (other); }
+
+    private:
+        friend class MidiFileView;
+
+        Iterator (const uint8* trackData, int trackSize, int offset, int64 tick, uint8 runningStatus, int64 endTick);
+
+        void moveToEnd() noexcept                   { offset = trackSize; }
+
+        const uint8* trackData = nullptr;
+        int trackSize = 0, offset = 0, nextOffset = 0;
+        int64 endTick = 0;
+        uint8 runningStatus = 0;
+        Event event;
+    };
+
+    /** A range of events which can be used in a range-based for loop. */
+    struct EventRange
+    {
+        Iterator begin() const noexcept             { return first; }
+        Iterator end() const noexcept               { return last; }
+
+        Iterator first, last;
+    };
+
+    /** Returns the events in a track whose times are at least startTick and less
+        than endTick.
+
+        Finding the first event only needs to decode a few events, however big the track is.
+    */
+    EventRange getEvents (int trackIndex,
+                          int64 startTick = 0,
+                          int64 endTick = std::numeric_limits<int64>::max()) const;
+
+private:
+    //==============================================================================
+    struct Checkpoint
+    {
+        int64 eventTick, previousTick;
+        int offset;
+        uint8 runningStatus;
+    };
+
+    struct Track
+    {
+        const uint8* data;
+        int size, numEvents;
+        int64 lastTick;
+        std::vector<Checkpoint> checkpoints;
+    };
+
+    struct TempoChange
+    {
+        int64 tick;
+        double seconds, secondsPerTick;
+    };
+
+    bool indexTracks (size_t numBytes);
+    Track indexTrack (const uint8*, int size, std::vector<TempoChange>&) const;
+
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    const uint8* data = nullptr;
+    std::vector<Track> tracks;
+    std::vector<TempoChange> tempoChanges;
+    short timeFormat = 0, fileType = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiFileView)
+};
+
+} // namespace juce
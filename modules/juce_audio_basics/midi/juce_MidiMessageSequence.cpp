@@ -38,14 +38,80 @@ namespace juce
 MidiMessageSequence::MidiEventHolder::MidiEventHolder (const MidiMessage& mm) : message (mm) {}
 MidiMessageSequence::MidiEventHolder::MidiEventHolder (MidiMessage&& mm) : message (std::move (mm)) {}
 
+//==============================================================================
+/*  Hands out storage for MidiEventHolders in blocks that grow geometrically, so
+    that building or editing a large sequence doesn't make one heap allocation
+    per event. Freed slots are kept on an intrusive list and reused.
+*/
+class MidiMessageSequence::EventPool
+{
+public:
+    void* allocate()
+    {
+        if (freeList == nullptr)
+            addBlock (nextBlockSize);
+
+        auto* slot = freeList;
+        freeList = slot->next;
+        return slot;
+    }
+
+    void release (void* storage) noexcept
+    {
+        auto* slot = static_cast<Slot*> (storage);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+    void reserve (int numExtraEvents)
+    {
+        auto numFree = 0;
+
+        for (auto* slot = freeList; slot != nullptr && numFree < numExtraEvents; slot = slot->next)
+            ++numFree;
+
+        if (numFree < numExtraEvents)
+            addBlock ((size_t) (numExtraEvents - numFree));
+    }
+
+private:
+    union Slot
+    {
+        Slot* next;
+        alignas (MidiEventHolder) std::byte storage[sizeof (MidiEventHolder)];
+    };
+
+    void addBlock (size_t numSlots)
+    {
+        auto& block = blocks.emplace_back (new Slot[numSlots]);
+
+        for (auto i = numSlots; i > 0; --i)
+            release (block.get() + i - 1);
+
+        nextBlockSize = jmin (nextBlockSize * 2, maxBlockSize);
+    }
+
+    static constexpr size_t maxBlockSize = 4096;
+
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    Slot* freeList = nullptr;
+    size_t nextBlockSize = 16;
+};
+
 //==============================================================================
 MidiMessageSequence::MidiMessageSequence()
+    : pool (std::make_unique<EventPool>())
 {
 }
 
 MidiMessageSequence::MidiMessageSequence (const MidiMessageSequence& other)
+    : MidiMessageSequence()
 {
-    list.addCopiesOf (other.list);
+    pool->reserve (other.list.size());
+    list.ensureStorageAllocated (other.list.size());
+
+    for (auto* meh : other.list)
+        list.add (createEvent (meh->message));
 
     for (int i = 0; i < list.size(); ++i)
     {
@@ -64,24 +130,59 @@ MidiMessageSequence& MidiMessageSequence::operator= (const MidiMessageSequence&
 }
 
 MidiMessageSequence::MidiMessageSequence (MidiMessageSequence&& other) noexcept
-    : list (std::move (other.list))
+    : list (std::move (other.list)),
+      pool (std::move (other.pool))
 {
 }
 
 MidiMessageSequence& MidiMessageSequence::operator= (MidiMessageSequence&& other) noexcept
 {
-    list = std::move (other.list);
+    MidiMessageSequence otherCopy (std::move (other));
+    swapWith (otherCopy);
     return *this;
 }
 
+MidiMessageSequence::~MidiMessageSequence()
+{
+    for (auto* meh : list)
+        meh->~MidiEventHolder();
+}
+
 void MidiMessageSequence::swapWith (MidiMessageSequence& other) noexcept
 {
     list.swapWith (other.list);
+    std::swap (pool, other.pool);
 }
 
 void MidiMessageSequence::clear()
 {
+    for (auto* meh : list)
+        meh->~MidiEventHolder();
+
     list.clear();
+    pool = std::make_unique<EventPool>();
+}
+
+MidiMessageSequence::MidiEventHolder* MidiMessageSequence::createEvent (const MidiMessage& message)
+{
+    if (pool == nullptr) // only happens after this sequence has been moved from
+        pool = std::make_unique<EventPool>();
+
+    return new (pool->allocate()) MidiEventHolder (message);
+}
+
+MidiMessageSequence::MidiEventHolder* MidiMessageSequence::createEvent (MidiMessage&& message)
+{
+    if (pool == nullptr)
+        pool = std::make_unique<EventPool>();
+
+    return new (pool->allocate()) MidiEventHolder (std::move (message));
+}
+
+void MidiMessageSequence::destroyEvent (MidiEventHolder* meh) noexcept
+{
+    meh->~MidiEventHolder();
+    pool->release (meh);
 }
 
 int MidiMessageSequence::getNumEvents() const noexcept
@@ -114,9 +215,10 @@ int MidiMessageSequence::getIndexOfMatchingKeyUp (int index) const noexcept
     {
         if (auto* noteOff = meh->noteOffObject)
         {
-            for (int i = index; i < list.size(); ++i)
-                if (list.getUnchecked (i) == noteOff)
-                    return i;
+            auto noteOffIndex = findIndexOf (noteOff, index);
+
+            if (noteOffIndex >= 0)
+                return noteOffIndex;
 
             jassertfalse; // we've somehow got a pointer to a note-off object that isn't in the sequence
         }
@@ -127,19 +229,40 @@ int MidiMessageSequence::getIndexOfMatchingKeyUp (int index) const noexcept
 
 int MidiMessageSequence::getIndexOf (const MidiEventHolder* event) const noexcept
 {
-    return list.indexOf (event);
+    return event != nullptr ? findIndexOf (event, 0) : -1;
 }
 
-int MidiMessageSequence::getNextIndexAtTime (double timeStamp) const noexcept
+int MidiMessageSequence::findIndexOf (const MidiEventHolder* event, int startIndex) const noexcept
 {
-    auto numEvents = list.size();
-    int i;
+    // Matching note-offs are usually only a few events along, so try those first..
+    for (int i = startIndex; i < jmin (startIndex + 8, list.size()); ++i)
+        if (list.getUnchecked (i) == event)
+            return i;
+
+    // ..then look among the events that share this one's timestamp, which will find
+    // it as long as the sequence is sorted..
+    auto time = event->message.getTimeStamp();
+    auto first = std::lower_bound (list.begin() + startIndex, list.end(), time,
+                                   [] (const MidiEventHolder* m, double t) { return m->message.getTimeStamp() < t; });
+
+    for (auto i = first; i != list.end() && exactlyEqual ((*i)->message.getTimeStamp(), time); ++i)
+        if (*i == event)
+            return (int) (i - list.begin());
+
+    // ..but if the caller has changed some timestamps without re-sorting, fall back to a full scan
+    for (int i = startIndex; i < list.size(); ++i)
+        if (list.getUnchecked (i) == event)
+            return i;
 
-    for (i = 0; i < numEvents; ++i)
-        if (list.getUnchecked (i)->message.getTimeStamp() >= timeStamp)
-            break;
+    return -1;
+}
+
+int MidiMessageSequence::getNextIndexAtTime (double timeStamp) const noexcept
+{
+    auto i = std::partition_point (list.begin(), list.end(),
+                                   [timeStamp] (const MidiEventHolder* m) { return m->message.getTimeStamp() < timeStamp; });
 
-    return i;
+    return (int) (i - list.begin());
 }
 
 //==============================================================================
@@ -166,24 +289,28 @@ MidiMessageSequence::MidiEventHolder* MidiMessageSequence::addEvent (MidiEventHo
 {
     newEvent->message.addToTimeStamp (timeAdjustment);
     auto time = newEvent->message.getTimeStamp();
-    int i;
 
-    for (i = list.size(); --i >= 0;)
-        if (list.getUnchecked (i)->message.getTimeStamp() <= time)
-            break;
+    if (list.isEmpty() || list.getLast()->message.getTimeStamp() <= time)
+    {
+        list.add (newEvent);
+        return newEvent;
+    }
+
+    auto i = std::upper_bound (list.begin(), list.end(), time,
+                               [] (double t, const MidiEventHolder* m) { return t < m->message.getTimeStamp(); });
 
-    list.insert (i + 1, newEvent);
+    list.insert ((int) (i - list.begin()), newEvent);
     return newEvent;
 }
 
 MidiMessageSequence::MidiEventHolder* MidiMessageSequence::addEvent (const MidiMessage& newMessage, double timeAdjustment)
 {
-    return addEvent (new MidiEventHolder (newMessage), timeAdjustment);
+    return addEvent (createEvent (newMessage), timeAdjustment);
 }
 
 MidiMessageSequence::MidiEventHolder* MidiMessageSequence::addEvent (MidiMessage&& newMessage, double timeAdjustment)
 {
-    return addEvent (new MidiEventHolder (std::move (newMessage)), timeAdjustment);
+    return addEvent (createEvent (std::move (newMessage)), timeAdjustment);
 }
 
 void MidiMessageSequence::deleteEvent (int index, bool deleteMatchingNoteUp)
@@ -191,22 +318,27 @@ void MidiMessageSequence::deleteEvent (int index, bool deleteMatchingNoteUp)
     if (isPositiveAndBelow (index, list.size()))
     {
         if (deleteMatchingNoteUp)
-            deleteEvent (getIndexOfMatchingKeyUp (index), false);
+        {
+            auto noteOffIndex = getIndexOfMatchingKeyUp (index);
+
+            if (noteOffIndex >= 0)
+            {
+                destroyEvent (list.getUnchecked (noteOffIndex));
+                list.remove (noteOffIndex);
 
+                if (noteOffIndex < index)
+                    --index;
+            }
+        }
+
+        destroyEvent (list.getUnchecked (index));
         list.remove (index);
     }
 }
 
 void MidiMessageSequence::addSequence (const MidiMessageSequence& other, double timeAdjustment)
 {
-    for (auto* m : other)
-    {
-        auto newOne = new MidiEventHolder (m->message);
-        newOne->message.addToTimeStamp (timeAdjustment);
-        list.add (newOne);
-    }
-
-    sort();
+    addSequence (other, timeAdjustment, -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
 }
 
 void MidiMessageSequence::addSequence (const MidiMessageSequence& other,
@@ -214,19 +346,35 @@ void MidiMessageSequence::addSequence (const MidiMessageSequence& other,
                                        double firstAllowableTime,
                                        double endOfAllowableDestTimes)
 {
+    auto numExisting = list.size();
+
+    if (pool == nullptr)
+        pool = std::make_unique<EventPool>();
+
+    pool->reserve (other.list.size());
+    list.ensureStorageAllocated (numExisting + other.list.size());
+
     for (auto* m : other)
     {
         auto t = m->message.getTimeStamp() + timeAdjustment;
 
         if (t >= firstAllowableTime && t < endOfAllowableDestTimes)
         {
-            auto newOne = new MidiEventHolder (m->message);
+            auto newOne = createEvent (m->message);
             newOne->message.setTimeStamp (t);
             list.add (newOne);
         }
     }
 
-    sort();
+    // Both halves will normally already be in order, in which case merging them gives
+    // the same result as a full stable sort without having to do one
+    auto byTime = [] (const MidiEventHolder* a, const MidiEventHolder* b) { return a->message.getTimeStamp() < b->message.getTimeStamp(); };
+    auto middle = list.begin() + numExisting;
+
+    if (std::is_sorted (list.begin(), middle, byTime) && std::is_sorted (middle, list.end(), byTime))
+        std::inplace_merge (list.begin(), middle, list.end(), byTime);
+    else
+        sort();
 }
 
 void MidiMessageSequence::sort() noexcept
@@ -237,43 +385,65 @@ void MidiMessageSequence::sort() noexcept
 
 void MidiMessageSequence::updateMatchedPairs() noexcept
 {
+    // Each note-on is paired with the next event for the same channel and note. If
+    // that's a note-off they get matched up, and if it's another note-on, a note-off
+    // is inserted just before it. Doing this in a single pass means only tracking the
+    // most recent unmatched note-on for each channel and note.
+    std::array<MidiEventHolder*, 16 * 128> pendingNoteOns {};
+    std::vector<std::pair<int, MidiEventHolder*>> noteOffsToInsert;
+
     for (int i = 0; i < list.size(); ++i)
     {
         auto* meh = list.getUnchecked (i);
-        auto& m1 = meh->message;
+        auto& m = meh->message;
+        auto isNoteOff = m.isNoteOff();
 
-        if (m1.isNoteOn())
-        {
-            meh->noteOffObject = nullptr;
-            auto note = m1.getNoteNumber();
-            auto chan = m1.getChannel();
-            auto len = list.size();
+        if (! (isNoteOff || m.isNoteOn()))
+            continue;
 
-            for (int j = i + 1; j < len; ++j)
-            {
-                auto* meh2 = list.getUnchecked (j);
-                auto& m = meh2->message;
+        auto& pending = pendingNoteOns[(size_t) ((m.getChannel() - 1) * 128 + m.getNoteNumber())];
 
-                if (m.getNoteNumber() == note && m.getChannel() == chan)
-                {
-                    if (m.isNoteOff())
-                    {
-                        meh->noteOffObject = meh2;
-                        break;
-                    }
+        if (isNoteOff)
+        {
+            if (pending != nullptr)
+                pending->noteOffObject = meh;
 
-                    if (m.isNoteOn())
-                    {
-                        auto newEvent = new MidiEventHolder (MidiMessage::noteOff (chan, note));
-                        list.insert (j, newEvent);
-                        newEvent->message.setTimeStamp (m.getTimeStamp());
-                        meh->noteOffObject = newEvent;
-                        break;
-                    }
-                }
+            pending = nullptr;
+        }
+        else
+        {
+            if (pending != nullptr)
+            {
+                auto newEvent = createEvent (MidiMessage::noteOff (m.getChannel(), m.getNoteNumber()));
+                newEvent->message.setTimeStamp (m.getTimeStamp());
+                pending->noteOffObject = newEvent;
+                noteOffsToInsert.emplace_back (i, newEvent);
             }
+
+            meh->noteOffObject = nullptr;
+            pending = meh;
         }
     }
+
+    if (noteOffsToInsert.empty())
+        return;
+
+    // Splice in all the new note-offs at once, rather than shuffling the list for each one
+    auto oldSize = list.size();
+    auto numToInsert = (int) noteOffsToInsert.size();
+    list.insertMultiple (oldSize, nullptr, numToInsert);
+
+    auto* events = list.begin();
+    auto dest = oldSize + numToInsert;
+    auto source = oldSize;
+
+    for (auto it = noteOffsToInsert.rbegin(); it != noteOffsToInsert.rend(); ++it)
+    {
+        while (source > it->first)
+            events[--dest] = events[--source];
+
+        events[--dest] = it->second;
+    }
 }
 
 void MidiMessageSequence::addTimeToMessages (double delta) noexcept
@@ -303,16 +473,30 @@ void MidiMessageSequence::extractSysExMessages (MidiMessageSequence& destSequenc
 
 void MidiMessageSequence::deleteMidiChannelMessages (const int channelNumberToRemove)
 {
-    for (int i = list.size(); --i >= 0;)
-        if (list.getUnchecked (i)->message.isForChannel (channelNumberToRemove))
-            list.remove (i);
+    auto newEnd = std::remove_if (list.begin(), list.end(), [this, channelNumberToRemove] (MidiEventHolder* meh)
+    {
+        if (! meh->message.isForChannel (channelNumberToRemove))
+            return false;
+
+        destroyEvent (meh);
+        return true;
+    });
+
+    list.removeRange ((int) (newEnd - list.begin()), (int) (list.end() - newEnd));
 }
 
 void MidiMessageSequence::deleteSysExMessages()
 {
-    for (int i = list.size(); --i >= 0;)
-        if (list.getUnchecked (i)->message.isSysEx())
-            list.remove (i);
+    auto newEnd = std::remove_if (list.begin(), list.end(), [this] (MidiEventHolder* meh)
+    {
+        if (! meh->message.isSysEx())
+            return false;
+
+        destroyEvent (meh);
+        return true;
+    });
+
+    list.removeRange ((int) (newEnd - list.begin()), (int) (list.end() - newEnd));
 }
 
 //==============================================================================
@@ -541,6 +725,169 @@ struct MidiMessageSequenceTest final : public UnitTest
         expectEquals (s.getIndexOfMatchingKeyUp (0), -1); // Truncated note, should be no note off
         expectEquals (s.getTimeOfMatchingKeyUp (1), 5.0);
 
+        beginTest ("Matching pairs agrees with a naive search");
+        {
+            auto random = getRandom();
+
+            for (int run = 0; run < 20; ++run)
+            {
+                MidiMessageSequence seq;
+
+                for (int i = 0; i < 300; ++i)
+                {
+                    auto channel = 1 + random.nextInt (2);
+                    auto note = 60 + random.nextInt (4);
+                    auto time = (double) random.nextInt (100);
+
+                    switch (random.nextInt (4))
+                    {
+                        case 0:  seq.addEvent (MidiMessage::noteOn (channel, note, 0.5f).withTimeStamp (time)); break;
+                        case 1:  seq.addEvent (MidiMessage::noteOff (channel, note).withTimeStamp (time)); break;
+                        case 2:  seq.addEvent (MidiMessage::noteOn (channel, note, (uint8) 0).withTimeStamp (time)); break;
+                        default: seq.addEvent (MidiMessage::controllerEvent (channel, note, 1).withTimeStamp (time)); break;
+                    }
+                }
+
+                // The original quadratic algorithm, working on a plain array of messages
+                std::vector<MidiMessage> expected;
+                std::vector<int> expectedMatches;
+
+                for (auto* meh : seq)
+                    expected.push_back (meh->message);
+
+                expectedMatches.resize (expected.size(), -1);
+
+                for (size_t i = 0; i < expected.size(); ++i)
+                {
+                    if (! expected[i].isNoteOn())
+                        continue;
+
+                    for (size_t j = i + 1; j < expected.size(); ++j)
+                    {
+                        const auto& m = expected[j];
+
+                        if (m.getNoteNumber() != expected[i].getNoteNumber() || m.getChannel() != expected[i].getChannel())
+                            continue;
+
+                        if (m.isNoteOff())
+                        {
+                            expectedMatches[i] = (int) j;
+                            break;
+                        }
+
+                        if (m.isNoteOn())
+                        {
+                            expected.insert (expected.begin() + (ptrdiff_t) j, MidiMessage::noteOff (m.getChannel(), m.getNoteNumber()).withTimeStamp (m.getTimeStamp()));
+                            expectedMatches.insert (expectedMatches.begin() + (ptrdiff_t) j, -1);
+
+                            for (size_t k = 0; k < i; ++k)
+                                if (expectedMatches[k] >= (int) j)
+                                    ++expectedMatches[k];
+
+                            expectedMatches[i] = (int) j;
+                            break;
+                        }
+                    }
+                }
+
+                seq.updateMatchedPairs();
+                expectEquals (seq.getNumEvents(), (int) expected.size());
+
+                for (int i = 0; i < seq.getNumEvents(); ++i)
+                {
+                    const auto& m = seq.getEventPointer (i)->message;
+                    expect (m.getDescription() == expected[(size_t) i].getDescription());
+                    expect (exactlyEqual (m.getTimeStamp(), expected[(size_t) i].getTimeStamp()));
+                    expectEquals (seq.getIndexOfMatchingKeyUp (i), expectedMatches[(size_t) i]);
+                }
+            }
+        }
+
+        beginTest ("Events keep their addresses while the sequence is edited");
+        {
+            MidiMessageSequence seq;
+            Array<MidiMessageSequence::MidiEventHolder*> holders;
+
+            for (int i = 0; i < 1000; ++i)
+                holders.add (seq.addEvent (MidiMessage::noteOn (1 + i % 16, i % 128, 0.5f).withTimeStamp ((i * 37) % 500)));
+
+            for (int i = 0; i < 100; ++i)
+                seq.addEvent (MidiMessage::controllerEvent (3, 7, i).withTimeStamp (i * 5));
+
+            holders.removeIf ([] (auto* h) { return h->message.getChannel() == 3; });
+            seq.deleteMidiChannelMessages (3);
+
+            expectEquals (seq.getNumEvents(), holders.size());
+
+            for (auto* h : holders)
+            {
+                auto index = seq.getIndexOf (h);
+                expect (seq.getEventPointer (index) == h);
+            }
+
+            for (int i = 1; i < seq.getNumEvents(); ++i)
+                expect (seq.getEventTime (i - 1) <= seq.getEventTime (i));
+
+            expectEquals (seq.getIndexOf (nullptr), -1);
+        }
+
+        beginTest ("Events with equal timestamps stay in the order they were added");
+        {
+            MidiMessageSequence seq, other;
+
+            for (int i = 0; i < 10; ++i)
+                seq.addEvent (MidiMessage::controllerEvent (1, 1, i).withTimeStamp (i % 2 == 0 ? 1.0 : 2.0));
+
+            other.addEvent (MidiMessage::controllerEvent (1, 1, 100).withTimeStamp (1.0));
+            other.addEvent (MidiMessage::controllerEvent (1, 1, 101).withTimeStamp (1.5));
+            seq.addSequence (other, 0.0);
+
+            const int expectedValues[] { 0, 2, 4, 6, 8, 100, 101, 1, 3, 5, 7, 9 };
+            expectEquals (seq.getNumEvents(), (int) std::size (expectedValues));
+
+            for (int i = 0; i < seq.getNumEvents(); ++i)
+                expectEquals (seq.getEventPointer (i)->message.getControllerValue(), expectedValues[i]);
+
+            expectEquals (seq.getNextIndexAtTime (1.0), 0);
+            expectEquals (seq.getNextIndexAtTime (1.2), 6);
+            expectEquals (seq.getNextIndexAtTime (2.0), 7);
+        }
+
+        beginTest ("Copies and moves keep their note-offs");
+        {
+            MidiMessageSequence seq;
+
+            for (int i = 0; i < 200; ++i)
+            {
+                seq.addEvent (MidiMessage::noteOn (1, i % 128, 0.5f).withTimeStamp (i));
+                seq.addEvent (MidiMessage::noteOff (1, i % 128).withTimeStamp (i + 0.5));
+            }
+
+            seq.updateMatchedPairs();
+
+            MidiMessageSequence copy (seq);
+            MidiMessageSequence moved (std::move (copy));
+            copy = seq;
+
+            for (auto* target : { &copy, &moved })
+            {
+                expectEquals (target->getNumEvents(), seq.getNumEvents());
+
+                for (int i = 0; i < seq.getNumEvents(); i += 2)
+                {
+                    auto* noteOff = target->getEventPointer (i)->noteOffObject;
+                    expect (noteOff == target->getEventPointer (i + 1));
+                    expect (noteOff != seq.getEventPointer (i + 1));
+                }
+            }
+
+            moved.deleteEvent (0, true);
+            expectEquals (moved.getNumEvents(), seq.getNumEvents() - 2);
+            moved.clear();
+            moved.addEvent (MidiMessage::noteOn (1, 1, 0.5f));
+            expectEquals (moved.getNumEvents(), 1);
+        }
+
         struct ControlValue { int control, value; };
 
         struct DataEntry
@@ -56,6 +56,9 @@ public:
     /** Creates a copy of another sequence. */
     MidiMessageSequence (const MidiMessageSequence&);
 
+    /** Destructor. */
+    ~MidiMessageSequence();
+
     /** Replaces this sequence with another one. */
     MidiMessageSequence& operator= (const MidiMessageSequence&);
 
@@ -71,6 +74,9 @@ public:
         These structures act as 'handles' on the events as they are moved about in
         the list, and make it quick to find the matching note-offs for note-on events.
 
+        The holders are allocated in blocks owned by the sequence, so a pointer to one
+        stays valid until its event is deleted or the sequence is cleared or destroyed.
+
         @see MidiMessageSequence::getEventPointer
     */
     class MidiEventHolder
@@ -99,7 +105,7 @@ public:
     };
 
     //==============================================================================
-    /** Clears the sequence. */
+    /** Clears the sequence, releasing the memory used by its events. */
     void clear();
 
     /** Returns the number of events in the sequence. */
@@ -132,7 +138,11 @@ public:
     */
     int getIndexOfMatchingKeyUp (int index) const noexcept;
 
-    /** Returns the index of an event. */
+    /** Returns the index of an event, or -1 if it isn't in the sequence.
+
+        As long as the sequence is sorted, this will find the event with a binary
+        search on its timestamp.
+    */
     int getIndexOf (const MidiEventHolder* event) const noexcept;
 
     /** Returns the index of the first event on or after the given timestamp.
@@ -317,9 +327,16 @@ public:
 private:
     //==============================================================================
     friend class MidiFile;
-    OwnedArray<MidiEventHolder> list;
+    class EventPool;
+
+    Array<MidiEventHolder*> list;
+    std::unique_ptr<EventPool> pool;
 
+    MidiEventHolder* createEvent (const MidiMessage&);
+    MidiEventHolder* createEvent (MidiMessage&&);
+    void destroyEvent (MidiEventHolder*) noexcept;
     MidiEventHolder* addEvent (MidiEventHolder*, double);
+    int findIndexOf (const MidiEventHolder*, int startIndex) const noexcept;
 
     JUCE_LEAK_DETECTOR (MidiMessageSequence)
 };
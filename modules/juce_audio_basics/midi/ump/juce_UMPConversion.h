@@ -151,6 +151,46 @@ struct Conversion
         }
     }
 
+    /** Converts a buffer of MIDI 1 bytestream messages to MIDI 1 on Universal MIDI
+        Packets, appending the packets to `out`.
+
+        This produces the same packets as calling toMidi1() for each message in turn,
+        but is much quicker for large buffers. Note that the sample positions of the
+        messages aren't stored in the packets.
+    */
+    static void toMidi1 (const MidiBuffer& messages, Packets& out)
+    {
+        detail::PacketsAppender appender (out);
+
+        for (const auto metadata : messages)
+        {
+            if (metadata.numBytes <= 0)
+                continue;
+
+            if (metadata.data[0] != 0xf0)
+            {
+                appender.add (getMidi1Word (metadata.data, (size_t) metadata.numBytes));
+                continue;
+            }
+
+            toMidi1 (BytestreamMidiView (metadata), [&] (const View& v) { appender.add (v); });
+        }
+    }
+
+    /** Converts a run of UMP messages, which may include MIDI 2.0 channel voice messages,
+        into equivalent MIDI 1.0 messages, appending the converted packets to `out`.
+
+        `words` must hold complete, well-formed packets. The results are the same as
+        calling midi2ToMidi1DefaultTranslation() for each packet in turn.
+    */
+    static void midi2ToMidi1DefaultTranslation (Span<const uint32_t> words, Packets& out)
+    {
+        detail::PacketsAppender appender (out);
+
+        for (auto* word = words.begin(); word < words.end(); word += Utils::getNumWordsForMessageType (*word))
+            midi2ToMidi1DefaultTranslation (View (word), [&] (const View& v) { appender.add (v); });
+    }
+
     /** Widens a 7-bit MIDI 1.0 value to a 8-bit MIDI 2.0 value. */
     static uint8_t scaleTo8 (uint8_t word7Bit)
     {
@@ -360,6 +400,21 @@ struct Conversion
                 return;
         }
     }
+
+private:
+    // Equivalent to the non-sysex branch of toMidi1(), but never reads past the end of the message
+    static uint32_t getMidi1Word (const uint8_t* data, size_t size)
+    {
+        if (size > 3)
+            return 0;
+
+        const auto messageType = (uint32_t) ((data[0] & 0xf0) == 0xf0 ? 0x1 : 0x2);
+
+        return (messageType << 0x1c)
+             | ((uint32_t) data[0] << 0x10)
+             | (size > 1 ? (uint32_t) data[1] << 0x08 : 0)
+             | (size > 2 ? (uint32_t) data[2] : 0);
+    }
 };
 
 } // namespace juce::universal_midi_packets
@@ -55,6 +55,16 @@ namespace juce::universal_midi_packets
         {
             Conversion::midi2ToMidi1DefaultTranslation (v, std::forward<Fn> (fn));
         }
+
+        void convert (const MidiBuffer& messages, Packets& out)
+        {
+            Conversion::toMidi1 (messages, out);
+        }
+
+        void convert (Span<const uint32_t> words, Packets& out)
+        {
+            Conversion::midi2ToMidi1DefaultTranslation (words, out);
+        }
     };
 
     /**
@@ -80,6 +90,19 @@ namespace juce::universal_midi_packets
             translator.dispatch (v, std::forward<Fn> (fn));
         }
 
+        void convert (const MidiBuffer& messages, Packets& out)
+        {
+            detail::PacketsAppender appender (out);
+
+            for (const auto metadata : messages)
+                convert (BytestreamMidiView (metadata), [&] (const View& v) { appender.add (v); });
+        }
+
+        void convert (Span<const uint32_t> words, Packets& out)
+        {
+            translator.dispatch (words, out);
+        }
+
         void reset()
         {
             translator.reset();
@@ -137,6 +160,18 @@ namespace juce::universal_midi_packets
             });
         }
 
+        template <typename Converter>
+        static void convertImpl (Converter& converter, const MidiBuffer& messages, Packets& out)
+        {
+            converter.convert (messages, out);
+        }
+
+        template <typename Converter>
+        static void convertImpl (Converter& converter, Span<const uint32_t> words, Packets& out)
+        {
+            converter.convert (words, out);
+        }
+
         template <typename Fn>
         void convert (const BytestreamMidiView& m, Fn&& fn)
         {
@@ -155,6 +190,22 @@ namespace juce::universal_midi_packets
             visit (*this, begin, end, std::forward<Fn> (fn));
         }
 
+        /** Converts all the messages in a buffer, appending the packets to `out`.
+            This is quicker than converting the messages one at a time.
+        */
+        void convert (const MidiBuffer& messages, Packets& out)
+        {
+            visit (*this, messages, out);
+        }
+
+        /** Converts a run of packets, appending the results to `out`.
+            This is quicker than converting the packets one at a time.
+        */
+        void convert (Span<const uint32_t> words, Packets& out)
+        {
+            visit (*this, words, out);
+        }
+
         PacketProtocol getProtocol() const noexcept { return mode; }
 
     private:
@@ -188,6 +239,18 @@ namespace juce::universal_midi_packets
             });
         }
 
+        /** Converts a run of packets, adding the messages to `out` at the given sample position. */
+        void convert (Span<const uint32_t> words, int samplePosition, MidiBuffer& out)
+        {
+            for (auto* word = words.begin(); word < words.end(); word += Utils::getNumWordsForMessageType (*word))
+            {
+                Conversion::midi2ToMidi1DefaultTranslation (View (word), [&] (const View& midi1)
+                {
+                    translator.dispatch (Span<const uint32_t> (midi1.data(), midi1.size()), samplePosition, out);
+                });
+            }
+        }
+
         void reset() { translator.reset(); }
 
         Midi1ToBytestreamTranslator translator;
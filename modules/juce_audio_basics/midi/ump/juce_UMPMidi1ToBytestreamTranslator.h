@@ -106,6 +106,44 @@ public:
         }
     }
 
+    /** Converts a run of Universal MIDI Packets using the MIDI 1.0 Protocol to
+        bytestream messages, adding them to `out` at the given sample position.
+
+        `words` must hold complete, well-formed packets. The results are the same
+        as calling the callback version of dispatch() for each packet in turn, and
+        SysEx packets are accumulated in the same way, so a SysEx message may span
+        several calls.
+    */
+    void dispatch (Span<const uint32_t> words, int samplePosition, MidiBuffer& out)
+    {
+        for (auto* word = words.begin(); word < words.end();)
+        {
+            const auto firstWord = *word;
+            const auto messageType = Utils::getMessageType (firstWord);
+
+            // Channel voice and system messages can be added directly, without creating a MidiMessage
+            if (messageType == 0x1 || messageType == 0x2)
+            {
+                if (! pendingSysExData.empty() && shouldPacketTerminateSysExEarly (firstWord))
+                    pendingSysExData.clear();
+
+                const uint8_t bytes[] { uint8_t ((firstWord >> 0x10) & 0xff),
+                                        uint8_t ((firstWord >> 0x08) & 0xff),
+                                        uint8_t ((firstWord >> 0x00) & 0xff) };
+                out.addEvent (bytes, MidiMessage::getMessageLengthFromFirstByte (bytes[0]), samplePosition);
+                ++word;
+                continue;
+            }
+
+            dispatch (View (word), (double) samplePosition, [&] (const BytestreamMidiView& m)
+            {
+                out.addEvent (m.bytes.data(), (int) m.bytes.size(), samplePosition);
+            });
+
+            word += Utils::getNumWordsForMessageType (firstWord);
+        }
+    }
+
     /** Converts from a Universal MIDI Packet to MIDI 1 bytestream format.
 
         This is only capable of converting a single Universal MIDI Packet to
@@ -35,6 +35,14 @@
 namespace juce::universal_midi_packets
 {
 
+void Midi1ToMidi2DefaultTranslator::dispatch (Span<const uint32_t> words, Packets& out)
+{
+    detail::PacketsAppender appender (out);
+
+    for (auto* word = words.begin(); word < words.end(); word += Utils::getNumWordsForMessageType (*word))
+        dispatch (View (word), [&] (const View& v) { appender.add (v); });
+}
+
 PacketX2 Midi1ToMidi2DefaultTranslator::processNoteOnOrOff (const HelperValues helpers)
 {
     const auto velocity = helpers.byte2;
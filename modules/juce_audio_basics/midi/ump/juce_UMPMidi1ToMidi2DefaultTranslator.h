@@ -127,6 +127,14 @@ public:
         }
     }
 
+    /** Converts a run of MIDI 1 Universal MIDI Packets to the corresponding MIDI 2
+        packets, appending the converted packets to `out`.
+
+        `words` must hold complete, well-formed packets. The results are the same
+        as calling the callback version of dispatch() for each packet in turn.
+    */
+    void dispatch (Span<const uint32_t> words, Packets& out);
+
     void reset()
     {
         groupAccumulators = {};
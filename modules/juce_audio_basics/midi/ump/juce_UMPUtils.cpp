@@ -1,68 +0,0 @@
-/*
-  ==============================================================================
-
-   This file is part of the JUCE framework.
-   Copyright (c) Raw Material Software Limited
-
-   JUCE is an open source framework subject to commercial or open source
-   licensing.
-
-   By downloading, installing, or using the JUCE framework, or combining the
-   JUCE framework with any other source code, object code, content or any other
-   copyrightable work, you agree to the terms of the JUCE End User Licence
-   Agreement, and all incorporated terms including the JUCE Privacy Policy and
-   the JUCE Website Terms of Service, as applicable, which will bind you. If you
-   do not agree to the terms of these agreements, we will not license the JUCE
-   framework to you, and you must discontinue the installation or download
-   process and cease use of the JUCE framework.
-
-   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
-   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
-   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
-
-   Or:
-
-   You may also use this code under the terms of the AGPLv3:
-   https://www.gnu.org/licenses/agpl-3.0.en.html
-
-   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
-   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
-   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
-
-  ==============================================================================
-*/
-
-namespace juce::universal_midi_packets
-{
-
-uint32_t Utils::getNumWordsForMessageType (uint32_t mt)
-{
-    switch (Utils::getMessageType (mt))
-    {
-        case 0x0:
-        case 0x1:
-        case 0x2:
-        case 0x6:
-        case 0x7:
-            return 1;
-        case 0x3:
-        case 0x4:
-        case 0x8:
-        case 0x9:
-        case 0xa:
-            return 2;
-        case 0xb:
-        case 0xc:
-            return 3;
-        case 0x5:
-        case 0xd:
-        case 0xe:
-        case 0xf:
-            return 4;
-    }
-
-    jassertfalse;
-    return 1;
-}
-
-} // namespace juce::universal_midi_packets
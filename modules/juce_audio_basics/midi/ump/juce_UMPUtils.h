@@ -59,7 +59,12 @@ struct Utils
         The result will be between 1 and 4 inclusive.
         A result of 1 means that the word is itself a complete packet.
     */
-    static uint32_t getNumWordsForMessageType (uint32_t);
+    static constexpr uint32_t getNumWordsForMessageType (uint32_t mt)
+    {
+        // This gets called for every packet that's parsed, so it's a lookup rather than a switch
+        constexpr uint8_t numWords[] { 1, 1, 1, 2, 2, 4, 1, 1, 2, 2, 2, 3, 3, 4, 4, 4 };
+        return numWords[getMessageType (mt)];
+    }
 
     /**
         Helper functions for setting/getting 4-bit ranges inside a 32-bit word.
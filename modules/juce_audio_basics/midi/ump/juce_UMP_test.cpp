@@ -875,6 +875,91 @@ public:
 
             checkMidi1ToMidi2Conversion (midi1, midi2);
         }
+
+        beginTest ("Batch bytestream -> UMP conversion matches converting messages individually");
+        {
+            const auto buffer = createRandomMidiBuffer (random);
+
+            Packets expected;
+
+            for (const auto metadata : buffer)
+                Conversion::toMidi1 (BytestreamMidiView (metadata), [&] (const View& v) { expected.add (v); });
+
+            Packets actual;
+            Conversion::toMidi1 (buffer, actual);
+            checkBytestreamConversion (actual, expected);
+
+            for (auto protocol : { PacketProtocol::MIDI_1_0, PacketProtocol::MIDI_2_0 })
+            {
+                GenericUMPConverter individual (protocol), batch (protocol);
+                Packets expectedFromConverter, actualFromConverter;
+
+                for (const auto metadata : buffer)
+                    individual.convert (BytestreamMidiView (metadata), [&] (const View& v) { expectedFromConverter.add (v); });
+
+                batch.convert (buffer, actualFromConverter);
+                checkBytestreamConversion (actualFromConverter, expectedFromConverter);
+            }
+        }
+
+        beginTest ("Batch MIDI 1 <-> MIDI 2 conversion matches converting packets individually");
+        {
+            Packets midi1;
+            Conversion::toMidi1 (createRandomMidiBuffer (random), midi1);
+
+            Midi1ToMidi2DefaultTranslator individual, batch;
+            Packets expectedMidi2, actualMidi2;
+
+            for (const auto& packet : midi1)
+                individual.dispatch (packet, [&] (const View& v) { expectedMidi2.add (v); });
+
+            // Split the input so that some RPN sequences straddle two calls
+            const auto split = midi1.size() / 3;
+            batch.dispatch (Span<const uint32_t> (midi1.data(), split), actualMidi2);
+            batch.dispatch (Span<const uint32_t> (midi1.data() + split, midi1.size() - split), actualMidi2);
+            checkBytestreamConversion (actualMidi2, expectedMidi2);
+
+            Packets actualMidi1;
+            Conversion::midi2ToMidi1DefaultTranslation (expectedMidi2, actualMidi1);
+            checkBytestreamConversion (actualMidi1, convertMidi2ToMidi1 (expectedMidi2));
+        }
+
+        beginTest ("Batch UMP -> bytestream conversion matches converting packets individually");
+        {
+            const auto buffer = createRandomMidiBuffer (random);
+
+            Packets midi1;
+
+            for (const auto metadata : buffer)
+            {
+                Conversion::toMidi1 (BytestreamMidiView (metadata), [&] (const View& v) { midi1.add (v); });
+
+                if (random.nextInt (4) == 0)
+                    midi1.add (random.nextBool() ? createRandomUtilityUMP (random) : createRandomRealtimeUMP (random));
+            }
+
+            Midi1ToBytestreamTranslator individual (0), batch (0);
+            MidiBuffer expected, actual;
+
+            for (const auto& packet : midi1)
+                individual.dispatch (packet, 10, [&] (const BytestreamMidiView& m) { expected.addEvent (m.getMessage(), 10); });
+
+            batch.dispatch (midi1, 10, actual);
+            expect (equal (actual, expected));
+
+            Packets midi2;
+            Midi1ToMidi2DefaultTranslator translator;
+            translator.dispatch (midi1, midi2);
+
+            ToBytestreamConverter individualConverter (0), batchConverter (0);
+            MidiBuffer expectedFromMidi2, actualFromMidi2;
+
+            for (const auto& packet : midi2)
+                individualConverter.convert (packet, 0.0, [&] (const BytestreamMidiView& m) { expectedFromMidi2.addEvent (m.getMessage(), 0); });
+
+            batchConverter.convert (midi2, 0, actualFromMidi2);
+            expect (equal (actualFromMidi2, expectedFromMidi2));
+        }
     }
 
 private:
@@ -941,6 +1026,45 @@ private:
         return MidiMessage::createSysExMessage (data.data(), int (data.size()));
     }
 
+    MidiBuffer createRandomMidiBuffer (Random& random)
+    {
+        MidiBuffer result;
+        int time = 0;
+
+        const auto addController = [&] (int cc, int value) { result.addEvent (MidiMessage::controllerEvent (1, cc, value), time++); };
+
+        for (int i = 0; i < 500; ++i)
+        {
+            switch (random.nextInt (4))
+            {
+                case 0:
+                    forEachNonSysExTestMessage (random, [&] (const MidiMessage& m) { result.addEvent (m, time++); });
+                    break;
+
+                case 1:
+                    result.addEvent (createRandomSysEx (random, (size_t) random.nextInt (20)), time++);
+                    break;
+
+                case 2:
+                    // A complete RPN, followed by a bank select and program change
+                    addController (101, random.nextInt (128));
+                    addController (100, random.nextInt (128));
+                    addController (6,   random.nextInt (128));
+                    addController (38,  random.nextInt (128));
+                    addController (0,   random.nextInt (128));
+                    addController (32,  random.nextInt (128));
+                    result.addEvent (MidiMessage::programChange (1, random.nextInt (128)), time++);
+                    break;
+
+                default:
+                    result.addEvent (MidiMessage::noteOn (1 + random.nextInt (16), random.nextInt (128), (uint8) random.nextInt (128)), time++);
+                    break;
+            }
+        }
+
+        return result;
+    }
+
     PacketX1 createRandomUtilityUMP (Random& random)
     {
         const auto status = random.nextInt (3);
@@ -65,6 +65,14 @@ public:
     void add (const PacketX3& p) { addImpl (p); }
     void add (const PacketX4& p) { addImpl (p); }
 
+    /** Adds a run of packets stored as contiguous 32-bit words.
+
+        As with add (const View&), the words must hold complete, well-formed
+        packets, otherwise iterating the collection will result in undefined
+        behaviour.
+    */
+    void add (const uint32_t* words, size_t numWords) { storage.insert (storage.end(), words, words + numWords); }
+
     /** Pre-allocates space for at least `numWords` 32-bit words in this collection. */
     void reserve (size_t numWords)          { storage.reserve (numWords); }
 
@@ -100,6 +108,63 @@ private:
     std::vector<uint32_t> storage;
 };
 
+namespace detail
+{
+
+/*  Collects converted packets in a small fixed-size buffer, and appends them to a
+    Packets collection in runs. This is used by the batch conversion functions, which
+    would otherwise spend most of their time growing the collection one packet at a time.
+*/
+class PacketsAppender
+{
+public:
+    explicit PacketsAppender (Packets& p) : packets (p) {}
+    ~PacketsAppender() { flush(); }
+
+    void add (uint32_t word)
+    {
+        makeRoomFor (1);
+        buffer[numUsed++] = word;
+    }
+
+    void add (uint32_t word0, uint32_t word1)
+    {
+        makeRoomFor (2);
+        buffer[numUsed++] = word0;
+        buffer[numUsed++] = word1;
+    }
+
+    void add (const View& v)
+    {
+        const auto numWords = Utils::getNumWordsForMessageType (v[0]);
+        makeRoomFor (numWords);
+
+        for (uint32_t i = 0; i < numWords; ++i)
+            buffer[numUsed++] = v[i];
+    }
+
+    void flush()
+    {
+        packets.add (buffer.data(), numUsed);
+        numUsed = 0;
+    }
+
+private:
+    void makeRoomFor (size_t numWords)
+    {
+        if (numUsed + numWords > buffer.size())
+            flush();
+    }
+
+    Packets& packets;
+    std::array<uint32_t, 256> buffer;
+    size_t numUsed = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (PacketsAppender)
+};
+
+} // namespace detail
+
 } // namespace juce::universal_midi_packets
 
 #endif
@@ -53,6 +53,11 @@ MPEInstrument::MPEInstrument() noexcept
     mpeInstrumentFill (lastPressureLowerBitReceivedOnChannel, noLSBValueReceived);
     mpeInstrumentFill (lastTimbreLowerBitReceivedOnChannel, noLSBValueReceived);
     mpeInstrumentFill (isMemberChannelSustained, false);
+    mpeInstrumentFill (numNotesOnChannel, (uint8) 0);
+
+    // Reserve enough space that adding and removing notes won't normally
+    // need to touch the heap while processing MIDI
+    notes.ensureStorageAllocated (numPreallocatedNotes);
 
     pitchbendDimension.value = &MPENote::pitchbend;
     pressureDimension.value  = &MPENote::pressure;
@@ -286,7 +291,7 @@ void MPEInstrument::processMidiResetAllControllersMessage (const MidiMessage& me
                 note.keyState = MPENote::off;
                 note.noteOffVelocity = MPEValue::from7BitInt (64); // some reasonable number
                 listeners.call ([&] (Listener& l) { l.noteReleased (note); });
-                notes.remove (i);
+                removeNote (i);
             }
         }
     }
@@ -304,7 +309,7 @@ void MPEInstrument::processMidiResetAllControllersMessage (const MidiMessage& me
                 note.keyState = MPENote::off;
                 note.noteOffVelocity = MPEValue::from7BitInt (64); // some reasonable number
                 listeners.call ([&] (Listener& l) { l.noteReleased (note); });
-                notes.remove (i);
+                removeNote (i);
             }
         }
     }
@@ -351,6 +356,8 @@ void MPEInstrument::noteOn (int midiChannel,
                             int midiNoteNumber,
                             MPEValue midiNoteOnVelocity)
 {
+    const ScopedLock sl (lock);
+
     if (! isUsingChannel (midiChannel))
         return;
 
@@ -362,7 +369,6 @@ void MPEInstrument::noteOn (int midiChannel,
                      getInitialValueForNewNote (midiChannel, timbreDimension),
                      isMemberChannelSustained[midiChannel - 1] ? MPENote::keyDownAndSustained : MPENote::keyDown);
 
-    const ScopedLock sl (lock);
     updateNoteTotalPitchbend (newNote);
 
     if (auto* alreadyPlayingNote = getNotePtr (midiChannel, midiNoteNumber))
@@ -371,10 +377,10 @@ void MPEInstrument::noteOn (int midiChannel,
         alreadyPlayingNote->keyState = MPENote::off;
         alreadyPlayingNote->noteOffVelocity = MPEValue::from7BitInt (64); // some reasonable number
         listeners.call ([=] (Listener& l) { l.noteReleased (*alreadyPlayingNote); });
-        notes.remove (alreadyPlayingNote);
+        removeNote ((int) (alreadyPlayingNote - notes.begin()));
     }
 
-    notes.add (newNote);
+    addNote (newNote);
     listeners.call ([&] (Listener& l) { l.noteAdded (newNote); });
 }
 
@@ -404,7 +410,7 @@ void MPEInstrument::noteOff (int midiChannel,
         if (note->keyState == MPENote::off)
         {
             listeners.call ([=] (Listener& l) { l.noteReleased (*note); });
-            notes.remove (note);
+            removeNote ((int) (note - notes.begin()));
         }
         else
         {
@@ -468,6 +474,9 @@ void MPEInstrument::updateDimension (int midiChannel, MPEDimension& dimension, M
 
     if (isMemberChannel (midiChannel))
     {
+        if (! hasNotesOnChannel (midiChannel))
+            return;
+
         if (dimension.trackingMode == allNotesOnChannel)
         {
             for (int i = notes.size(); --i >= 0;)
@@ -624,7 +633,7 @@ void MPEInstrument::handleSustainOrSostenuto (int midiChannel, bool isDown, bool
             if (note.keyState == MPENote::off)
             {
                 listeners.call ([&] (Listener& l) { l.noteReleased (note); });
-                notes.remove (i);
+                removeNote (i);
             }
             else
             {
@@ -717,6 +726,8 @@ MPENote MPEInstrument::getNoteWithID (uint16 noteID) const noexcept
 //==============================================================================
 MPENote MPEInstrument::getMostRecentNote (int midiChannel) const noexcept
 {
+    const ScopedLock sl (lock);
+
     if (auto* note = getLastNotePlayedPtr (midiChannel))
         return *note;
 
@@ -739,6 +750,9 @@ MPENote MPEInstrument::getMostRecentNoteOtherThan (MPENote otherThanThisNote) co
 //==============================================================================
 const MPENote* MPEInstrument::getNotePtr (int midiChannel, int midiNoteNumber) const noexcept
 {
+    if (! hasNotesOnChannel (midiChannel))
+        return nullptr;
+
     for (int i = 0; i < notes.size(); ++i)
     {
         auto& note = notes.getReference (i);
@@ -777,7 +791,8 @@ MPENote* MPEInstrument::getNotePtr (int midiChannel, TrackingMode mode) noexcept
 //==============================================================================
 const MPENote* MPEInstrument::getLastNotePlayedPtr (int midiChannel) const noexcept
 {
-    const ScopedLock sl (lock);
+    if (! hasNotesOnChannel (midiChannel))
+        return nullptr;
 
     for (auto i = notes.size(); --i >= 0;)
     {
@@ -799,6 +814,9 @@ MPENote* MPEInstrument::getLastNotePlayedPtr (int midiChannel) noexcept
 //==============================================================================
 const MPENote* MPEInstrument::getHighestNotePtr (int midiChannel) const noexcept
 {
+    if (! hasNotesOnChannel (midiChannel))
+        return nullptr;
+
     int initialNoteMax = -1;
     const MPENote* result = nullptr;
 
@@ -825,6 +843,9 @@ MPENote* MPEInstrument::getHighestNotePtr (int midiChannel) noexcept
 
 const MPENote* MPEInstrument::getLowestNotePtr (int midiChannel) const noexcept
 {
+    if (! hasNotesOnChannel (midiChannel))
+        return nullptr;
+
     int initialNoteMin = 128;
     const MPENote* result = nullptr;
 
@@ -862,9 +883,101 @@ void MPEInstrument::releaseAllNotes()
         listeners.call ([&] (Listener& l) { l.noteReleased (note); });
     }
 
-    notes.clear();
+    notes.clearQuick();
+    mpeInstrumentFill (numNotesOnChannel, (uint8) 0);
+}
+
+//==============================================================================
+bool MPEInstrument::hasNotesOnChannel (int midiChannel) const noexcept
+{
+    return isPositiveAndBelow (midiChannel - 1, 16) && numNotesOnChannel[midiChannel - 1] != 0;
+}
+
+void MPEInstrument::addNote (const MPENote& note)
+{
+    notes.add (note);
+    ++numNotesOnChannel[note.midiChannel - 1];
+}
+
+void MPEInstrument::removeNote (int index)
+{
+    --numNotesOnChannel[notes.getReference (index).midiChannel - 1];
+    notes.remove (index);
+}
+
+//==============================================================================
+MPEInstrument::BufferedListener::BufferedListener (MPEInstrument& instrument, int capacity)
+    : owner (instrument),
+      fifo (capacity),
+      notifications ((size_t) capacity)
+{
+    const ScopedLock sl (owner.lock);
+    owner.addListener (this);
+}
+
+MPEInstrument::BufferedListener::~BufferedListener()
+{
+    const ScopedLock sl (owner.lock);
+    owner.removeListener (this);
+}
+
+void MPEInstrument::BufferedListener::push (Kind kind, MPENote note)
+{
+    // Continuous controller updates are the most frequent notifications, and the least important
+    // to deliver, so a quarter of the queue is kept free for notifications that change the set
+    // of playing notes
+    const auto isDimensionChange = kind == Kind::notePressureChanged
+                                || kind == Kind::notePitchbendChanged
+                                || kind == Kind::noteTimbreChanged;
+
+    if (isDimensionChange && fifo.getFreeSpace() < fifo.getTotalSize() / 4)
+    {
+        ++numDropped;
+        return;
+    }
+
+    const auto scope = fifo.write (1);
+
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+    {
+        ++numDropped;
+        return;
+    }
+
+    scope.forEach ([&] (int index) { notifications[(size_t) index] = { kind, note }; });
+}
+
+int MPEInstrument::BufferedListener::dispatchPendingNotifications (Listener& listenerToNotify)
+{
+    const auto scope = fifo.read (fifo.getNumReady());
+
+    scope.forEach ([&] (int index)
+    {
+        const auto& n = notifications[(size_t) index];
+
+        switch (n.kind)
+        {
+            case Kind::noteAdded:               listenerToNotify.noteAdded            (n.note); break;
+            case Kind::notePressureChanged:     listenerToNotify.notePressureChanged  (n.note); break;
+            case Kind::notePitchbendChanged:    listenerToNotify.notePitchbendChanged (n.note); break;
+            case Kind::noteTimbreChanged:       listenerToNotify.noteTimbreChanged    (n.note); break;
+            case Kind::noteKeyStateChanged:     listenerToNotify.noteKeyStateChanged  (n.note); break;
+            case Kind::noteReleased:            listenerToNotify.noteReleased         (n.note); break;
+            case Kind::zoneLayoutChanged:       listenerToNotify.zoneLayoutChanged();           break;
+        }
+    });
+
+    return scope.blockSize1 + scope.blockSize2;
 }
 
+void MPEInstrument::BufferedListener::noteAdded (MPENote note)              { push (Kind::noteAdded, note); }
+void MPEInstrument::BufferedListener::notePressureChanged (MPENote note)    { push (Kind::notePressureChanged, note); }
+void MPEInstrument::BufferedListener::notePitchbendChanged (MPENote note)   { push (Kind::notePitchbendChanged, note); }
+void MPEInstrument::BufferedListener::noteTimbreChanged (MPENote note)      { push (Kind::noteTimbreChanged, note); }
+void MPEInstrument::BufferedListener::noteKeyStateChanged (MPENote note)    { push (Kind::noteKeyStateChanged, note); }
+void MPEInstrument::BufferedListener::noteReleased (MPENote note)           { push (Kind::noteReleased, note); }
+void MPEInstrument::BufferedListener::zoneLayoutChanged()                   { push (Kind::zoneLayoutChanged, {}); }
+
 //==============================================================================
 void MPEInstrument::Listener::noteAdded ([[maybe_unused]] MPENote newNote)                 {}
 void MPEInstrument::Listener::notePressureChanged  ([[maybe_unused]] MPENote changedNote)  {}
@@ -2205,6 +2318,107 @@ public:
                 expectEquals (test.getNumPlayingNotes(), 0);
             }
         }
+
+        beginTest ("many notes");
+        {
+            UnitTestInstrument test;
+            test.enableLegacyMode();
+
+            for (int note = 0; note < 128; ++note)
+                test.noteOn (1 + note % 2, note, MPEValue::from7BitInt (100));
+
+            expectEquals (test.getNumPlayingNotes(), 128);
+            expectNote (test.getMostRecentNote (2), 100, 0, 8192, 64, MPENote::keyDown);
+            expectEquals ((int) test.getMostRecentNote (2).initialNote, 127);
+
+            for (int note = 0; note < 128; note += 2)
+                test.noteOff (1, note, MPEValue::from7BitInt (100));
+
+            expectEquals (test.getNumPlayingNotes(), 64);
+            expect (! test.getMostRecentNote (1).isValid());
+            expect (! test.getNote (1, 0).isValid());
+            expect (test.getNote (2, 1).isValid());
+
+            test.pitchbend (1, MPEValue::from14BitInt (1000));
+            expectEquals (test.notePitchbendChangedCallCounter, 0);
+
+            test.pitchbend (2, MPEValue::from14BitInt (1000));
+            expectEquals (test.notePitchbendChangedCallCounter, 1);
+            expectEquals (test.getMostRecentNote (2).pitchbend.as14BitInt(), 1000);
+
+            test.releaseAllNotes();
+            expectEquals (test.getNumPlayingNotes(), 0);
+            expect (! test.getMostRecentNote (2).isValid());
+        }
+
+        beginTest ("BufferedListener");
+        {
+            struct RecordingListener final : public MPEInstrument::Listener
+            {
+                void noteAdded (MPENote n) override             { record ('a', n); }
+                void notePressureChanged (MPENote n) override   { record ('p', n); }
+                void notePitchbendChanged (MPENote n) override  { record ('b', n); }
+                void noteTimbreChanged (MPENote n) override     { record ('t', n); }
+                void noteKeyStateChanged (MPENote n) override   { record ('k', n); }
+                void noteReleased (MPENote n) override          { record ('r', n); }
+                void zoneLayoutChanged() override               { kinds += 'z'; }
+
+                void record (char kind, MPENote n)
+                {
+                    kinds += kind;
+                    lastNote = n;
+                }
+
+                String kinds;
+                MPENote lastNote;
+            };
+
+            {
+                MPEInstrument test (testLayout);
+                MPEInstrument::BufferedListener buffered (test, 16);
+                RecordingListener recorder;
+
+                test.noteOn (3, 60, MPEValue::from7BitInt (100));
+                test.pressure (3, MPEValue::from7BitInt (20));
+                test.pitchbend (3, MPEValue::from14BitInt (4000));
+                test.timbre (3, MPEValue::from7BitInt (30));
+                test.sustainPedal (1, true);
+
+                expectEquals (recorder.kinds, String());
+                expectEquals (buffered.dispatchPendingNotifications (recorder), 5);
+                expectEquals (recorder.kinds, String ("apbtk"));
+                expectNote (recorder.lastNote, 100, 20, 4000, 30, MPENote::keyDownAndSustained);
+
+                test.noteOff (3, 60, MPEValue::from7BitInt (100));
+                test.sustainPedal (1, false);
+                test.setZoneLayout ({});
+
+                expectEquals (buffered.dispatchPendingNotifications (recorder), 3);
+                expectEquals (recorder.kinds, String ("apbtkkrz"));
+                expectEquals (buffered.dispatchPendingNotifications (recorder), 0);
+                expectEquals (buffered.getNumDroppedNotifications(), 0);
+            }
+
+            {
+                // When the queue fills up, controller updates are dropped before note on/off
+                MPEInstrument test (testLayout);
+                MPEInstrument::BufferedListener buffered (test, 16);
+                RecordingListener recorder;
+
+                test.noteOn (3, 60, MPEValue::from7BitInt (100));
+
+                for (int i = 0; i < 100; ++i)
+                    test.pressure (3, MPEValue::from7BitInt (1 + i % 2));
+
+                test.noteOff (3, 60, MPEValue::from7BitInt (100));
+
+                buffered.dispatchPendingNotifications (recorder);
+                expect (recorder.kinds.startsWith ("ap"));
+                expect (recorder.kinds.endsWith ("pr"));
+                expect (buffered.getNumDroppedNotifications() > 0);
+                expectEquals (recorder.kinds.length() + buffered.getNumDroppedNotifications(), 102);
+            }
+        }
     }
     JUCE_END_IGNORE_WARNINGS_MSVC
 
@@ -52,7 +52,10 @@ namespace juce
 
     The class has a Listener class that can be used to react to note and
     state changes and trigger some functionality for your application.
-    For example, you can use this class to write an MPE visualiser.
+    For example, you can use this class to write an MPE visualiser. Listener
+    callbacks are made on the thread that is feeding MIDI into the instrument,
+    so if that's the audio thread, use a BufferedListener to pass them on to
+    the message thread.
 
     If you want to write a real-time audio synth with MPE functionality,
     you should instead use the classes MPESynthesiserBase, which adds
@@ -327,6 +330,93 @@ public:
     /** Removes a listener. */
     void removeListener (Listener* listenerToRemove);
 
+    //==============================================================================
+    /**
+        A Listener that queues the notifications it receives, so that they can be
+        handled later on another thread.
+
+        Listener callbacks arrive on whichever thread is feeding MIDI into the
+        instrument, which is usually the audio thread. If you want to display the
+        instrument's notes, create a BufferedListener for the instrument and call
+        dispatchPendingNotifications() periodically from the message thread, e.g.
+        in a Timer callback. This keeps the UI from having to query the instrument
+        (and contend for its lock) while the audio thread is processing MIDI.
+
+        Queuing a notification never allocates or blocks. If the queue becomes
+        nearly full, pressure, pitchbend and timbre notifications are dropped
+        first, leaving room for the notifications that add and release notes.
+
+        The BufferedListener registers itself with the instrument when it is
+        created, and unregisters itself when it is destroyed, so the instrument
+        must outlive it.
+    */
+    class JUCE_API  BufferedListener  : public Listener
+    {
+    public:
+        /** Creates a BufferedListener which is able to hold the given number of
+            pending notifications, and registers it with the instrument.
+        */
+        explicit BufferedListener (MPEInstrument& instrument, int capacity = 1024);
+
+        /** Destructor. */
+        ~BufferedListener() override;
+
+        /** Calls the corresponding methods of the given listener for each queued
+            notification, in the order in which they were received, and returns
+            the number of notifications that were dispatched.
+
+            This may be called on any thread, but only one thread at a time.
+        */
+        int dispatchPendingNotifications (Listener& listenerToNotify);
+
+        /** Returns the number of notifications that have been dropped because the
+            queue was full.
+        */
+        int getNumDroppedNotifications() const noexcept     { return numDropped.load(); }
+
+        /** @internal */
+        void noteAdded (MPENote) override;
+        /** @internal */
+        void notePressureChanged (MPENote) override;
+        /** @internal */
+        void notePitchbendChanged (MPENote) override;
+        /** @internal */
+        void noteTimbreChanged (MPENote) override;
+        /** @internal */
+        void noteKeyStateChanged (MPENote) override;
+        /** @internal */
+        void noteReleased (MPENote) override;
+        /** @internal */
+        void zoneLayoutChanged() override;
+
+    private:
+        enum class Kind : uint8
+        {
+            noteAdded,
+            notePressureChanged,
+            notePitchbendChanged,
+            noteTimbreChanged,
+            noteKeyStateChanged,
+            noteReleased,
+            zoneLayoutChanged
+        };
+
+        struct Notification
+        {
+            Kind kind;
+            MPENote note;
+        };
+
+        void push (Kind, MPENote);
+
+        MPEInstrument& owner;
+        AbstractFifo fifo;
+        std::vector<Notification> notifications;
+        std::atomic<int> numDropped { 0 };
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferedListener)
+    };
+
     //==============================================================================
     /** Puts the instrument into legacy mode. If legacy mode is already enabled this method
         does nothing.
@@ -373,13 +463,16 @@ protected:
 
 private:
     //==============================================================================
-    Array<MPENote> notes;
+    static constexpr int numPreallocatedNotes = 64;
+
+    Array<MPENote, DummyCriticalSection, numPreallocatedNotes> notes;
     MPEZoneLayout zoneLayout;
     ListenerList<Listener> listeners;
 
     uint8 lastPressureLowerBitReceivedOnChannel[16];
     uint8 lastTimbreLowerBitReceivedOnChannel[16];
     bool isMemberChannelSustained[16];
+    uint8 numNotesOnChannel[16];
 
     struct LegacyMode
     {
@@ -420,6 +513,10 @@ private:
     void handleTimbreLSB (int midiChannel, int value) noexcept;
     void handleSustainOrSostenuto (int midiChannel, bool isDown, bool isSostenuto);
 
+    bool hasNotesOnChannel (int midiChannel) const noexcept;
+    void addNote (const MPENote&);
+    void removeNote (int index);
+
     const MPENote* getNotePtr (int midiChannel, int midiNoteNumber) const noexcept;
     MPENote* getNotePtr (int midiChannel, int midiNoteNumber) noexcept;
     const MPENote* getNotePtr (int midiChannel, TrackingMode) const noexcept;
@@ -35,14 +35,153 @@
 namespace juce
 {
 
+BufferingAudioSourceScheduler::BufferingAudioSourceScheduler (const String& name, size_t maxMemoryBytes)
+    : Thread (name), memoryLimit (maxMemoryBytes)
+{
+}
+
+BufferingAudioSourceScheduler::~BufferingAudioSourceScheduler()
+{
+    // All the sources using this scheduler must be deleted before it is!
+    jassert (sources.isEmpty());
+
+    stopThread (2000);
+}
+
+int BufferingAudioSourceScheduler::getNumSources() const
+{
+    const ScopedLock sl (sourcesLock);
+    return sources.size();
+}
+
+size_t BufferingAudioSourceScheduler::getMemoryUsed() const
+{
+    const ScopedLock sl (memoryLock);
+    return memoryUsed;
+}
+
+void BufferingAudioSourceScheduler::addSource (BufferingAudioSource* s)
+{
+    {
+        const ScopedLock sl (sourcesLock);
+        sources.addIfNotAlreadyThere (s);
+    }
+
+    notify();
+}
+
+void BufferingAudioSourceScheduler::removeSource (BufferingAudioSource* s)
+{
+    // this waits for any read that's in progress to finish
+    const ScopedLock sl (sourcesLock);
+    sources.removeFirstMatchingValue (s);
+}
+
+BufferingAudioSource* BufferingAudioSourceScheduler::findMostUrgentSource() const
+{
+    BufferingAudioSource* best = nullptr;
+    auto bestSecondsBuffered = std::numeric_limits<double>::max();
+
+    for (auto* s : sources)
+    {
+        const auto state = s->getReadState();
+
+        if (state.isWorthReading && state.secondsBuffered < bestSecondsBuffered)
+        {
+            best = s;
+            bestSecondsBuffered = state.secondsBuffered;
+        }
+    }
+
+    return best;
+}
+
+void BufferingAudioSourceScheduler::run()
+{
+    // A source gets at most this much in one go, so that the others get a look-in
+    constexpr int maxReadSize = 32768;
+
+    while (! threadShouldExit())
+    {
+        {
+            const ScopedLock sl (sourcesLock);
+
+            if (auto* s = findMostUrgentSource())
+            {
+                s->readNextBufferChunk (maxReadSize);
+                continue;
+            }
+        }
+
+        wait (10);
+    }
+}
+
+int BufferingAudioSourceScheduler::allocateBuffer (size_t& bytesAllocated, int numChannels,
+                                                   int numSamplesWanted, int minimumNumSamples)
+{
+    const ScopedLock sl (memoryLock);
+
+    jassert (memoryUsed >= bytesAllocated);
+    memoryUsed -= bytesAllocated;
+
+    const auto bytesPerSample = (size_t) jmax (1, numChannels) * sizeof (float);
+    auto numSamples = numSamplesWanted;
+
+    if (memoryLimit > 0)
+    {
+        const auto bytesAvailable = memoryLimit > memoryUsed ? memoryLimit - memoryUsed : 0;
+        numSamples = (int) jmin ((size_t) numSamplesWanted, bytesAvailable / bytesPerSample);
+        numSamples = jmax (numSamples, jmin (minimumNumSamples, numSamplesWanted));
+    }
+
+    bytesAllocated = (size_t) numSamples * bytesPerSample;
+    memoryUsed += bytesAllocated;
+    return numSamples;
+}
+
+void BufferingAudioSourceScheduler::releaseBuffer (size_t& bytesAllocated)
+{
+    const ScopedLock sl (memoryLock);
+
+    jassert (memoryUsed >= bytesAllocated);
+    memoryUsed -= bytesAllocated;
+    bytesAllocated = 0;
+}
+
+//==============================================================================
 BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* s,
                                             TimeSliceThread& thread,
                                             bool deleteSourceWhenDeleted,
                                             int bufferSizeSamples,
                                             int numChannels,
                                             bool prefillBufferOnPrepareToPlay)
+    : BufferingAudioSource (s, &thread, nullptr, deleteSourceWhenDeleted,
+                            bufferSizeSamples, numChannels, prefillBufferOnPrepareToPlay)
+{
+}
+
+BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* s,
+                                            BufferingAudioSourceScheduler& schedulerToUse,
+                                            bool deleteSourceWhenDeleted,
+                                            int bufferSizeSamples,
+                                            int numChannels,
+                                            bool prefillBufferOnPrepareToPlay)
+    : BufferingAudioSource (s, nullptr, &schedulerToUse, deleteSourceWhenDeleted,
+                            bufferSizeSamples, numChannels, prefillBufferOnPrepareToPlay)
+{
+}
+
+BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* s,
+                                            TimeSliceThread* thread,
+                                            BufferingAudioSourceScheduler* schedulerToUse,
+                                            bool deleteSourceWhenDeleted,
+                                            int bufferSizeSamples,
+                                            int numChannels,
+                                            bool prefillBufferOnPrepareToPlay)
     : source (s, deleteSourceWhenDeleted),
       backgroundThread (thread),
+      scheduler (schedulerToUse),
       numberOfSamplesToBuffer (jmax (1024, bufferSizeSamples)),
       numberOfChannels (numChannels),
       prefillBuffer (prefillBufferOnPrepareToPlay)
@@ -64,31 +203,40 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double ne
     auto bufferSizeNeeded = jmax (samplesPerBlockExpected * 2, numberOfSamplesToBuffer);
 
     if (! approximatelyEqual (newSampleRate, sampleRate)
-         || bufferSizeNeeded != buffer.getNumSamples()
+         || bufferSizeNeeded != bufferSizeRequested
          || ! isPrepared)
     {
-        backgroundThread.removeTimeSliceClient (this);
+        stopReading();
 
         isPrepared = true;
         sampleRate = newSampleRate;
+        bufferSizeRequested = bufferSizeNeeded;
 
         source->prepareToPlay (samplesPerBlockExpected, newSampleRate);
 
+        if (scheduler != nullptr)
+            bufferSizeNeeded = scheduler->allocateBuffer (bytesAllocated, numberOfChannels, bufferSizeNeeded,
+                                                          jmax (samplesPerBlockExpected * 2, 2048));
+
         buffer.setSize (numberOfChannels, bufferSizeNeeded);
         buffer.clear();
 
-        const ScopedLock sl (bufferRangeLock);
+        {
+            const ScopedLock sl (bufferRangeLock);
+
+            bufferValidStart = 0;
+            bufferValidEnd = 0;
+        }
 
-        bufferValidStart = 0;
-        bufferValidEnd = 0;
+        startReading();
 
-        backgroundThread.addTimeSliceClient (this);
+        const ScopedLock sl (bufferRangeLock);
 
         do
         {
             const ScopedUnlock ul (bufferRangeLock);
 
-            backgroundThread.moveToFrontOfQueue (this);
+            prioritiseReading();
             Thread::sleep (5);
         }
         while (prefillBuffer
@@ -99,9 +247,13 @@ void BufferingAudioSource::prepareToPlay (int samplesPerBlockExpected, double ne
 void BufferingAudioSource::releaseResources()
 {
     isPrepared = false;
-    backgroundThread.removeTimeSliceClient (this);
+    stopReading();
 
     buffer.setSize (numberOfChannels, 0);
+    bufferSizeRequested = 0;
+
+    if (scheduler != nullptr)
+        scheduler->releaseBuffer (bytesAllocated);
 
     // MSVC2017 seems to need this if statement to not generate a warning during linking.
     // As source is set in the constructor, there is no way that source could
@@ -114,6 +266,19 @@ void BufferingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info
 {
     const auto bufferRange = getValidBufferRange (info.numSamples);
 
+    if (isPrepared)
+    {
+        // samples before the start of the source are silent anyway, so they don't count
+        const auto numBeforeStart = (int) jlimit ((int64) 0, (int64) info.numSamples, -nextPlayPos.load());
+        const auto numMissed = info.numSamples - numBeforeStart - bufferRange.getLength();
+
+        if (numMissed > 0)
+        {
+            ++numUnderruns;
+            numSamplesMissed += numMissed;
+        }
+    }
+
     if (bufferRange.isEmpty())
     {
         // total cache miss
@@ -227,7 +392,73 @@ void BufferingAudioSource::setNextReadPosition (int64 newPosition)
     const ScopedLock sl (bufferRangeLock);
 
     nextPlayPos = newPosition;
-    backgroundThread.moveToFrontOfQueue (this);
+    prioritiseReading();
+}
+
+BufferingAudioSource::Statistics BufferingAudioSource::getStatistics() const noexcept
+{
+    Statistics stats;
+    stats.numUnderruns = numUnderruns.load();
+    stats.numSamplesMissed = numSamplesMissed.load();
+    return stats;
+}
+
+void BufferingAudioSource::resetStatistics() noexcept
+{
+    numUnderruns = 0;
+    numSamplesMissed = 0;
+}
+
+void BufferingAudioSource::startReading()
+{
+    if (scheduler != nullptr)
+        scheduler->addSource (this);
+    else
+        backgroundThread->addTimeSliceClient (this);
+}
+
+void BufferingAudioSource::stopReading()
+{
+    if (scheduler != nullptr)
+        scheduler->removeSource (this);
+    else
+        backgroundThread->removeTimeSliceClient (this);
+}
+
+void BufferingAudioSource::prioritiseReading()
+{
+    if (scheduler != nullptr)
+        scheduler->notify();
+    else
+        backgroundThread->moveToFrontOfQueue (this);
+}
+
+BufferingAudioSource::ReadState BufferingAudioSource::getReadState() const
+{
+    const ScopedLock sl (bufferRangeLock);
+
+    ReadState state;
+    const auto bufferSize = buffer.getNumSamples();
+
+    if (bufferSize <= 0 || sampleRate <= 0)
+        return state;
+
+    const auto pos = jmax ((int64) 0, nextPlayPos.load());
+
+    if (wasSourceLooping != isLooping() || pos < bufferValidStart || pos >= bufferValidEnd)
+    {
+        // nothing usable in the buffer, so this needs reading straight away
+        state.numSamplesToRead = bufferSize;
+        state.isWorthReading = true;
+        return state;
+    }
+
+    state.secondsBuffered = (double) (bufferValidEnd - pos) / sampleRate;
+    state.numSamplesToRead = (int) (pos + bufferSize - 4 - bufferValidEnd);
+
+    // Waiting until there's a reasonable amount of space lets the source make fewer, larger reads
+    state.isWorthReading = state.numSamplesToRead > jmax (512, bufferSize / 8);
+    return state;
 }
 
 Range<int> BufferingAudioSource::getValidBufferRange (int numSamples) const
@@ -240,7 +471,7 @@ Range<int> BufferingAudioSource::getValidBufferRange (int numSamples) const
              (int) (jlimit (bufferValidStart, bufferValidEnd, pos + numSamples) - pos) };
 }
 
-bool BufferingAudioSource::readNextBufferChunk()
+bool BufferingAudioSource::readNextBufferChunk (int maxChunkSize)
 {
     int64 newBVS, newBVE, sectionToReadStart, sectionToReadEnd;
 
@@ -259,11 +490,10 @@ bool BufferingAudioSource::readNextBufferChunk()
         sectionToReadStart = 0;
         sectionToReadEnd = 0;
 
-        constexpr int maxChunkSize = 2048;
-
         if (newBVS < bufferValidStart || newBVS >= bufferValidEnd)
         {
-            newBVE = jmin (newBVE, newBVS + maxChunkSize);
+            // keep the first read after a jump short, so that playback can resume quickly
+            newBVE = jmin (newBVE, newBVS + jmin (maxChunkSize, 2048));
 
             sectionToReadStart = newBVS;
             sectionToReadEnd = newBVE;
@@ -335,7 +565,151 @@ void BufferingAudioSource::readBufferSection (int64 start, int length, int buffe
 
 int BufferingAudioSource::useTimeSlice()
 {
-    return readNextBufferChunk() ? 1 : 100;
+    return readNextBufferChunk (2048) ? 1 : 100;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct BufferingAudioSourceTests final : public UnitTest
+{
+    BufferingAudioSourceTests()  : UnitTest ("BufferingAudioSource", UnitTestCategories::audio) {}
+
+    void runTest() override
+    {
+        constexpr int blockSize = 512;
+        constexpr int bufferSize = 8192;
+        constexpr double sampleRate = 44100.0;
+
+        beginTest ("Sources read by a scheduler play back correctly");
+        {
+            BufferingAudioSourceScheduler scheduler ("test");
+            scheduler.startThread();
+
+            std::vector<AudioBuffer<float>> sourceData;
+            std::vector<std::unique_ptr<BufferingAudioSource>> sources;
+
+            for (int i = 0; i < 4; ++i)
+                sourceData.push_back (getRamp (3 * bufferSize + i * 1000, (float) i));
+
+            for (auto& data : sourceData)
+                sources.push_back (std::make_unique<BufferingAudioSource> (new MemoryAudioSource (data, false),
+                                                                           scheduler, true, bufferSize, 2));
+
+            for (auto& s : sources)
+                s->prepareToPlay (blockSize, sampleRate);
+
+            expectEquals (scheduler.getNumSources(), 4);
+
+            for (size_t i = 0; i < sources.size(); ++i)
+                expect (playsBack (*sources[i], sourceData[i], 0, blockSize));
+
+            sources[1]->setNextReadPosition (5000);
+            expect (playsBack (*sources[1], sourceData[1], 5000, blockSize));
+
+            for (auto& s : sources)
+                expectEquals (s->getStatistics().numUnderruns, 0);
+
+            sources.clear();
+            expectEquals (scheduler.getNumSources(), 0);
+            expectEquals ((int) scheduler.getMemoryUsed(), 0);
+        }
+
+        beginTest ("The memory limit is shared between sources");
+        {
+            constexpr size_t bytesPerBuffer = bufferSize * 2 * sizeof (float);
+
+            BufferingAudioSourceScheduler scheduler ("test", 2 * bytesPerBuffer);
+            scheduler.startThread();
+
+            auto data = getRamp (3 * bufferSize, 0.0f);
+            std::vector<std::unique_ptr<BufferingAudioSource>> sources;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                sources.push_back (std::make_unique<BufferingAudioSource> (new MemoryAudioSource (data, false),
+                                                                           scheduler, true, bufferSize, 2));
+                sources.back()->prepareToPlay (blockSize, sampleRate);
+            }
+
+            // The third source only gets the minimum amount
+            expectEquals ((int) scheduler.getMemoryUsed(), (int) (2 * bytesPerBuffer + 2048 * 2 * sizeof (float)));
+
+            for (auto& s : sources)
+                expect (playsBack (*s, data, 0, blockSize));
+
+            sources[0]->releaseResources();
+            expectEquals ((int) scheduler.getMemoryUsed(), (int) (bytesPerBuffer + 2048 * 2 * sizeof (float)));
+
+            sources.clear();
+            expectEquals ((int) scheduler.getMemoryUsed(), 0);
+        }
+
+        beginTest ("Underruns are counted");
+        {
+            // This thread is never started, so nothing gets read
+            BufferingAudioSourceScheduler scheduler ("test");
+
+            auto data = getRamp (3 * bufferSize, 0.0f);
+            BufferingAudioSource source (new MemoryAudioSource (data, false), scheduler, true, bufferSize, 2, false);
+            source.prepareToPlay (blockSize, sampleRate);
+
+            AudioBuffer<float> output (2, blockSize);
+            source.getNextAudioBlock (AudioSourceChannelInfo (output));
+            source.getNextAudioBlock (AudioSourceChannelInfo (output));
+
+            expectEquals (source.getStatistics().numUnderruns, 2);
+            expectEquals ((int) source.getStatistics().numSamplesMissed, 2 * blockSize);
+            expectEquals (output.getMagnitude (0, blockSize), 0.0f);
+
+            source.resetStatistics();
+            expectEquals (source.getStatistics().numUnderruns, 0);
+            expectEquals ((int) source.getStatistics().numSamplesMissed, 0);
+
+            // Samples before the start of the source aren't missing
+            source.setNextReadPosition (-blockSize);
+            source.getNextAudioBlock (AudioSourceChannelInfo (output));
+            expectEquals (source.getStatistics().numUnderruns, 0);
+        }
+    }
+
+    static AudioBuffer<float> getRamp (int length, float offset)
+    {
+        AudioBuffer<float> buffer (2, length);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < length; ++i)
+                buffer.setSample (ch, i, offset + (float) (i + ch) / (float) length);
+
+        return buffer;
+    }
+
+    static bool playsBack (BufferingAudioSource& source, const AudioBuffer<float>& expected, int startPos, int blockSize)
+    {
+        AudioBuffer<float> output (2, blockSize);
+
+        for (auto pos = startPos; pos + blockSize <= expected.getNumSamples(); pos += blockSize)
+        {
+            const AudioSourceChannelInfo info (output);
+
+            if (! source.waitForNextAudioBlockReady (info, 5000))
+                return false;
+
+            source.getNextAudioBlock (info);
+
+            for (int ch = 0; ch < output.getNumChannels(); ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    if (! exactlyEqual (output.getSample (ch, i), expected.getSample (ch, pos + i)))
+                        return false;
+        }
+
+        return true;
+    }
+};
+
+static BufferingAudioSourceTests bufferingAudioSourceTests;
+
+#endif
+
 } // namespace juce
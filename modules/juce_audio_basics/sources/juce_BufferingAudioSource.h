@@ -35,6 +35,81 @@
 namespace juce
 {
 
+class BufferingAudioSource;
+
+//==============================================================================
+/**
+    A background thread which reads ahead for a set of BufferingAudioSources.
+
+    A TimeSliceThread gives each of its clients a turn in order, so when a lot of
+    BufferingAudioSources share one, a source that's about to run out of data may
+    have to wait while all the others top up their buffers. This thread instead always
+    reads next for the source that will run out soonest. It also waits until a source
+    has room for a decent-sized chunk before reading for it, so that sources streaming
+    from disk make fewer, larger reads.
+
+    It can also put a limit on the total memory used by the buffers of all its sources.
+    Once that's been reached, sources that are prepared later get smaller buffers.
+
+    Like a TimeSliceThread, you need to call startThread() before it'll do any reading,
+    and it must not be deleted until all the BufferingAudioSources that use it have
+    been deleted.
+
+    @see BufferingAudioSource
+
+    @tags{Audio}
+*/
+class JUCE_API  BufferingAudioSourceScheduler  : public Thread
+{
+public:
+    //==============================================================================
+    /** Creates a scheduler.
+
+        @param threadName       the name of the thread
+        @param maxMemoryBytes   the total number of bytes that the buffers of all the
+                                sources may use, or 0 for no limit
+    */
+    explicit BufferingAudioSourceScheduler (const String& threadName, size_t maxMemoryBytes = 0);
+
+    /** Destructor.
+
+        This stops the thread, but all the sources that use it must already have been
+        deleted.
+    */
+    ~BufferingAudioSourceScheduler() override;
+
+    //==============================================================================
+    /** Returns the number of sources that are currently prepared and being read. */
+    int getNumSources() const;
+
+    /** Returns the total number of bytes used by the buffers of the sources. */
+    size_t getMemoryUsed() const;
+
+    /** Returns the memory limit that was passed to the constructor. */
+    size_t getMemoryLimit() const noexcept          { return memoryLimit; }
+
+    //==============================================================================
+    /** @internal */
+    void run() override;
+
+private:
+    //==============================================================================
+    friend class BufferingAudioSource;
+
+    void addSource (BufferingAudioSource*);
+    void removeSource (BufferingAudioSource*);
+    BufferingAudioSource* findMostUrgentSource() const;
+    int allocateBuffer (size_t& bytesAllocated, int numChannels, int numSamplesWanted, int minimumNumSamples);
+    void releaseBuffer (size_t& bytesAllocated);
+
+    Array<BufferingAudioSource*> sources;
+    CriticalSection sourcesLock, memoryLock;
+    const size_t memoryLimit;
+    size_t memoryUsed = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferingAudioSourceScheduler)
+};
+
 //==============================================================================
 /**
     An AudioSource which takes another source as input, and buffers it using a thread.
@@ -73,6 +148,20 @@ public:
                           int numberOfChannels = 2,
                           bool prefillBufferOnPrepareToPlay = true);
 
+    /** Creates a BufferingAudioSource which is read by a BufferingAudioSourceScheduler.
+
+        This takes the same parameters as the other constructor, but uses a scheduler,
+        which may also limit the size of the buffer, instead of a TimeSliceThread.
+        The scheduler must not be deleted until after any BufferingAudioSources that
+        are using it have been deleted!
+    */
+    BufferingAudioSource (PositionableAudioSource* source,
+                          BufferingAudioSourceScheduler& scheduler,
+                          bool deleteSourceWhenDeleted,
+                          int numberOfSamplesToBuffer,
+                          int numberOfChannels = 2,
+                          bool prefillBufferOnPrepareToPlay = true);
+
     /** Destructor.
 
         The input source may be deleted depending on whether the deleteSourceWhenDeleted
@@ -109,17 +198,54 @@ public:
     */
     bool waitForNextAudioBlockReady (const AudioSourceChannelInfo& info, uint32 timeout);
 
+    //==============================================================================
+    /** Counts the times that the buffer couldn't keep up with playback. */
+    struct Statistics
+    {
+        /** The number of calls to getNextAudioBlock() that couldn't be completely filled. */
+        int numUnderruns = 0;
+
+        /** The total number of samples that had to be replaced with silence. */
+        int64 numSamplesMissed = 0;
+    };
+
+    /** Returns the number of underruns since the source was created, or since
+        resetStatistics() was last called.
+    */
+    Statistics getStatistics() const noexcept;
+
+    /** Resets the underrun counts to zero. */
+    void resetStatistics() noexcept;
+
 private:
     //==============================================================================
+    friend class BufferingAudioSourceScheduler;
+
+    BufferingAudioSource (PositionableAudioSource*, TimeSliceThread*, BufferingAudioSourceScheduler*, bool, int, int, bool);
+
     Range<int> getValidBufferRange (int numSamples) const;
-    bool readNextBufferChunk();
+    bool readNextBufferChunk (int maxChunkSize);
     void readBufferSection (int64 start, int length, int bufferOffset);
     int useTimeSlice() override;
 
+    void startReading();
+    void stopReading();
+    void prioritiseReading();
+
+    struct ReadState
+    {
+        double secondsBuffered = 0;
+        int numSamplesToRead = 0;
+        bool isWorthReading = false;
+    };
+
+    ReadState getReadState() const;
+
     //==============================================================================
     OptionalScopedPointer<PositionableAudioSource> source;
-    TimeSliceThread& backgroundThread;
-    int numberOfSamplesToBuffer, numberOfChannels;
+    TimeSliceThread* backgroundThread;
+    BufferingAudioSourceScheduler* scheduler;
+    int numberOfSamplesToBuffer, numberOfChannels, bufferSizeRequested = 0;
     AudioBuffer<float> buffer;
     CriticalSection callbackLock, bufferRangeLock;
     WaitableEvent bufferReadyEvent;
@@ -128,6 +254,9 @@ private:
     double sampleRate = 0;
     bool wasSourceLooping = false, isPrepared = false;
     const bool prefillBuffer;
+    size_t bytesAllocated = 0;
+    std::atomic<int> numUnderruns { 0 };
+    std::atomic<int64> numSamplesMissed { 0 };
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferingAudioSource)
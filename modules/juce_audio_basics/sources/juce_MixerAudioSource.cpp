@@ -35,6 +35,7 @@
 namespace juce
 {
 
+//==============================================================================
 MixerAudioSource::MixerAudioSource()
    : currentSampleRate (0.0), bufferSizeExpected (0)
 {
@@ -62,10 +63,20 @@ void MixerAudioSource::addInputSource (AudioSource* input, const bool deleteWhen
         if (localRate > 0.0)
             input->prepareToPlay (localBufferSize, localRate);
 
-        const ScopedLock sl (lock);
+        SmoothedValue<float> gain (1.0f);
+
+        if (localRate > 0.0)
+            gain.reset (localRate, gainRampLength);
+
+        {
+            const ScopedLock sl (lock);
+
+            inputsToDelete.setBit (inputs.size(), deleteWhenRemoved);
+            inputs.add (input);
+            inputGains.add (gain);
+        }
 
-        inputsToDelete.setBit (inputs.size(), deleteWhenRemoved);
-        inputs.add (input);
+        reserveTempBuffer();
     }
 }
 
@@ -87,6 +98,7 @@ void MixerAudioSource::removeInputSource (AudioSource* const input)
 
             inputsToDelete.shiftBits (-1, index);
             inputs.remove (index);
+            inputGains.remove (index);
         }
 
         input->releaseResources();
@@ -105,6 +117,8 @@ void MixerAudioSource::removeAllInputs()
                 toDelete.add (inputs.getUnchecked (i));
 
         inputs.clear();
+        inputGains.clear();
+        inputsToDelete.clear();
     }
 
     for (int i = toDelete.size(); --i >= 0;)
@@ -113,15 +127,20 @@ void MixerAudioSource::removeAllInputs()
 
 void MixerAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
 {
-    tempBuffer.setSize (2, samplesPerBlockExpected);
+    {
+        const ScopedLock sl (lock);
 
-    const ScopedLock sl (lock);
+        currentSampleRate = sampleRate;
+        bufferSizeExpected = samplesPerBlockExpected;
+
+        for (int i = inputs.size(); --i >= 0;)
+            inputs.getUnchecked (i)->prepareToPlay (samplesPerBlockExpected, sampleRate);
 
-    currentSampleRate = sampleRate;
-    bufferSizeExpected = samplesPerBlockExpected;
+        for (auto& gain : inputGains)
+            gain.reset (sampleRate, gainRampLength);
+    }
 
-    for (int i = inputs.size(); --i >= 0;)
-        inputs.getUnchecked (i)->prepareToPlay (samplesPerBlockExpected, sampleRate);
+    reserveTempBuffer();
 }
 
 void MixerAudioSource::releaseResources()
@@ -137,34 +156,314 @@ void MixerAudioSource::releaseResources()
     bufferSizeExpected = 0;
 }
 
+//==============================================================================
+void MixerAudioSource::setInputGain (AudioSource* input, float newGain)
+{
+    const ScopedLock sl (lock);
+    const int index = inputs.indexOf (input);
+
+    // This isn't one of the mixer's inputs!
+    jassert (index >= 0);
+
+    if (index >= 0)
+        inputGains.getReference (index).setTargetValue (newGain);
+}
+
+float MixerAudioSource::getInputGain (AudioSource* input) const
+{
+    const ScopedLock sl (lock);
+    const int index = inputs.indexOf (input);
+
+    return index >= 0 ? inputGains.getReference (index).getTargetValue() : 0.0f;
+}
+
+void MixerAudioSource::setGainRampLength (double rampLengthSeconds)
+{
+    const ScopedLock sl (lock);
+    gainRampLength = jmax (0.0, rampLengthSeconds);
+
+    if (currentSampleRate > 0.0)
+        for (auto& gain : inputGains)
+            gain.reset (currentSampleRate, gainRampLength);
+}
+
+void MixerAudioSource::setNumRenderingThreads (int numThreads)
+{
+    std::unique_ptr<detail::RealtimeTaskPool> newThreads;
+
+    if (numThreads > 0)
+        newThreads = std::make_unique<detail::RealtimeTaskPool> (numThreads, "Mixer render thread");
+
+    {
+        const ScopedLock sl (lock);
+        std::swap (renderThreads, newThreads);
+    }
+
+    reserveTempBuffer();
+}
+
+int MixerAudioSource::getNumRenderingThreads() const noexcept
+{
+    const ScopedLock sl (lock);
+    return renderThreads != nullptr ? renderThreads->getNumThreads() : 0;
+}
+
+//==============================================================================
+int MixerAudioSource::getNumTempSlots (int numInputs) const noexcept
+{
+    if (renderThreads != nullptr)
+        return jmax (0, numInputs - 1);
+
+    return jmin (maxInputsPerBatch, numInputs);
+}
+
+// Sizes tempBuffer for the expected block size and the current inputs, so that the
+// audio thread only has to reallocate it if it's given bigger blocks than expected
+void MixerAudioSource::reserveTempBuffer()
+{
+    const ScopedLock sl (lock);
+
+    const auto numChannels = numTempChannelsPerInput * getNumTempSlots (inputs.size());
+
+    if (bufferSizeExpected > 0 && (numChannels > tempBuffer.getNumChannels() || bufferSizeExpected > tempBuffer.getNumSamples()))
+        tempBuffer.setSize (numChannels, bufferSizeExpected, false, false, true);
+}
+
 void MixerAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
     const ScopedLock sl (lock);
 
-    if (inputs.size() > 0)
+    const auto numInputs = inputs.size();
+
+    if (numInputs == 0)
+    {
+        info.clearActiveBufferRegion();
+        return;
+    }
+
+    // The first input is rendered straight into the output, and the others into
+    // slots in tempBuffer, one slot of numTempChannelsPerInput channels per input.
+    numTempChannelsPerInput = jmax (1, info.buffer->getNumChannels());
+
+    tempBuffer.setSize (numTempChannelsPerInput * getNumTempSlots (numInputs), info.numSamples, false, false, true);
+
+    if (renderThreads != nullptr && numInputs > 1)
+    {
+        // Fetched here rather than by each worker, because getArrayOfWritePointers() also
+        // marks the buffer as non-clear, which would be a race between the threads
+        auto* const* tempChannels = tempBuffer.getArrayOfWritePointers();
+
+        auto render = [&] (int index, int) { renderInput (info, tempChannels, index, index - 1); };
+        renderThreads->run (numInputs, render);
+
+        mixInputs (info, 0, numInputs, 1);
+        return;
+    }
+
+    // Rendering a batch of inputs before mixing them means that each part of the
+    // output is only read and written once per batch, rather than once per input.
+    auto* const* tempChannels = tempBuffer.getArrayOfWritePointers();
+
+    for (int first = 0; first < numInputs; first += maxInputsPerBatch)
+    {
+        const auto numInBatch = jmin (maxInputsPerBatch, numInputs - first);
+        const auto firstSlotInput = jmax (1, first);
+
+        for (int i = first; i < first + numInBatch; ++i)
+            renderInput (info, tempChannels, i, i - firstSlotInput);
+
+        mixInputs (info, first, numInBatch, firstSlotInput);
+    }
+}
+
+void MixerAudioSource::renderInput (const AudioSourceChannelInfo& info, float* const* tempChannels, int inputIndex, int slot)
+{
+    if (inputIndex == 0)
     {
         inputs.getUnchecked (0)->getNextAudioBlock (info);
+        return;
+    }
+
+    AudioBuffer<float> slotBuffer (tempChannels + slot * numTempChannelsPerInput,
+                                   numTempChannelsPerInput, info.numSamples);
+
+    inputs.getUnchecked (inputIndex)->getNextAudioBlock (AudioSourceChannelInfo (slotBuffer));
+}
+
+void MixerAudioSource::mixInputs (const AudioSourceChannelInfo& info, int firstInput, int numInputs, int firstSlotInput)
+{
+    // Small enough that this section of the output stays in the L1 cache while all
+    // the inputs are added to it
+    constexpr int samplesPerTile = 256;
+
+    const auto numChannels = info.buffer->getNumChannels();
+    auto* const* outputs = info.buffer->getArrayOfWritePointers();
+    float gainRamp[samplesPerTile];
 
-        if (inputs.size() > 1)
+    for (int start = 0; start < info.numSamples; start += samplesPerTile)
+    {
+        const auto numSamples = jmin (samplesPerTile, info.numSamples - start);
+
+        for (int i = firstInput; i < firstInput + numInputs; ++i)
         {
-            tempBuffer.setSize (jmax (1, info.buffer->getNumChannels()),
-                                info.buffer->getNumSamples());
+            auto& gain = inputGains.getReference (i);
+            const auto isRamping = gain.isSmoothing();
+            const auto targetGain = gain.getTargetValue();
 
-            AudioSourceChannelInfo info2 (&tempBuffer, 0, info.numSamples);
+            if (isRamping)
+                for (int j = 0; j < numSamples; ++j)
+                    gainRamp[j] = gain.getNextValue();
 
-            for (int i = 1; i < inputs.size(); ++i)
+            for (int chan = 0; chan < numChannels; ++chan)
             {
-                inputs.getUnchecked (i)->getNextAudioBlock (info2);
+                auto* out = outputs[chan] + info.startSample + start;
+
+                if (i == 0)
+                {
+                    // the first input is already in the output, so just needs its gain applying
+                    if (isRamping)
+                        FloatVectorOperations::multiply (out, gainRamp, numSamples);
+                    else if (! exactlyEqual (targetGain, 1.0f))
+                        FloatVectorOperations::multiply (out, targetGain, numSamples);
+
+                    continue;
+                }
+
+                const auto* in = tempBuffer.getReadPointer ((i - firstSlotInput) * numTempChannelsPerInput + chan, start);
+
+                if (isRamping)
+                    FloatVectorOperations::addWithMultiply (out, in, gainRamp, numSamples);
+                else if (exactlyEqual (targetGain, 1.0f))
+                    FloatVectorOperations::add (out, in, numSamples);
+                else if (! exactlyEqual (targetGain, 0.0f))
+                    FloatVectorOperations::addWithMultiply (out, in, targetGain, numSamples);
+            }
+        }
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
 
-                for (int chan = 0; chan < info.buffer->getNumChannels(); ++chan)
-                    info.buffer->addFrom (chan, info.startSample, tempBuffer, chan, 0, info.numSamples);
+struct MixerAudioSourceTests final : public UnitTest
+{
+    MixerAudioSourceTests()  : UnitTest ("MixerAudioSource", UnitTestCategories::audio) {}
+
+    // Produces a different, predictable signal for each input
+    struct TestSource final : public AudioSource
+    {
+        explicit TestSource (int indexIn)  : index (indexIn) {}
+
+        void prepareToPlay (int, double) override  { position = 0; }
+        void releaseResources() override {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            for (int i = 0; i < info.numSamples; ++i)
+                for (int ch = 0; ch < info.buffer->getNumChannels(); ++ch)
+                    info.buffer->setSample (ch, info.startSample + i, getSample (index, ch, position + i));
+
+            position += info.numSamples;
+        }
+
+        static float getSample (int sourceIndex, int channel, int64 pos)
+        {
+            return (float) ((sourceIndex * 7 + channel * 3 + pos) % 101) / 100.0f - 0.5f;
+        }
+
+        int index;
+        int64 position = 0;
+    };
+
+    void runTest() override
+    {
+        constexpr int blockSize = 600;
+        constexpr double sampleRate = 1000.0;
+
+        beginTest ("Many inputs are summed with their gains");
+        {
+            for (auto numThreads : { 0, 3 })
+            {
+                MixerAudioSource mixer;
+                mixer.setNumRenderingThreads (numThreads);
+                expectEquals (mixer.getNumRenderingThreads(), numThreads);
+
+                constexpr int numInputs = 40;
+                std::vector<std::unique_ptr<TestSource>> sources;
+
+                for (int i = 0; i < numInputs; ++i)
+                {
+                    sources.push_back (std::make_unique<TestSource> (i));
+                    mixer.addInputSource (sources.back().get(), false);
+                }
+
+                // changes made before the mixer is prepared aren't ramped
+                for (int i = 0; i < numInputs; ++i)
+                    mixer.setInputGain (sources[(size_t) i].get(), (float) (i % 5) * 0.25f);
+
+                mixer.prepareToPlay (blockSize, sampleRate);
+
+                expectEquals (mixer.getInputGain (sources[3].get()), 0.75f);
+
+                AudioBuffer<float> output (2, blockSize + 10);
+                mixer.getNextAudioBlock (AudioSourceChannelInfo (&output, 10, blockSize));
+
+                expect (matches (output, 10, blockSize, [&] (int ch, int pos)
+                {
+                    float sum = 0;
+
+                    for (int i = 0; i < numInputs; ++i)
+                        sum += (float) (i % 5) * 0.25f * TestSource::getSample (i, ch, pos);
+
+                    return sum;
+                }));
+
+                mixer.removeAllInputs();
             }
         }
+
+        beginTest ("Gain changes are ramped");
+        {
+            MixerAudioSource mixer;
+            TestSource first (0), second (1);
+            mixer.addInputSource (&first, false);
+            mixer.addInputSource (&second, false);
+            mixer.setGainRampLength (0.1);
+            mixer.prepareToPlay (blockSize, sampleRate);
+
+            mixer.setInputGain (&first, 0.0f);
+            mixer.setInputGain (&second, 2.0f);
+
+            AudioBuffer<float> output (2, blockSize);
+            mixer.getNextAudioBlock (AudioSourceChannelInfo (output));
+
+            // 0.1 seconds is 100 samples at this sample rate
+            expect (matches (output, 0, blockSize, [] (int ch, int pos)
+            {
+                const auto ramp = (float) jmin (pos + 1, 100) / 100.0f;
+                return (1.0f - ramp) * TestSource::getSample (0, ch, pos)
+                         + (1.0f + ramp) * TestSource::getSample (1, ch, pos);
+            }));
+
+            mixer.removeAllInputs();
+        }
     }
-    else
+
+    template <typename Fn>
+    bool matches (const AudioBuffer<float>& buffer, int startSample, int numSamples, Fn&& getExpected)
     {
-        info.clearActiveBufferRegion();
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                if (std::abs (buffer.getSample (ch, startSample + i) - getExpected (ch, i)) > 1.0e-4f)
+                    return false;
+
+        return true;
     }
-}
+};
+
+static MixerAudioSourceTests mixerAudioSourceTests;
+
+#endif
 
 } // namespace juce
@@ -43,6 +43,11 @@ namespace juce
     prepareToPlay() and releaseResources() methods are called before and after adding
     them to the mixer.
 
+    Each input has a gain, and changes to it are ramped smoothly. The inputs are summed
+    a short section at a time, so that the part of the output being mixed stays in the
+    cache however many inputs there are. If the inputs don't share any state, they can
+    also be rendered in parallel - see setNumRenderingThreads().
+
     @tags{Audio}
 */
 class JUCE_API  MixerAudioSource  : public AudioSource
@@ -81,6 +86,35 @@ public:
     */
     void removeAllInputs();
 
+    //==============================================================================
+    /** Sets the gain that is applied to one of the inputs.
+
+        The change is ramped over the time set by setGainRampLength(). The input must
+        already have been added to the mixer.
+    */
+    void setInputGain (AudioSource* input, float newGain);
+
+    /** Returns the gain of one of the inputs, or 0 if it isn't one of the mixer's inputs. */
+    float getInputGain (AudioSource* input) const;
+
+    /** Sets the length of the ramps used when changing an input's gain. The default is 50ms. */
+    void setGainRampLength (double rampLengthSeconds);
+
+    //==============================================================================
+    /** Sets the number of extra threads that are used to render the inputs.
+
+        If this is more than 0, the inputs' getNextAudioBlock() methods will be called
+        in parallel on these threads and the audio thread, so you should only do this
+        if none of the inputs share any state. The threads are started as realtime threads
+        where the system allows it, and at the highest priority otherwise.
+
+        Note that this creates or deletes threads, so don't call it on the audio thread!
+    */
+    void setNumRenderingThreads (int numThreads);
+
+    /** Returns the number of extra threads used to render the inputs. */
+    int getNumRenderingThreads() const noexcept;
+
     //==============================================================================
     /** Implementation of the AudioSource method.
         This will call prepareToPlay() on all its input sources.
@@ -98,12 +132,22 @@ public:
 
 private:
     //==============================================================================
+    void renderInput (const AudioSourceChannelInfo&, float* const* tempChannels, int inputIndex, int slot);
+    void mixInputs (const AudioSourceChannelInfo&, int firstInput, int numInputs, int firstSlotInput);
+    int getNumTempSlots (int numInputs) const noexcept;
+    void reserveTempBuffer();
+
+    static constexpr int maxInputsPerBatch = 16;
+
     Array<AudioSource*> inputs;
+    Array<SmoothedValue<float>> inputGains;
     BigInteger inputsToDelete;
     CriticalSection lock;
     AudioBuffer<float> tempBuffer;
+    std::unique_ptr<detail::RealtimeTaskPool> renderThreads;
     double currentSampleRate;
-    int bufferSizeExpected;
+    double gainRampLength = 0.05;
+    int bufferSizeExpected, numTempChannelsPerInput = 2;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MixerAudioSource)
 };
@@ -105,6 +105,7 @@ SynthesiserVoice* Synthesiser::getVoice (const int index) const
 void Synthesiser::clearVoices()
 {
     const ScopedLock sl (lock);
+    voiceIndexIsValid = false;
     voices.clear();
 }
 
@@ -129,6 +130,7 @@ SynthesiserVoice* Synthesiser::addVoice (SynthesiserVoice* const newVoice)
 void Synthesiser::removeVoice (const int index)
 {
     const ScopedLock sl (lock);
+    voiceIndexIsValid = false;
     voices.remove (index);
 }
 
@@ -162,6 +164,12 @@ void Synthesiser::setMinimumRenderingSubdivisionSize (int numSamples, bool shoul
     subBlockSubdivisionIsStrict = shouldBeStrict;
 }
 
+void Synthesiser::setEventScheduledRenderingEnabled (bool shouldBeEnabled) noexcept
+{
+    const ScopedLock sl (lock);
+    eventScheduledRendering = shouldBeEnabled;
+}
+
 //==============================================================================
 void Synthesiser::setCurrentPlaybackSampleRate (const double newRate)
 {
@@ -192,6 +200,18 @@ void Synthesiser::processNextBlock (AudioBuffer<floatType>& outputAudio,
 
     const ScopedLock sl (lock);
 
+    // The voices can only be modified by this thread while we hold the lock, so for the
+    // duration of the block, note-on and note-off events can use an index to find the
+    // voices playing a particular note rather than checking every voice.
+    rebuildVoiceIndex();
+    const ScopeGuard invalidateIndex { [this] { voiceIndexIsValid = false; } };
+
+    if (eventScheduledRendering)
+    {
+        processNextBlockWithScheduledEvents (outputAudio, midiData, startSample, numSamples);
+        return;
+    }
+
     for (; numSamples > 0; ++midiIterator)
     {
         if (midiIterator == midiData.cend())
@@ -239,6 +259,159 @@ void Synthesiser::processNextBlock (AudioBuffer<floatType>& outputAudio,
 template void Synthesiser::processNextBlock<float>  (AudioBuffer<float>&,  const MidiBuffer&, int, int);
 template void Synthesiser::processNextBlock<double> (AudioBuffer<double>&, const MidiBuffer&, int, int);
 
+static void setScheduledOutput (AudioBuffer<float>& buffer, AudioBuffer<float>*& floatOutput, AudioBuffer<double>*&)
+{
+    floatOutput = &buffer;
+}
+
+static void setScheduledOutput (AudioBuffer<double>& buffer, AudioBuffer<float>*&, AudioBuffer<double>*& doubleOutput)
+{
+    doubleOutput = &buffer;
+}
+
+template <typename floatType>
+void Synthesiser::processNextBlockWithScheduledEvents (AudioBuffer<floatType>& outputAudio,
+                                                       const MidiBuffer& midiData,
+                                                       int startSample,
+                                                       int numSamples)
+{
+    const auto endSample = startSample + numSamples;
+
+    if (outputAudio.getNumChannels() > 0)
+        setScheduledOutput (outputAudio, scheduledFloatOutput, scheduledDoubleOutput);
+
+    const ScopeGuard clearOutput { [this]
+    {
+        scheduledFloatOutput = nullptr;
+        scheduledDoubleOutput = nullptr;
+    } };
+
+    scheduledBlockStart = startSample;
+
+    for (auto* voice : voices)
+        voice->renderedUpToSample = startSample;
+
+    // Each event brings the voices it affects up to date before changing them, so the
+    // other voices can carry on without being split
+    std::for_each (midiData.findNextSamplePosition (startSample),
+                   midiData.cend(),
+                   [&] (const MidiMessageMetadata& meta)
+                   {
+                       scheduledEventPosition = jmin (meta.samplePosition, endSample);
+                       handleMidiEvent (meta.getMessage());
+                   });
+
+    if (outputAudio.getNumChannels() > 0)
+        for (auto* voice : voices)
+            renderVoiceUpTo (*voice, outputAudio, endSample, true);
+}
+
+template <typename floatType>
+void Synthesiser::renderVoiceUpTo (SynthesiserVoice& voice, AudioBuffer<floatType>& outputAudio, int endSample, bool isEndOfBlock)
+{
+    const auto start = jmax (voice.renderedUpToSample, scheduledBlockStart);
+    const auto numSamples = endSample - start;
+
+    if (numSamples <= 0)
+        return;
+
+    if (! isEndOfBlock)
+    {
+        const auto smallBlockAllowed = start == scheduledBlockStart && ! subBlockSubdivisionIsStrict;
+
+        // If the event is too close to the last one, it'll take effect a little early
+        if (numSamples < (smallBlockAllowed ? 1 : minimumSubBlockSize))
+            return;
+    }
+
+    voice.renderNextBlock (outputAudio, start, numSamples);
+    voice.renderedUpToSample = endSample;
+}
+
+void Synthesiser::renderVoiceUpToCurrentEvent (SynthesiserVoice& voice)
+{
+    if (scheduledFloatOutput != nullptr)
+        renderVoiceUpTo (voice, *scheduledFloatOutput, scheduledEventPosition, false);
+    else if (scheduledDoubleOutput != nullptr)
+        renderVoiceUpTo (voice, *scheduledDoubleOutput, scheduledEventPosition, false);
+}
+
+//==============================================================================
+void Synthesiser::rebuildVoiceIndex()
+{
+    std::fill (std::begin (firstVoiceForNote), std::end (firstVoiceForNote), nullptr);
+
+    for (auto* voice : voices)
+    {
+        voice->indexedNote = -1;
+        voice->nextVoiceWithSameNote = nullptr;
+    }
+
+    voiceIndexIsValid = true;
+
+    for (auto* voice : voices)
+        addVoiceToIndex (*voice);
+}
+
+void Synthesiser::addVoiceToIndex (SynthesiserVoice& voice)
+{
+    if (! voiceIndexIsValid)
+        return;
+
+    removeVoiceFromIndex (voice);
+
+    const auto note = voice.getCurrentlyPlayingNote();
+
+    if (isPositiveAndBelow (note, numElementsInArray (firstVoiceForNote)))
+    {
+        voice.nextVoiceWithSameNote = std::exchange (firstVoiceForNote[note], &voice);
+        voice.indexedNote = note;
+    }
+}
+
+void Synthesiser::removeVoiceFromIndex (SynthesiserVoice& voice)
+{
+    if (voice.indexedNote < 0)
+        return;
+
+    for (auto** v = &firstVoiceForNote[voice.indexedNote]; *v != nullptr; v = &(*v)->nextVoiceWithSameNote)
+    {
+        if (*v == &voice)
+        {
+            *v = voice.nextVoiceWithSameNote;
+            break;
+        }
+    }
+
+    voice.nextVoiceWithSameNote = nullptr;
+    voice.indexedNote = -1;
+}
+
+template <typename Callback>
+void Synthesiser::forEachVoicePlayingNote (int midiNoteNumber, Callback&& callback)
+{
+    if (voiceIndexIsValid && isPositiveAndBelow (midiNoteNumber, numElementsInArray (firstVoiceForNote)))
+    {
+        // Voices that have finished stay in the index until they're restarted, so each entry
+        // still needs checking
+        for (auto* voice = firstVoiceForNote[midiNoteNumber]; voice != nullptr;)
+        {
+            auto* next = voice->nextVoiceWithSameNote;
+
+            if (voice->getCurrentlyPlayingNote() == midiNoteNumber)
+                callback (*voice);
+
+            voice = next;
+        }
+
+        return;
+    }
+
+    for (auto* voice : voices)
+        if (voice->getCurrentlyPlayingNote() == midiNoteNumber)
+            callback (*voice);
+}
+
 void Synthesiser::renderNextBlock (AudioBuffer<float>& outputAudio, const MidiBuffer& inputMidi,
                                    int startSample, int numSamples)
 {
@@ -316,9 +489,11 @@ void Synthesiser::noteOn (const int midiChannel,
         {
             // If hitting a note that's still ringing, stop it first (it could be
             // still playing because of the sustain or sostenuto pedal).
-            for (auto* voice : voices)
-                if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel (midiChannel))
-                    stopVoice (voice, 1.0f, true);
+            forEachVoicePlayingNote (midiNoteNumber, [&] (SynthesiserVoice& voice)
+            {
+                if (voice.isPlayingChannel (midiChannel))
+                    stopVoice (&voice, 1.0f, true);
+            });
 
             startVoice (findFreeVoice (sound, midiChannel, midiNoteNumber, shouldStealNotes),
                         sound, midiChannel, midiNoteNumber, velocity);
@@ -334,6 +509,8 @@ void Synthesiser::startVoice (SynthesiserVoice* const voice,
 {
     if (voice != nullptr && sound != nullptr)
     {
+        renderVoiceUpToCurrentEvent (*voice);
+
         if (voice->currentlyPlayingSound != nullptr)
             voice->stopNote (0.0f, false);
 
@@ -344,6 +521,7 @@ void Synthesiser::startVoice (SynthesiserVoice* const voice,
         voice->setKeyDown (true);
         voice->setSostenutoPedalDown (false);
         voice->setSustainPedalDown (sustainPedalsDown[midiChannel]);
+        addVoiceToIndex (*voice);
 
         voice->startNote (midiNoteNumber, velocity, sound,
                           lastPitchWheelValues [midiChannel - 1]);
@@ -354,6 +532,7 @@ void Synthesiser::stopVoice (SynthesiserVoice* voice, float velocity, const bool
 {
     jassert (voice != nullptr);
 
+    renderVoiceUpToCurrentEvent (*voice);
     voice->stopNote (velocity, allowTailOff);
 
     // the subclass MUST call clearCurrentNote() if it's not tailing off! RTFM for stopNote()!
@@ -367,26 +546,25 @@ void Synthesiser::noteOff (const int midiChannel,
 {
     const ScopedLock sl (lock);
 
-    for (auto* voice : voices)
+    forEachVoicePlayingNote (midiNoteNumber, [&] (SynthesiserVoice& voice)
     {
-        if (voice->getCurrentlyPlayingNote() == midiNoteNumber
-              && voice->isPlayingChannel (midiChannel))
+        if (! voice.isPlayingChannel (midiChannel))
+            return;
+
+        if (auto sound = voice.getCurrentlyPlayingSound())
         {
-            if (auto sound = voice->getCurrentlyPlayingSound())
+            if (sound->appliesToNote (midiNoteNumber)
+                 && sound->appliesToChannel (midiChannel))
             {
-                if (sound->appliesToNote (midiNoteNumber)
-                     && sound->appliesToChannel (midiChannel))
-                {
-                    jassert (! voice->keyIsDown || voice->isSustainPedalDown() == sustainPedalsDown [midiChannel]);
+                jassert (! voice.keyIsDown || voice.isSustainPedalDown() == sustainPedalsDown [midiChannel]);
 
-                    voice->setKeyDown (false);
+                voice.setKeyDown (false);
 
-                    if (! (voice->isSustainPedalDown() || voice->isSostenutoPedalDown()))
-                        stopVoice (voice, velocity, allowTailOff);
-                }
+                if (! (voice.isSustainPedalDown() || voice.isSostenutoPedalDown()))
+                    stopVoice (&voice, velocity, allowTailOff);
             }
         }
-    }
+    });
 }
 
 void Synthesiser::allNotesOff (const int midiChannel, const bool allowTailOff)
@@ -394,8 +572,13 @@ void Synthesiser::allNotesOff (const int midiChannel, const bool allowTailOff)
     const ScopedLock sl (lock);
 
     for (auto* voice : voices)
+    {
         if (midiChannel <= 0 || voice->isPlayingChannel (midiChannel))
+        {
+            renderVoiceUpToCurrentEvent (*voice);
             voice->stopNote (1.0f, allowTailOff);
+        }
+    }
 
     sustainPedalsDown.clear();
 }
@@ -405,8 +588,13 @@ void Synthesiser::handlePitchWheel (const int midiChannel, const int wheelValue)
     const ScopedLock sl (lock);
 
     for (auto* voice : voices)
+    {
         if (midiChannel <= 0 || voice->isPlayingChannel (midiChannel))
+        {
+            renderVoiceUpToCurrentEvent (*voice);
             voice->pitchWheelMoved (wheelValue);
+        }
+    }
 }
 
 void Synthesiser::handleController (const int midiChannel,
@@ -424,18 +612,27 @@ void Synthesiser::handleController (const int midiChannel,
     const ScopedLock sl (lock);
 
     for (auto* voice : voices)
+    {
         if (midiChannel <= 0 || voice->isPlayingChannel (midiChannel))
+        {
+            renderVoiceUpToCurrentEvent (*voice);
             voice->controllerMoved (controllerNumber, controllerValue);
+        }
+    }
 }
 
 void Synthesiser::handleAftertouch (int midiChannel, int midiNoteNumber, int aftertouchValue)
 {
     const ScopedLock sl (lock);
 
-    for (auto* voice : voices)
-        if (voice->getCurrentlyPlayingNote() == midiNoteNumber
-              && (midiChannel <= 0 || voice->isPlayingChannel (midiChannel)))
-            voice->aftertouchChanged (aftertouchValue);
+    forEachVoicePlayingNote (midiNoteNumber, [&] (SynthesiserVoice& voice)
+    {
+        if (midiChannel <= 0 || voice.isPlayingChannel (midiChannel))
+        {
+            renderVoiceUpToCurrentEvent (voice);
+            voice.aftertouchChanged (aftertouchValue);
+        }
+    });
 }
 
 void Synthesiser::handleChannelPressure (int midiChannel, int channelPressureValue)
@@ -443,8 +640,13 @@ void Synthesiser::handleChannelPressure (int midiChannel, int channelPressureVal
     const ScopedLock sl (lock);
 
     for (auto* voice : voices)
+    {
         if (midiChannel <= 0 || voice->isPlayingChannel (midiChannel))
+        {
+            renderVoiceUpToCurrentEvent (*voice);
             voice->channelPressureChanged (channelPressureValue);
+        }
+    }
 }
 
 void Synthesiser::handleSustainPedal (int midiChannel, bool isDown)
@@ -608,4 +810,220 @@ SynthesiserVoice* Synthesiser::findVoiceToSteal (SynthesiserSound* soundToPlay,
     return low;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class SynthesiserTests final : public UnitTest
+{
+public:
+    SynthesiserTests()
+        : UnitTest ("Synthesiser", UnitTestCategories::audio) {}
+
+    void runTest() override
+    {
+        beginTest ("Event-scheduled rendering produces the same output as splitting blocks at every event");
+        {
+            auto random = getRandom();
+
+            std::vector<MidiBuffer> blocks;
+
+            for (int block = 0; block < 20; ++block)
+            {
+                auto& midi = blocks.emplace_back();
+
+                for (int i = 0; i < 100; ++i)
+                {
+                    const auto channel = 1 + random.nextInt (3);
+                    const auto note = 60 + random.nextInt (12);
+                    const auto position = random.nextInt (blockSize);
+
+                    switch (random.nextInt (5))
+                    {
+                        case 0:  midi.addEvent (MidiMessage::noteOn (channel, note, (uint8) 100), position); break;
+                        case 1:  midi.addEvent (MidiMessage::noteOff (channel, note), position); break;
+                        case 2:  midi.addEvent (MidiMessage::pitchWheel (channel, random.nextInt (0x4000)), position); break;
+                        case 3:  midi.addEvent (MidiMessage::controllerEvent (channel, 1, random.nextInt (128)), position); break;
+                        default: midi.addEvent (MidiMessage::controllerEvent (channel, 64, random.nextBool() ? 127 : 0), position); break;
+                    }
+                }
+            }
+
+            const auto render = [&] (bool scheduled)
+            {
+                TestSynthesiser synth (8);
+                synth.setMinimumRenderingSubdivisionSize (1);
+                synth.setEventScheduledRenderingEnabled (scheduled);
+
+                AudioBuffer<float> output (1, blockSize * (int) blocks.size());
+                output.clear();
+
+                for (const auto [index, midi] : enumerate (blocks, int{}))
+                {
+                    AudioBuffer<float> slice (output.getArrayOfWritePointers(), 1, index * blockSize, blockSize);
+                    synth.renderNextBlock (slice, midi, 0, blockSize);
+                }
+
+                return output;
+            };
+
+            const auto splitOutput = render (false);
+            const auto scheduledOutput = render (true);
+
+            expect (std::equal (splitOutput.getReadPointer (0),
+                                splitOutput.getReadPointer (0) + splitOutput.getNumSamples(),
+                                scheduledOutput.getReadPointer (0)));
+        }
+
+        beginTest ("Event-scheduled rendering only splits voices that receive events");
+        {
+            for (const auto scheduled : { false, true })
+            {
+                TestSynthesiser synth (4);
+                synth.setMinimumRenderingSubdivisionSize (1);
+                synth.setEventScheduledRenderingEnabled (scheduled);
+
+                AudioBuffer<float> output (1, blockSize);
+
+                MidiBuffer noteOns;
+
+                for (int channel = 1; channel <= 4; ++channel)
+                    noteOns.addEvent (MidiMessage::noteOn (channel, 60, (uint8) 100), 0);
+
+                synth.renderNextBlock (output, noteOns, 0, blockSize);
+
+                MidiBuffer pitchWheels;
+
+                for (int i = 8; i < blockSize; i += 8)
+                    pitchWheels.addEvent (MidiMessage::pitchWheel (1, i), i);
+
+                for (auto* voice : synth.getTestVoices())
+                    voice->numRenderCalls = 0;
+
+                synth.renderNextBlock (output, pitchWheels, 0, blockSize);
+
+                for (auto* voice : synth.getTestVoices())
+                {
+                    const auto expectedCalls = (scheduled && voice->getCurrentlyPlayingNote() >= 0 && ! voice->isPlayingChannel (1))
+                                             ? 1
+                                             : blockSize / 8;
+                    expectEquals (voice->numRenderCalls, expectedCalls);
+                }
+            }
+        }
+
+        beginTest ("Note-offs reach every voice playing the note");
+        {
+            for (const auto scheduled : { false, true })
+            {
+                TestSynthesiser synth (4);
+                synth.setEventScheduledRenderingEnabled (scheduled);
+
+                AudioBuffer<float> output (1, blockSize);
+                MidiBuffer midi;
+
+                midi.addEvent (MidiMessage::controllerEvent (1, 64, 127), 0);
+                midi.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 0);
+                midi.addEvent (MidiMessage::noteOn (2, 60, (uint8) 100), 10);
+                midi.addEvent (MidiMessage::noteOn (1, 62, (uint8) 100), 20);
+                midi.addEvent (MidiMessage::noteOff (1, 60), 30);
+                midi.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 40);
+                synth.renderNextBlock (output, midi, 0, blockSize);
+
+                // The retriggered note replaces the sustained one on the same channel
+                expectEquals (synth.getNumVoicesPlaying (60), 2);
+
+                midi.clear();
+                midi.addEvent (MidiMessage::noteOff (1, 60), 0);
+                midi.addEvent (MidiMessage::noteOff (2, 60), 0);
+                midi.addEvent (MidiMessage::controllerEvent (1, 64, 0), 10);
+                synth.renderNextBlock (output, midi, 0, blockSize);
+
+                expectEquals (synth.getNumVoicesPlaying (60), 0);
+                expectEquals (synth.getNumVoicesPlaying (62), 1);
+
+                synth.noteOff (1, 62, 1.0f, false);
+                expectEquals (synth.getNumVoicesPlaying (62), 0);
+            }
+        }
+    }
+
+private:
+    static constexpr int blockSize = 256;
+
+    struct TestSound final : public SynthesiserSound
+    {
+        bool appliesToNote (int) override       { return true; }
+        bool appliesToChannel (int) override    { return true; }
+    };
+
+    // Adds a value that depends on the voice's note and controller state, so
+    // that any change in the timing of events is visible in the output
+    struct TestVoice final : public SynthesiserVoice
+    {
+        bool canPlaySound (SynthesiserSound*) override  { return true; }
+
+        void startNote (int midiNoteNumber, float, SynthesiserSound*, int pitchWheel) override
+        {
+            level = midiNoteNumber;
+            wheel = pitchWheel;
+        }
+
+        void stopNote (float, bool) override                { clearCurrentNote(); }
+        void pitchWheelMoved (int newValue) override        { wheel = newValue; }
+        void controllerMoved (int, int newValue) override   { controller = newValue; }
+
+        void renderNextBlock (AudioBuffer<float>& buffer, int startSample, int numSamples) override
+        {
+            ++numRenderCalls;
+
+            if (! isVoiceActive())
+                return;
+
+            const auto value = (float) (level + (wheel >> 7) + controller);
+
+            for (int i = startSample; i < startSample + numSamples; ++i)
+                buffer.addSample (0, i, value);
+        }
+
+        using SynthesiserVoice::renderNextBlock;
+
+        int level = 0, wheel = 0, controller = 0, numRenderCalls = 0;
+    };
+
+    struct TestSynthesiser final : public Synthesiser
+    {
+        explicit TestSynthesiser (int numVoices)
+        {
+            for (int i = 0; i < numVoices; ++i)
+                addVoice (new TestVoice());
+
+            addSound (new TestSound());
+            setCurrentPlaybackSampleRate (44100.0);
+        }
+
+        std::vector<TestVoice*> getTestVoices() const
+        {
+            std::vector<TestVoice*> result;
+
+            for (auto* voice : voices)
+                result.push_back (static_cast<TestVoice*> (voice));
+
+            return result;
+        }
+
+        int getNumVoicesPlaying (int midiNoteNumber) const
+        {
+            return (int) std::count_if (voices.begin(), voices.end(), [&] (auto* voice)
+            {
+                return voice->getCurrentlyPlayingNote() == midiNoteNumber;
+            });
+        }
+    };
+};
+
+static SynthesiserTests synthesiserTests;
+
+#endif
+
 } // namespace juce
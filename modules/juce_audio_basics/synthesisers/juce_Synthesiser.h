@@ -286,6 +286,9 @@ private:
 
     AudioBuffer<float> tempBuffer;
 
+    SynthesiserVoice* nextVoiceWithSameNote = nullptr;
+    int indexedNote = -1, renderedUpToSample = 0;
+
     JUCE_LEAK_DETECTOR (SynthesiserVoice)
 };
 
@@ -569,6 +572,37 @@ public:
     */
     void setMinimumRenderingSubdivisionSize (int numSamples, bool shouldBeStrict = false) noexcept;
 
+    /** Enables or disables event-scheduled rendering.
+
+        By default, renderNextBlock() splits the audio block at each midi event, and
+        renders all of the voices for each of the resulting sub-blocks. With dense midi
+        input, every voice ends up rendering lots of tiny blocks, even though most of the
+        events don't affect it.
+
+        When event-scheduled rendering is enabled, a voice is only split at the events
+        that are actually delivered to it: before the synthesiser passes an event to a
+        voice, it renders that voice up to the event's sample position. Voices that aren't
+        affected by an event carry on rendering in large blocks, and events still take
+        effect at their sample positions (within the limit set by
+        setMinimumRenderingSubdivisionSize()).
+
+        In this mode, renderVoices() isn't used, and the voices' renderNextBlock() methods
+        are called directly. Events are scheduled when they reach a voice through the
+        Synthesiser's own methods, such as noteOn(), noteOff() and handlePitchWheel(), so
+        if you override these and call the voices yourself, those calls may take effect
+        earlier than the event's sample position. Voice allocation sees each voice as it was
+        when it was last rendered, so a voice that finishes its tail-off part-way through a
+        block may not be reused until it's next rendered.
+
+        This is disabled by default.
+    */
+    void setEventScheduledRenderingEnabled (bool shouldBeEnabled) noexcept;
+
+    /** Returns true if event-scheduled rendering is enabled.
+        @see setEventScheduledRenderingEnabled
+    */
+    bool isEventScheduledRenderingEnabled() const noexcept          { return eventScheduledRendering; }
+
 protected:
     //==============================================================================
     /** This is used to control access to the rendering callback and the note trigger methods. */
@@ -638,13 +672,36 @@ private:
     int minimumSubBlockSize = 32;
     bool subBlockSubdivisionIsStrict = false;
     bool shouldStealNotes = true;
+    bool eventScheduledRendering = false;
     BigInteger sustainPedalsDown;
     mutable CriticalSection stealLock;
     mutable Array<SynthesiserVoice*> usableVoicesToStealArray;
 
+    SynthesiserVoice* firstVoiceForNote[128] = {};
+    bool voiceIndexIsValid = false;
+
+    AudioBuffer<float>* scheduledFloatOutput = nullptr;
+    AudioBuffer<double>* scheduledDoubleOutput = nullptr;
+    int scheduledBlockStart = 0, scheduledEventPosition = 0;
+
     template <typename floatType>
     void processNextBlock (AudioBuffer<floatType>&, const MidiBuffer&, int startSample, int numSamples);
 
+    template <typename floatType>
+    void processNextBlockWithScheduledEvents (AudioBuffer<floatType>&, const MidiBuffer&, int startSample, int numSamples);
+
+    template <typename floatType>
+    void renderVoiceUpTo (SynthesiserVoice&, AudioBuffer<floatType>&, int endSample, bool isEndOfBlock);
+
+    void renderVoiceUpToCurrentEvent (SynthesiserVoice&);
+
+    void rebuildVoiceIndex();
+    void addVoiceToIndex (SynthesiserVoice&);
+    void removeVoiceFromIndex (SynthesiserVoice&);
+
+    template <typename Callback>
+    void forEachVoicePlayingNote (int midiNoteNumber, Callback&&);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Synthesiser)
 };
 
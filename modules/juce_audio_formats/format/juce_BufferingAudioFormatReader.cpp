@@ -35,11 +35,300 @@
 namespace juce
 {
 
+//==============================================================================
+class BufferingAudioReaderCache::Pimpl
+{
+public:
+    Pimpl (size_t maxBytes, int numThreads)
+        : memoryLimit (maxBytes)
+    {
+        for (int i = 0; i < jmax (1, numThreads); ++i)
+        {
+            workers.add (new Worker (*this));
+            workers.getLast()->startThread (Thread::Priority::high);
+        }
+    }
+
+    ~Pimpl()
+    {
+        for (auto* w : workers)
+            w->signalThreadShouldExit();
+
+        for (int i = 0; i < workers.size(); ++i)
+            workAvailable.signal();
+
+        workers.clear();
+
+        // All the readers using this cache must be deleted before it is!
+        jassert (readers.empty());
+    }
+
+    void addReader (BufferingAudioReader& reader)
+    {
+        const ScopedLock sl (lock);
+        readers[&reader];
+    }
+
+    void removeReader (BufferingAudioReader& reader)
+    {
+        for (;;)
+        {
+            {
+                const ScopedLock sl (lock);
+                auto found = readers.find (&reader);
+
+                if (found == readers.end())
+                    return;
+
+                // if a worker is reading from this reader, wait for it to finish
+                if (! found->second.isBeingRead)
+                {
+                    memoryUsed -= found->second.blocks.size() * getBlockSize (*found->first);
+
+                    readers.erase (found);
+                    return;
+                }
+            }
+
+            Thread::yield();
+        }
+    }
+
+    std::shared_ptr<BufferingAudioReader::BufferedBlock> getBlock (const BufferingAudioReader& reader, int64 blockIndex)
+    {
+        const ScopedLock sl (lock);
+        auto found = readers.find (&reader);
+
+        if (found != readers.end())
+        {
+            auto& blocks = found->second.blocks;
+            auto block = blocks.find (blockIndex);
+
+            if (block != blocks.end())
+            {
+                block->second.lastUsed = ++useCounter;
+                return block->second.block;
+            }
+        }
+
+        return {};
+    }
+
+    void notifyWorkers()
+    {
+        workAvailable.signal();
+    }
+
+    int getNumBlocks() const
+    {
+        const ScopedLock sl (lock);
+        size_t num = 0;
+
+        for (auto& r : readers)
+            num += r.second.blocks.size();
+
+        return (int) num;
+    }
+
+    size_t getMemoryUsed() const
+    {
+        const ScopedLock sl (lock);
+        return memoryUsed;
+    }
+
+private:
+    //==============================================================================
+    using Block = BufferingAudioReader::BufferedBlock;
+
+    struct CachedBlock
+    {
+        std::shared_ptr<Block> block;
+        uint64 lastUsed = 0;
+    };
+
+    struct ReaderState
+    {
+        std::map<int64, CachedBlock> blocks;
+        bool isBeingRead = false;
+    };
+
+    struct Worker final : public Thread
+    {
+        explicit Worker (Pimpl& p)  : Thread ("BufferingAudioReaderCache"), owner (p) {}
+        ~Worker() override          { stopThread (4000); }
+
+        void run() override
+        {
+            while (! threadShouldExit())
+                if (! owner.readNextBlock())
+                    owner.workAvailable.wait (100);
+        }
+
+        Pimpl& owner;
+    };
+
+    //==============================================================================
+    static constexpr int samplesPerBlock = BufferingAudioReader::samplesPerBlock;
+
+    static size_t getBlockSize (const BufferingAudioReader& reader) noexcept
+    {
+        return (size_t) reader.numChannels * (size_t) samplesPerBlock * sizeof (float);
+    }
+
+    static int64 getCurrentBlockIndex (const BufferingAudioReader& reader) noexcept
+    {
+        return jmax ((int64) 0, reader.nextReadPosition.load()) / samplesPerBlock;
+    }
+
+    // The blocks that a reader wants, in order of urgency: the current one, then the
+    // ones ahead of it, then the one behind it.
+    static int getNumWantedBlocks (const BufferingAudioReader& reader) noexcept
+    {
+        return reader.numBlocks + 1;
+    }
+
+    static bool getWantedBlock (const BufferingAudioReader& reader, int urgency, int64& blockIndex) noexcept
+    {
+        const auto current = getCurrentBlockIndex (reader);
+        blockIndex = urgency < reader.numBlocks ? current + urgency : current - 1;
+
+        return blockIndex >= 0 && blockIndex * samplesPerBlock < reader.lengthInSamples;
+    }
+
+    static bool isWanted (const BufferingAudioReader& reader, int64 blockIndex) noexcept
+    {
+        const auto current = getCurrentBlockIndex (reader);
+        return blockIndex >= current - 1 && blockIndex < current + reader.numBlocks;
+    }
+
+    bool readNextBlock()
+    {
+        const BufferingAudioReader* reader = nullptr;
+        ReaderState* state = nullptr;
+        int64 blockIndex = 0;
+
+        {
+            const ScopedLock sl (lock);
+            auto bestUrgency = std::numeric_limits<int>::max();
+
+            for (auto& r : readers)
+            {
+                if (r.second.isBeingRead)
+                    continue;
+
+                const auto numWanted = jmin (bestUrgency, getNumWantedBlocks (*r.first));
+
+                for (int urgency = 0; urgency < numWanted; ++urgency)
+                {
+                    int64 index;
+
+                    if (getWantedBlock (*r.first, urgency, index) && r.second.blocks.count (index) == 0)
+                    {
+                        reader = r.first;
+                        state = &r.second;
+                        blockIndex = index;
+                        bestUrgency = urgency;
+                        break;
+                    }
+                }
+            }
+
+            if (reader == nullptr || ! makeRoom (getBlockSize (*reader), bestUrgency == 0))
+                return false;
+
+            // reserve the space now, so that other threads can't also claim it
+            memoryUsed += getBlockSize (*reader);
+            state->isBeingRead = true;
+        }
+
+        // there may be more work to do, so wake another thread to look for it
+        workAvailable.signal();
+
+        auto block = std::make_shared<Block> (*reader->source, blockIndex * samplesPerBlock, samplesPerBlock);
+
+        const ScopedLock sl (lock);
+        state->isBeingRead = false;
+        state->blocks[blockIndex] = { std::move (block), ++useCounter };
+        return true;
+    }
+
+    // If a reader is waiting for a block, anything can be evicted to make room for it.
+    // Otherwise, only blocks that their readers no longer need can be evicted.
+    bool makeRoom (size_t bytesNeeded, bool isUrgent)
+    {
+        while (memoryLimit > 0 && memoryUsed + bytesNeeded > memoryLimit)
+        {
+            const BufferingAudioReader* victimReader = nullptr;
+            ReaderState* victimState = nullptr;
+            std::map<int64, CachedBlock>::iterator victim;
+
+            for (auto& r : readers)
+            {
+                for (auto it = r.second.blocks.begin(); it != r.second.blocks.end(); ++it)
+                {
+                    if ((isUrgent || ! isWanted (*r.first, it->first))
+                         && (victimState == nullptr || it->second.lastUsed < victim->second.lastUsed))
+                    {
+                        victimReader = r.first;
+                        victimState = &r.second;
+                        victim = it;
+                    }
+                }
+            }
+
+            if (victimState == nullptr)
+                return isUrgent;
+
+            memoryUsed -= getBlockSize (*victimReader);
+            victimState->blocks.erase (victim);
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    CriticalSection lock;
+    std::map<const BufferingAudioReader*, ReaderState> readers;
+    const size_t memoryLimit;
+    size_t memoryUsed = 0;
+    uint64 useCounter = 0;
+    WaitableEvent workAvailable;
+    OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+BufferingAudioReaderCache::BufferingAudioReaderCache (size_t maxMemoryBytes, int numThreads)
+    : pimpl (std::make_unique<Pimpl> (maxMemoryBytes, numThreads))
+{
+}
+
+BufferingAudioReaderCache::~BufferingAudioReaderCache() = default;
+
+int BufferingAudioReaderCache::getNumBlocks() const        { return pimpl->getNumBlocks(); }
+size_t BufferingAudioReaderCache::getMemoryUsed() const    { return pimpl->getMemoryUsed(); }
+
+//==============================================================================
 BufferingAudioReader::BufferingAudioReader (AudioFormatReader* sourceReader,
                                             TimeSliceThread& timeSliceThread,
                                             int samplesToBuffer)
+    : BufferingAudioReader (sourceReader, &timeSliceThread, nullptr, samplesToBuffer)
+{
+}
+
+BufferingAudioReader::BufferingAudioReader (AudioFormatReader* sourceReader,
+                                            BufferingAudioReaderCache& cacheToUse,
+                                            int samplesToBuffer)
+    : BufferingAudioReader (sourceReader, nullptr, &cacheToUse, samplesToBuffer)
+{
+}
+
+BufferingAudioReader::BufferingAudioReader (AudioFormatReader* sourceReader,
+                                            TimeSliceThread* timeSliceThread,
+                                            BufferingAudioReaderCache* cacheToUse,
+                                            int samplesToBuffer)
     : AudioFormatReader (nullptr, sourceReader->getFormatName()),
-      source (sourceReader), thread (timeSliceThread),
+      source (sourceReader), thread (timeSliceThread), cache (cacheToUse),
       numBlocks (1 + (samplesToBuffer / samplesPerBlock))
 {
     sampleRate            = source->sampleRate;
@@ -49,12 +338,18 @@ BufferingAudioReader::BufferingAudioReader (AudioFormatReader* sourceReader,
     bitsPerSample         = 32;
     usesFloatingPointData = true;
 
-    timeSliceThread.addTimeSliceClient (this);
+    if (cache != nullptr)
+        cache->pimpl->addReader (*this);
+    else
+        thread->addTimeSliceClient (this);
 }
 
 BufferingAudioReader::~BufferingAudioReader()
 {
-    thread.removeTimeSliceClient (this);
+    if (cache != nullptr)
+        cache->pimpl->removeReader (*this);
+    else
+        thread->removeTimeSliceClient (this);
 }
 
 void BufferingAudioReader::setReadTimeout (int timeoutMilliseconds) noexcept
@@ -62,6 +357,18 @@ void BufferingAudioReader::setReadTimeout (int timeoutMilliseconds) noexcept
     timeoutMs = timeoutMilliseconds;
 }
 
+BufferingAudioReader::Statistics BufferingAudioReader::getStatistics() const
+{
+    const ScopedLock sl (statisticsLock);
+    return statistics;
+}
+
+void BufferingAudioReader::resetStatistics()
+{
+    const ScopedLock sl (statisticsLock);
+    statistics = {};
+}
+
 bool BufferingAudioReader::readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
                                         int64 startSampleInFile, int numSamples)
 {
@@ -72,12 +379,48 @@ bool BufferingAudioReader::readSamples (int* const* destSamples, int numDestChan
     const ScopedLock sl (lock);
     nextReadPosition = startSampleInFile;
 
+    if (cache != nullptr)
+        cache->pimpl->notifyWorkers();
+
     bool allSamplesRead = true;
+    double waitStartTime = 0;
+
+    // When using a cache, this keeps the block alive even if the cache throws it away
+    std::shared_ptr<BufferedBlock> cachedBlock;
+
+    auto findBlock = [&]() -> const BufferedBlock*
+    {
+        if (cache == nullptr)
+            return getBlockContaining (startSampleInFile);
+
+        cachedBlock = cache->pimpl->getBlock (*this, startSampleInFile / samplesPerBlock);
+        return cachedBlock.get();
+    };
+
+    auto updateStatistics = [&]
+    {
+        const ScopedLock ssl (statisticsLock);
+
+        if (waitStartTime > 0)
+        {
+            const auto waitTime = Time::getMillisecondCounterHiRes() - waitStartTime;
+            ++statistics.numMisses;
+            statistics.totalWaitTimeMs += waitTime;
+            statistics.maxWaitTimeMs = jmax (statistics.maxWaitTimeMs, waitTime);
+            waitStartTime = 0;
+        }
+        else
+        {
+            ++statistics.numHits;
+        }
+    };
 
     while (numSamples > 0)
     {
-        if (auto block = getBlockContaining (startSampleInFile))
+        if (auto block = findBlock())
         {
+            updateStatistics();
+
             auto offset = (int) (startSampleInFile - block->range.getStart());
             auto numToDo = jmin (numSamples, (int) (block->range.getEnd() - startSampleInFile));
 
@@ -102,12 +445,21 @@ bool BufferingAudioReader::readSamples (int* const* destSamples, int numDestChan
         }
         else
         {
+            if (waitStartTime <= 0)
+            {
+                waitStartTime = Time::getMillisecondCounterHiRes();
+
+                if (cache != nullptr)
+                    cache->pimpl->notifyWorkers();
+            }
+
             if (timeoutMs >= 0 && Time::getMillisecondCounter() >= startTime + (uint32) timeoutMs)
             {
                 for (int j = 0; j < numDestChannels; ++j)
                     if (auto* dest = (float*) destSamples[j])
                         FloatVectorOperations::clear (dest + startOffsetInDestBuffer, numSamples);
 
+                updateStatistics();
                 allSamplesRead = false;
                 break;
             }
@@ -296,6 +648,8 @@ public:
 
             read (reader, destination);
             expect (isSilent (destination));
+            expectEquals ((int) reader.getStatistics().numHits, 0);
+            expectEquals ((int) reader.getStatistics().numMisses, 1);
 
             blockingReader->unblock.signal();
         }
@@ -321,6 +675,86 @@ public:
                 expect (source == destination);
             }
         }
+
+        beginTest ("Readers sharing a cache should produce the same samples as their sources");
+        {
+            Random random { getRandom() };
+            BufferingAudioReaderCache cache (0, 3);
+
+            std::vector<AudioBuffer<float>> sources;
+            std::vector<std::unique_ptr<BufferingAudioReader>> readers;
+            sources.reserve (3);
+
+            for (auto size : { 1000, 100000, 200000 })
+            {
+                sources.push_back (generateTestBuffer (random, size));
+                readers.push_back (std::make_unique<BufferingAudioReader> (new TestAudioFormatReader (&sources.back()), cache, 65536));
+                readers.back()->setReadTimeout (-1);
+            }
+
+            for (size_t i = 0; i < readers.size(); ++i)
+            {
+                AudioBuffer<float> destination (2, sources[i].getNumSamples());
+                read (*readers[i], destination);
+                expect (sources[i] == destination);
+            }
+
+            // Read blocks from random positions, as when scrubbing
+            for (int i = 0; i < 50; ++i)
+            {
+                const auto index = (size_t) random.nextInt ((int) readers.size());
+                const auto& source = sources[index];
+                const auto numSamples = jmin (source.getNumSamples(), 1 + random.nextInt (5000));
+                const auto start = random.nextInt (source.getNumSamples() - numSamples + 1);
+
+                AudioBuffer<float> destination (2, numSamples);
+                expect (readers[index]->read (&destination, 0, numSamples, start, true, true));
+
+                for (int ch = 0; ch < 2; ++ch)
+                    expect (std::equal (destination.getReadPointer (ch), destination.getReadPointer (ch) + numSamples,
+                                        source.getReadPointer (ch, start)));
+            }
+
+            // Having read everything once, going back to the start should hit the cache
+            readers[2]->resetStatistics();
+            AudioBuffer<float> destination (2, 1024);
+            readers[2]->read (&destination, 0, 1024, 0, true, true);
+            expectEquals ((int) readers[2]->getStatistics().numHits, 1);
+            expectEquals ((int) readers[2]->getStatistics().numMisses, 0);
+
+            readers.clear();
+            expectEquals (cache.getNumBlocks(), 0);
+            expectEquals ((int) cache.getMemoryUsed(), 0);
+        }
+
+        beginTest ("A cache's memory limit is shared between its readers");
+        {
+            Random random { getRandom() };
+            constexpr size_t blockSize = 2 * 32768 * sizeof (float);
+            BufferingAudioReaderCache cache (4 * blockSize, 2);
+
+            std::vector<AudioBuffer<float>> sources;
+            std::vector<std::unique_ptr<BufferingAudioReader>> readers;
+            sources.reserve (3);
+
+            for (int i = 0; i < 3; ++i)
+            {
+                sources.push_back (generateTestBuffer (random, 300000));
+                readers.push_back (std::make_unique<BufferingAudioReader> (new TestAudioFormatReader (&sources.back()), cache, 100000));
+                readers.back()->setReadTimeout (-1);
+            }
+
+            for (size_t i = 0; i < readers.size(); ++i)
+            {
+                AudioBuffer<float> destination (2, sources[i].getNumSamples());
+                read (*readers[i], destination);
+                expect (sources[i] == destination);
+                expect (cache.getMemoryUsed() <= 4 * blockSize);
+            }
+
+            readers.clear();
+            expectEquals ((int) cache.getMemoryUsed(), 0);
+        }
     }
 
 private:
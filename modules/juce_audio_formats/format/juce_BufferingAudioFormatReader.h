@@ -35,12 +35,19 @@
 namespace juce
 {
 
+class BufferingAudioReaderCache;
+
 //==============================================================================
 /**
     An AudioFormatReader that uses a background thread to pre-read data from
     another reader.
 
-    @see AudioFormatReader
+    The reader can either use a TimeSliceThread, in which case it keeps just the
+    blocks around the current read position, or a BufferingAudioReaderCache, which
+    keeps blocks that many readers have used recently and reads them on a pool of
+    threads.
+
+    @see AudioFormatReader, BufferingAudioReaderCache
 
     @tags{Audio}
 */
@@ -62,6 +69,21 @@ public:
                           TimeSliceThread& timeSliceThread,
                           int samplesToBuffer);
 
+    /** Creates a reader which keeps its blocks in a BufferingAudioReaderCache.
+
+        @param sourceReader     the source reader to wrap. This BufferingAudioReader
+                                takes ownership of this object and will delete it later
+                                when no longer needed
+        @param cache            the cache to use. This must not be deleted while the
+                                reader object still exists.
+        @param samplesToBuffer  the number of samples to read ahead of the current
+                                position. The block before the current position is
+                                also kept, so that small jumps backwards are quick.
+    */
+    BufferingAudioReader (AudioFormatReader* sourceReader,
+                          BufferingAudioReaderCache& cache,
+                          int samplesToBuffer);
+
     ~BufferingAudioReader() override;
 
     /** Sets a number of milliseconds that the reader can block for in its readSamples()
@@ -71,11 +93,41 @@ public:
     */
     void setReadTimeout (int timeoutMilliseconds) noexcept;
 
+    //==============================================================================
+    /** Describes how well the background reading has been keeping up with readSamples(). */
+    struct Statistics
+    {
+        /** The number of blocks that were ready when readSamples() needed them. */
+        int64 numHits = 0;
+
+        /** The number of blocks that readSamples() had to wait for, or gave up on. */
+        int64 numMisses = 0;
+
+        /** The total time that readSamples() has spent waiting for blocks. */
+        double totalWaitTimeMs = 0;
+
+        /** The longest time that readSamples() has waited for a single block. */
+        double maxWaitTimeMs = 0;
+
+        /** Returns the proportion of blocks that were ready, from 0 to 1. */
+        double getHitRate() const noexcept      { return numHits + numMisses > 0 ? (double) numHits / (double) (numHits + numMisses) : 1.0; }
+    };
+
+    /** Returns the statistics gathered since the reader was created, or since
+        resetStatistics() was last called.
+    */
+    Statistics getStatistics() const;
+
+    /** Resets the statistics. */
+    void resetStatistics();
+
     //==============================================================================
     bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       int64 startSampleInFile, int numSamples) override;
 
 private:
+    friend class BufferingAudioReaderCache;
+
     struct BufferedBlock
     {
         BufferedBlock (AudioFormatReader& reader, int64 pos, int numSamples);
@@ -85,6 +137,8 @@ private:
         bool allSamplesRead = false;
     };
 
+    BufferingAudioReader (AudioFormatReader*, TimeSliceThread*, BufferingAudioReaderCache*, int);
+
     int useTimeSlice() override;
     BufferedBlock* getBlockContaining (int64 pos) const noexcept;
     bool readNextBufferChunk();
@@ -92,15 +146,70 @@ private:
     static constexpr int samplesPerBlock = 32768;
 
     std::unique_ptr<AudioFormatReader> source;
-    TimeSliceThread& thread;
+    TimeSliceThread* thread;
+    BufferingAudioReaderCache* cache;
     std::atomic<int64> nextReadPosition { 0 };
     const int numBlocks;
     int timeoutMs = 0;
 
+    CriticalSection statisticsLock;
+    Statistics statistics;
+
     CriticalSection lock;
     OwnedArray<BufferedBlock> blocks;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferingAudioReader)
 };
 
+//==============================================================================
+/**
+    A cache of audio blocks shared by a set of BufferingAudioReaders.
+
+    Each reader asks for the blocks just ahead of (and just behind) its current read
+    position to be pre-read, and a pool of threads reads them, starting with the block
+    that's needed most urgently. Different readers can be read in parallel, but each
+    reader is only read by one thread at a time, because AudioFormatReaders aren't
+    thread-safe.
+
+    Once the cache's memory limit is reached, the least recently used blocks that
+    aren't near any reader's current position are thrown away to make room. That means
+    that when jumping around in a set of files, recently-visited parts of them are
+    often still ready to play.
+
+    The cache must not be deleted until all the readers using it have been deleted.
+
+    @see BufferingAudioReader
+
+    @tags{Audio}
+*/
+class JUCE_API  BufferingAudioReaderCache
+{
+public:
+    /** Creates a cache.
+
+        @param maxMemoryBytes   the total size of the blocks that may be kept, or 0
+                                for no limit
+        @param numThreads       the number of threads to use for reading
+    */
+    explicit BufferingAudioReaderCache (size_t maxMemoryBytes, int numThreads = 2);
+
+    /** Destructor. */
+    ~BufferingAudioReaderCache();
+
+    /** Returns the number of blocks in the cache. */
+    int getNumBlocks() const;
+
+    /** Returns the number of bytes used by the blocks in the cache. */
+    size_t getMemoryUsed() const;
+
+private:
+    //==============================================================================
+    friend class BufferingAudioReader;
+
+    class Pimpl;
+    std::unique_ptr<Pimpl> pimpl;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferingAudioReaderCache)
+};
+
 } // namespace juce
@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::detail
+{
+
+/*  Runs batches of tasks on a fixed set of worker threads, with the calling thread also
+    taking part, and waits for each batch to finish. Running a batch doesn't allocate, so
+    it can be used to split up the work done in an audio callback.
+
+    The workers are started as realtime threads wherever the system allows it, so that
+    the caller isn't left waiting on a worker that has been preempted by other work.
+*/
+class RealtimeTaskPool
+{
+public:
+    RealtimeTaskPool (int numThreads, const String& threadName)
+    {
+        for (auto i = 0; i < numThreads; ++i)
+        {
+            auto& worker = *workers.emplace_back (std::make_unique<Worker> (*this, threadName, i + 1));
+
+            if (! worker.startRealtimeThread ({}))
+                worker.startThread (Thread::Priority::highest);
+        }
+    }
+
+    ~RealtimeTaskPool()
+    {
+        for (auto& worker : workers)
+            worker->stopThread (-1);
+    }
+
+    int getNumThreads() const noexcept      { return (int) workers.size(); }
+
+    /*  Calls fn (taskIndex, threadIndex) for each taskIndex below numTasks, and returns once
+        they've all been done. The threadIndex is 0 for the calling thread and runs from 1 to
+        getNumThreads() for the workers, so it can be used to pick per-thread scratch state.
+    */
+    template <typename Fn>
+    void run (int numTasks, Fn& fn)
+    {
+        const auto numWorkersToWake = jmin (getNumThreads(), numTasks - 1);
+
+        if (numWorkersToWake <= 0)
+        {
+            for (auto i = 0; i < numTasks; ++i)
+                fn (i, 0);
+
+            return;
+        }
+
+        task = [] (void* context, int taskIndex, int threadIndex) { (*static_cast<Fn*> (context)) (taskIndex, threadIndex); };
+        taskContext = &fn;
+        totalTasks = numTasks;
+        numWorkersRunning = numWorkersToWake;
+        nextTask = 0;
+
+        for (auto i = 0; i < numWorkersToWake; ++i)
+            workers[(size_t) i]->notify();
+
+        runAvailableTasks (0);
+
+        // All the woken workers must be finished before the next batch can be started
+        workersFinished.wait (-1);
+    }
+
+private:
+    struct Worker final : public Thread
+    {
+        Worker (RealtimeTaskPool& p, const String& name, int index)
+            : Thread (name), pool (p), threadIndex (index) {}
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                wait (-1);
+
+                if (threadShouldExit())
+                    return;
+
+                pool.runAvailableTasks (threadIndex);
+
+                if (--pool.numWorkersRunning == 0)
+                    pool.workersFinished.signal();
+            }
+        }
+
+        RealtimeTaskPool& pool;
+        const int threadIndex;
+    };
+
+    void runAvailableTasks (int threadIndex)
+    {
+        for (auto index = nextTask++; index < totalTasks; index = nextTask++)
+            task (taskContext, index, threadIndex);
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    WaitableEvent workersFinished;
+
+    void (*task) (void*, int, int) = nullptr;
+    void* taskContext = nullptr;
+    int totalTasks = 0;
+    std::atomic<int> nextTask { 0 };
+    std::atomic<int> numWorkersRunning { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeTaskPool)
+};
+
+} // namespace juce::detail
@@ -141,6 +141,7 @@
 #include "files/juce_FileSearchPath.cpp"
 #include "files/juce_TemporaryFile.cpp"
 #include "logging/juce_FileLogger.cpp"
+#include "logging/juce_AsyncFileLogger.cpp"
 #include "logging/juce_Logger.cpp"
 #include "maths/juce_BigInteger.cpp"
 #include "maths/juce_Expression.cpp"
@@ -294,6 +295,7 @@
  #include "misc/juce_EnumHelpers_test.cpp"
  #include "containers/juce_FixedSizeFunction_test.cpp"
  #include "json/juce_JSONSerialisation_test.cpp"
+ #include "serialisation/juce_BinarySerialisation_test.cpp"
  #include "memory/juce_SharedResourcePointer_test.cpp"
  #include "text/juce_CharPointer_UTF8_test.cpp"
  #include "text/juce_CharPointer_UTF16_test.cpp"
@@ -327,9 +327,11 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "files/juce_WildcardFileFilter.h"
 #include "streams/juce_FileInputSource.h"
 #include "logging/juce_FileLogger.h"
+#include "logging/juce_AsyncFileLogger.h"
 #include "json/juce_JSONUtils.h"
 #include "serialisation/juce_Serialisation.h"
 #include "json/juce_JSONSerialisation.h"
+#include "serialisation/juce_BinarySerialisation.h"
 #include "maths/juce_BigInteger.h"
 #include "maths/juce_Expression.h"
 #include "maths/juce_Random.h"
@@ -372,6 +374,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "misc/juce_OptionsHelpers.h"
 
 #include "detail/juce_CallbackListenerList.h"
+#include "detail/juce_RealtimeTaskPool.h"
 
 #if JUCE_CORE_INCLUDE_OBJC_HELPERS && (JUCE_MAC || JUCE_IOS)
  #include "native/juce_CFHelpers_mac.h"
@@ -0,0 +1,395 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+static File getAsyncLoggerBackupFile (const File& logFile, int index)
+{
+    return logFile.getSiblingFile (logFile.getFileNameWithoutExtension()
+                                     + "." + String (index)
+                                     + logFile.getFileExtension());
+}
+
+//==============================================================================
+class AsyncFileLogger::Writer final : private Thread
+{
+public:
+    Writer (const File& f, const Options& o)
+        : Thread ("AsyncFileLogger"),
+          file (f),
+          options (o),
+          capacity ((size_t) nextPowerOfTwo (jmax (2, o.getQueueSize()))),
+          slots (std::make_unique<Slot[]> (capacity))
+    {
+        for (size_t i = 0; i < capacity; ++i)
+            slots[i].sequence.store (i, std::memory_order_relaxed);
+
+        startThread (Priority::low);
+    }
+
+    ~Writer() override
+    {
+        stopThread (-1);
+        writePendingMessages();
+    }
+
+    //==============================================================================
+    // This is a bounded multiple-producer queue in which each slot carries a sequence
+    // number that tells producers and the consumer whether it's free or full. Pushing
+    // a message just bumps its String's reference count, so it never allocates.
+    bool push (const String& message) noexcept
+    {
+        auto pos = enqueuePos.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            auto& slot = slots[pos & (capacity - 1)];
+            const auto seq = slot.sequence.load (std::memory_order_acquire);
+            const auto diff = (std::ptrdiff_t) (seq - pos);
+
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.message = message;
+                    slot.sequence.store (pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                numDropped.fetch_add (1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos.load (std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void writePendingMessages()
+    {
+        const ScopedLock sl (writeLock);
+
+        if (stream == nullptr)
+            openStream();
+
+        rotateIfNeeded();
+
+        auto numWritten = 0;
+
+        for (String message; pop (message); ++numWritten)
+            write (message);
+
+        const auto dropped = numDropped.load (std::memory_order_relaxed);
+
+        if (dropped != numDroppedReported)
+        {
+            write ("(" + String (dropped - numDroppedReported) + " log messages were discarded)");
+            numDroppedReported = dropped;
+            ++numWritten;
+        }
+
+        if (numWritten > 0 && stream != nullptr)
+            stream->flush();
+    }
+
+    int64 getNumDroppedMessages() const noexcept
+    {
+        return numDropped.load (std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence { 0 };
+        String message;
+    };
+
+    // Only called by whoever holds the writeLock
+    bool pop (String& result)
+    {
+        auto& slot = slots[dequeuePos & (capacity - 1)];
+
+        if (slot.sequence.load (std::memory_order_acquire) != dequeuePos + 1)
+            return false;
+
+        result = std::move (slot.message);
+        slot.message = {};
+        slot.sequence.store (dequeuePos + capacity, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+    void write (const String& message)
+    {
+        if (stream == nullptr)
+            return;
+
+        *stream << message << newLine;
+        rotateIfNeeded();
+    }
+
+    void openStream()
+    {
+        stream = std::make_unique<FileOutputStream> (file, 1 << 16);
+
+        if (stream->failedToOpen())
+            stream.reset();
+    }
+
+    void rotateIfNeeded()
+    {
+        if (stream == nullptr || options.getMaxFileSize() <= 0 || stream->getPosition() < options.getMaxFileSize())
+            return;
+
+        stream.reset();
+
+        if (const auto numBackups = options.getMaxNumBackupFiles(); numBackups > 0)
+        {
+            getAsyncLoggerBackupFile (file, numBackups).deleteFile();
+
+            for (int i = numBackups - 1; i > 0; --i)
+            {
+                const auto backup = getAsyncLoggerBackupFile (file, i);
+
+                if (backup.existsAsFile())
+                    backup.moveFileTo (getAsyncLoggerBackupFile (file, i + 1));
+            }
+
+            if (! file.moveFileTo (getAsyncLoggerBackupFile (file, 1)))
+                file.deleteFile();
+        }
+        else
+        {
+            file.deleteFile();
+        }
+
+        openStream();
+    }
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            wait (options.getFlushIntervalMs());
+            writePendingMessages();
+        }
+    }
+
+    //==============================================================================
+    const File file;
+    const Options options;
+    const size_t capacity;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<size_t> enqueuePos { 0 };
+    std::atomic<int64> numDropped { 0 };
+
+    CriticalSection writeLock;
+    std::unique_ptr<FileOutputStream> stream;
+    size_t dequeuePos = 0;
+    int64 numDroppedReported = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (Writer)
+};
+
+//==============================================================================
+AsyncFileLogger::AsyncFileLogger (const File& file, const String& welcomeMessage)
+    : AsyncFileLogger (file, welcomeMessage, Options{})
+{
+}
+
+AsyncFileLogger::AsyncFileLogger (const File& file, const String& welcomeMessage, const Options& options)
+    : logFile (file)
+{
+    if (! file.exists())
+        file.create();  // (to create the parent directories)
+
+    writer = std::make_unique<Writer> (logFile, options);
+
+    String welcome;
+    welcome << newLine
+            << "**********************************************************" << newLine
+            << welcomeMessage << newLine
+            << "Log started: " << Time::getCurrentTime().toString (true, true) << newLine;
+
+    AsyncFileLogger::logMessage (welcome);
+}
+
+AsyncFileLogger::~AsyncFileLogger() = default;
+
+File AsyncFileLogger::getBackupFile (int index) const
+{
+    return getAsyncLoggerBackupFile (logFile, index);
+}
+
+void AsyncFileLogger::flush()
+{
+    writer->writePendingMessages();
+}
+
+int64 AsyncFileLogger::getNumDroppedMessages() const noexcept
+{
+    return writer->getNumDroppedMessages();
+}
+
+void AsyncFileLogger::logMessage (const String& message)
+{
+    writer->push (message);
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AsyncFileLoggerTests final : public UnitTest
+{
+public:
+    AsyncFileLoggerTests()
+        : UnitTest ("AsyncFileLogger", UnitTestCategories::files)
+    {}
+
+    void runTest() override
+    {
+        const auto folder = File::getSpecialLocation (File::tempDirectory)
+                                .getNonexistentChildFile ("AsyncFileLoggerTests", {}, false);
+        const auto logFile = folder.getChildFile ("log.txt");
+
+        beginTest ("Messages logged from several threads are all written in order");
+        {
+            constexpr int numThreads = 4, numMessages = 1000;
+
+            {
+                AsyncFileLogger logger (logFile, "welcome", AsyncFileLogger::Options{}.withQueueSize (numThreads * numMessages + 1));
+
+                std::vector<std::thread> threads;
+
+                for (int t = 0; t < numThreads; ++t)
+                    threads.emplace_back ([&logger, t]
+                    {
+                        for (int i = 0; i < numMessages; ++i)
+                            logger.logMessage (String (t) + ":" + String (i));
+                    });
+
+                for (auto& thread : threads)
+                    thread.join();
+
+                expectEquals (logger.getNumDroppedMessages(), (int64) 0);
+            }
+
+            StringArray lines;
+            logFile.readLines (lines);
+
+            std::vector<int> nextExpected ((size_t) numThreads, 0);
+            auto allInOrder = true;
+
+            for (const auto& line : lines)
+            {
+                const auto thread = line.upToFirstOccurrenceOf (":", false, false);
+
+                if (! line.containsChar (':') || ! thread.containsOnly ("0123456789"))
+                    continue;
+
+                auto& expected = nextExpected[(size_t) thread.getIntValue()];
+                allInOrder = allInOrder && line.fromFirstOccurrenceOf (":", false, false).getIntValue() == expected;
+                ++expected;
+            }
+
+            expect (allInOrder);
+
+            for (auto n : nextExpected)
+                expectEquals (n, numMessages);
+
+            expect (lines.contains ("welcome"));
+            logFile.deleteFile();
+        }
+
+        beginTest ("Messages are discarded rather than blocking when the queue is full");
+        {
+            AsyncFileLogger logger (logFile, "welcome", AsyncFileLogger::Options{}.withQueueSize (4)
+                                                                                 .withFlushIntervalMs (100000));
+
+            for (int i = 0; i < 10; ++i)
+                logger.logMessage ("message " + String (i));
+
+            // the welcome message takes up one slot
+            expectEquals (logger.getNumDroppedMessages(), (int64) 7);
+
+            logger.flush();
+
+            const auto text = logFile.loadFileAsString();
+            expect (text.contains ("message 2"));
+            expect (! text.contains ("message 3"));
+            expect (text.contains ("(7 log messages were discarded)"));
+
+            logger.logMessage ("message after flush");
+            logger.flush();
+            expect (logFile.loadFileAsString().contains ("message after flush"));
+            expectEquals (logger.getNumDroppedMessages(), (int64) 7);
+        }
+
+        logFile.deleteFile();
+
+        beginTest ("Log files are rotated when they reach the maximum size");
+        {
+            constexpr int64 maxSize = 1000;
+
+            AsyncFileLogger logger (logFile, "welcome", AsyncFileLogger::Options{}.withMaxFileSize (maxSize)
+                                                                                 .withMaxNumBackupFiles (2));
+
+            for (int i = 0; i < 200; ++i)
+                logger.logMessage ("message number " + String (i));
+
+            logger.flush();
+
+            expect (logFile.getSize() < maxSize);
+            expect (logger.getBackupFile (1).getSize() >= maxSize);
+            expect (logger.getBackupFile (2).getSize() >= maxSize);
+            expect (! logger.getBackupFile (3).exists());
+            expect (logFile.loadFileAsString().contains ("message number 199"));
+        }
+
+        folder.deleteRecursively();
+    }
+};
+
+static AsyncFileLoggerTests asyncFileLoggerTests;
+
+#endif
+
+} // namespace juce
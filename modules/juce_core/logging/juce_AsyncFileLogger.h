@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A Logger that writes to a file from a background thread.
+
+    Calls to logMessage() only place the message in a fixed-size lock-free queue,
+    so they never touch the file system, block on a lock or allocate memory, which
+    makes it safe to log from time-critical threads. A background thread wakes up
+    periodically, writes everything that has been queued in a single batch to a file
+    that it keeps open, and flushes it.
+
+    If messages arrive faster than the writer can consume them and the queue fills up,
+    further messages are discarded rather than making the caller wait. The number of
+    discarded messages is written to the log when space becomes available again.
+
+    Optionally, the file can be rotated when it grows beyond a given size: the current
+    file is renamed to "name.1.ext", any older backups are shifted along, and a new
+    file is started.
+
+    @see FileLogger, Logger
+
+    @tags{Core}
+*/
+class JUCE_API  AsyncFileLogger  : public Logger
+{
+public:
+    //==============================================================================
+    /** Settings that control the behaviour of an AsyncFileLogger. */
+    class [[nodiscard]] Options
+    {
+    public:
+        /** Returns a copy of these options with the given maximum file size.
+            When the log file reaches this size it will be rotated. A value of zero
+            or less means that the file is never rotated.
+        */
+        Options withMaxFileSize (int64 x) const
+        {
+            return withMember (*this, &Options::maxFileSize, x);
+        }
+
+        /** Returns a copy of these options with the given number of backup files.
+            When the log is rotated, at most this many older files are kept. If this
+            is zero, the current file is simply deleted when it reaches the size limit.
+        */
+        Options withMaxNumBackupFiles (int x) const
+        {
+            return withMember (*this, &Options::maxNumBackupFiles, x);
+        }
+
+        /** Returns a copy of these options with the given queue capacity.
+            This is the number of messages that can be waiting to be written before
+            new messages start being discarded. It will be rounded up to a power of two.
+        */
+        Options withQueueSize (int x) const
+        {
+            return withMember (*this, &Options::queueSize, x);
+        }
+
+        /** Returns a copy of these options with the given interval, in milliseconds,
+            at which the background thread writes queued messages to the file.
+        */
+        Options withFlushIntervalMs (int x) const
+        {
+            return withMember (*this, &Options::flushIntervalMs, x);
+        }
+
+        /** Returns the size at which the log file is rotated. */
+        int64 getMaxFileSize() const        { return maxFileSize; }
+
+        /** Returns the number of backup files that are kept when rotating. */
+        int getMaxNumBackupFiles() const    { return maxNumBackupFiles; }
+
+        /** Returns the number of messages that can be queued. */
+        int getQueueSize() const            { return queueSize; }
+
+        /** Returns the interval at which queued messages are written. */
+        int getFlushIntervalMs() const      { return flushIntervalMs; }
+
+    private:
+        int64 maxFileSize = 0;
+        int maxNumBackupFiles = 2;
+        int queueSize = 8192;
+        int flushIntervalMs = 100;
+    };
+
+    //==============================================================================
+    /** Creates an AsyncFileLogger for a given file.
+
+        @param fileToWriteTo    the file to use - new messages will be appended to it. If
+                                the file doesn't exist, it will be created, along with any
+                                parent directories that are needed.
+        @param welcomeMessage   when opened, the logger will write a header to the log, along
+                                with the current date and time, and this welcome message
+        @param options          the queue, flushing and rotation settings to use
+    */
+    AsyncFileLogger (const File& fileToWriteTo,
+                     const String& welcomeMessage,
+                     const Options& options);
+
+    /** Creates an AsyncFileLogger for a given file, using the default Options. */
+    AsyncFileLogger (const File& fileToWriteTo,
+                     const String& welcomeMessage);
+
+    /** Destructor.
+        Any messages that are still queued will be written before the file is closed.
+    */
+    ~AsyncFileLogger() override;
+
+    //==============================================================================
+    /** Returns the file that this logger is writing to. */
+    const File& getLogFile() const noexcept               { return logFile; }
+
+    /** Returns the file that a given backup of the log will be moved to when the
+        log is rotated, where 1 is the most recent backup.
+    */
+    File getBackupFile (int index) const;
+
+    /** Writes any queued messages to the file before returning.
+
+        This may block, so it must not be called from a time-critical thread.
+    */
+    void flush();
+
+    /** Returns the total number of messages that have been discarded because the
+        queue was full.
+    */
+    int64 getNumDroppedMessages() const noexcept;
+
+    // (implementation of the Logger virtual method)
+    void logMessage (const String&) override;
+
+private:
+    //==============================================================================
+    class Writer;
+
+    File logFile;
+    std::unique_ptr<Writer> writer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AsyncFileLogger)
+};
+
+} // namespace juce
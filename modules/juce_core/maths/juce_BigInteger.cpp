@@ -40,6 +40,325 @@ namespace
     inline uint32 bitToMask  (const int bit) noexcept           { return (uint32) 1 << (bit & 31); }
     inline size_t bitToIndex (const int bit) noexcept           { return (size_t) (bit >> 5); }
     inline size_t sizeNeededToHold (int highestBit) noexcept    { return (size_t) (highestBit >> 5) + 1; }
+
+    //==============================================================================
+    // Word-level arithmetic on little-endian arrays of 32-bit limbs, used by the
+    // multiplication, division and modular exponentiation routines below.
+    namespace Limbs
+    {
+        // Below this number of limbs, schoolbook multiplication beats Karatsuba.
+        constexpr size_t karatsubaThreshold = 32;
+
+        inline size_t getNumUsed (const uint32* a, size_t n) noexcept
+        {
+            while (n > 0 && a[n - 1] == 0)
+                --n;
+
+            return n;
+        }
+
+        // a[0..na) += b[0..nb), with na >= nb. Returns the carry out of the top limb.
+        inline uint32 addInPlace (uint32* a, size_t na, const uint32* b, size_t nb) noexcept
+        {
+            jassert (na >= nb);
+            uint64 carry = 0;
+
+            for (size_t i = 0; i < nb; ++i)
+            {
+                carry += (uint64) a[i] + b[i];
+                a[i] = (uint32) carry;
+                carry >>= 32;
+            }
+
+            for (size_t i = nb; carry != 0 && i < na; ++i)
+            {
+                carry += a[i];
+                a[i] = (uint32) carry;
+                carry >>= 32;
+            }
+
+            return (uint32) carry;
+        }
+
+        // a[0..na) -= b[0..nb), with na >= nb and a >= b. Returns the borrow out of the top limb.
+        inline uint32 subtractInPlace (uint32* a, size_t na, const uint32* b, size_t nb) noexcept
+        {
+            jassert (na >= nb);
+            uint32 borrow = 0;
+
+            for (size_t i = 0; i < nb; ++i)
+            {
+                auto diff = (uint64) a[i] - b[i] - borrow;
+                a[i] = (uint32) diff;
+                borrow = (uint32) (diff >> 63);
+            }
+
+            for (size_t i = nb; borrow != 0 && i < na; ++i)
+                borrow = (a[i]-- == 0) ? 1 : 0;
+
+            return borrow;
+        }
+
+        // r[0..na+nb) = a * b, where r must be zeroed by the caller.
+        inline void multiplySchoolbook (const uint32* a, size_t na, const uint32* b, size_t nb, uint32* r) noexcept
+        {
+            for (size_t i = 0; i < nb; ++i)
+            {
+                auto bi = (uint64) b[i];
+
+                if (bi == 0)
+                    continue;
+
+                uint64 carry = 0;
+
+                for (size_t j = 0; j < na; ++j)
+                {
+                    carry += (uint64) r[i + j] + (uint64) a[j] * bi;
+                    r[i + j] = (uint32) carry;
+                    carry >>= 32;
+                }
+
+                r[i + na] = (uint32) carry;
+            }
+        }
+
+        // r[0..na+nb) = a * b, where r must be zeroed by the caller.
+        inline void multiply (const uint32* a, size_t na, const uint32* b, size_t nb, uint32* r)
+        {
+            na = getNumUsed (a, na);
+            nb = getNumUsed (b, nb);
+
+            if (na < nb)
+            {
+                std::swap (a, b);
+                std::swap (na, nb);
+            }
+
+            if (nb < karatsubaThreshold)
+            {
+                multiplySchoolbook (a, na, b, nb, r);
+                return;
+            }
+
+            auto half = (na + 1) / 2;
+
+            if (nb <= half)
+            {
+                // Unbalanced operands: multiply b by successive chunks of a
+                HeapBlock<uint32> partial (2 * nb);
+
+                for (size_t offset = 0; offset < na; offset += nb)
+                {
+                    auto chunkSize = jmin (nb, na - offset);
+                    zeromem (partial, sizeof (uint32) * (chunkSize + nb));
+                    multiply (a + offset, chunkSize, b, nb, partial);
+                    addInPlace (r + offset, na + nb - offset, partial, chunkSize + nb);
+                }
+
+                return;
+            }
+
+            // Karatsuba: with a = a1.B^h + a0 and b = b1.B^h + b0,
+            // a.b = z2.B^2h + ((a0 + a1)(b0 + b1) - z2 - z0).B^h + z0
+            auto* z0 = r;
+            auto* z2 = r + 2 * half;
+            multiply (a, half, b, half, z0);
+            multiply (a + half, na - half, b + half, nb - half, z2);
+
+            HeapBlock<uint32> sums (2 * (half + 1), true), z1 (2 * (half + 1), true);
+            auto* sumA = sums.get();
+            auto* sumB = sums + (half + 1);
+
+            memcpy (sumA, a, sizeof (uint32) * half);
+            memcpy (sumB, b, sizeof (uint32) * half);
+            sumA[half] = addInPlace (sumA, half, a + half, na - half);
+            sumB[half] = addInPlace (sumB, half, b + half, nb - half);
+
+            multiply (sumA, half + 1, sumB, half + 1, z1);
+
+            auto z1Size = 2 * (half + 1);
+            subtractInPlace (z1, z1Size, z0, 2 * half);
+            subtractInPlace (z1, z1Size, z2, na + nb - 2 * half);
+
+            z1Size = getNumUsed (z1, z1Size);
+            jassert (z1Size <= na + nb - half);
+
+            auto carry = addInPlace (r + half, na + nb - half, z1, z1Size);
+            ignoreUnused (carry);
+            jassert (carry == 0);
+        }
+
+        // Divides u[0..nu) by the single limb v, leaving the quotient in q[0..nu).
+        inline uint32 divideBySingleLimb (const uint32* u, size_t nu, uint32 v, uint32* q) noexcept
+        {
+            uint64 remainder = 0;
+
+            for (auto i = nu; i-- > 0;)
+            {
+                remainder = (remainder << 32) | u[i];
+                q[i] = (uint32) (remainder / v);
+                remainder %= v;
+            }
+
+            return (uint32) remainder;
+        }
+
+        // Knuth's algorithm D: q[0..nu-nv+1) = u / v and r[0..nv) = u % v,
+        // where nu >= nv >= 2 and v[nv - 1] != 0.
+        inline void divide (const uint32* u, size_t nu, const uint32* v, size_t nv, uint32* q, uint32* r)
+        {
+            jassert (nu >= nv && nv >= 2 && v[nv - 1] != 0);
+
+            constexpr uint64 base = (uint64) 1 << 32;
+            auto shift = 31 - findHighestSetBit (v[nv - 1]);
+
+            HeapBlock<uint32> vn (nv), un (nu + 1);
+
+            for (auto i = nv; --i > 0;)
+                vn[i] = (v[i] << shift) | (shift != 0 ? (v[i - 1] >> (32 - shift)) : 0);
+
+            vn[0] = v[0] << shift;
+
+            un[nu] = shift != 0 ? (u[nu - 1] >> (32 - shift)) : 0;
+
+            for (auto i = nu; --i > 0;)
+                un[i] = (u[i] << shift) | (shift != 0 ? (u[i - 1] >> (32 - shift)) : 0);
+
+            un[0] = u[0] << shift;
+
+            for (auto j = nu - nv + 1; j-- > 0;)
+            {
+                auto numerator = ((uint64) un[j + nv] << 32) | un[j + nv - 1];
+                auto qhat = numerator / vn[nv - 1];
+                auto rhat = numerator % vn[nv - 1];
+
+                while (qhat >= base || qhat * vn[nv - 2] > ((rhat << 32) | un[j + nv - 2]))
+                {
+                    --qhat;
+                    rhat += vn[nv - 1];
+
+                    if (rhat >= base)
+                        break;
+                }
+
+                // Multiply and subtract
+                int64 borrow = 0;
+
+                for (size_t i = 0; i < nv; ++i)
+                {
+                    auto product = qhat * vn[i];
+                    auto t = (int64) un[i + j] - borrow - (int64) (product & 0xffffffff);
+                    un[i + j] = (uint32) t;
+                    borrow = (int64) (product >> 32) - (t >> 32);
+                }
+
+                auto t = (int64) un[j + nv] - borrow;
+                un[j + nv] = (uint32) t;
+                q[j] = (uint32) qhat;
+
+                if (t < 0)
+                {
+                    // qhat was one too large, so add the divisor back
+                    --q[j];
+                    uint64 carry = 0;
+
+                    for (size_t i = 0; i < nv; ++i)
+                    {
+                        carry += (uint64) un[i + j] + vn[i];
+                        un[i + j] = (uint32) carry;
+                        carry >>= 32;
+                    }
+
+                    un[j + nv] += (uint32) carry;
+                }
+            }
+
+            for (size_t i = 0; i < nv; ++i)
+                r[i] = (un[i] >> shift) | (shift != 0 ? (un[i + 1] << (32 - shift)) : 0);
+        }
+
+        //==============================================================================
+        // Montgomery arithmetic modulo an odd number m of n limbs, with R = 2^(32n).
+        struct MontgomeryContext
+        {
+            MontgomeryContext (const uint32* modulus, size_t numLimbs)
+                : m (modulus), n (numLimbs), scratch (numLimbs + 2)
+            {
+                jassert ((m[0] & 1) != 0);
+
+                // Newton iteration for m^-1 mod 2^32, doubling the number of correct bits each time
+                auto inverse = m[0];
+
+                for (int i = 0; i < 4; ++i)
+                    inverse *= 2 - m[0] * inverse;
+
+                mPrime = (uint32) (0 - inverse);
+            }
+
+            // result = a * b * R^-1 mod m, where a, b < m. The result may alias a or b.
+            void multiply (const uint32* a, const uint32* b, uint32* result) noexcept
+            {
+                auto* t = scratch.get();
+                zeromem (t, sizeof (uint32) * (n + 2));
+
+                for (size_t i = 0; i < n; ++i)
+                {
+                    auto bi = (uint64) b[i];
+                    uint64 carry = 0;
+
+                    for (size_t j = 0; j < n; ++j)
+                    {
+                        carry += (uint64) t[j] + (uint64) a[j] * bi;
+                        t[j] = (uint32) carry;
+                        carry >>= 32;
+                    }
+
+                    carry += t[n];
+                    t[n] = (uint32) carry;
+                    t[n + 1] = (uint32) (carry >> 32);
+
+                    auto u = (uint64) (uint32) (t[0] * mPrime);
+                    carry = ((uint64) t[0] + u * m[0]) >> 32;
+
+                    for (size_t j = 1; j < n; ++j)
+                    {
+                        carry += (uint64) t[j] + u * m[j];
+                        t[j - 1] = (uint32) carry;
+                        carry >>= 32;
+                    }
+
+                    carry += t[n];
+                    t[n - 1] = (uint32) carry;
+                    t[n] = t[n + 1] + (uint32) (carry >> 32);
+                }
+
+                if (t[n] != 0 || ! isLessThanModulus (t))
+                    subtractInPlace (t, n + 1, m, n);
+
+                memcpy (result, t, sizeof (uint32) * n);
+            }
+
+            bool isLessThanModulus (const uint32* a) const noexcept
+            {
+                for (auto i = n; i-- > 0;)
+                    if (a[i] != m[i])
+                        return a[i] < m[i];
+
+                return false;
+            }
+
+            const uint32* m;
+            size_t n;
+            uint32 mPrime = 0;
+            HeapBlock<uint32> scratch;
+        };
+
+        // The sliding window size that minimises the number of multiplications for an exponent size.
+        inline int getWindowSizeForExponent (int numBits) noexcept
+        {
+            return numBits > 671 ? 6 : numBits > 239 ? 5 : numBits > 79 ? 4 : numBits > 23 ? 3 : 1;
+        }
+    }
 }
 
 int findHighestSetBit (uint32 n) noexcept
@@ -550,38 +869,23 @@ BigInteger& BigInteger::operator*= (const BigInteger& other)
     auto n = getHighestBit();
     auto t = other.getHighestBit();
 
-    auto wasNegative = isNegative();
-    setNegative (false);
+    if (n < 0 || t < 0)
+    {
+        clear();
+        return *this;
+    }
+
+    auto numInts = sizeNeededToHold (n);
+    auto numOtherInts = sizeNeededToHold (t);
 
     BigInteger total;
     total.highestBit = n + t + 1;
-    auto* totalValues = total.ensureSize (sizeNeededToHold (total.highestBit) + 1);
-
-    n >>= 5;
-    t >>= 5;
-
-    auto m = other;
-    m.setNegative (false);
-
-    auto* mValues = m.getValues();
-    auto* values = getValues();
-
-    for (int i = 0; i <= t; ++i)
-    {
-        uint32 c = 0;
-
-        for (int j = 0; j <= n; ++j)
-        {
-            auto uv = (uint64) totalValues[i + j] + (uint64) values[j] * (uint64) mValues[i] + (uint64) c;
-            totalValues[i + j] = (uint32) uv;
-            c = static_cast<uint32> (uv >> 32);
-        }
+    auto* totalValues = total.ensureSize (numInts + numOtherInts);
 
-        totalValues[i + n + 1] = c;
-    }
+    Limbs::multiply (getValues(), numInts, other.getValues(), numOtherInts, totalValues);
 
     total.highestBit = total.getHighestBit();
-    total.setNegative (wasNegative ^ other.isNegative());
+    total.setNegative (isNegative() ^ other.isNegative());
     swapWith (total);
 
     return *this;
@@ -606,30 +910,40 @@ void BigInteger::divideBy (const BigInteger& divisor, BigInteger& remainder)
     else
     {
         auto wasNegative = isNegative();
+        auto quotientNegative = wasNegative ^ divisor.isNegative();
 
-        swapWith (remainder);
-        remainder.setNegative (false);
-        clear();
-
-        BigInteger temp (divisor);
-        temp.setNegative (false);
+        if (compareAbsolute (divisor) < 0)
+        {
+            swapWith (remainder);
+            clear();
+        }
+        else
+        {
+            auto numInts = sizeNeededToHold (ourHB);
+            auto numDivisorInts = sizeNeededToHold (divHB);
 
-        auto leftShift = ourHB - divHB;
-        temp <<= leftShift;
+            BigInteger quotient, rem;
+            quotient.highestBit = ourHB;
+            auto* quotientValues = quotient.ensureSize (numInts);
 
-        while (leftShift >= 0)
-        {
-            if (remainder.compareAbsolute (temp) >= 0)
+            if (numDivisorInts == 1)
             {
-                remainder -= temp;
-                setBit (leftShift);
+                rem = Limbs::divideBySingleLimb (getValues(), numInts, divisor.getValues()[0], quotientValues);
+            }
+            else
+            {
+                rem.highestBit = divHB;
+                Limbs::divide (getValues(), numInts, divisor.getValues(), numDivisorInts,
+                               quotientValues, rem.ensureSize (numDivisorInts));
+                rem.highestBit = rem.getHighestBit();
             }
 
-            if (--leftShift >= 0)
-                temp >>= 1;
+            quotient.highestBit = quotient.getHighestBit();
+            swapWith (quotient);
+            remainder.swapWith (rem);
         }
 
-        negative = wasNegative ^ divisor.isNegative();
+        negative = quotientNegative;
         remainder.setNegative (wasNegative);
     }
 }
@@ -939,7 +1253,7 @@ void BigInteger::exponentModulo (const BigInteger& exponent, const BigInteger& m
     *this %= modulus;
     auto exp = exponent;
 
-    if (modulus.getHighestBit() <= 32 || modulus % 2 == 0)
+    if (modulus.getHighestBit() <= 32 || modulus % 2 == 0 || modulus.isNegative())
     {
         auto a = *this;
         auto n = exp.getHighestBit();
@@ -957,45 +1271,64 @@ void BigInteger::exponentModulo (const BigInteger& exponent, const BigInteger& m
     }
     else
     {
-        auto Rfactor = modulus.getHighestBit() + 1;
-        BigInteger R (1);
-        R.shiftLeft (Rfactor, 0);
+        // Montgomery exponentiation with a sliding window over the exponent bits
+        if (isNegative())
+            *this += modulus;
 
-        BigInteger R1, m1, g;
-        g.extendedEuclidean (modulus, R, m1, R1);
+        auto numInts = sizeNeededToHold (modulus.getHighestBit());
+        Limbs::MontgomeryContext context (modulus.getValues(), numInts);
 
-        if (! g.isOne())
+        const auto toMontgomeryForm = [&] (BigInteger value, uint32* dest)
         {
-            BigInteger a (*this);
+            value <<= (int) numInts * 32;
+            value %= modulus;
 
-            for (int i = exp.getHighestBit(); --i >= 0;)
-            {
-                *this *= *this;
+            zeromem (dest, sizeof (uint32) * numInts);
+            memcpy (dest, value.getValues(), sizeof (uint32) * jmin (numInts, sizeNeededToHold (value.getHighestBit())));
+        };
 
-                if (exp[i])
-                    *this *= a;
+        auto windowSize = Limbs::getWindowSizeForExponent (exp.getHighestBit() + 1);
+        auto numOddPowers = (size_t) 1 << (windowSize - 1);
+        HeapBlock<uint32> oddPowers (numOddPowers * numInts), squared (numInts), result (numInts);
 
-                if (compareAbsolute (modulus) >= 0)
-                    *this %= modulus;
-            }
-        }
-        else
-        {
-            auto am  = (*this * R) % modulus;
-            auto xm = am;
-            auto um = R % modulus;
+        toMontgomeryForm (*this, oddPowers);
+        toMontgomeryForm (1, result);
 
-            for (int i = exp.getHighestBit(); --i >= 0;)
-            {
-                xm.montgomeryMultiplication (xm, modulus, m1, Rfactor);
+        context.multiply (oddPowers, oddPowers, squared);
+
+        for (size_t i = 1; i < numOddPowers; ++i)
+            context.multiply (oddPowers + (i - 1) * numInts, squared, oddPowers + i * numInts);
 
-                if (exp[i])
-                    xm.montgomeryMultiplication (am, modulus, m1, Rfactor);
+        for (int i = exp.getHighestBit(); i >= 0;)
+        {
+            if (! exp[i])
+            {
+                context.multiply (result, result, result);
+                --i;
+                continue;
             }
 
-            xm.montgomeryMultiplication (1, modulus, m1, Rfactor);
-            swapWith (xm);
+            auto lowestBit = jmax (0, i - windowSize + 1);
+
+            while (! exp[lowestBit])
+                ++lowestBit;
+
+            for (int j = lowestBit; j <= i; ++j)
+                context.multiply (result, result, result);
+
+            auto window = exp.getBitRangeAsInt (lowestBit, i - lowestBit + 1);
+            context.multiply (result, oddPowers + ((window - 1) / 2) * numInts, result);
+            i = lowestBit - 1;
         }
+
+        HeapBlock<uint32> one (numInts, true);
+        one[0] = 1;
+        context.multiply (result, one, result);
+
+        clear();
+        memcpy (ensureSize (numInts), result, sizeof (uint32) * numInts);
+        highestBit = (int) numInts * 32 - 1;
+        highestBit = getHighestBit();
     }
 }
 
@@ -1371,6 +1704,77 @@ public:
             }
         }
 
+        {
+            beginTest ("Large operands");
+
+            Random r = getRandom();
+
+            const auto getRandomWithBits = [&r] (int numBits)
+            {
+                BigInteger b;
+                r.fillBitsRandomly (b, 0, numBits);
+                b.setBit (numBits - 1);
+                return b;
+            };
+
+            for (int j = 50; --j >= 0;)
+            {
+                auto a = getRandomWithBits (r.nextInt (12000) + 1000);
+                auto b = getRandomWithBits (r.nextInt (12000) + 64);
+
+                auto product = a * b;
+
+                const auto getLimbs = [] (const BigInteger& value)
+                {
+                    std::vector<uint32> limbs (sizeNeededToHold (value.getHighestBit()));
+
+                    for (size_t i = 0; i < limbs.size(); ++i)
+                        limbs[i] = value.getBitRangeAsInt ((int) i * 32, 32);
+
+                    return limbs;
+                };
+
+                auto limbsA = getLimbs (a), limbsB = getLimbs (b);
+                auto numA = limbsA.size(), numB = limbsB.size();
+                HeapBlock<uint32> expected (numA + numB, true);
+                Limbs::multiplySchoolbook (limbsA.data(), numA, limbsB.data(), numB, expected);
+
+                BigInteger expectedProduct;
+                expectedProduct.loadFromMemoryBlock (MemoryBlock (expected, sizeof (uint32) * (numA + numB)));
+                expect (product == expectedProduct);
+
+                auto c = b;
+                c -= 1;
+                auto dividend = product + c;
+                BigInteger remainder;
+                dividend.divideBy (b, remainder);
+                expect (dividend == a);
+                expect (remainder == c);
+            }
+
+            for (int j = 10; --j >= 0;)
+            {
+                auto modulus = getRandomWithBits (r.nextInt (1000) + 40);
+                modulus.setBit (0);
+
+                auto base = getRandomWithBits (r.nextInt (1200) + 2);
+                auto exponent = getRandomWithBits (r.nextInt (600) + 1);
+
+                BigInteger expected (1), a (base % modulus);
+
+                for (int i = exponent.getHighestBit(); i >= 0; --i)
+                {
+                    expected = (expected * expected) % modulus;
+
+                    if (exponent[i])
+                        expected = (expected * a) % modulus;
+                }
+
+                base.exponentModulo (exponent, modulus);
+                expect (base == expected);
+            }
+        }
+
         {
             beginTest ("Bit setting");
 
@@ -77,7 +77,8 @@ static void getCPUInfo (bool& hasMMX,
                         bool& hasAVX512BW,
                         bool& hasAVX512VL,
                         bool& hasAVX512VBMI,
-                        bool& hasAVX512VPOPCNTDQ)
+                        bool& hasAVX512VPOPCNTDQ,
+                        bool& hasSHA)
 {
     uint32 a = 0, b = 0, d = 0, c = 0;
     SystemStatsHelpers::doCPUID (a, b, c, d, 1);
@@ -104,6 +105,7 @@ static void getCPUInfo (bool& hasMMX,
     hasAVX512PF        = (b & (1u << 26)) != 0;
     hasAVX512ER        = (b & (1u << 27)) != 0;
     hasAVX512CD        = (b & (1u << 28)) != 0;
+    hasSHA             = (b & (1u << 29)) != 0;
     hasAVX512BW        = (b & (1u << 30)) != 0;
     hasAVX512VL        = (b & (1u << 31)) != 0;
     hasAVX512VBMI      = (c & (1u <<  1)) != 0;
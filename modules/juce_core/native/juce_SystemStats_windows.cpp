@@ -174,6 +174,7 @@ void CPUInformation::initialise() noexcept
     hasAVX512PF        = ((unsigned int) info[1] & (1u << 26)) != 0;
     hasAVX512ER        = ((unsigned int) info[1] & (1u << 27)) != 0;
     hasAVX512CD        = ((unsigned int) info[1] & (1u << 28)) != 0;
+    hasSHA             = ((unsigned int) info[1] & (1u << 29)) != 0;
     hasAVX512BW        = ((unsigned int) info[1] & (1u << 30)) != 0;
     hasAVX512VL        = ((unsigned int) info[1] & (1u << 31)) != 0;
     hasAVX512VBMI      = ((unsigned int) info[2] & (1u <<  1)) != 0;
@@ -0,0 +1,793 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+/**
+    Options that control conversion from arbitrary types to the binary format written by ToBinary.
+
+    @see ToBinary
+
+    @tags{Core}
+*/
+class ToBinaryOptions
+{
+public:
+    /** By default, conversion will serialise the type using the marshallingVersion defined for
+        that type. Setting an explicit version allows the type to be serialised as an earlier
+        version.
+    */
+    [[nodiscard]] ToBinaryOptions withExplicitVersion (std::optional<int> x) const { return withMember (*this, &ToBinaryOptions::explicitVersion, x); }
+
+    /** @see withExplicitVersion() */
+    [[nodiscard]] auto getExplicitVersion() const { return explicitVersion; }
+
+private:
+    std::optional<std::optional<int>> explicitVersion;
+};
+
+#ifndef DOXYGEN
+
+namespace detail
+{
+    /*  Constants and helpers shared by ToBinary and FromBinary.
+
+        The binary format is positional: the names passed to named() are not written, so items
+        are read back in the same order in which they were written.
+
+        - bool is a single byte, either 0 or 1.
+        - Integers are written as LEB128 varints. Signed types are zigzag-encoded first, so that
+          small negative numbers stay small.
+        - float and double are written as little-endian IEEE-754 values of 4 and 8 bytes.
+        - Strings are a varint byte count, followed by UTF-8 data with no terminator.
+        - A SerialisationSize is a varint. A container may not claim more elements than there are
+          bytes remaining in the input.
+        - Types with a non-null marshallingVersion are preceded by a varint header, which holds 0
+          if the object was written without a version, or the zigzag-encoded version plus one.
+        - A var is a tag byte, followed by a payload that depends on the tag. Arrays and objects
+          may be nested at most maxVarDepth levels deep.
+    */
+    struct BinarySerialisation
+    {
+        static constexpr int maxVarDepth = 256;
+
+        enum class VarTag : uint8
+        {
+            voidValue,
+            undefined,
+            falseValue,
+            trueValue,
+            intValue,
+            int64Value,
+            doubleValue,
+            string,
+            array,
+            object,
+            binary
+        };
+
+        static constexpr uint64 zigzagEncode (int64 x) { return ((uint64) x << 1) ^ (uint64) (x >> 63); }
+        static constexpr int64  zigzagDecode (uint64 x) { return (int64) (x >> 1) ^ -(int64) (x & 1); }
+    };
+} // namespace detail
+
+#endif
+
+/**
+    Allows converting an object of arbitrary type to a compact binary representation.
+
+    To use this, you must first ensure that the type passed to convert is set up for serialisation.
+    For details of what this entails, see the docs for SerialisationTraits.
+
+    In short, the constant 'marshallingVersion', and either the single function 'serialise()', or
+    the function pair 'load()' and 'save()' must be defined for the type. These may be defined
+    as public members of the type T itself, or as public members of juce::SerialisationTraits<T>,
+    which is a specialisation of the SerialisationTraits template struct for the type T.
+
+    Unlike ToVar, this doesn't build an intermediate tree of vars: each value is written straight
+    to the destination stream as it is visited. Names are not stored, so the result is much
+    smaller than the equivalent JSON, but it can only be read back by FromBinary using the same
+    serialisation functions. Data written with a newer marshallingVersion than the reader knows
+    about will be rejected.
+
+    @see FromBinary, ToVar
+
+    @tags{Core}
+*/
+class ToBinary
+{
+public:
+    using Options = ToBinaryOptions;
+
+    /** Attempts to write the argument to a stream using the serialisation utilities specified
+        for that type.
+
+        Returns false if the requested explicit version is higher than the declared version of
+        the type, if a var holds something that can't be written (such as a method, or an object
+        that isn't a DynamicObject), or if writing to the stream fails. In that case, the
+        stream may contain some partially-written data.
+    */
+    template <typename T>
+    static bool convert (const T& t, OutputStream& stream, const Options& options = {})
+    {
+        return Visitor::convert (t, stream, options);
+    }
+
+    /** Attempts to convert the argument to a block of binary data using the serialisation
+        utilities specified for that type.
+
+        This will return a non-null optional if conversion succeeds, or nullopt if conversion fails.
+    */
+    template <typename T>
+    static std::optional<MemoryBlock> convert (const T& t, const Options& options = {})
+    {
+        MemoryBlock block;
+
+        {
+            MemoryOutputStream stream (block, false);
+
+            if (! convert (t, stream, options))
+                return std::nullopt;
+        }
+
+        return block;
+    }
+
+private:
+    class Visitor
+    {
+    public:
+        template <typename T>
+        static bool convert (const T& t, OutputStream& stream, const Options& options)
+        {
+            constexpr auto fallbackVersion = detail::ForwardingSerialisationTraits<T>::marshallingVersion;
+            const auto versionToUse = options.getExplicitVersion()
+                                             .value_or (fallbackVersion);
+
+            if (versionToUse > fallbackVersion)
+            {
+                // The requested explicit version is higher than the declared version of the type.
+                return false;
+            }
+
+            Visitor visitor { stream };
+            visitor.writeObject (t, versionToUse);
+            return ! visitor.failed;
+        }
+
+        std::optional<int> getVersion() const { return version; }
+
+        template <typename... Ts>
+        void operator() (Ts&&... ts)
+        {
+            (visit (std::forward<Ts> (ts)), ...);
+        }
+
+    private:
+        using Format = detail::BinarySerialisation;
+
+        explicit Visitor (OutputStream& s) : stream (s) {}
+
+        template <typename T>
+        void writeObject (const T& t, std::optional<int> versionToUse)
+        {
+            constexpr std::optional<int> declaredVersion { detail::ForwardingSerialisationTraits<T>::marshallingVersion };
+
+            if constexpr (declaredVersion.has_value())
+                writeVarint (versionToUse.has_value() ? Format::zigzagEncode (*versionToUse) + 1 : 0);
+
+            const auto previousVersion = std::exchange (version, versionToUse);
+            detail::doSave (*this, t);
+            version = previousVersion;
+        }
+
+        template <typename T>
+        void visit (const T& t)
+        {
+            if constexpr (std::is_integral_v<T>)
+            {
+                if constexpr (std::is_signed_v<T>)
+                    writeVarint (Format::zigzagEncode ((int64) t));
+                else
+                    writeVarint ((uint64) t);
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                writeFloatingPoint (t);
+            }
+            else if constexpr (std::is_same_v<T, std::string>)
+            {
+                // Avoids the temporary String that the std::string traits would create
+                writeString (t.data(), t.size());
+            }
+            else
+            {
+                writeObject (t, detail::ForwardingSerialisationTraits<T>::marshallingVersion);
+            }
+        }
+
+        template <typename T>
+        void visit (const Named<T>& named)
+        {
+            visit (named.value);
+        }
+
+        template <typename T>
+        void visit (const SerialisationSize<T>& t)
+        {
+            if constexpr (std::is_signed_v<T>)
+            {
+                if (t.size < 0)
+                {
+                    jassertfalse;
+                    failed = true;
+                    return;
+                }
+            }
+
+            writeVarint ((uint64) t.size);
+        }
+
+        void visit (const bool& t)
+        {
+            writeByte (t ? 1 : 0);
+        }
+
+        void visit (const String& t)
+        {
+            writeString (t.toRawUTF8(), t.getNumBytesAsUTF8());
+        }
+
+        void visit (const var& t)
+        {
+            using Tag = Format::VarTag;
+
+            if (t.isVoid())
+            {
+                writeByte ((uint8) Tag::voidValue);
+            }
+            else if (t.isUndefined())
+            {
+                writeByte ((uint8) Tag::undefined);
+            }
+            else if (t.isBool())
+            {
+                writeByte ((uint8) ((bool) t ? Tag::trueValue : Tag::falseValue));
+            }
+            else if (t.isInt())
+            {
+                writeByte ((uint8) Tag::intValue);
+                visit ((int) t);
+            }
+            else if (t.isInt64())
+            {
+                writeByte ((uint8) Tag::int64Value);
+                visit ((int64) t);
+            }
+            else if (t.isDouble())
+            {
+                writeByte ((uint8) Tag::doubleValue);
+                writeFloatingPoint ((double) t);
+            }
+            else if (t.isString())
+            {
+                writeByte ((uint8) Tag::string);
+                visit (t.toString());
+            }
+            else if (auto* array = t.getArray())
+            {
+                writeByte ((uint8) Tag::array);
+                writeVarint ((uint64) array->size());
+
+                for (const auto& element : *array)
+                    visit (element);
+            }
+            else if (auto* object = t.getDynamicObject())
+            {
+                const auto& properties = object->getProperties();
+
+                writeByte ((uint8) Tag::object);
+                writeVarint ((uint64) properties.size());
+
+                for (const auto& property : properties)
+                {
+                    visit (property.name.toString());
+                    visit (property.value);
+                }
+            }
+            else if (auto* block = t.getBinaryData())
+            {
+                writeByte ((uint8) Tag::binary);
+                writeVarint ((uint64) block->getSize());
+                writeBytes (block->getData(), block->getSize());
+            }
+            else
+            {
+                // Methods and objects that aren't DynamicObjects can't be serialised
+                jassertfalse;
+                failed = true;
+            }
+        }
+
+        void writeString (const char* data, size_t numBytes)
+        {
+            writeVarint ((uint64) numBytes);
+            writeBytes (data, numBytes);
+        }
+
+        void writeFloatingPoint (float x)
+        {
+            uint32 bits{};
+            std::memcpy (&bits, &x, sizeof (bits));
+            bits = ByteOrder::swapIfBigEndian (bits);
+            writeBytes (&bits, sizeof (bits));
+        }
+
+        void writeFloatingPoint (double x)
+        {
+            uint64 bits{};
+            std::memcpy (&bits, &x, sizeof (bits));
+            bits = ByteOrder::swapIfBigEndian (bits);
+            writeBytes (&bits, sizeof (bits));
+        }
+
+        void writeFloatingPoint (long double x)
+        {
+            writeFloatingPoint ((double) x);
+        }
+
+        void writeVarint (uint64 x)
+        {
+            uint8 buffer[10];
+            size_t numBytes = 0;
+
+            for (; x >= 0x80; x >>= 7)
+                buffer[numBytes++] = (uint8) (x | 0x80);
+
+            buffer[numBytes++] = (uint8) x;
+            writeBytes (buffer, numBytes);
+        }
+
+        void writeByte (uint8 x)
+        {
+            writeBytes (&x, 1);
+        }
+
+        void writeBytes (const void* data, size_t numBytes)
+        {
+            if (! failed && numBytes > 0)
+                failed = ! stream.write (data, numBytes);
+        }
+
+        OutputStream& stream;
+        std::optional<int> version;
+        bool failed = false;
+    };
+};
+
+//==============================================================================
+/**
+    Allows converting binary data written by ToBinary back to an object of arbitrary type.
+
+    To use this, you must first ensure that the type passed to convert is set up for serialisation.
+    For details of what this entails, see the docs for SerialisationTraits.
+
+    In short, the constant 'marshallingVersion', and either the single function 'serialise()', or
+    the function pair 'load()' and 'save()' must be defined for the type. These may be defined
+    as public members of the type T itself, or as public members of juce::SerialisationTraits<T>,
+    which is a specialisation of the SerialisationTraits template struct for the type T.
+
+    The input is read in place, so the only allocations made are those needed to construct the
+    resulting object.
+
+    @see ToBinary, FromVar
+
+    @tags{Core}
+*/
+class FromBinary
+{
+public:
+    /** Attempts to convert a block of data to an instance of type T.
+
+        This will return a non-null optional if conversion succeeds, or nullopt if conversion
+        fails. Conversion fails if the data is truncated or malformed, if it contains a version
+        that is higher than the declared version of the type, if it contains vars nested more
+        than 256 levels deep, or if any bytes remain unread once the object has been loaded.
+    */
+    template <typename T>
+    static std::optional<T> convert (const void* data, size_t numBytes)
+    {
+        return Visitor::convert<T> (data, numBytes);
+    }
+
+    /** Attempts to convert a MemoryBlock to an instance of type T.
+
+        @see convert (const void*, size_t)
+    */
+    template <typename T>
+    static std::optional<T> convert (const MemoryBlock& block)
+    {
+        return convert<T> (block.getData(), block.getSize());
+    }
+
+private:
+    class Visitor
+    {
+    public:
+        template <typename T>
+        static std::optional<T> convert (const void* data, size_t numBytes)
+        {
+            Visitor visitor { static_cast<const uint8*> (data), numBytes };
+            T t{};
+            visitor.readObject (t);
+            return ! visitor.failed && visitor.position == visitor.end ? std::optional<T> (std::move (t))
+                                                                       : std::nullopt;
+        }
+
+        std::optional<int> getVersion() const { return version; }
+
+        template <typename... Ts>
+        void operator() (Ts&&... ts)
+        {
+            (visit (std::forward<Ts> (ts)), ...);
+        }
+
+    private:
+        using Format = detail::BinarySerialisation;
+
+        Visitor (const uint8* data, size_t numBytes)
+            : position (data), end (data + numBytes) {}
+
+        template <typename T>
+        void readObject (T& t)
+        {
+            constexpr std::optional<int> declaredVersion { detail::ForwardingSerialisationTraits<T>::marshallingVersion };
+
+            std::optional<int> detectedVersion;
+
+            if constexpr (declaredVersion.has_value())
+            {
+                if (const auto header = readVarint(); header != 0)
+                {
+                    const auto decoded = Format::zigzagDecode (header - 1);
+
+                    if (decoded < std::numeric_limits<int>::min() || *declaredVersion < decoded)
+                        failed = true;
+                    else
+                        detectedVersion = (int) decoded;
+                }
+            }
+
+            if (failed)
+                return;
+
+            const auto previousVersion = std::exchange (version, detectedVersion);
+            detail::doLoad (*this, t);
+            version = previousVersion;
+        }
+
+        template <typename T>
+        void visit (T& t)
+        {
+            if constexpr (std::is_integral_v<T>)
+            {
+                readInteger (t);
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                readFloatingPoint (t);
+            }
+            else if constexpr (std::is_same_v<T, std::string>)
+            {
+                // Avoids the temporary String that the std::string traits would create
+                const auto numBytes = readVarint();
+                const auto* bytes = readBytes (numBytes);
+
+                if (! failed)
+                    t.assign (reinterpret_cast<const char*> (bytes), (size_t) numBytes);
+            }
+            else
+            {
+                readObject (t);
+            }
+        }
+
+        template <typename T>
+        void visit (const Named<T>& named)
+        {
+            visit (named.value);
+        }
+
+        template <typename T>
+        void visit (const SerialisationSize<T>& t)
+        {
+            const auto size = readVarint();
+
+            // Rejecting sizes that couldn't be satisfied by the remaining data avoids trying to
+            // allocate huge containers when loading corrupt input
+            if (size > getNumBytesRemaining() || size > (uint64) std::numeric_limits<T>::max())
+                failed = true;
+            else
+                t.size = static_cast<T> (size);
+        }
+
+        void visit (bool& t)
+        {
+            if (const auto* byte = readBytes (1))
+            {
+                if (*byte > 1)
+                    failed = true;
+                else
+                    t = *byte != 0;
+            }
+        }
+
+        void visit (String& t)
+        {
+            const auto numBytes = readVarint();
+
+            if (numBytes > (uint64) std::numeric_limits<int>::max())
+            {
+                failed = true;
+                return;
+            }
+
+            const auto* bytes = reinterpret_cast<const char*> (readBytes (numBytes));
+
+            if (failed)
+                return;
+
+            if (numBytes == 0)
+            {
+                t = String();
+                return;
+            }
+
+            if (! CharPointer_UTF8::isValidString (bytes, (int) numBytes))
+            {
+                failed = true;
+                return;
+            }
+
+            t = String::fromUTF8 (bytes, (int) numBytes);
+        }
+
+        void visit (var& t)
+        {
+            using Tag = Format::VarTag;
+
+            // Each nested array or object recurses, so the depth has to be limited to stop
+            // malformed input from overflowing the stack
+            if (varDepth >= Format::maxVarDepth)
+            {
+                failed = true;
+                return;
+            }
+
+            const ScopedValueSetter<int> depthSetter (varDepth, varDepth + 1);
+            const auto* tag = readBytes (1);
+
+            if (tag == nullptr)
+                return;
+
+            switch ((Tag) *tag)
+            {
+                case Tag::voidValue:    t = var();              return;
+                case Tag::undefined:    t = var::undefined();   return;
+                case Tag::falseValue:   t = false;              return;
+                case Tag::trueValue:    t = true;               return;
+                case Tag::intValue:     t = readTyped<int>();   return;
+                case Tag::int64Value:   t = readTyped<int64>(); return;
+                case Tag::doubleValue:  t = readTyped<double>(); return;
+                case Tag::string:       t = readTyped<String>(); return;
+
+                case Tag::array:
+                {
+                    const auto size = readSize();
+                    Array<var> array;
+                    array.ensureStorageAllocated (size);
+
+                    for (auto i = 0; i < size && ! failed; ++i)
+                        array.add (readTyped<var>());
+
+                    t = std::move (array);
+                    return;
+                }
+
+                case Tag::object:
+                {
+                    const auto size = readSize();
+                    DynamicObject::Ptr object = new DynamicObject;
+
+                    for (auto i = 0; i < size && ! failed; ++i)
+                    {
+                        const auto name = readTyped<String>();
+                        const auto value = readTyped<var>();
+
+                        if (name.isEmpty())
+                            failed = true;
+                        else if (! failed)
+                            object->setProperty (name, value);
+                    }
+
+                    t = object.get();
+                    return;
+                }
+
+                case Tag::binary:
+                {
+                    const auto size = readSize();
+
+                    const auto* bytes = readBytes ((uint64) size);
+
+                    if (! failed)
+                        t = MemoryBlock (bytes, (size_t) size);
+
+                    return;
+                }
+            }
+
+            failed = true;
+        }
+
+        template <typename T>
+        T readTyped()
+        {
+            T result{};
+            visit (result);
+            return result;
+        }
+
+        int readSize()
+        {
+            auto result = 0;
+            visit (serialisationSize (result));
+            return result;
+        }
+
+        template <typename T>
+        void readInteger (T& t)
+        {
+            const auto raw = readVarint();
+
+            if constexpr (std::is_signed_v<T>)
+            {
+                const auto decoded = Format::zigzagDecode (raw);
+
+                if constexpr (sizeof (T) < sizeof (int64))
+                {
+                    if (decoded < std::numeric_limits<T>::min() || std::numeric_limits<T>::max() < decoded)
+                    {
+                        failed = true;
+                        return;
+                    }
+                }
+
+                t = static_cast<T> (decoded);
+            }
+            else
+            {
+                if constexpr (sizeof (T) < sizeof (uint64))
+                {
+                    if (std::numeric_limits<T>::max() < raw)
+                    {
+                        failed = true;
+                        return;
+                    }
+                }
+
+                t = static_cast<T> (raw);
+            }
+        }
+
+        void readFloatingPoint (float& t)
+        {
+            if (const auto* bytes = readBytes (sizeof (uint32)))
+            {
+                const auto bits = ByteOrder::littleEndianInt (bytes);
+                std::memcpy (&t, &bits, sizeof (t));
+            }
+        }
+
+        void readFloatingPoint (double& t)
+        {
+            if (const auto* bytes = readBytes (sizeof (uint64)))
+            {
+                const auto bits = ByteOrder::littleEndianInt64 (bytes);
+                std::memcpy (&t, &bits, sizeof (t));
+            }
+        }
+
+        void readFloatingPoint (long double& t)
+        {
+            double d{};
+            readFloatingPoint (d);
+            t = d;
+        }
+
+        uint64 readVarint()
+        {
+            uint64 result = 0;
+
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                const auto* byte = readBytes (1);
+
+                if (byte == nullptr)
+                    return 0;
+
+                if (shift == 63 && (*byte & 0x7e) != 0)
+                    break;
+
+                result |= (uint64) (*byte & 0x7f) << shift;
+
+                if ((*byte & 0x80) == 0)
+                    return result;
+            }
+
+            // The encoded value doesn't fit in 64 bits
+            failed = true;
+            return 0;
+        }
+
+        /*  Returns a pointer to the next numBytes bytes of input and advances past them, or
+            sets the failure flag and returns nullptr if there isn't enough data remaining.
+        */
+        const uint8* readBytes (uint64 numBytes)
+        {
+            if (failed || getNumBytesRemaining() < numBytes)
+            {
+                failed = true;
+                return nullptr;
+            }
+
+            return std::exchange (position, position + numBytes);
+        }
+
+        uint64 getNumBytesRemaining() const
+        {
+            return (uint64) (end - position);
+        }
+
+        const uint8* position = nullptr;
+        const uint8* end = nullptr;
+        std::optional<int> version;
+        int varDepth = 0;
+        bool failed = false;
+    };
+};
+
+} // namespace juce
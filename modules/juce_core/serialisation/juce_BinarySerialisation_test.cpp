@@ -0,0 +1,383 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace juce
+{
+
+enum class BinarySerialisationTestShape : uint8 { circle, square, triangle };
+
+struct BinarySerialisationTestPoint
+{
+    float x{}, y{};
+
+    auto operator== (const BinarySerialisationTestPoint& other) const
+    {
+        const auto tie = [] (const auto& p) { return std::tie (p.x, p.y); };
+        return tie (*this) == tie (other);
+    }
+
+    auto operator!= (const BinarySerialisationTestPoint& other) const { return ! operator== (other); }
+
+    static constexpr auto marshallingVersion = std::nullopt;
+
+    template <typename Archive, typename T>
+    static void serialise (Archive& archive, T& t)
+    {
+        archive (named ("x", t.x), named ("y", t.y));
+    }
+};
+
+struct BinarySerialisationTestItem
+{
+    std::string name;
+    BinarySerialisationTestShape shape{};
+    std::vector<BinarySerialisationTestPoint> points;
+    std::optional<String> comment;
+    std::map<String, int64> tags;
+    std::set<int> ids;
+    Array<double> weights;
+    StringArray labels;
+    std::array<uint8, 4> colour{};
+    var extra;
+
+    auto operator== (const BinarySerialisationTestItem& other) const
+    {
+        const auto tie = [] (const auto& x) { return std::tie (x.name, x.shape, x.points, x.comment, x.tags, x.ids, x.weights, x.labels, x.colour); };
+        return tie (*this) == tie (other) && JSONUtils::deepEqual (extra, other.extra);
+    }
+
+    auto operator!= (const BinarySerialisationTestItem& other) const { return ! operator== (other); }
+};
+
+template <>
+struct SerialisationTraits<BinarySerialisationTestItem>
+{
+    static constexpr auto marshallingVersion = 1;
+
+    template <typename Archive, typename T>
+    static void serialise (Archive& archive, T& t)
+    {
+        archive (named ("name", t.name),
+                 named ("shape", t.shape),
+                 named ("points", t.points),
+                 named ("comment", t.comment),
+                 named ("tags", t.tags),
+                 named ("ids", t.ids),
+                 named ("weights", t.weights),
+                 named ("labels", t.labels),
+                 named ("colour", t.colour),
+                 named ("extra", t.extra));
+    }
+};
+
+struct BinarySerialisationTestVersioned
+{
+    int a{}, b{}, c{}, d{};
+
+    bool operator== (const BinarySerialisationTestVersioned& other) const
+    {
+        const auto tie = [] (const auto& x) { return std::tie (x.a, x.b, x.c, x.d); };
+        return tie (*this) == tie (other);
+    }
+
+    bool operator!= (const BinarySerialisationTestVersioned& other) const { return ! operator== (other); }
+
+    static constexpr auto marshallingVersion = 3;
+
+    template <typename Archive, typename T>
+    static void serialise (Archive& archive, T& t)
+    {
+        archive (named ("a", t.a));
+
+        if (archive.getVersion() >= 1)
+            archive (named ("b", t.b));
+
+        if (archive.getVersion() >= 2)
+            archive (named ("c", t.c));
+
+        if (archive.getVersion() >= 3)
+            archive (named ("d", t.d));
+    }
+};
+
+struct BinarySerialisationTestNestedVersions
+{
+    BinarySerialisationTestVersioned inner;
+    std::vector<BinarySerialisationTestVersioned> list;
+
+    bool operator== (const BinarySerialisationTestNestedVersions& other) const
+    {
+        const auto tie = [] (const auto& x) { return std::tie (x.inner, x.list); };
+        return tie (*this) == tie (other);
+    }
+
+    static constexpr auto marshallingVersion = 7;
+
+    template <typename Archive, typename T>
+    static void serialise (Archive& archive, T& t)
+    {
+        archive (named ("inner", t.inner));
+
+        // The nested objects shouldn't change the version seen by the outer object
+        if (archive.getVersion() == 7)
+            archive (named ("list", t.list));
+    }
+};
+
+class BinarySerialisationTest final : public UnitTest
+{
+public:
+    BinarySerialisationTest() : UnitTest ("BinarySerialisation", UnitTestCategories::streams) {}
+
+    void runTest() override
+    {
+        beginTest ("Primitive encoding");
+        {
+            expectBytes (ToBinary::convert (false), { 0x00 });
+            expectBytes (ToBinary::convert (true), { 0x01 });
+            expectBytes (ToBinary::convert (0), { 0x00 });
+            expectBytes (ToBinary::convert (-1), { 0x01 });
+            expectBytes (ToBinary::convert (1), { 0x02 });
+            expectBytes (ToBinary::convert (300), { 0xd8, 0x04 });
+            expectBytes (ToBinary::convert ((uint32) 300), { 0xac, 0x02 });
+            expectBytes (ToBinary::convert (std::numeric_limits<uint64>::max()), { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01 });
+            expectBytes (ToBinary::convert (1.0f), { 0x00, 0x00, 0x80, 0x3f });
+            expectBytes (ToBinary::convert (-2.0), { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0 });
+            expectBytes (ToBinary::convert (String ("abc")), { 0x03, 'a', 'b', 'c' });
+            expectBytes (ToBinary::convert (std::string ("abc")), { 0x03, 'a', 'b', 'c' });
+            expectBytes (ToBinary::convert (BinarySerialisationTestShape::triangle), { 0x02 });
+            expectBytes (ToBinary::convert (std::vector<int> { 1, -2, 3 }), { 0x03, 0x02, 0x03, 0x06 });
+            expectBytes (ToBinary::convert (std::optional<int> {}), { 0x00 });
+            expectBytes (ToBinary::convert (std::optional<int> { 5 }), { 0x01, 0x0a });
+
+            // The version header holds the zigzag-encoded version plus one
+            expectBytes (ToBinary::convert (BinarySerialisationTestVersioned { 1, 2, 3, 4 }), { 0x07, 0x02, 0x04, 0x06, 0x08 });
+        }
+
+        beginTest ("Primitive round trips");
+        {
+            expectRoundTrip (true);
+            expectRoundTrip (std::numeric_limits<int8>::min());
+            expectRoundTrip (std::numeric_limits<int8>::max());
+            expectRoundTrip (std::numeric_limits<uint16>::max());
+            expectRoundTrip (std::numeric_limits<int>::min());
+            expectRoundTrip (std::numeric_limits<int64>::min());
+            expectRoundTrip (std::numeric_limits<int64>::max());
+            expectRoundTrip (std::numeric_limits<uint64>::max());
+            expectRoundTrip (3.25f);
+            expectRoundTrip (-1.0e300);
+            expectRoundTrip (std::numeric_limits<double>::infinity());
+            expectRoundTrip (String());
+            expectRoundTrip (String (CharPointer_UTF8 ("\xc3\xa9t\xc3\xa9 \xe2\x82\xac")));
+            expectRoundTrip (std::string ("hello world"));
+            expectRoundTrip (BinarySerialisationTestShape::square);
+        }
+
+        beginTest ("Structure round trips");
+        {
+            const auto item = makeItem (5);
+            const auto encoded = ToBinary::convert (item);
+
+            expect (encoded.has_value());
+            expect (FromBinary::convert<BinarySerialisationTestItem> (*encoded) == item);
+
+            std::vector<BinarySerialisationTestItem> items;
+
+            for (auto i = 0; i < 20; ++i)
+                items.push_back (makeItem (i));
+
+            expectRoundTrip (items);
+
+            // Writing to a stream appends, and produces the same bytes as a MemoryBlock conversion
+            MemoryOutputStream stream;
+            stream.writeByte (0x55);
+            expect (ToBinary::convert (item, stream));
+            expect (stream.getDataSize() == encoded->getSize() + 1);
+            expect (std::memcmp (addBytesToPointer (stream.getData(), 1), encoded->getData(), encoded->getSize()) == 0);
+
+            // The binary form should be much smaller than the equivalent JSON
+            const auto json = JSON::toString (*ToVar::convert (items), JSON::FormatOptions{}.withSpacing (JSON::Spacing::none));
+            expect (ToBinary::convert (items)->getSize() * 2 < json.getNumBytesAsUTF8());
+        }
+
+        beginTest ("var round trips");
+        {
+            auto object = JSONUtils::makeObject ({ { "int", 1 },
+                                                   { "int64", (int64) 1 << 40 },
+                                                   { "double", 0.5 },
+                                                   { "string", "text" },
+                                                   { "bool", true },
+                                                   { "void", var() },
+                                                   { "array", Array<var> { 1, "two", Array<var> { 3.0 } } },
+                                                   { "object", JSONUtils::makeObject ({ { "nested", false } }) } });
+
+            const auto decoded = FromBinary::convert<var> (*ToBinary::convert (object));
+            expect (decoded.has_value() && JSONUtils::deepEqual (*decoded, object));
+            expect (decoded->getProperty ("int", {}).isInt());
+            expect (decoded->getProperty ("int64", {}).isInt64());
+            expect (decoded->getProperty ("double", {}).isDouble());
+            expect (decoded->getProperty ("bool", {}).isBool());
+
+            const auto undefined = FromBinary::convert<var> (*ToBinary::convert (var::undefined()));
+            expect (undefined.has_value() && undefined->isUndefined());
+
+            const MemoryBlock block ("\x00\x01\x02\xff", 4);
+            const auto binary = FromBinary::convert<var> (*ToBinary::convert (var (block)));
+            expect (binary.has_value() && binary->getBinaryData() != nullptr && *binary->getBinaryData() == block);
+        }
+
+        beginTest ("Versioning");
+        {
+            const BinarySerialisationTestVersioned value { 1, 2, 3, 4 };
+
+            expect (FromBinary::convert<BinarySerialisationTestVersioned> (*ToBinary::convert (value)) == value);
+            expect (! ToBinary::convert (value, ToBinary::Options{}.withExplicitVersion (4)).has_value());
+
+            const auto checkVersion = [&] (std::optional<int> version, BinarySerialisationTestVersioned expected)
+            {
+                const auto encoded = ToBinary::convert (value, ToBinary::Options{}.withExplicitVersion (version));
+                expect (encoded.has_value());
+                expect (FromBinary::convert<BinarySerialisationTestVersioned> (*encoded) == expected);
+            };
+
+            checkVersion (3, { 1, 2, 3, 4 });
+            checkVersion (2, { 1, 2, 3, 0 });
+            checkVersion (1, { 1, 2, 0, 0 });
+            checkVersion (0, { 1, 0, 0, 0 });
+            checkVersion (std::nullopt, { 1, 0, 0, 0 });
+
+            // Data written by a newer version of the type can't be read
+            auto newer = *ToBinary::convert (value);
+            newer[0] = 0x09;
+            expect (! FromBinary::convert<BinarySerialisationTestVersioned> (newer).has_value());
+
+            // Nested objects are written with their own versions
+            const BinarySerialisationTestNestedVersions nested { value, { value, value } };
+            expect (FromBinary::convert<BinarySerialisationTestNestedVersions> (*ToBinary::convert (nested)) == nested);
+        }
+
+        beginTest ("Malformed input");
+        {
+            const auto encoded = *ToBinary::convert (makeItem (3));
+
+            for (size_t i = 0; i < encoded.getSize(); ++i)
+                expect (! FromBinary::convert<BinarySerialisationTestItem> (encoded.getData(), i).has_value());
+
+            MemoryBlock trailing (encoded);
+            trailing.append ("\x00", 1);
+            expect (! FromBinary::convert<BinarySerialisationTestItem> (trailing).has_value());
+
+            expect (! FromBinary::convert<bool> (MemoryBlock ("\x02", 1)).has_value());
+            expect (! FromBinary::convert<int8> (*ToBinary::convert (300)).has_value());
+            expect (! FromBinary::convert<uint8> (*ToBinary::convert (256)).has_value());
+            expect (! FromBinary::convert<uint64> (MemoryBlock ("\xff\xff\xff\xff\xff\xff\xff\xff\xff\x02", 10)).has_value());
+            expect (! FromBinary::convert<String> (MemoryBlock ("\x01\xc3", 2)).has_value());
+            expect (! FromBinary::convert<std::vector<int>> (MemoryBlock ("\xff\xff\xff\xff\x0f\x00", 6)).has_value());
+            expect (! FromBinary::convert<var> (MemoryBlock ("\x7f", 1)).has_value());
+            expect (! FromBinary::convert<int> (nullptr, 0).has_value());
+        }
+
+        beginTest ("Deeply nested vars");
+        {
+            const auto nestedArrays = [] (int depth)
+            {
+                MemoryOutputStream stream;
+
+                for (auto i = 0; i < depth; ++i)
+                    stream.write ("\x08\x01", 2);
+
+                stream.writeByte (0);
+                return stream.getMemoryBlock();
+            };
+
+            const auto decoded = FromBinary::convert<var> (nestedArrays (255));
+            expect (decoded.has_value());
+
+            auto depth = 0;
+
+            for (auto v = *decoded; v.isArray(); v = v[0])
+                ++depth;
+
+            expectEquals (depth, 255);
+
+            expect (! FromBinary::convert<var> (nestedArrays (256)).has_value());
+            expect (! FromBinary::convert<var> (nestedArrays (100000)).has_value());
+        }
+    }
+
+private:
+    static BinarySerialisationTestItem makeItem (int index)
+    {
+        BinarySerialisationTestItem item;
+        item.name = "item " + std::to_string (index);
+        item.shape = (BinarySerialisationTestShape) (index % 3);
+
+        for (auto i = 0; i < index; ++i)
+            item.points.push_back ({ (float) i * 0.5f, (float) -i });
+
+        if (index % 2 == 0)
+            item.comment = "comment " + String (index);
+
+        item.tags = { { "first", index }, { "second", (int64) index << 35 } };
+        item.ids = { index, -index, 1000 * index };
+        item.weights = { 0.25 * index, -1.0 };
+        item.labels = { "a", "b", String (index) };
+        item.colour = { 0xff, (uint8) index, 0x00, 0x80 };
+        item.extra = JSONUtils::makeObject ({ { "index", index }, { "list", Array<var> { 1, "two" } } });
+        return item;
+    }
+
+    template <typename T>
+    void expectRoundTrip (const T& value)
+    {
+        const auto encoded = ToBinary::convert (value);
+        expect (encoded.has_value());
+
+        const auto decoded = FromBinary::convert<T> (*encoded);
+        expect (decoded == value);
+    }
+
+    void expectBytes (const std::optional<MemoryBlock>& block, std::initializer_list<uint8> expected)
+    {
+        expect (block.has_value());
+
+        if (block.has_value())
+            expect (*block == MemoryBlock (std::data (expected), expected.size()), String::toHexString (block->getData(), (int) block->getSize()));
+    }
+};
+
+static BinarySerialisationTest binarySerialisationTest;
+
+} // namespace juce
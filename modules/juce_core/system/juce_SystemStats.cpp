@@ -148,7 +148,7 @@ struct CPUInformation
          hasAVX512F  = false, hasAVX512BW   = false, hasAVX512CD   = false,
          hasAVX512DQ = false, hasAVX512ER   = false, hasAVX512IFMA = false,
          hasAVX512PF = false, hasAVX512VBMI = false, hasAVX512VL   = false,
-         hasAVX512VPOPCNTDQ = false,
+         hasAVX512VPOPCNTDQ = false, hasSHA = false,
          hasNeon = false;
 };
 
@@ -182,6 +182,7 @@ bool SystemStats::hasAVX512PF() noexcept        { return getCPUInformation().has
 bool SystemStats::hasAVX512VBMI() noexcept      { return getCPUInformation().hasAVX512VBMI; }
 bool SystemStats::hasAVX512VL() noexcept        { return getCPUInformation().hasAVX512VL; }
 bool SystemStats::hasAVX512VPOPCNTDQ() noexcept { return getCPUInformation().hasAVX512VPOPCNTDQ; }
+bool SystemStats::hasSHA() noexcept             { return getCPUInformation().hasSHA; }
 bool SystemStats::hasNeon() noexcept            { return getCPUInformation().hasNeon; }
 
 
@@ -242,10 +242,13 @@ void MD5::processStream (InputStream& input, int64 numBytesToRead)
     if (numBytesToRead < 0)
         numBytesToRead = std::numeric_limits<int64>::max();
 
+    // A large buffer keeps the per-read overhead of file streams small
+    constexpr int bufferSize = 65536;
+    HeapBlock<uint8_t> tempBuffer (bufferSize);
+
     while (numBytesToRead > 0)
     {
-        uint8_t tempBuffer[512];
-        auto bytesRead = input.read (tempBuffer, (int) jmin (numBytesToRead, (int64) sizeof (tempBuffer)));
+        auto bytesRead = input.read (tempBuffer, (int) jmin (numBytesToRead, (int64) bufferSize));
 
         if (bytesRead <= 0)
             break;
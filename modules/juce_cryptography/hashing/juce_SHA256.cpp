@@ -35,51 +35,31 @@
 namespace juce
 {
 
+#if JUCE_INTEL && (JUCE_MSVC || JUCE_GCC || JUCE_CLANG)
+ #define JUCE_SHA256_USE_SHA_EXTENSIONS 1
+ #include <immintrin.h>
+
+ #if JUCE_MSVC
+  #define JUCE_SHA256_TARGET_SHA_EXTENSIONS
+ #else
+  #define JUCE_SHA256_TARGET_SHA_EXTENSIONS __attribute__ ((target ("sha,sse4.1")))
+ #endif
+#elif JUCE_ARM && (defined (__ARM_FEATURE_SHA2) || defined (__ARM_FEATURE_CRYPTO))
+ #define JUCE_SHA256_USE_ARM_CRYPTO 1
+ #if JUCE_MSVC
+  #include <arm64_neon.h>
+ #else
+  #include <arm_neon.h>
+ #endif
+#endif
+
 struct SHA256Processor
 {
-    // expects 64 bytes of data
-    void processFullBlock (const void* data) noexcept
+    // expects numBlocks * 64 bytes of data
+    void processFullBlocks (const void* data, size_t numBlocks) noexcept
     {
-        const uint32_t constants[] =
-        {
-            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-        };
-
-        uint32_t block[16], s[8];
-        memcpy (s, state, sizeof (s));
-
-        auto d = static_cast<const uint8_t*> (data);
-
-        for (auto& b : block)
-        {
-            b = (uint32_t (d[0]) << 24) | (uint32_t (d[1]) << 16) | (uint32_t (d[2]) << 8) | d[3];
-            d += 4;
-        }
-
-        auto convolve = [&] (uint32_t i, uint32_t j)
-        {
-            s[(7 - i) & 7] += S1 (s[(4 - i) & 7]) + ch (s[(4 - i) & 7], s[(5 - i) & 7], s[(6 - i) & 7]) + constants[i + j]
-                                 + (j != 0 ? (block[i & 15] += s1 (block[(i - 2) & 15]) + block[(i - 7) & 15] + s0 (block[(i - 15) & 15]))
-                                           : block[i]);
-            s[(3 - i) & 7] += s[(7 - i) & 7];
-            s[(7 - i) & 7] += S0 (s[(0 - i) & 7]) + maj (s[(0 - i) & 7], s[(1 - i) & 7], s[(2 - i) & 7]);
-        };
-
-        for (uint32_t j = 0; j < 64; j += 16)
-            for (uint32_t i = 0; i < 16; ++i)
-                convolve (i, j);
-
-        for (int i = 0; i < 8; ++i)
-            state[i] += s[i];
-
-        length += 64;
+        getBlockFunction() (state, static_cast<const uint8_t*> (data), numBlocks);
+        length += (uint64_t) numBlocks * 64;
     }
 
     void processFinalBlock (const void* data, uint32_t numBytes) noexcept
@@ -102,10 +82,7 @@ struct SHA256Processor
 
         jassert (numBytes == 64 || numBytes == 128);
 
-        processFullBlock (finalBlocks);
-
-        if (numBytes > 64)
-            processFullBlock (finalBlocks + 64);
+        getBlockFunction() (state, finalBlocks, numBytes / 64);
     }
 
     void copyResult (uint8_t* result) const noexcept
@@ -119,34 +96,210 @@ struct SHA256Processor
         }
     }
 
+    void processBlock (const void* data, size_t numBytes, uint8_t* result) noexcept
+    {
+        auto numFullBlocks = numBytes / 64;
+        processFullBlocks (data, numFullBlocks);
+        processFinalBlock (static_cast<const uint8_t*> (data) + numFullBlocks * 64, (uint32_t) (numBytes % 64));
+        copyResult (result);
+    }
+
     void processStream (InputStream& input, int64_t numBytesToRead, uint8_t* result)
     {
         if (numBytesToRead < 0)
             numBytesToRead = std::numeric_limits<int64_t>::max();
 
+        // Reading in large chunks lets the whole blocks be hashed straight from the buffer
+        constexpr int bufferSize = 65536;
+        HeapBlock<uint8_t> buffer (bufferSize);
+
         for (;;)
         {
-            uint8_t buffer[64];
-            auto bytesRead = input.read (buffer, (int) jmin (numBytesToRead, (int64_t) sizeof (buffer)));
+            auto bytesToRead = (int) jmin (numBytesToRead, (int64_t) bufferSize);
+            auto bytesRead = 0;
 
-            if (bytesRead < (int) sizeof (buffer))
+            while (bytesRead < bytesToRead)
             {
-                processFinalBlock (buffer, (unsigned int) bytesRead);
-                break;
+                auto numRead = input.read (buffer + bytesRead, bytesToRead - bytesRead);
+
+                if (numRead <= 0)
+                    break;
+
+                bytesRead += numRead;
             }
 
-            numBytesToRead -= (int64_t) sizeof (buffer);
-            processFullBlock (buffer);
+            numBytesToRead -= bytesRead;
+
+            auto numFullBlocks = (size_t) bytesRead / 64;
+            processFullBlocks (buffer, numFullBlocks);
+
+            if (bytesRead < bufferSize)
+            {
+                processFinalBlock (buffer + numFullBlocks * 64, (uint32_t) bytesRead % 64);
+                break;
+            }
         }
 
         copyResult (result);
     }
 
 private:
+    using BlockFunction = void (*) (uint32_t*, const uint8_t*, size_t) noexcept;
+
     uint32_t state[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
                           0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
     uint64_t length = 0;
 
+    static constexpr uint32_t constants[] =
+    {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    static BlockFunction getBlockFunction() noexcept
+    {
+       #if JUCE_SHA256_USE_SHA_EXTENSIONS
+        static const auto function = SystemStats::hasSHA() && SystemStats::hasSSE41() ? processBlocksWithSHAExtensions
+                                                                                       : processBlocksPortable;
+        return function;
+       #elif JUCE_SHA256_USE_ARM_CRYPTO
+        return processBlocksWithARMCrypto;
+       #else
+        return processBlocksPortable;
+       #endif
+    }
+
+    static void processBlocksPortable (uint32_t* state, const uint8_t* d, size_t numBlocks) noexcept
+    {
+        for (; numBlocks > 0; --numBlocks)
+        {
+            uint32_t block[16], s[8];
+            memcpy (s, state, sizeof (s));
+
+            for (auto& b : block)
+            {
+                b = (uint32_t (d[0]) << 24) | (uint32_t (d[1]) << 16) | (uint32_t (d[2]) << 8) | d[3];
+                d += 4;
+            }
+
+            auto convolve = [&] (uint32_t i, uint32_t j)
+            {
+                s[(7 - i) & 7] += S1 (s[(4 - i) & 7]) + ch (s[(4 - i) & 7], s[(5 - i) & 7], s[(6 - i) & 7]) + constants[i + j]
+                                     + (j != 0 ? (block[i & 15] += s1 (block[(i - 2) & 15]) + block[(i - 7) & 15] + s0 (block[(i - 15) & 15]))
+                                               : block[i]);
+                s[(3 - i) & 7] += s[(7 - i) & 7];
+                s[(7 - i) & 7] += S0 (s[(0 - i) & 7]) + maj (s[(0 - i) & 7], s[(1 - i) & 7], s[(2 - i) & 7]);
+            };
+
+            for (uint32_t j = 0; j < 64; j += 16)
+                for (uint32_t i = 0; i < 16; ++i)
+                    convolve (i, j);
+
+            for (int i = 0; i < 8; ++i)
+                state[i] += s[i];
+        }
+    }
+
+   #if JUCE_SHA256_USE_SHA_EXTENSIONS
+    JUCE_SHA256_TARGET_SHA_EXTENSIONS
+    static void processBlocksWithSHAExtensions (uint32_t* state, const uint8_t* d, size_t numBlocks) noexcept
+    {
+        const auto byteSwapMask = _mm_set_epi64x (0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+
+        // The SHA instructions work on the state rearranged as ABEF and CDGH
+        auto dcba = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i*) state), 0xb1);
+        auto hgfe = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i*) (state + 4)), 0x1b);
+        auto abef = _mm_alignr_epi8 (dcba, hgfe, 8);
+        auto cdgh = _mm_blend_epi16 (hgfe, dcba, 0xf0);
+
+        for (; numBlocks > 0; --numBlocks, d += 64)
+        {
+            const auto abefSaved = abef, cdghSaved = cdgh;
+            __m128i w[4];
+
+            // Each iteration performs four rounds, while computing the message schedule
+            // for the rounds ahead.
+            for (int i = 0; i < 16; ++i)
+            {
+                if (i < 4)
+                    w[i] = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (d + 16 * i)), byteSwapMask);
+
+                const auto current = w[i & 3];
+                auto message = _mm_add_epi32 (current, _mm_loadu_si128 ((const __m128i*) (constants + 4 * i)));
+                cdgh = _mm_sha256rnds2_epu32 (cdgh, abef, message);
+
+                if (i >= 3 && i < 15)
+                {
+                    auto& next = w[(i + 1) & 3];
+                    next = _mm_add_epi32 (next, _mm_alignr_epi8 (current, w[(i + 3) & 3], 4));
+                    next = _mm_sha256msg2_epu32 (next, current);
+                }
+
+                message = _mm_shuffle_epi32 (message, 0x0e);
+                abef = _mm_sha256rnds2_epu32 (abef, cdgh, message);
+
+                if (i >= 1 && i < 13)
+                    w[(i + 3) & 3] = _mm_sha256msg1_epu32 (w[(i + 3) & 3], current);
+            }
+
+            abef = _mm_add_epi32 (abef, abefSaved);
+            cdgh = _mm_add_epi32 (cdgh, cdghSaved);
+        }
+
+        auto feba = _mm_shuffle_epi32 (abef, 0x1b);
+        auto dchg = _mm_shuffle_epi32 (cdgh, 0xb1);
+        _mm_storeu_si128 ((__m128i*) state,       _mm_blend_epi16 (feba, dchg, 0xf0));
+        _mm_storeu_si128 ((__m128i*) (state + 4), _mm_alignr_epi8 (dchg, feba, 8));
+    }
+   #endif
+
+   #if JUCE_SHA256_USE_ARM_CRYPTO
+    static void processBlocksWithARMCrypto (uint32_t* state, const uint8_t* d, size_t numBlocks) noexcept
+    {
+        auto abcd = vld1q_u32 (state);
+        auto efgh = vld1q_u32 (state + 4);
+
+        for (; numBlocks > 0; --numBlocks, d += 64)
+        {
+            const auto abcdSaved = abcd, efghSaved = efgh;
+            uint32x4_t w[4];
+
+            for (int i = 0; i < 4; ++i)
+                w[i] = vreinterpretq_u32_u8 (vrev32q_u8 (vld1q_u8 (d + 16 * i)));
+
+            // Each iteration performs four rounds, while computing the message schedule
+            // for the rounds ahead.
+            for (int i = 0; i < 16; ++i)
+            {
+                auto& current = w[i & 3];
+                const auto message = vaddq_u32 (current, vld1q_u32 (constants + 4 * i));
+
+                if (i < 12)
+                    current = vsha256su0q_u32 (current, w[(i + 1) & 3]);
+
+                const auto abcdPrevious = abcd;
+                abcd = vsha256hq_u32 (abcd, efgh, message);
+                efgh = vsha256h2q_u32 (efgh, abcdPrevious, message);
+
+                if (i < 12)
+                    current = vsha256su1q_u32 (current, w[(i + 2) & 3], w[(i + 3) & 3]);
+            }
+
+            abcd = vaddq_u32 (abcd, abcdSaved);
+            efgh = vaddq_u32 (efgh, efghSaved);
+        }
+
+        vst1q_u32 (state, abcd);
+        vst1q_u32 (state + 4, efgh);
+    }
+   #endif
+
     static uint32_t rotate (uint32_t x, uint32_t y) noexcept            { return (x >> y) | (x << (32 - y)); }
     static uint32_t ch  (uint32_t x, uint32_t y, uint32_t z) noexcept   { return z ^ ((y ^ z) & x); }
     static uint32_t maj (uint32_t x, uint32_t y, uint32_t z) noexcept   { return y ^ ((y ^ z) & (x ^ y)); }
@@ -200,11 +353,48 @@ SHA256::SHA256 (CharPointer_UTF8 utf8) noexcept
     process (utf8.getAddress(), utf8.sizeInBytes() - 1);
 }
 
+Array<SHA256> SHA256::hashFiles (const Array<File>& files, int numThreads)
+{
+    Array<SHA256> results;
+    results.resize (files.size());
+
+    if (numThreads <= 0)
+        numThreads = SystemStats::getNumCpus();
+
+    numThreads = jmin (numThreads, files.size());
+
+    if (numThreads <= 1)
+    {
+        for (int i = 0; i < files.size(); ++i)
+            results.getReference (i) = SHA256 (files.getReference (i));
+
+        return results;
+    }
+
+    std::atomic<int> nextFile { 0 };
+
+    auto hashRemainingFiles = [&]
+    {
+        for (int i = nextFile++; i < files.size(); i = nextFile++)
+            results.getReference (i) = SHA256 (files.getReference (i));
+    };
+
+    ThreadPool pool (ThreadPoolOptions{}.withThreadName ("SHA256 hashing")
+                                        .withNumberOfThreads (numThreads - 1));
+
+    for (int i = 1; i < numThreads; ++i)
+        pool.addJob (hashRemainingFiles);
+
+    hashRemainingFiles();
+    pool.removeAllJobs (false, -1);
+
+    return results;
+}
+
 void SHA256::process (const void* data, size_t numBytes)
 {
-    MemoryInputStream m (data, numBytes, false);
     SHA256Processor processor;
-    processor.processStream (m, -1, result);
+    processor.processBlock (data, numBytes, result);
 }
 
 MemoryBlock SHA256::getRawData() const
@@ -258,6 +448,63 @@ public:
         test ("", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
         test ("The quick brown fox jumps over the lazy dog",  "d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592");
         test ("The quick brown fox jumps over the lazy dog.", "ef537f25c895bfa782526529a9b63d97aa631564d5d789c2b765448c8635fb6c");
+        test ("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+        beginTest ("Large inputs");
+        {
+            MemoryBlock data (1000000);
+            memset (data.getData(), 'a', data.getSize());
+            expectEquals (SHA256 (data).toHexString(), String ("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+
+            // Stream reads that straddle the internal buffer must give the same result
+            // as hashing the whole block at once.
+            Random r (9412);
+
+            for (auto size : { 63, 64, 65, 65535, 65536, 65537, 200003 })
+            {
+                MemoryBlock block ((size_t) size);
+                r.fillBitsRandomly (block.getData(), block.getSize());
+
+                const SHA256 direct (block);
+
+                for (auto limit : { -1, size / 2 })
+                {
+                    MemoryInputStream m (block, false);
+                    const SHA256 fromStream (m, limit);
+
+                    if (limit < 0)
+                        expect (fromStream == direct);
+                    else
+                        expect (fromStream == SHA256 (block.getData(), (size_t) limit));
+                }
+            }
+        }
+
+        beginTest ("Hashing multiple files");
+        {
+            TemporaryFile tempFiles[5];
+            Array<File> files;
+            Random r (123);
+
+            for (auto& temp : tempFiles)
+            {
+                MemoryBlock block ((size_t) r.nextInt (100000));
+                r.fillBitsRandomly (block.getData(), block.getSize());
+                temp.getFile().replaceWithData (block.getData(), block.getSize());
+                files.add (temp.getFile());
+            }
+
+            files.add (File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("missing", ".bin"));
+
+            for (auto numThreads : { 1, 3, 0 })
+            {
+                const auto hashes = SHA256::hashFiles (files, numThreads);
+                expectEquals (hashes.size(), files.size());
+
+                for (int i = 0; i < files.size(); ++i)
+                    expect (hashes[i] == SHA256 (files[i]));
+            }
+        }
     }
 };
 
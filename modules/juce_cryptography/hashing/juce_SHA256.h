@@ -94,6 +94,17 @@ public:
     */
     explicit SHA256 (CharPointer_UTF8 utf8Text) noexcept;
 
+    /** Generates the hashes of a set of files, hashing several files at once on a
+        pool of background threads.
+
+        The results are returned in the same order as the files that were passed in.
+        Any file that can't be opened will produce an uninitialised hash, just as the
+        File constructor does.
+
+        If numThreads is 0 or less, a thread is used for each of the CPU's cores.
+    */
+    static Array<SHA256> hashFiles (const Array<File>& files, int numThreads = 0);
+
     //==============================================================================
     /** Returns the hash as a 32-byte block of data. */
     MemoryBlock getRawData() const;
@@ -60,17 +60,51 @@ struct UndoManager::ActionSet
 
     int getTotalSize() const
     {
-        int total = 0;
+        return totalSize;
+    }
 
-        for (auto* a : actions)
-            total += a->getSizeInUnits();
+    void add (std::unique_ptr<UndoableAction> action)
+    {
+        totalSize += action->getSizeInUnits();
+        actions.add (std::move (action));
+    }
+
+    /*  Tries to merge a newly-performed action into one of the most recent actions in this
+        set. If it can't be merged with the last action, earlier actions are also tried, as
+        long as the new action is independent of every action that it would be moved in front
+        of. Only a few actions are searched, so that transactions containing large numbers of
+        unrelated actions don't make this quadratic.
+    */
+    bool coalesce (UndoableAction& nextAction)
+    {
+        constexpr int maxActionsToSearch = 8;
+
+        for (int i = actions.size(); --i >= jmax (0, actions.size() - maxActionsToSearch);)
+        {
+            auto* previous = actions.getUnchecked (i);
+
+            if (auto* coalesced = previous->createCoalescedAction (&nextAction))
+            {
+                totalSize += coalesced->getSizeInUnits() - previous->getSizeInUnits();
+                actions.set (i, coalesced);
+                return true;
+            }
 
-        return total;
+            if (! nextAction.isIndependentOf (previous))
+                break;
+        }
+
+        return false;
     }
 
     OwnedArray<UndoableAction> actions;
     String name;
     Time time { Time::getCurrentTime() };
+
+private:
+    // The sizes are recorded as actions are added, so that the total stays consistent even
+    // if an action's getSizeInUnits() changes later on
+    int totalSize = 0;
 };
 
 //==============================================================================
@@ -134,27 +168,19 @@ bool UndoManager::perform (UndoableAction* newAction)
         {
             auto* actionSet = getCurrentSet();
 
-            if (actionSet != nullptr && ! newTransaction)
-            {
-                if (auto* lastAction = actionSet->actions.getLast())
-                {
-                    if (auto coalescedAction = lastAction->createCoalescedAction (action.get()))
-                    {
-                        action.reset (coalescedAction);
-                        totalUnitsStored -= lastAction->getSizeInUnits();
-                        actionSet->actions.removeLast();
-                    }
-                }
-            }
-            else
+            if (actionSet == nullptr || newTransaction)
             {
                 actionSet = new ActionSet (newTransactionName);
                 transactions.insert (nextIndex, actionSet);
                 ++nextIndex;
             }
 
-            totalUnitsStored += action->getSizeInUnits();
-            actionSet->actions.add (std::move (action));
+            const auto previousSize = actionSet->getTotalSize();
+
+            if (! actionSet->coalesce (*action))
+                actionSet->add (std::move (action));
+
+            totalUnitsStored += actionSet->getTotalSize() - previousSize;
             newTransaction = false;
 
             moveFutureTransactionsToStash();
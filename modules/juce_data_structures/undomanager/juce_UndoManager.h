@@ -50,6 +50,11 @@ namespace juce
     together - all actions performed between calls to beginNewTransaction() are
     grouped together and are all undone/redone as a group.
 
+    Where possible, actions within a transaction are merged together as they're performed,
+    which keeps the history small when something like a drag produces a long stream of
+    tiny changes. See UndoableAction::createCoalescedAction() and
+    UndoableAction::isIndependentOf() for details.
+
     The UndoManager is a ChangeBroadcaster, so listeners can register to be told
     when actions are performed or undone.
 
@@ -36,5 +36,6 @@ namespace juce
 {
 
 UndoableAction* UndoableAction::createCoalescedAction ([[maybe_unused]] UndoableAction* nextAction)  { return nullptr; }
+bool UndoableAction::isIndependentOf ([[maybe_unused]] UndoableAction* otherAction)                  { return false; }
 
 } // namespace juce
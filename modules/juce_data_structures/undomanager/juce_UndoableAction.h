@@ -102,8 +102,26 @@ public:
         this one followed by the supplied action.
 
         If it's not possible to merge the two actions, the method should return a nullptr.
+
+        @see isIndependentOf
     */
     virtual UndoableAction* createCoalescedAction (UndoableAction* nextAction);
+
+    /** Returns true if this action doesn't interact with another action, so that performing
+        the two in either order would have the same effect.
+
+        When the UndoManager can't coalesce a newly-performed action with the previous action
+        in the transaction, it uses this to decide whether it may look further back for an
+        action to coalesce it with. This lets interleaved changes, such as a drag that keeps
+        updating two different properties, collapse into a single action per property rather
+        than storing every step.
+
+        The UndoManager calls this on the new action, passing each earlier action that it
+        would have to be moved in front of. The default implementation returns false.
+
+        @see createCoalescedAction
+    */
+    virtual bool isIndependentOf (UndoableAction* otherAction);
 };
 
 } // namespace juce
@@ -467,6 +467,18 @@ public:
             return nullptr;
         }
 
+        bool isIndependentOf (UndoableAction* otherAction) override
+        {
+            // Adding or removing a property changes the order of the target's properties
+            if (isAddingNewProperty || isDeletingProperty)
+                return false;
+
+            if (auto* other = dynamic_cast<SetPropertyAction*> (otherAction))
+                return other->target != target || other->name != name;
+
+            return false;
+        }
+
     private:
         const Ptr target;
         const Identifier name;
@@ -1252,6 +1264,43 @@ public:
                 expectEquals (lines[numLines - 1], "<Test number=\"" + test.second + "\"/>");
             }
         }
+
+        {
+            beginTest ("Undo coalescing");
+
+            const Identifier x ("x"), y ("y");
+            ValueTree tree ("Test");
+            tree.setProperty (x, 0, nullptr);
+            tree.setProperty (y, 0, nullptr);
+
+            UndoManager undoManager;
+            undoManager.beginNewTransaction();
+
+            // Interleaved changes to independent properties are merged into one action each
+            for (int i = 1; i <= 1000; ++i)
+            {
+                tree.setProperty (x, i, &undoManager);
+                tree.setProperty (y, -i, &undoManager);
+            }
+
+            expectEquals (undoManager.getNumActionsInCurrentTransaction(), 2);
+
+            // Adding a child can't be reordered with the property changes, so a later change
+            // to x mustn't be merged into the earlier one
+            tree.appendChild (ValueTree ("Child"), &undoManager);
+            tree.setProperty (x, 5000, &undoManager);
+            expectEquals (undoManager.getNumActionsInCurrentTransaction(), 4);
+
+            expect (undoManager.undo());
+            expect (tree.getProperty (x) == var (0));
+            expect (tree.getProperty (y) == var (0));
+            expectEquals (tree.getNumChildren(), 0);
+
+            expect (undoManager.redo());
+            expect (tree.getProperty (x) == var (5000));
+            expect (tree.getProperty (y) == var (-1000));
+            expectEquals (tree.getNumChildren(), 1);
+        }
     }
 };
 
@@ -152,6 +152,57 @@ ConvolutionMessageQueue::~ConvolutionMessageQueue() noexcept
 ConvolutionMessageQueue::ConvolutionMessageQueue (ConvolutionMessageQueue&&) noexcept = default;
 ConvolutionMessageQueue& ConvolutionMessageQueue::operator= (ConvolutionMessageQueue&&) noexcept = default;
 
+//==============================================================================
+// After each FFT, this function is called to allow convolution to be performed with only 4 SIMD functions calls.
+static void prepareForConvolution (float* samples, size_t fftSize) noexcept
+{
+    auto FFTSizeDiv2 = fftSize / 2;
+
+    for (size_t i = 0; i < FFTSizeDiv2; i++)
+        samples[i] = samples[i << 1];
+
+    samples[FFTSizeDiv2] = 0;
+
+    for (size_t i = 1; i < FFTSizeDiv2; i++)
+        samples[i + FFTSizeDiv2] = -samples[((fftSize - i) << 1) + 1];
+}
+
+// Does the convolution operation itself only on half of the frequency domain samples.
+static void convolutionProcessingAndAccumulate (const float* input, const float* impulse, float* output, size_t fftSize) noexcept
+{
+    auto FFTSizeDiv2 = fftSize / 2;
+
+    FloatVectorOperations::addWithMultiply      (output, input, impulse, static_cast<int> (FFTSizeDiv2));
+    FloatVectorOperations::subtractWithMultiply (output, &(input[FFTSizeDiv2]), &(impulse[FFTSizeDiv2]), static_cast<int> (FFTSizeDiv2));
+
+    FloatVectorOperations::addWithMultiply      (&(output[FFTSizeDiv2]), input, &(impulse[FFTSizeDiv2]), static_cast<int> (FFTSizeDiv2));
+    FloatVectorOperations::addWithMultiply      (&(output[FFTSizeDiv2]), &(input[FFTSizeDiv2]), impulse, static_cast<int> (FFTSizeDiv2));
+
+    output[fftSize] += input[fftSize] * impulse[fftSize];
+}
+
+// Undoes the re-organization of samples from the function prepareForConvolution.
+// Then takes the conjugate of the frequency domain first half of samples to fill the
+// second half, so that the inverse transform will return real samples in the time domain.
+static void updateSymmetricFrequencyDomainData (float* samples, size_t fftSize) noexcept
+{
+    auto FFTSizeDiv2 = fftSize / 2;
+
+    for (size_t i = 1; i < FFTSizeDiv2; i++)
+    {
+        samples[(fftSize - i) << 1] = samples[i];
+        samples[((fftSize - i) << 1) + 1] = -samples[FFTSizeDiv2 + i];
+    }
+
+    samples[1] = 0.f;
+
+    for (size_t i = 1; i < FFTSizeDiv2; i++)
+    {
+        samples[i << 1] = samples[(fftSize - i) << 1];
+        samples[(i << 1) + 1] = -samples[((fftSize - i) << 1) + 1];
+    }
+}
+
 //==============================================================================
 struct ConvolutionEngine
 {
@@ -204,7 +255,7 @@ struct ConvolutionEngine
                                          static_cast<int> (jmin (fftSize - blockSize, numSamples - currentPtr)));
 
             FFTTempObject->performRealOnlyForwardTransform (impulseResponse);
-            prepareForConvolution (impulseResponse);
+            prepareForConvolution (impulseResponse, fftSize);
 
             currentPtr += (fftSize - blockSize);
         }
@@ -249,7 +300,7 @@ struct ConvolutionEngine
             FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
 
             fftObject->performRealOnlyForwardTransform (inputSegmentData);
-            prepareForConvolution (inputSegmentData);
+            prepareForConvolution (inputSegmentData, fftSize);
 
             // Complex multiplication
             if (inputDataWasEmpty)
@@ -267,7 +318,8 @@ struct ConvolutionEngine
 
                     convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
                                                         buffersImpulseSegments[i].getWritePointer (0),
-                                                        outputTempData);
+                                                        outputTempData,
+                                                        fftSize);
                 }
             }
 
@@ -275,9 +327,10 @@ struct ConvolutionEngine
 
             convolutionProcessingAndAccumulate (inputSegmentData,
                                                 buffersImpulseSegments.front().getWritePointer (0),
-                                                outputData);
+                                                outputData,
+                                                fftSize);
 
-            updateSymmetricFrequencyDomainData (outputData);
+            updateSymmetricFrequencyDomainData (outputData, fftSize);
             fftObject->performRealOnlyInverseTransform (outputData);
 
             // Add overlap
@@ -337,7 +390,7 @@ struct ConvolutionEngine
                 FloatVectorOperations::copy (inputSegmentData, inputData, static_cast<int> (fftSize));
 
                 fftObject->performRealOnlyForwardTransform (inputSegmentData);
-                prepareForConvolution (inputSegmentData);
+                prepareForConvolution (inputSegmentData, fftSize);
 
                 // Complex multiplication
                 FloatVectorOperations::fill (outputTempData, 0, static_cast<int> (fftSize + 1));
@@ -353,16 +406,18 @@ struct ConvolutionEngine
 
                     convolutionProcessingAndAccumulate (buffersInputSegments[index].getWritePointer (0),
                                                         buffersImpulseSegments[i].getWritePointer (0),
-                                                        outputTempData);
+                                                        outputTempData,
+                                                        fftSize);
                 }
 
                 FloatVectorOperations::copy (outputData, outputTempData, static_cast<int> (fftSize + 1));
 
                 convolutionProcessingAndAccumulate (inputSegmentData,
                                                     buffersImpulseSegments.front().getWritePointer (0),
-                                                    outputData);
+                                                    outputData,
+                                                    fftSize);
 
-                updateSymmetricFrequencyDomainData (outputData);
+                updateSymmetricFrequencyDomainData (outputData, fftSize);
                 fftObject->performRealOnlyInverseTransform (outputData);
 
                 // Add overlap
@@ -384,56 +439,6 @@ struct ConvolutionEngine
         }
     }
 
-    // After each FFT, this function is called to allow convolution to be performed with only 4 SIMD functions calls.
-    void prepareForConvolution (float *samples) noexcept
-    {
-        auto FFTSizeDiv2 = fftSize / 2;
-
-        for (size_t i = 0; i < FFTSizeDiv2; i++)
-            samples[i] = samples[i << 1];
-
-        samples[FFTSizeDiv2] = 0;
-
-        for (size_t i = 1; i < FFTSizeDiv2; i++)
-            samples[i + FFTSizeDiv2] = -samples[((fftSize - i) << 1) + 1];
-    }
-
-    // Does the convolution operation itself only on half of the frequency domain samples.
-    void convolutionProcessingAndAccumulate (const float *input, const float *impulse, float *output)
-    {
-        auto FFTSizeDiv2 = fftSize / 2;
-
-        FloatVectorOperations::addWithMultiply      (output, input, impulse, static_cast<int> (FFTSizeDiv2));
-        FloatVectorOperations::subtractWithMultiply (output, &(input[FFTSizeDiv2]), &(impulse[FFTSizeDiv2]), static_cast<int> (FFTSizeDiv2));
-
-        FloatVectorOperations::addWithMultiply      (&(output[FFTSizeDiv2]), input, &(impulse[FFTSizeDiv2]), static_cast<int> (FFTSizeDiv2));
-        FloatVectorOperations::addWithMultiply      (&(output[FFTSizeDiv2]), &(input[FFTSizeDiv2]), impulse, static_cast<int> (FFTSizeDiv2));
-
-        output[fftSize] += input[fftSize] * impulse[fftSize];
-    }
-
-    // Undoes the re-organization of samples from the function prepareForConvolution.
-    // Then takes the conjugate of the frequency domain first half of samples to fill the
-    // second half, so that the inverse transform will return real samples in the time domain.
-    void updateSymmetricFrequencyDomainData (float* samples) noexcept
-    {
-        auto FFTSizeDiv2 = fftSize / 2;
-
-        for (size_t i = 1; i < FFTSizeDiv2; i++)
-        {
-            samples[(fftSize - i) << 1] = samples[i];
-            samples[((fftSize - i) << 1) + 1] = -samples[FFTSizeDiv2 + i];
-        }
-
-        samples[1] = 0.f;
-
-        for (size_t i = 1; i < FFTSizeDiv2; i++)
-        {
-            samples[i << 1] = samples[(fftSize - i) << 1];
-            samples[(i << 1) + 1] = -samples[((fftSize - i) << 1) + 1];
-        }
-    }
-
     //==============================================================================
     const size_t blockSize;
     const size_t fftSize;
@@ -1300,4 +1305,348 @@ int Convolution::getCurrentIRSize() const { return pimpl->getCurrentIRSize(); }
 
 int Convolution::getLatency() const { return pimpl->getLatency(); }
 
+//==============================================================================
+// Uniform partitioned convolution with a matrix of impulse responses, using the same
+// zero-latency scheme as ConvolutionEngine. Each input is transformed once per block,
+// the products are accumulated per output in the frequency domain, and each output is
+// transformed back once per block.
+class MatrixConvolutionEngine
+{
+public:
+    MatrixConvolutionEngine (const AudioBuffer<float>& impulseResponses,
+                             size_t numInputsIn,
+                             size_t numOutputsIn,
+                             size_t maxBlockSize)
+        : numInputs (numInputsIn),
+          numOutputs (numOutputsIn),
+          irSize (impulseResponses.getNumSamples()),
+          blockSize ((size_t) nextPowerOfTwo ((int) maxBlockSize)),
+          fftSize (blockSize > 128 ? 2 * blockSize : 4 * blockSize),
+          spectrumSize (fftSize + 1),
+          fftOrder (roundToInt (std::log2 (fftSize))),
+          numSegments ((size_t) irSize / (fftSize - blockSize) + 1u),
+          numInputSegments (blockSize > 128 ? numSegments : 3 * numSegments),
+          impulseSpectra (numOutputs * numInputs * numSegments * spectrumSize),
+          inputSpectra (numInputs * numInputSegments * spectrumSize),
+          inputBuffers   ((int) numInputs,  (int) fftSize),
+          inputScratch   ((int) numInputs,  (int) fftSize * 2),
+          outputBuffers  ((int) numOutputs, (int) fftSize * 2),
+          outputTails    ((int) numOutputs, (int) spectrumSize),
+          outputOverlaps ((int) numOutputs, (int) fftSize)
+    {
+        jassert (impulseResponses.getNumChannels() == (int) (numInputs * numOutputs));
+
+        ffts.emplace_back (fftOrder);
+
+        const auto segmentLength = fftSize - blockSize;
+        HeapBlock<float> scratch (fftSize * 2);
+
+        for (size_t output = 0; output < numOutputs; ++output)
+        {
+            for (size_t input = 0; input < numInputs; ++input)
+            {
+                const auto* impulse = impulseResponses.getReadPointer ((int) (output * numInputs + input));
+
+                for (size_t segment = 0; segment < numSegments; ++segment)
+                {
+                    const auto offset = segment * segmentLength;
+
+                    FloatVectorOperations::clear (scratch.get(), fftSize * 2);
+                    FloatVectorOperations::copy (scratch.get(), impulse + offset, jmin (segmentLength, (size_t) irSize - offset));
+
+                    ffts.front().performRealOnlyForwardTransform (scratch);
+                    prepareForConvolution (scratch, fftSize);
+
+                    FloatVectorOperations::copy (getImpulseSpectrum (output, input, segment), scratch.get(), spectrumSize);
+                }
+            }
+        }
+
+        reset();
+    }
+
+    // An FFT can't be used by more than one thread at once, so each thread that takes part
+    // in the processing needs its own
+    void setNumThreads (int numThreads)
+    {
+        while ((int) ffts.size() < numThreads)
+            ffts.emplace_back (fftOrder);
+    }
+
+    void reset()
+    {
+        std::fill (inputSpectra.begin(), inputSpectra.end(), 0.0f);
+
+        inputBuffers.clear();
+        inputScratch.clear();
+        outputBuffers.clear();
+        outputTails.clear();
+        outputOverlaps.clear();
+
+        currentSegment = 0;
+        inputDataPos = 0;
+    }
+
+    void processSamples (const AudioBlock<const float>& input, AudioBlock<float>& output, juce::detail::RealtimeTaskPool* workers)
+    {
+        jassert (input.getNumChannels() >= numInputs && output.getNumChannels() >= numOutputs);
+
+        const auto numSamples = jmin (input.getNumSamples(), output.getNumSamples());
+        const auto indexStep = numInputSegments / numSegments;
+        size_t numSamplesProcessed = 0;
+
+        while (numSamplesProcessed < numSamples)
+        {
+            const auto inputDataWasEmpty = (inputDataPos == 0);
+            const auto numSamplesToProcess = jmin (numSamples - numSamplesProcessed, blockSize - inputDataPos);
+            const auto blockIsComplete = (inputDataPos + numSamplesToProcess == blockSize);
+
+            // All of the inputs are read before any outputs are written, so the input and
+            // output blocks may be the same
+            auto transformInput = [&] (int channelIndex, int threadIndex)
+            {
+                const auto channel = (size_t) channelIndex;
+                auto* inputData = inputBuffers.getWritePointer ((int) channel);
+                auto* scratch = inputScratch.getWritePointer ((int) channel);
+
+                FloatVectorOperations::copy (inputData + inputDataPos,
+                                             input.getChannelPointer (channel) + numSamplesProcessed,
+                                             numSamplesToProcess);
+                FloatVectorOperations::copy (scratch, inputData, fftSize);
+
+                ffts[(size_t) threadIndex].performRealOnlyForwardTransform (scratch);
+                prepareForConvolution (scratch, fftSize);
+
+                FloatVectorOperations::copy (getInputSpectrum (channel, currentSegment), scratch, spectrumSize);
+            };
+
+            auto renderOutput = [&] (int channelIndex, int threadIndex)
+            {
+                const auto channel = (size_t) channelIndex;
+                auto* outputData = outputBuffers.getWritePointer ((int) channel);
+                auto* tailData = outputTails.getWritePointer ((int) channel);
+                auto* overlapData = outputOverlaps.getWritePointer ((int) channel);
+
+                // The contribution of the earlier input blocks only changes once per block
+                if (inputDataWasEmpty)
+                {
+                    FloatVectorOperations::clear (tailData, spectrumSize);
+
+                    for (size_t in = 0; in < numInputs; ++in)
+                    {
+                        auto index = currentSegment;
+
+                        for (size_t segment = 1; segment < numSegments; ++segment)
+                        {
+                            index += indexStep;
+
+                            if (index >= numInputSegments)
+                                index -= numInputSegments;
+
+                            convolutionProcessingAndAccumulate (getInputSpectrum (in, index),
+                                                                getImpulseSpectrum (channel, in, segment),
+                                                                tailData,
+                                                                fftSize);
+                        }
+                    }
+                }
+
+                FloatVectorOperations::copy (outputData, tailData, spectrumSize);
+
+                for (size_t in = 0; in < numInputs; ++in)
+                    convolutionProcessingAndAccumulate (getInputSpectrum (in, currentSegment),
+                                                        getImpulseSpectrum (channel, in, 0),
+                                                        outputData,
+                                                        fftSize);
+
+                updateSymmetricFrequencyDomainData (outputData, fftSize);
+                ffts[(size_t) threadIndex].performRealOnlyInverseTransform (outputData);
+
+                FloatVectorOperations::add (output.getChannelPointer (channel) + numSamplesProcessed,
+                                            outputData + inputDataPos,
+                                            overlapData + inputDataPos,
+                                            numSamplesToProcess);
+
+                if (blockIsComplete)
+                {
+                    FloatVectorOperations::add (outputData + blockSize, overlapData + blockSize, fftSize - 2 * blockSize);
+                    FloatVectorOperations::copy (overlapData, outputData + blockSize, fftSize - blockSize);
+                }
+            };
+
+            runTasks (workers, numInputs, transformInput);
+            runTasks (workers, numOutputs, renderOutput);
+
+            inputDataPos += numSamplesToProcess;
+            numSamplesProcessed += numSamplesToProcess;
+
+            if (blockIsComplete)
+            {
+                inputBuffers.clear();
+                inputDataPos = 0;
+                currentSegment = (currentSegment > 0) ? (currentSegment - 1) : (numInputSegments - 1);
+            }
+        }
+    }
+
+    int getIRSize() const noexcept     { return irSize; }
+
+private:
+    template <typename Fn>
+    void runTasks (juce::detail::RealtimeTaskPool* workers, size_t numTasks, Fn& fn)
+    {
+        if (workers != nullptr)
+        {
+            jassert (workers->getNumThreads() < (int) ffts.size());
+            workers->run ((int) numTasks, fn);
+            return;
+        }
+
+        for (size_t i = 0; i < numTasks; ++i)
+            fn ((int) i, 0);
+    }
+
+    float* getImpulseSpectrum (size_t output, size_t input, size_t segment) noexcept
+    {
+        return impulseSpectra.data() + ((output * numInputs + input) * numSegments + segment) * spectrumSize;
+    }
+
+    float* getInputSpectrum (size_t input, size_t segment) noexcept
+    {
+        return inputSpectra.data() + (input * numInputSegments + segment) * spectrumSize;
+    }
+
+    const size_t numInputs, numOutputs;
+    const int irSize;
+    const size_t blockSize, fftSize, spectrumSize;
+    const int fftOrder;
+    const size_t numSegments, numInputSegments;
+    size_t currentSegment = 0, inputDataPos = 0;
+
+    std::vector<FFT> ffts;
+    std::vector<float> impulseSpectra, inputSpectra;
+    AudioBuffer<float> inputBuffers, inputScratch, outputBuffers, outputTails, outputOverlaps;
+};
+
+//==============================================================================
+class MatrixConvolution::Impl
+{
+public:
+    void loadImpulseResponses (AudioBuffer<float>&& buffer, double bufferSampleRate, size_t numInputsIn, size_t numOutputsIn)
+    {
+        jassert (bufferSampleRate > 0);
+        jassert (buffer.getNumChannels() == (int) (numInputsIn * numOutputsIn));
+
+        impulseResponses = std::move (buffer);
+        impulseResponseSampleRate = bufferSampleRate;
+        numInputs = numInputsIn;
+        numOutputs = numOutputsIn;
+
+        if (isPrepared)
+            createEngine();
+    }
+
+    void setNumWorkerThreads (int numThreads)
+    {
+        workers = numThreads > 0 ? std::make_unique<juce::detail::RealtimeTaskPool> (numThreads, "Convolution worker") : nullptr;
+
+        if (engine != nullptr)
+            engine->setNumThreads (numThreads + 1);
+    }
+
+    void prepare (const ProcessSpec& spec)
+    {
+        processSpec = spec;
+        isPrepared = true;
+        createEngine();
+    }
+
+    void reset()
+    {
+        if (engine != nullptr)
+            engine->reset();
+    }
+
+    void processSamples (const AudioBlock<const float>& input, AudioBlock<float>& output, bool isBypassed)
+    {
+        if (engine == nullptr || isBypassed)
+        {
+            const auto numToCopy = jmin (input.getNumChannels(), output.getNumChannels());
+
+            // Empty blocks don't have any channel pointers to compare or clear
+            if (output.getNumSamples() == 0)
+                return;
+
+            if (numToCopy > 0 && input.getChannelPointer (0) != output.getChannelPointer (0))
+                output.getSubsetChannelBlock (0, numToCopy).copyFrom (input.getSubsetChannelBlock (0, numToCopy));
+
+            if (output.getNumChannels() > numToCopy)
+                output.getSubsetChannelBlock (numToCopy, output.getNumChannels() - numToCopy).clear();
+
+            return;
+        }
+
+        engine->processSamples (input, output, workers.get());
+    }
+
+    size_t getNumInputChannels() const noexcept     { return numInputs; }
+    size_t getNumOutputChannels() const noexcept    { return numOutputs; }
+    int getCurrentIRSize() const noexcept           { return engine != nullptr ? engine->getIRSize() : 0; }
+
+private:
+    void createEngine()
+    {
+        if (numInputs == 0 || numOutputs == 0)
+        {
+            engine.reset();
+            return;
+        }
+
+        auto resampled = resampleImpulseResponse (impulseResponses, impulseResponseSampleRate, processSpec.sampleRate);
+        resampled.applyGain ((float) (impulseResponseSampleRate / processSpec.sampleRate));
+
+        engine = std::make_unique<MatrixConvolutionEngine> (resampled, numInputs, numOutputs, processSpec.maximumBlockSize);
+        engine->setNumThreads (workers != nullptr ? workers->getNumThreads() + 1 : 1);
+    }
+
+    AudioBuffer<float> impulseResponses;
+    double impulseResponseSampleRate = 44100.0;
+    size_t numInputs = 0, numOutputs = 0;
+
+    ProcessSpec processSpec { 44100.0, 128, 2 };
+    bool isPrepared = false;
+
+    std::unique_ptr<MatrixConvolutionEngine> engine;
+    std::unique_ptr<juce::detail::RealtimeTaskPool> workers;
+};
+
+//==============================================================================
+MatrixConvolution::MatrixConvolution()
+    : pimpl (std::make_unique<Impl>())
+{}
+
+MatrixConvolution::~MatrixConvolution() noexcept = default;
+
+void MatrixConvolution::loadImpulseResponses (AudioBuffer<float>&& impulseResponses, double bufferSampleRate,
+                                              size_t numInputs, size_t numOutputs)
+{
+    pimpl->loadImpulseResponses (std::move (impulseResponses), bufferSampleRate, numInputs, numOutputs);
+}
+
+void MatrixConvolution::setNumWorkerThreads (int numThreads)    { pimpl->setNumWorkerThreads (numThreads); }
+
+size_t MatrixConvolution::getNumInputChannels() const noexcept  { return pimpl->getNumInputChannels(); }
+size_t MatrixConvolution::getNumOutputChannels() const noexcept { return pimpl->getNumOutputChannels(); }
+int MatrixConvolution::getCurrentIRSize() const noexcept        { return pimpl->getCurrentIRSize(); }
+
+void MatrixConvolution::prepare (const ProcessSpec& spec)       { pimpl->prepare (spec); }
+void MatrixConvolution::reset() noexcept                        { pimpl->reset(); }
+
+void MatrixConvolution::processSamples (const AudioBlock<const float>& input,
+                                        AudioBlock<float>& output,
+                                        bool isBypassed) noexcept
+{
+    pimpl->processSamples (input, output, isBypassed);
+}
+
 } // namespace juce::dsp
@@ -313,4 +313,110 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Convolution)
 };
 
+//==============================================================================
+/**
+    Performs uniform partitioned convolution with a matrix of impulse responses, where
+    each output channel is the sum of every input channel convolved with its own
+    impulse response.
+
+    This is useful for true-stereo reverbs, where each output has a separate response
+    to each input, and for multichannel or ambisonic room responses.
+
+    Rather than running a separate convolution for every pair of channels, each input
+    is transformed to the frequency domain once per block, the products with the impulse
+    responses are accumulated in the frequency domain, and each output is transformed
+    back once per block. The transforms for the different channels can optionally be
+    spread over some worker threads.
+
+    The processing has no latency. Unlike Convolution, the impulse responses are
+    prepared on the thread that loads them and there's no crossfading between them,
+    so loadImpulseResponses() must not be called while processing.
+
+    @see Convolution
+
+    @tags{DSP}
+*/
+class JUCE_API MatrixConvolution
+{
+public:
+    //==============================================================================
+    /** Creates a MatrixConvolution with no impulse responses, which passes its input
+        straight through.
+    */
+    MatrixConvolution();
+
+    /** Destructor. */
+    ~MatrixConvolution() noexcept;
+
+    //==============================================================================
+    /** Sets the impulse responses.
+
+        The buffer must have numInputs * numOutputs channels. The response from input
+        channel i to output channel o is channel (o * numInputs + i) of the buffer, so a
+        true-stereo response is ordered left-to-left, right-to-left, left-to-right,
+        right-to-right.
+
+        This allocates memory and prepares the impulse responses if prepare() has already
+        been called, so it must not be called on the audio thread or while processing.
+
+        @param impulseResponses     the impulse responses
+        @param bufferSampleRate     the sample rate of the impulse responses, which will
+                                    be resampled to match the rate passed to prepare()
+        @param numInputs            the number of input channels
+        @param numOutputs           the number of output channels
+    */
+    void loadImpulseResponses (AudioBuffer<float>&& impulseResponses, double bufferSampleRate,
+                               size_t numInputs, size_t numOutputs);
+
+    /** Sets the number of extra threads used to process the channels.
+
+        With no worker threads, which is the default, all the processing happens on the
+        thread that calls process(). Otherwise, the calling thread shares the work with
+        the workers and waits for them to finish, so this only helps when there are
+        enough channels to keep them busy. The workers are started as realtime threads
+        where the system allows it.
+
+        This must not be called while processing.
+    */
+    void setNumWorkerThreads (int numThreads);
+
+    /** Returns the number of input channels of the current impulse responses. */
+    size_t getNumInputChannels() const noexcept;
+
+    /** Returns the number of output channels of the current impulse responses. */
+    size_t getNumOutputChannels() const noexcept;
+
+    /** Returns the length of the current impulse responses in samples. */
+    int getCurrentIRSize() const noexcept;
+
+    //==============================================================================
+    /** Must be called before first calling process. */
+    void prepare (const ProcessSpec&);
+
+    /** Resets the processing pipeline ready to start a new stream of data. */
+    void reset() noexcept;
+
+    /** Performs the convolution on the given set of samples.
+
+        The input block must have at least getNumInputChannels() channels and the output
+        block at least getNumOutputChannels() channels. They may be the same block.
+    */
+    template <typename ProcessContext,
+              std::enable_if_t<std::is_same_v<typename ProcessContext::SampleType, float>, int> = 0>
+    void process (const ProcessContext& context) noexcept
+    {
+        processSamples (context.getInputBlock(), context.getOutputBlock(), context.isBypassed);
+    }
+
+private:
+    //==============================================================================
+    void processSamples (const AudioBlock<const float>&, AudioBlock<float>&, bool isBypassed) noexcept;
+
+    class Impl;
+    std::unique_ptr<Impl> pimpl;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MatrixConvolution)
+};
+
 } // namespace juce::dsp
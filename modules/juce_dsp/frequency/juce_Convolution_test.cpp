@@ -576,6 +576,122 @@ public:
                                  ramp);
             }
         }
+
+        beginTest ("Matrix convolutions match direct convolution");
+        {
+            constexpr size_t numInputs = 3, numOutputs = 2;
+            constexpr int irLength = 700, signalLength = 3000;
+
+            Random random (getRandom().nextInt64());
+
+            AudioBuffer<float> irs ((int) (numInputs * numOutputs), irLength);
+            AudioBuffer<float> signal ((int) numInputs, signalLength);
+
+            for (auto* randomBuffer : { &irs, &signal })
+                for (auto channel = 0; channel < randomBuffer->getNumChannels(); ++channel)
+                    for (auto sample = 0; sample < randomBuffer->getNumSamples(); ++sample)
+                        randomBuffer->setSample (channel, sample, random.nextFloat() * 2.0f - 1.0f);
+
+            AudioBuffer<float> expected ((int) numOutputs, signalLength);
+            expected.clear();
+
+            for (size_t out = 0; out < numOutputs; ++out)
+            {
+                for (size_t in = 0; in < numInputs; ++in)
+                {
+                    const auto* ir = irs.getReadPointer ((int) (out * numInputs + in));
+                    const auto* x = signal.getReadPointer ((int) in);
+                    auto* y = expected.getWritePointer ((int) out);
+
+                    for (auto n = 0; n < signalLength; ++n)
+                        for (auto k = 0; k < jmin (irLength, n + 1); ++k)
+                            y[n] += ir[k] * x[n - k];
+                }
+            }
+
+            const auto runMatrixConvolution = [&] (int maxBlockSize, int numWorkers, bool inPlace)
+            {
+                MatrixConvolution convolution;
+                convolution.setNumWorkerThreads (numWorkers);
+                convolution.loadImpulseResponses (AudioBuffer<float> (irs), spec.sampleRate, numInputs, numOutputs);
+                convolution.prepare ({ spec.sampleRate, (uint32) maxBlockSize, (uint32) numInputs });
+
+                expectEquals (convolution.getCurrentIRSize(), irLength);
+
+                AudioBuffer<float> input (signal);
+                AudioBuffer<float> output ((int) numOutputs, signalLength);
+                output.clear();
+
+                for (int start = 0, blockIndex = 0; start < signalLength; ++blockIndex)
+                {
+                    // Vary the block sizes to exercise partially filled FFT blocks
+                    const auto numSamples = jmin (signalLength - start, blockIndex % 3 == 2 ? maxBlockSize / 3 + 1 : maxBlockSize);
+
+                    if (inPlace)
+                    {
+                        auto inOutBlock = AudioBlock<float> (input).getSubBlock ((size_t) start, (size_t) numSamples);
+                        convolution.process (ProcessContextReplacing<float> (inOutBlock));
+                    }
+                    else
+                    {
+                        auto inputBlock = AudioBlock<const float> (input).getSubBlock ((size_t) start, (size_t) numSamples);
+                        auto outputBlock = AudioBlock<float> (output).getSubBlock ((size_t) start, (size_t) numSamples);
+                        convolution.process (ProcessContextNonReplacing<float> (inputBlock, outputBlock));
+                    }
+
+                    start += numSamples;
+                }
+
+                if (inPlace)
+                    for (size_t channel = 0; channel < numOutputs; ++channel)
+                        output.copyFrom ((int) channel, 0, input, (int) channel, 0, signalLength);
+
+                auto maxError = 0.0f;
+
+                for (size_t channel = 0; channel < numOutputs; ++channel)
+                    for (auto sample = 0; sample < signalLength; ++sample)
+                        maxError = jmax (maxError, std::abs (output.getSample ((int) channel, sample)
+                                                             - expected.getSample ((int) channel, sample)));
+
+                expectLessThan (maxError, 1.0e-3f);
+            };
+
+            for (auto maxBlockSize : { 64, 256, 512 })
+                runMatrixConvolution (maxBlockSize, 0, false);
+
+            runMatrixConvolution (128, 0, true);
+            runMatrixConvolution (256, 2, false);
+            runMatrixConvolution (64, 3, true);
+        }
+
+        beginTest ("Bypassed matrix convolutions pass the input through");
+        {
+            MatrixConvolution convolution;
+            convolution.prepare (spec);
+
+            AudioBuffer<float> irs (4, 100);
+            irs.clear();
+            convolution.loadImpulseResponses (std::move (irs), spec.sampleRate, 2, 2);
+
+            AudioBuffer<float> input (2, 256), output (2, 256);
+            input.clear();
+            input.setSample (0, 10, 1.0f);
+            input.setSample (1, 20, -1.0f);
+
+            AudioBlock<const float> inputBlock (input);
+            AudioBlock<float> outputBlock (output);
+            ProcessContextNonReplacing<float> bypassedContext (inputBlock, outputBlock);
+            bypassedContext.isBypassed = true;
+            convolution.process (bypassedContext);
+
+            expectEquals (output.getSample (0, 10), 1.0f);
+            expectEquals (output.getSample (1, 20), -1.0f);
+
+            auto emptyBlock = outputBlock.getSubBlock (0, 0);
+            ProcessContextReplacing<float> emptyContext (emptyBlock);
+            emptyContext.isBypassed = true;
+            convolution.process (emptyContext);
+        }
     }
 };
 
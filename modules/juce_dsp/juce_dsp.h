@@ -274,6 +274,7 @@ namespace util
 #include "processors/juce_BallisticsFilter.h"
 #include "processors/juce_LinkwitzRileyFilter.h"
 #include "processors/juce_DryWetMixer.h"
+#include "processors/juce_MatrixMixer.h"
 #include "processors/juce_StateVariableTPTFilter.h"
 #include "frequency/juce_FFT.h"
 #include "frequency/juce_Convolution.h"
@@ -284,6 +285,7 @@ namespace util
 #include "widgets/juce_Gain.h"
 #include "widgets/juce_WaveShaper.h"
 #include "widgets/juce_Oscillator.h"
+#include "widgets/juce_OscillatorBank.h"
 #include "widgets/juce_LadderFilter.h"
 #include "widgets/juce_Compressor.h"
 #include "widgets/juce_NoiseGate.h"
@@ -77,14 +77,74 @@ void LookupTable<FloatType>::prepare() noexcept
     data.getReference (guardIndex) = data.getUnchecked (guardIndex - 1);
 }
 
+template <typename FloatType>
+void LookupTable<FloatType>::getUnchecked (const FloatType* indices, FloatType* results, size_t numValues,
+                                           LookupTableInterpolation interpolation) const noexcept
+{
+    jassert (isInitialised());  // Use the non-default constructor or call initialise() before first use
+
+    // The table reads can't be vectorised without gather instructions, so they're done
+    // in a scalar pass that fills some small arrays, and the interpolation then runs
+    // over the whole arrays.
+    constexpr size_t chunkSize = 64;
+    const auto* table = data.begin();
+    const auto guardIndex = getGuardIndex();
+
+    for (size_t start = 0; start < numValues; start += chunkSize)
+    {
+        const auto num = jmin (chunkSize, numValues - start);
+        const auto* chunkIndices = indices + start;
+        auto* chunkResults = results + start;
+
+        FloatType fractions[chunkSize], x0[chunkSize], x1[chunkSize];
+
+        if (interpolation == LookupTableInterpolation::linear)
+        {
+            for (size_t n = 0; n < num; ++n)
+            {
+                jassert (isPositiveAndBelow (chunkIndices[n], FloatType (getNumPoints())));
+
+                const auto i = (size_t) truncatePositiveToUnsignedInt (chunkIndices[n]);
+                fractions[n] = chunkIndices[n] - FloatType (i);
+                x0[n] = table[i];
+                x1[n] = table[i + 1] - table[i];
+            }
+
+            FloatVectorOperations::copy (chunkResults, x0, num);
+            FloatVectorOperations::addWithMultiply (chunkResults, fractions, x1, num);
+        }
+        else
+        {
+            FloatType xm1[chunkSize], x2[chunkSize];
+
+            for (size_t n = 0; n < num; ++n)
+            {
+                jassert (isPositiveAndBelow (chunkIndices[n], FloatType (getNumPoints())));
+
+                const auto i = (size_t) truncatePositiveToUnsignedInt (chunkIndices[n]);
+                fractions[n] = chunkIndices[n] - FloatType (i);
+                xm1[n] = table[i > 0 ? i - 1 : 0];
+                x0[n]  = table[i];
+                x1[n]  = table[i + 1];
+                x2[n]  = table[jmin (i + 2, guardIndex)];
+            }
+
+            for (size_t n = 0; n < num; ++n)
+                chunkResults[n] = interpolateCubic (fractions[n], xm1[n], x0[n], x1[n], x2[n]);
+        }
+    }
+}
+
 template <typename FloatType>
 void LookupTableTransform<FloatType>::initialise (const std::function<FloatType (FloatType)>& functionToApproximate,
                                                   FloatType minInputValueToUse,
                                                   FloatType maxInputValueToUse,
-                                                  size_t numPoints)
+                                                  size_t numPoints,
+                                                  LookupTableInterpolation interpolationToUse)
 {
     jassert (maxInputValueToUse > minInputValueToUse);
 
+    interpolation = interpolationToUse;
     minInputValue = minInputValueToUse;
     maxInputValue = maxInputValueToUse;
     scaler = FloatType (numPoints - 1) / (maxInputValueToUse - minInputValueToUse);
@@ -102,20 +162,53 @@ void LookupTableTransform<FloatType>::initialise (const std::function<FloatType
     lookupTable.initialise (initFn, numPoints);
 }
 
+template <typename FloatType>
+void LookupTableTransform<FloatType>::processBlock (const FloatType* input, FloatType* output,
+                                                    size_t numSamples, bool clipInput) const noexcept
+{
+    // Because the points are evenly spaced, the table indices can be calculated for a
+    // whole chunk of samples at once
+    constexpr size_t chunkSize = 256;
+    FloatType indices[chunkSize];
+
+    for (size_t start = 0; start < numSamples; start += chunkSize)
+    {
+        const auto num = jmin (chunkSize, numSamples - start);
+
+        if (clipInput)
+        {
+            FloatVectorOperations::clip (indices, input + start, minInputValue, maxInputValue, num);
+        }
+        else
+        {
+            jassert (std::all_of (input + start, input + start + num,
+                                  [this] (auto x) { return x >= minInputValue && x <= maxInputValue; }));
+
+            FloatVectorOperations::copy (indices, input + start, num);
+        }
+
+        FloatVectorOperations::multiply (indices, scaler, num);
+        FloatVectorOperations::add (indices, offset, num);
+
+        lookupTable.getUnchecked (indices, output + start, num, interpolation);
+    }
+}
+
 //==============================================================================
 template <typename FloatType>
 double LookupTableTransform<FloatType>::calculateMaxRelativeError (const std::function<FloatType (FloatType)>& functionToApproximate,
                                                                    FloatType minInputValue,
                                                                    FloatType maxInputValue,
                                                                    size_t numPoints,
-                                                                   size_t numTestPoints)
+                                                                   size_t numTestPoints,
+                                                                   LookupTableInterpolation interpolationToUse)
 {
     jassert (maxInputValue > minInputValue);
 
     if (numTestPoints == 0)
         numTestPoints = 100 * numPoints;    // use default
 
-    LookupTableTransform transform (functionToApproximate, minInputValue, maxInputValue, numPoints);
+    LookupTableTransform transform (functionToApproximate, minInputValue, maxInputValue, numPoints, interpolationToUse);
 
     double maxError = 0;
 
@@ -35,6 +35,22 @@
 namespace juce::dsp
 {
 
+/**
+    The interpolation used by LookupTable and LookupTableTransform to calculate values
+    between the pre-calculated points.
+
+    Cubic interpolation uses a Catmull-Rom spline through the four surrounding points,
+    which is more accurate for smooth functions at the cost of some extra arithmetic.
+
+    @tags{DSP}
+*/
+enum class LookupTableInterpolation
+{
+    linear,
+    cubic
+};
+
+//==============================================================================
 /**
     Class for efficiently approximating expensive arithmetic operations.
 
@@ -114,6 +130,39 @@ public:
         return jmap (f, x0, x1);
     }
 
+    /** Calculates the approximated value for the given index without range checking,
+        using cubic interpolation.
+
+        @see getUnchecked
+    */
+    FloatType getUncheckedCubic (FloatType index) const noexcept
+    {
+        jassert (isInitialised());  // Use the non-default constructor or call initialise() before first use
+        jassert (isPositiveAndBelow (index, FloatType (getNumPoints())));
+
+        auto i = truncatePositiveToUnsignedInt (index);
+        auto f = index - FloatType (i);
+        jassert (isPositiveAndBelow (f, FloatType (1)));
+
+        auto xm1 = data.getUnchecked (static_cast<int> (i > 0 ? i - 1 : 0));
+        auto x0  = data.getUnchecked (static_cast<int> (i));
+        auto x1  = data.getUnchecked (static_cast<int> (i + 1));
+        auto x2  = data.getUnchecked (static_cast<int> (jmin ((size_t) i + 2, getGuardIndex())));
+
+        return interpolateCubic (f, xm1, x0, x1, x2);
+    }
+
+    /** Calculates the approximated values for an array of indices without range checking.
+
+        The indices are truncated in a single pass and the interpolation is done on whole
+        arrays, so that it can make use of SIMD instructions. The indices and results may
+        point to the same memory.
+
+        @see getUnchecked, getUncheckedCubic
+    */
+    void getUnchecked (const FloatType* indices, FloatType* results, size_t numValues,
+                       LookupTableInterpolation interpolation = LookupTableInterpolation::linear) const noexcept;
+
     //==============================================================================
     /** Calculates the approximated value for the given index with range checking.
 
@@ -151,6 +200,15 @@ private:
     //==============================================================================
     Array<FloatType> data;
 
+    static FloatType interpolateCubic (FloatType f, FloatType xm1, FloatType x0, FloatType x1, FloatType x2) noexcept
+    {
+        auto c1 = FloatType (0.5) * (x1 - xm1);
+        auto c2 = xm1 - FloatType (2.5) * x0 + FloatType (2) * x1 - FloatType (0.5) * x2;
+        auto c3 = FloatType (0.5) * (x2 - xm1) + FloatType (1.5) * (x0 - x1);
+
+        return ((c3 * f + c2) * f + c1) * f + x0;
+    }
+
     void prepare() noexcept;
     static size_t getRequiredBufferSize (size_t numPointsToUse) noexcept { return numPointsToUse + 1; }
     size_t getGuardIndex() const noexcept                                { return getRequiredBufferSize (getNumPoints()) - 1; }
@@ -173,6 +231,10 @@ private:
     Note: If you try to call the function with an input outside the provided
     range, it will return either the first or the last recorded LookupTable value.
 
+    When processing whole blocks, prefer process() and processUnchecked() over calling
+    processSample() in a loop, as they evaluate many samples at once using SIMD
+    instructions.
+
     @see LookupTable
 
     @tags{DSP}
@@ -201,13 +263,16 @@ public:
         @param maxInputValueToUse    The highest input value used. The approximation will
                                      fail for values higher than this.
         @param numPoints             The number of pre-calculated values stored.
+        @param interpolationToUse    How to calculate the values between the
+                                     pre-calculated points.
     */
     LookupTableTransform (const std::function<FloatType (FloatType)>& functionToApproximate,
                           FloatType minInputValueToUse,
                           FloatType maxInputValueToUse,
-                          size_t numPoints)
+                          size_t numPoints,
+                          LookupTableInterpolation interpolationToUse = LookupTableInterpolation::linear)
     {
-        initialise (functionToApproximate, minInputValueToUse, maxInputValueToUse, numPoints);
+        initialise (functionToApproximate, minInputValueToUse, maxInputValueToUse, numPoints, interpolationToUse);
     }
 
     //==============================================================================
@@ -220,11 +285,14 @@ public:
         @param maxInputValueToUse    The highest input value used. The approximation will
                                      fail for values higher than this.
         @param numPoints             The number of pre-calculated values stored.
+        @param interpolationToUse    How to calculate the values between the
+                                     pre-calculated points.
     */
     void initialise (const std::function<FloatType (FloatType)>& functionToApproximate,
                      FloatType minInputValueToUse,
                      FloatType maxInputValueToUse,
-                     size_t numPoints);
+                     size_t numPoints,
+                     LookupTableInterpolation interpolationToUse = LookupTableInterpolation::linear);
 
     //==============================================================================
     /** Calculates the approximated value for the given input value without range checking.
@@ -240,7 +308,7 @@ public:
     FloatType processSampleUnchecked (FloatType value) const noexcept
     {
         jassert (value >= minInputValue && value <= maxInputValue);
-        return lookupTable[scaler * value + offset];
+        return lookup (scaler * value + offset);
     }
 
     //==============================================================================
@@ -262,7 +330,7 @@ public:
         auto index = scaler * jlimit (minInputValue, maxInputValue, value) + offset;
         jassert (isPositiveAndBelow (index, FloatType (lookupTable.getNumPoints())));
 
-        return lookupTable[index];
+        return lookup (index);
     }
 
     //==============================================================================
@@ -278,8 +346,7 @@ public:
     */
     void processUnchecked (const FloatType* input, FloatType* output, size_t numSamples) const noexcept
     {
-        for (size_t i = 0; i < numSamples; ++i)
-            output[i] = processSampleUnchecked (input[i]);
+        processBlock (input, output, numSamples, false);
     }
 
     //==============================================================================
@@ -288,8 +355,7 @@ public:
     */
     void process (const FloatType* input, FloatType* output, size_t numSamples) const noexcept
     {
-        for (size_t i = 0; i < numSamples; ++i)
-            output[i] = processSample (input[i]);
+        processBlock (input, output, numSamples, true);
     }
 
     //==============================================================================
@@ -314,21 +380,32 @@ public:
                                      calculation. Higher numbers can increase the
                                      accuracy of the error calculation. If it's zero
                                      then 100 * numPoints will be used.
+        @param interpolationToUse    The interpolation to use.
     */
     static double calculateMaxRelativeError (const std::function<FloatType (FloatType)>& functionToApproximate,
                                              FloatType minInputValue,
                                              FloatType maxInputValue,
                                              size_t numPoints,
-                                             size_t numTestPoints = 0);
+                                             size_t numTestPoints = 0,
+                                             LookupTableInterpolation interpolationToUse = LookupTableInterpolation::linear);
 private:
     //==============================================================================
     static double calculateRelativeDifference (double, double) noexcept;
 
+    FloatType lookup (FloatType index) const noexcept
+    {
+        return interpolation == LookupTableInterpolation::cubic ? lookupTable.getUncheckedCubic (index)
+                                                                : lookupTable.getUnchecked (index);
+    }
+
+    void processBlock (const FloatType* input, FloatType* output, size_t numSamples, bool clipInput) const noexcept;
+
     //==============================================================================
     LookupTable<FloatType> lookupTable;
 
     FloatType minInputValue, maxInputValue;
     FloatType scaler, offset;
+    LookupTableInterpolation interpolation = LookupTableInterpolation::linear;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LookupTableTransform)
 };
@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+class LookupTableTransformTest final : public UnitTest
+{
+public:
+    LookupTableTransformTest()
+        : UnitTest ("LookupTableTransform", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        runForAllTypes<BlockProcessingTest> ("Block processing matches single samples");
+        runForAllTypes<CubicInterpolationTest> ("Cubic interpolation");
+        runForAllTypes<WaveShaperTest> ("WaveShaper uses block processing");
+    }
+
+private:
+    template <typename FloatType>
+    static FloatType tanhFunction (FloatType x)     { return std::tanh (x); }
+
+    struct BlockProcessingTest
+    {
+        template <typename FloatType>
+        static void run (LookupTableTransformTest& u)
+        {
+            auto random = u.getRandom();
+
+            for (auto interpolation : { LookupTableInterpolation::linear, LookupTableInterpolation::cubic })
+            {
+                LookupTableTransform<FloatType> transform (tanhFunction<FloatType>, (FloatType) -5, (FloatType) 5, 128, interpolation);
+
+                // An odd size, so that the last chunk is only partly filled
+                std::vector<FloatType> input (1001), output (input.size());
+
+                for (auto& x : input)
+                    x = (FloatType) (random.nextDouble() * 14.0 - 7.0);
+
+                input.front() = -5;
+                input.back() = 5;
+
+                transform.process (input.data(), output.data(), input.size());
+
+                for (size_t i = 0; i < input.size(); ++i)
+                    u.expectWithinAbsoluteError (output[i], transform.processSample (input[i]), (FloatType) 1e-5);
+
+                std::transform (input.begin(), input.end(), input.begin(),
+                                [] (auto x) { return jlimit ((FloatType) -5, (FloatType) 5, x); });
+
+                transform.processUnchecked (input.data(), input.data(), input.size());
+                u.expect (std::equal (input.begin(), input.end(), output.begin(),
+                                      [] (auto a, auto b) { return std::abs (a - b) < (FloatType) 1e-5; }));
+            }
+        }
+    };
+
+    struct CubicInterpolationTest
+    {
+        template <typename FloatType>
+        static void run (LookupTableTransformTest& u)
+        {
+            const auto getMaxError = [] (LookupTableInterpolation interpolation)
+            {
+                LookupTableTransform<FloatType> transform (tanhFunction<FloatType>, (FloatType) -5, (FloatType) 5, 64, interpolation);
+                FloatType maxError = 0;
+
+                for (int i = 0; i < 6400; ++i)
+                {
+                    const auto x = jmap ((FloatType) i, (FloatType) 0, (FloatType) 6399, (FloatType) -5, (FloatType) 5);
+                    maxError = jmax (maxError, std::abs (transform (x) - std::tanh (x)));
+                }
+
+                return maxError;
+            };
+
+            u.expect (getMaxError (LookupTableInterpolation::cubic) < getMaxError (LookupTableInterpolation::linear) * (FloatType) 0.1);
+
+            // The interpolated curve still passes through the pre-calculated points
+            LookupTable<FloatType> table ([] (size_t i) { return (FloatType) (i * i); }, 8);
+
+            for (size_t i = 0; i < 7; ++i)
+                u.expectWithinAbsoluteError (table.getUncheckedCubic ((FloatType) i), (FloatType) (i * i), (FloatType) 1e-6);
+        }
+    };
+
+    struct WaveShaperTest
+    {
+        template <typename FloatType>
+        static void run (LookupTableTransformTest& u)
+        {
+            WaveShaper<FloatType, LookupTableTransform<FloatType>> shaper;
+            shaper.functionToUse.initialise (tanhFunction<FloatType>, (FloatType) -5, (FloatType) 5, 256);
+
+            AudioBuffer<FloatType> buffer (2, 300);
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample (ch, i, (FloatType) (i - 150) * (FloatType) 0.05);
+
+            AudioBlock<FloatType> block (buffer);
+            shaper.process (ProcessContextReplacing<FloatType> (block));
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    u.expectWithinAbsoluteError (buffer.getSample (ch, i),
+                                                 shaper.functionToUse ((FloatType) (i - 150) * (FloatType) 0.05),
+                                                 (FloatType) 1e-6);
+        }
+    };
+
+    template <class TheTest>
+    void runForAllTypes (const char* testName)
+    {
+        beginTest (testName);
+
+        TheTest::template run<float> (*this);
+        TheTest::template run<double> (*this);
+    }
+};
+
+static LookupTableTransformTest lookupTableTransformTest;
+
+} // namespace juce::dsp
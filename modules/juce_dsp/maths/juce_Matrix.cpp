@@ -35,6 +35,175 @@
 namespace juce::dsp
 {
 
+template <typename ElementType>
+struct MatrixKernels
+{
+   #if JUCE_USE_SIMD
+    using Register = SIMDRegister<ElementType>;
+    static constexpr size_t registerSize = Register::SIMDNumElements;
+
+    static Register load (const ElementType* src) noexcept             { return Register::fromRawArray (src); }
+    static void store (Register value, ElementType* dest) noexcept     { value.copyToRawArray (dest); }
+   #else
+    using Register = ElementType;
+    static constexpr size_t registerSize = 1;
+
+    static Register load (const ElementType* src) noexcept             { return *src; }
+    static void store (Register value, ElementType* dest) noexcept     { *dest = value; }
+   #endif
+
+    // Each tile of the result is accumulated in registers, so that every value loaded
+    // from the right-hand matrix is used for several rows
+    static constexpr size_t tileRows = 4, tileRegisters = 2, tileColumns = tileRegisters * registerSize;
+
+    // The right-hand matrix is copied into aligned storage in blocks of this size, which
+    // stay in the cache while they're reused for every row of the left-hand matrix
+    static constexpr size_t blockDepth = 128, blockWidth = 256;
+
+    // Below this number of multiply-adds, blocking costs more than it saves
+    static constexpr size_t smallProductSize = 4096;
+
+    static size_t getPaddedWidth (size_t numColumns) noexcept
+    {
+        return (numColumns + tileColumns - 1) / tileColumns * tileColumns;
+    }
+
+    //==============================================================================
+    // Adds the product of numRows rows of a and a tile of aligned storage b to c, only
+    // writing the first numColumns columns of the tile
+    template <size_t numRows>
+    static void multiplyTile (const ElementType* a, size_t aStride,
+                              const ElementType* b, size_t bStride, size_t depth,
+                              ElementType* c, size_t cStride, size_t numColumns) noexcept
+    {
+        Register sums[numRows][tileRegisters];
+
+        for (auto& row : sums)
+            for (auto& sum : row)
+                sum = Register (ElementType());
+
+        for (size_t k = 0; k < depth; ++k, b += bStride)
+        {
+            Register bk[tileRegisters];
+
+            for (size_t v = 0; v < tileRegisters; ++v)
+                bk[v] = load (b + v * registerSize);
+
+            for (size_t r = 0; r < numRows; ++r)
+            {
+                const Register ark (a[r * aStride + k]);
+
+                for (size_t v = 0; v < tileRegisters; ++v)
+                    sums[r][v] += bk[v] * ark;
+            }
+        }
+
+        alignas (Register) ElementType results[tileColumns];
+
+        for (size_t r = 0; r < numRows; ++r)
+        {
+            for (size_t v = 0; v < tileRegisters; ++v)
+                store (sums[r][v], results + v * registerSize);
+
+            auto* dest = c + r * cStride;
+
+            for (size_t j = 0; j < numColumns; ++j)
+                dest[j] += results[j];
+        }
+    }
+
+    // Adds the product of numRows rows of a and a block of aligned storage b to c
+    static void multiplyBlock (const ElementType* a, size_t aStride,
+                               const ElementType* b, size_t bStride, size_t depth,
+                               ElementType* c, size_t cStride,
+                               size_t numRows, size_t numColumns) noexcept
+    {
+        for (size_t i = 0; i < numRows; i += tileRows)
+        {
+            const auto* aTile = a + i * aStride;
+            auto* cTile = c + i * cStride;
+
+            for (size_t j = 0; j < numColumns; j += tileColumns)
+            {
+                const auto columnsInTile = jmin (tileColumns, numColumns - j);
+
+                switch (jmin (tileRows, numRows - i))
+                {
+                    case 4:  multiplyTile<4> (aTile, aStride, b + j, bStride, depth, cTile + j, cStride, columnsInTile); break;
+                    case 3:  multiplyTile<3> (aTile, aStride, b + j, bStride, depth, cTile + j, cStride, columnsInTile); break;
+                    case 2:  multiplyTile<2> (aTile, aStride, b + j, bStride, depth, cTile + j, cStride, columnsInTile); break;
+                    default: multiplyTile<1> (aTile, aStride, b + j, bStride, depth, cTile + j, cStride, columnsInTile); break;
+                }
+            }
+        }
+    }
+
+    //==============================================================================
+    // c (n x m) += a (n x p) * b (p x m), for dense row-major matrices
+    static void multiply (const ElementType* a, const ElementType* b, ElementType* c,
+                          size_t n, size_t p, size_t m)
+    {
+        std::vector<Register> blockStorage (blockDepth * getPaddedWidth (jmin (blockWidth, m)) / registerSize);
+        auto* block = reinterpret_cast<ElementType*> (blockStorage.data());
+
+        for (size_t j = 0; j < m; j += blockWidth)
+        {
+            const auto width = jmin (blockWidth, m - j);
+            const auto stride = getPaddedWidth (width);
+
+            for (size_t k = 0; k < p; k += blockDepth)
+            {
+                const auto depth = jmin (blockDepth, p - k);
+
+                for (size_t row = 0; row < depth; ++row)
+                {
+                    auto* dest = block + row * stride;
+                    std::copy (b + (k + row) * m + j, b + (k + row) * m + j + width, dest);
+                    std::fill (dest + width, dest + stride, ElementType());
+                }
+
+                multiplyBlock (a + k, p, block, stride, depth, c + j, m, n, width);
+            }
+        }
+    }
+
+    static void multiplySmall (const ElementType* a, const ElementType* b, ElementType* c,
+                               size_t n, size_t p, size_t m) noexcept
+    {
+        for (size_t i = 0; i < n; ++i, c += m)
+            for (size_t k = 0; k < p; ++k)
+            {
+                const auto aik = *a++;
+                const auto* bk = b + k * m;
+
+                for (size_t j = 0; j < m; ++j)
+                    c[j] += aik * bk[j];
+            }
+    }
+
+    // y (n) = a (n x p) * x (p)
+    static void multiplyVector (const ElementType* a, const ElementType* x, ElementType* y,
+                                size_t n, size_t p) noexcept
+    {
+        for (size_t i = 0; i < n; ++i, a += p)
+        {
+            // Independent partial sums avoid serialising on the latency of each addition
+            ElementType sums[4] = {};
+            size_t k = 0;
+
+            for (; k + 4 <= p; k += 4)
+                for (size_t s = 0; s < 4; ++s)
+                    sums[s] += a[k + s] * x[k + s];
+
+            for (; k < p; ++k)
+                sums[0] += a[k] * x[k];
+
+            y[i] = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        }
+    }
+};
+
+//==============================================================================
 template <typename ElementType>
 Matrix<ElementType> Matrix<ElementType>::identity (size_t size)
 {
@@ -124,30 +293,70 @@ Matrix<ElementType> Matrix<ElementType>::operator* (const Matrix<ElementType>& o
 
     jassert (p == other.getNumRows());
 
-    size_t offsetMat = 0, offsetlhs = 0;
+    using Kernels = MatrixKernels<ElementType>;
 
     auto* dst = result.getRawDataPointer();
     auto* a = getRawDataPointer();
     auto* b = other.getRawDataPointer();
 
-    for (size_t i = 0; i < n; ++i)
+    if (m == 1)
+        Kernels::multiplyVector (a, b, dst, n, p);
+    else if (n * m * p <= Kernels::smallProductSize)
+        Kernels::multiplySmall (a, b, dst, n, p, m);
+    else
+        Kernels::multiply (a, b, dst, n, p, m);
+
+    return result;
+}
+
+//==============================================================================
+template <typename ElementType>
+void Matrix<ElementType>::process (const AudioBlock<const ElementType>& input,
+                                   const AudioBlock<ElementType>& output) const noexcept
+{
+    using Kernels = MatrixKernels<ElementType>;
+    using Register = typename Kernels::Register;
+
+    constexpr size_t maxChannels = 256;
+    constexpr size_t scratchSize = maxChannels * Kernels::tileColumns;
+
+    jassert (input.getNumChannels() == columns && output.getNumChannels() == rows);
+    jassert (input.getNumSamples() == output.getNumSamples());
+
+    if (rows > maxChannels || columns > maxChannels)
     {
-        size_t offsetrhs = 0;
+        jassertfalse; // this matrix is too large to be applied without allocating
+        return;
+    }
 
-        for (size_t k = 0; k < p; ++k)
-        {
-            auto ak = a[offsetlhs++];
+    // Each chunk of input is copied first, so that the output can overwrite it
+    alignas (Register) ElementType inputScratch[scratchSize];
+    alignas (Register) ElementType outputScratch[scratchSize];
 
-            for (size_t j = 0; j < m; ++j)
-                dst[offsetMat + j] += ak * b[offsetrhs + j];
+    const auto chunkSize = scratchSize / jmax (rows, columns, (size_t) 1) / Kernels::tileColumns * Kernels::tileColumns;
+    const auto numSamples = output.getNumSamples();
+
+    for (size_t start = 0; start < numSamples; start += chunkSize)
+    {
+        const auto numInChunk = jmin (chunkSize, numSamples - start);
+        const auto stride = Kernels::getPaddedWidth (numInChunk);
 
-            offsetrhs += m;
+        for (size_t ch = 0; ch < columns; ++ch)
+        {
+            auto* dest = inputScratch + ch * stride;
+            std::copy (input.getChannelPointer (ch) + start, input.getChannelPointer (ch) + start + numInChunk, dest);
+            std::fill (dest + numInChunk, dest + stride, ElementType());
         }
 
-        offsetMat += m;
-    }
+        std::fill (outputScratch, outputScratch + rows * stride, ElementType());
 
-    return result;
+        Kernels::multiplyBlock (getRawDataPointer(), columns, inputScratch, stride, columns,
+                                outputScratch, stride, rows, numInChunk);
+
+        for (size_t ch = 0; ch < rows; ++ch)
+            std::copy (outputScratch + ch * stride, outputScratch + ch * stride + numInChunk,
+                       output.getChannelPointer (ch) + start);
+    }
 }
 
 //==============================================================================
@@ -233,53 +442,112 @@ bool Matrix<ElementType>::solve (Matrix& b) const noexcept
 
 
         default:
-        {
-            Matrix<ElementType> M (A);
+            return LUDecomposition (A).solve (b);
+    }
 
-            for (size_t j = 0; j < n; ++j)
-            {
-                if (approximatelyEqual (M (j, j), (ElementType) 0))
-                {
-                    auto i = j;
-                    while (i < n && approximatelyEqual (M (i, j), (ElementType) 0))
-                        ++i;
+    return true;
+}
 
-                    if (i == n)
-                        return false;
+//==============================================================================
+template <typename ElementType>
+Matrix<ElementType>::LUDecomposition::LUDecomposition (const Matrix& matrix)
+    : lu (matrix)
+{
+    jassert (matrix.isSquare());
 
-                    for (size_t k = 0; k < n; ++k)
-                        M (j, k) += M (i, k);
+    const auto n = lu.getNumRows();
 
-                    x[j] += x[i];
-                }
+    for (size_t i = 0; i < n; ++i)
+        permutation.add (i);
 
-                auto t = 1 / M (j, j);
+    for (size_t j = 0; j < n; ++j)
+    {
+        auto pivot = j;
 
-                for (size_t k = 0; k < n; ++k)
-                    M (j, k) *= t;
+        for (size_t i = j + 1; i < n; ++i)
+            if (std::abs (lu (i, j)) > std::abs (lu (pivot, j)))
+                pivot = i;
 
-                x[j] *= t;
+        if (approximatelyEqual (lu (pivot, j), (ElementType) 0))
+            return;
 
-                for (size_t k = j + 1; k < n; ++k)
-                {
-                    auto u = -M (k, j);
+        if (pivot != j)
+        {
+            lu.swapRows (pivot, j);
+            permutation.swap ((int) pivot, (int) j);
+            oddPermutation = ! oddPermutation;
+        }
 
-                    for (size_t l = 0; l < n; ++l)
-                        M (k, l) += u * M (j, l);
+        const auto* pivotRow = lu.getRawDataPointer() + j * n;
+        const auto reciprocal = 1 / pivotRow[j];
 
-                    x[k] += u * x[j];
-                }
-            }
+        for (size_t i = j + 1; i < n; ++i)
+        {
+            auto* row = lu.getRawDataPointer() + i * n;
+            const auto factor = (row[j] *= reciprocal);
 
-            for (int k = static_cast<int> (n) - 2; k >= 0; --k)
-                for (size_t i = static_cast<size_t> (k) + 1; i < n; ++i)
-                    x[k] -= M (static_cast<size_t> (k), i) * x[i];
+            if (! exactlyEqual (factor, (ElementType) 0))
+                FloatVectorOperations::subtractWithMultiply (row + j + 1, pivotRow + j + 1, factor, n - j - 1);
         }
     }
 
+    valid = true;
+}
+
+template <typename ElementType>
+bool Matrix<ElementType>::LUDecomposition::solve (Matrix& b) const noexcept
+{
+    const auto n = lu.getNumRows();
+    const auto numColumns = b.getNumColumns();
+
+    jassert (b.getNumRows() == n);
+
+    if (! valid)
+        return false;
+
+    // Each step works on whole rows of b, so that several right-hand sides are
+    // processed together
+    Matrix permuted (b);
+
+    for (size_t i = 0; i < n; ++i)
+        std::copy (permuted.begin() + permutation.getUnchecked ((int) i) * numColumns,
+                   permuted.begin() + (permutation.getUnchecked ((int) i) + 1) * numColumns,
+                   b.begin() + i * numColumns);
+
+    auto* x = b.getRawDataPointer();
+    const auto* a = lu.getRawDataPointer();
+
+    for (size_t i = 1; i < n; ++i)
+        for (size_t k = 0; k < i; ++k)
+            if (! exactlyEqual (a[i * n + k], (ElementType) 0))
+                FloatVectorOperations::subtractWithMultiply (x + i * numColumns, x + k * numColumns, a[i * n + k], numColumns);
+
+    for (size_t i = n; i-- > 0;)
+    {
+        for (size_t k = i + 1; k < n; ++k)
+            if (! exactlyEqual (a[i * n + k], (ElementType) 0))
+                FloatVectorOperations::subtractWithMultiply (x + i * numColumns, x + k * numColumns, a[i * n + k], numColumns);
+
+        FloatVectorOperations::multiply (x + i * numColumns, 1 / a[i * n + i], numColumns);
+    }
+
     return true;
 }
 
+template <typename ElementType>
+ElementType Matrix<ElementType>::LUDecomposition::getDeterminant() const noexcept
+{
+    if (! valid)
+        return 0;
+
+    ElementType result = oddPermutation ? -1 : 1;
+
+    for (size_t i = 0; i < lu.getNumRows(); ++i)
+        result *= lu (i, i);
+
+    return result;
+}
+
 //==============================================================================
 template <typename ElementType>
 String Matrix<ElementType>::toString() const
@@ -35,6 +35,9 @@
 namespace juce::dsp
 {
 
+template <typename SampleType>
+class AudioBlock;
+
 /**
     General matrix and vectors class, meant for classic math manipulation such as
     additions, multiplications, and linear systems of equations solving.
@@ -164,7 +167,11 @@ public:
     /** Scalar multiplication */
     inline Matrix operator* (ElementType scalar) const                  { Matrix result (*this); result *= scalar; return result; }
 
-    /** Matrix multiplication */
+    /** Matrix multiplication.
+
+        Large products are computed in cache-sized blocks using SIMD registers, and
+        products with a column vector use a dedicated matrix-vector routine.
+    */
     Matrix operator* (const Matrix& other) const;
 
     /** Does a hadarmard product with the receiver and other and stores the result in the receiver */
@@ -208,6 +215,29 @@ public:
      */
     bool solve (Matrix& b) const noexcept;
 
+    /** The LU decomposition of a square matrix, computed with partial pivoting.
+
+        Decomposing the matrix is the expensive part of solving a linear system, so
+        if you need to solve several systems which share the same matrix, create one
+        of these once and call its solve() method for each right-hand side.
+    */
+    class LUDecomposition;
+
+    //==============================================================================
+    /** Multiplies each frame of samples in a block by this matrix.
+
+        The samples of the input channels at each position in time are treated as a
+        column vector, so the input must have getNumColumns() channels and the output
+        must have getNumRows() channels, with the same number of samples. The input
+        and output may refer to the same channels, in which case the block is processed
+        in place.
+
+        This doesn't allocate any memory, and works on matrices of up to 256 rows and
+        columns.
+    */
+    void process (const AudioBlock<const ElementType>& input,
+                  const AudioBlock<ElementType>& output) const noexcept;
+
     //==============================================================================
     /** Returns a String displaying in a convenient way the matrix contents. */
     String toString() const;
@@ -257,4 +287,36 @@ private:
     JUCE_LEAK_DETECTOR (Matrix)
 };
 
+//==============================================================================
+template <typename ElementType>
+class Matrix<ElementType>::LUDecomposition
+{
+public:
+    /** Decomposes a square matrix. */
+    explicit LUDecomposition (const Matrix& matrix);
+
+    /** Returns false if the matrix was singular, in which case it can't be used to
+        solve any systems.
+    */
+    bool isValid() const noexcept                   { return valid; }
+
+    /** Solves the linear system represented by the decomposed matrix and b.
+
+        b must have the same number of rows as the matrix, and may have any number of
+        columns, each of which is treated as a separate right-hand side. After the
+        execution of the algorithm, b will contain the solution.
+
+        Returns false if the matrix was singular.
+    */
+    bool solve (Matrix& b) const noexcept;
+
+    /** Returns the determinant of the decomposed matrix. */
+    ElementType getDeterminant() const noexcept;
+
+private:
+    Matrix lu;
+    Array<size_t> permutation;
+    bool valid = false, oddPermutation = false;
+};
+
 } // namespace juce::dsp
@@ -153,6 +153,141 @@ struct LinearAlgebraUnitTest final : public UnitTest
         }
     };
 
+    template <typename ElementType>
+    static Matrix<ElementType> createRandomMatrix (Random& random, size_t numRows, size_t numColumns)
+    {
+        Matrix<ElementType> result (numRows, numColumns);
+
+        for (auto& x : result)
+            x = (ElementType) (random.nextDouble() * 2.0 - 1.0);
+
+        return result;
+    }
+
+    template <typename ElementType>
+    static Matrix<ElementType> referenceProduct (const Matrix<ElementType>& a, const Matrix<ElementType>& b)
+    {
+        Matrix<ElementType> result (a.getNumRows(), b.getNumColumns());
+
+        for (size_t i = 0; i < a.getNumRows(); ++i)
+            for (size_t j = 0; j < b.getNumColumns(); ++j)
+                for (size_t k = 0; k < a.getNumColumns(); ++k)
+                    result (i, j) += a (i, k) * b (k, j);
+
+        return result;
+    }
+
+    struct LargeMultiplicationTest
+    {
+        template <typename ElementType>
+        static void run (LinearAlgebraUnitTest& u)
+        {
+            Random random (u.getRandom().nextInt64());
+
+            // Sizes chosen to cover partial tiles and multiple cache blocks
+            for (auto [n, p, m] : { std::make_tuple (5, 7, 3), std::make_tuple (64, 64, 64),
+                                    std::make_tuple (37, 130, 300), std::make_tuple (64, 64, 1),
+                                    std::make_tuple (1, 200, 19), std::make_tuple (130, 3, 9) })
+            {
+                const auto a = createRandomMatrix<ElementType> (random, (size_t) n, (size_t) p);
+                const auto b = createRandomMatrix<ElementType> (random, (size_t) p, (size_t) m);
+
+                u.expect (Matrix<ElementType>::compare (a * b, referenceProduct (a, b), (ElementType) 1e-3));
+            }
+        }
+    };
+
+    struct LUDecompositionTest
+    {
+        template <typename ElementType>
+        static void run (LinearAlgebraUnitTest& u)
+        {
+            const ElementType data1[] = { 0, 2, 1, 1, 1, 1, 2, 1, 3 };
+            typename Matrix<ElementType>::LUDecomposition small (Matrix<ElementType> (3, 3, data1));
+            u.expect (small.isValid());
+            u.expectWithinAbsoluteError (small.getDeterminant(), (ElementType) -3, (ElementType) 1e-5);
+
+            const ElementType singularData[] = { 1, 2, 3, 2, 4, 6, 1, 0, 1 };
+            typename Matrix<ElementType>::LUDecomposition singular (Matrix<ElementType> (3, 3, singularData));
+            u.expect (! singular.isValid());
+
+            Random random (u.getRandom().nextInt64());
+
+            for (auto n : { 4, 17, 64 })
+            {
+                // Diagonally dominant, so that the system is well conditioned
+                auto a = createRandomMatrix<ElementType> (random, (size_t) n, (size_t) n);
+
+                for (size_t i = 0; i < (size_t) n; ++i)
+                    a (i, i) += (ElementType) n;
+
+                const auto x = createRandomMatrix<ElementType> (random, (size_t) n, 3);
+                const auto b = a * x;
+
+                typename Matrix<ElementType>::LUDecomposition decomposition (a);
+                auto solution = b;
+                u.expect (decomposition.solve (solution));
+                u.expect (Matrix<ElementType>::compare (solution, x, (ElementType) 1e-3));
+
+                Matrix<ElementType> column (b.getNumRows(), 1);
+
+                for (size_t i = 0; i < b.getNumRows(); ++i)
+                    column (i, 0) = b (i, 1);
+
+                u.expect (a.solve (column));
+
+                for (size_t i = 0; i < b.getNumRows(); ++i)
+                    u.expectWithinAbsoluteError (column (i, 0), x (i, 1), (ElementType) 1e-3);
+            }
+        }
+    };
+
+    struct BlockProcessingTest
+    {
+        template <typename ElementType>
+        static void run (LinearAlgebraUnitTest& u)
+        {
+            Random random (u.getRandom().nextInt64());
+
+            for (auto [numOutputs, numInputs] : { std::make_pair (3, 5), std::make_pair (16, 16),
+                                                  std::make_pair (64, 64), std::make_pair (2, 1) })
+            {
+                constexpr size_t numSamples = 1000;
+
+                const auto matrix = createRandomMatrix<ElementType> (random, (size_t) numOutputs, (size_t) numInputs);
+                const auto samples = createRandomMatrix<ElementType> (random, (size_t) numInputs, numSamples);
+                const auto expected = referenceProduct (matrix, samples);
+
+                HeapBlock<char> inputData, outputData;
+                AudioBlock<ElementType> input (inputData, (size_t) numInputs, numSamples);
+                AudioBlock<ElementType> output (outputData, (size_t) numOutputs, numSamples);
+
+                for (size_t ch = 0; ch < (size_t) numInputs; ++ch)
+                    std::copy (samples.begin() + ch * numSamples, samples.begin() + (ch + 1) * numSamples, input.getChannelPointer (ch));
+
+                matrix.process (input, output);
+
+                auto matches = [&] (const AudioBlock<ElementType>& block)
+                {
+                    for (size_t ch = 0; ch < (size_t) numOutputs; ++ch)
+                        for (size_t i = 0; i < numSamples; ++i)
+                            if (std::abs (block.getSample ((int) ch, (int) i) - expected (ch, i)) > (ElementType) 1e-4)
+                                return false;
+
+                    return true;
+                };
+
+                u.expect (matches (output));
+
+                if (numInputs == numOutputs)
+                {
+                    matrix.process (input, input);
+                    u.expect (matches (input));
+                }
+            }
+        }
+    };
+
     template <class TheTest>
     void runTestForAllTypes (const char* unitTestName)
     {
@@ -171,6 +306,9 @@ struct LinearAlgebraUnitTest final : public UnitTest
         runTestForAllTypes<MultiplicationTest> ("MultiplicationTest");
         runTestForAllTypes<IdentityMatrixTest> ("IdentityMatrixTest");
         runTestForAllTypes<SolvingTest> ("SolvingTest");
+        runTestForAllTypes<LargeMultiplicationTest> ("LargeMultiplicationTest");
+        runTestForAllTypes<LUDecompositionTest> ("LUDecompositionTest");
+        runTestForAllTypes<BlockProcessingTest> ("BlockProcessingTest");
     }
 };
 
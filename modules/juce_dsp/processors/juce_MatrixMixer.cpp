@@ -0,0 +1,344 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+//==============================================================================
+template <typename SampleType>
+MatrixMixer<SampleType>::MatrixMixer (size_t numInputChannels, size_t numOutputChannels)
+{
+    setNumChannels (numInputChannels, numOutputChannels);
+}
+
+template <typename SampleType>
+void MatrixMixer<SampleType>::setNumChannels (size_t numInputChannels, size_t numOutputChannels)
+{
+    numInputs = numInputChannels;
+    numOutputs = numOutputChannels;
+
+    Matrix<SampleType> identity (numOutputs, numInputs);
+
+    for (size_t i = 0; i < jmin (numInputs, numOutputs); ++i)
+        identity (i, i) = 1;
+
+    {
+        const SpinLock::ScopedLockType lock (pendingLock);
+        pendingGains = identity;
+        pendingGainsChanged = false;
+    }
+
+    currentGains = targetGains = identity;
+    gainIncrements = Matrix<SampleType> (numOutputs, numInputs);
+    remainingRampSamples = 0;
+
+    // Reserving the full size means that updating the lists never allocates
+    activeInputs.resize (numOutputs);
+
+    for (auto& inputs : activeInputs)
+        inputs.reserve (numInputs);
+
+    scratch.setSize ((int) numInputs, tileSize);
+    updateActiveInputs();
+}
+
+//==============================================================================
+template <typename SampleType>
+void MatrixMixer<SampleType>::setGain (size_t outputChannel, size_t inputChannel, SampleType newGain) noexcept
+{
+    jassert (outputChannel < numOutputs && inputChannel < numInputs);
+
+    const SpinLock::ScopedLockType lock (pendingLock);
+    pendingGains (outputChannel, inputChannel) = newGain;
+    pendingGainsChanged = true;
+}
+
+template <typename SampleType>
+void MatrixMixer<SampleType>::setGainMatrix (const Matrix<SampleType>& newGains) noexcept
+{
+    if (newGains.getNumRows() != numOutputs || newGains.getNumColumns() != numInputs)
+    {
+        jassertfalse; // the matrix must have a row for each output and a column for each input
+        return;
+    }
+
+    const SpinLock::ScopedLockType lock (pendingLock);
+    std::copy (newGains.getRawDataPointer(), newGains.getRawDataPointer() + numInputs * numOutputs,
+               pendingGains.getRawDataPointer());
+    pendingGainsChanged = true;
+}
+
+template <typename SampleType>
+Matrix<SampleType> MatrixMixer<SampleType>::getGainMatrix() const
+{
+    const SpinLock::ScopedLockType lock (pendingLock);
+    return pendingGains;
+}
+
+template <typename SampleType>
+void MatrixMixer<SampleType>::setRampDurationSeconds (double newDurationSeconds) noexcept
+{
+    jassert (newDurationSeconds >= 0.0);
+
+    rampDurationSeconds = newDurationSeconds;
+    rampLengthSamples = (int) std::floor (rampDurationSeconds * sampleRate);
+}
+
+//==============================================================================
+template <typename SampleType>
+void MatrixMixer<SampleType>::prepare (const ProcessSpec& spec)
+{
+    jassert (spec.sampleRate > 0);
+
+    sampleRate = spec.sampleRate;
+    setRampDurationSeconds (rampDurationSeconds);
+    reset();
+}
+
+template <typename SampleType>
+void MatrixMixer<SampleType>::reset() noexcept
+{
+    applyPendingGains();
+
+    currentGains = targetGains;
+    remainingRampSamples = 0;
+    updateActiveInputs();
+}
+
+//==============================================================================
+template <typename SampleType>
+void MatrixMixer<SampleType>::applyPendingGains() noexcept
+{
+    const SpinLock::ScopedTryLockType lock (pendingLock);
+
+    if (! lock.isLocked() || ! pendingGainsChanged)
+        return;
+
+    pendingGainsChanged = false;
+    std::copy (pendingGains.getRawDataPointer(), pendingGains.getRawDataPointer() + numInputs * numOutputs,
+               targetGains.getRawDataPointer());
+
+    if (rampLengthSamples > 0)
+    {
+        // A ramp that is already running restarts from the current gains
+        const auto* target = targetGains.getRawDataPointer();
+        const auto* current = currentGains.getRawDataPointer();
+        auto* increments = gainIncrements.getRawDataPointer();
+
+        for (size_t i = 0; i < numInputs * numOutputs; ++i)
+            increments[i] = (target[i] - current[i]) / (SampleType) rampLengthSamples;
+
+        remainingRampSamples = rampLengthSamples;
+    }
+    else
+    {
+        std::copy (targetGains.getRawDataPointer(), targetGains.getRawDataPointer() + numInputs * numOutputs,
+                   currentGains.getRawDataPointer());
+        remainingRampSamples = 0;
+    }
+
+    updateActiveInputs();
+}
+
+template <typename SampleType>
+void MatrixMixer<SampleType>::updateActiveInputs() noexcept
+{
+    numActiveGains = 0;
+
+    for (size_t out = 0; out < numOutputs; ++out)
+    {
+        auto& inputs = activeInputs[out];
+        inputs.clear();
+
+        for (size_t in = 0; in < numInputs; ++in)
+        {
+            if (! exactlyEqual (currentGains (out, in), (SampleType) 0)
+                || ! exactlyEqual (targetGains (out, in), (SampleType) 0))
+            {
+                inputs.push_back (in);
+            }
+        }
+
+        numActiveGains += inputs.size();
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void MatrixMixer<SampleType>::processBlock (const AudioBlock<const SampleType>& input,
+                                            const AudioBlock<SampleType>& output,
+                                            bool isBypassed) noexcept
+{
+    jassert (input.getNumChannels() >= numInputs && output.getNumChannels() >= numOutputs);
+    jassert (input.getNumSamples() == output.getNumSamples());
+
+    applyPendingGains();
+
+    const auto numSamples = output.getNumSamples();
+
+    if (isBypassed)
+    {
+        const auto numToCopy = jmin (numInputs, numOutputs);
+
+        // Empty blocks don't have any channel pointers to compare or clear
+        if (numSamples == 0)
+            return;
+
+        if (numToCopy > 0 && input.getChannelPointer (0) != output.getChannelPointer (0))
+            output.getSubsetChannelBlock (0, numToCopy).copyFrom (input.getSubsetChannelBlock (0, numToCopy));
+
+        if (numOutputs > numToCopy)
+            output.getSubsetChannelBlock (numToCopy, numOutputs - numToCopy).clear();
+
+        return;
+    }
+
+    const auto inputs  = input.getSubsetChannelBlock (0, numInputs);
+    const auto outputs = output.getSubsetChannelBlock (0, numOutputs);
+
+    size_t position = 0;
+
+    while (position < numSamples)
+    {
+        if (remainingRampSamples > 0)
+        {
+            const auto numInRamp = jmin (numSamples - position, (size_t) remainingRampSamples);
+
+            processRamp (inputs.getSubBlock (position, numInRamp), outputs.getSubBlock (position, numInRamp));
+            position += numInRamp;
+            remainingRampSamples -= (int) numInRamp;
+
+            if (remainingRampSamples == 0)
+            {
+                // Snap to the targets to avoid accumulated rounding errors
+                std::copy (targetGains.getRawDataPointer(), targetGains.getRawDataPointer() + numInputs * numOutputs,
+                           currentGains.getRawDataPointer());
+                updateActiveInputs();
+            }
+        }
+        else
+        {
+            processSteady (inputs.getSubBlock (position), outputs.getSubBlock (position));
+            position = numSamples;
+        }
+    }
+}
+
+template <typename SampleType>
+void MatrixMixer<SampleType>::copyToScratch (const AudioBlock<const SampleType>& input, size_t startSample, size_t numSamples) noexcept
+{
+    for (size_t in = 0; in < numInputs; ++in)
+        FloatVectorOperations::copy (scratch.getWritePointer ((int) in), input.getChannelPointer (in) + startSample, numSamples);
+}
+
+template <typename SampleType>
+void MatrixMixer<SampleType>::processSteady (const AudioBlock<const SampleType>& input,
+                                             const AudioBlock<SampleType>& output) noexcept
+{
+    constexpr size_t maxDenseChannels = 256;
+
+    // Mostly non-zero matrices are cheaper to apply as a whole, using the blocked
+    // SIMD kernel of the Matrix class
+    if (numActiveGains * 2 > numInputs * numOutputs && jmax (numInputs, numOutputs) <= maxDenseChannels)
+    {
+        currentGains.process (input, output);
+        return;
+    }
+
+    const auto numSamples = output.getNumSamples();
+
+    for (size_t start = 0; start < numSamples; start += (size_t) tileSize)
+    {
+        const auto numInTile = jmin ((size_t) tileSize, numSamples - start);
+
+        copyToScratch (input, start, numInTile);
+
+        for (size_t out = 0; out < numOutputs; ++out)
+        {
+            auto* dest = output.getChannelPointer (out) + start;
+            const auto& inputs = activeInputs[out];
+
+            if (inputs.empty())
+            {
+                FloatVectorOperations::clear (dest, numInTile);
+                continue;
+            }
+
+            FloatVectorOperations::copyWithMultiply (dest, scratch.getReadPointer ((int) inputs.front()),
+                                                     currentGains (out, inputs.front()), numInTile);
+
+            for (size_t i = 1; i < inputs.size(); ++i)
+                FloatVectorOperations::addWithMultiply (dest, scratch.getReadPointer ((int) inputs[i]),
+                                                        currentGains (out, inputs[i]), numInTile);
+        }
+    }
+}
+
+template <typename SampleType>
+void MatrixMixer<SampleType>::processRamp (const AudioBlock<const SampleType>& input,
+                                           const AudioBlock<SampleType>& output) noexcept
+{
+    const auto numSamples = output.getNumSamples();
+
+    for (size_t start = 0; start < numSamples; start += (size_t) tileSize)
+    {
+        const auto numInTile = jmin ((size_t) tileSize, numSamples - start);
+
+        copyToScratch (input, start, numInTile);
+
+        for (size_t out = 0; out < numOutputs; ++out)
+        {
+            auto* dest = output.getChannelPointer (out) + start;
+            FloatVectorOperations::clear (dest, numInTile);
+
+            for (auto in : activeInputs[out])
+            {
+                const auto* src = scratch.getReadPointer ((int) in);
+                auto& gain = currentGains (out, in);
+                const auto increment = gainIncrements (out, in);
+
+                for (size_t i = 0; i < numInTile; ++i)
+                    dest[i] += src[i] * (gain + increment * (SampleType) (i + 1));
+
+                gain += increment * (SampleType) numInTile;
+            }
+        }
+    }
+}
+
+//==============================================================================
+template class MatrixMixer<float>;
+template class MatrixMixer<double>;
+
+} // namespace juce::dsp
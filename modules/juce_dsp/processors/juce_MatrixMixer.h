@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+/**
+    A processor that mixes a number of input channels into a number of output channels,
+    using a matrix of gains.
+
+    Each output channel is the sum of all the input channels, each multiplied by the
+    gain at the corresponding row and column of the gain matrix, so the matrix has one
+    row per output channel and one column per input channel. This makes it suitable for
+    things like ambisonic decoding, up/down-mixing and routing.
+
+    When the gains change, they ramp linearly to their new values over the duration
+    set with setRampDurationSeconds(). Gains that are zero (and not ramping) are
+    skipped entirely, so sparse routing matrices are cheap to apply.
+
+    The input block must have at least getNumInputChannels() channels and the output
+    block at least getNumOutputChannels() channels. When processing in place, the block
+    must have enough channels for both; only the first getNumOutputChannels() channels
+    are written.
+
+    The gains may be changed from any thread; the new values are picked up at the start
+    of the next call to process().
+
+    @see Matrix
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class MatrixMixer
+{
+public:
+    //==============================================================================
+    /** Creates a mixer with no inputs or outputs. */
+    MatrixMixer() = default;
+
+    /** Creates a mixer with the given number of channels.
+        @see setNumChannels
+    */
+    MatrixMixer (size_t numInputChannels, size_t numOutputChannels);
+
+    //==============================================================================
+    /** Changes the number of input and output channels.
+
+        This allocates memory, so it must not be called while the mixer is being used
+        by another thread. All the gains are reset so that each input channel is sent
+        to the output channel with the same index.
+    */
+    void setNumChannels (size_t numInputChannels, size_t numOutputChannels);
+
+    /** Returns the number of input channels. */
+    size_t getNumInputChannels() const noexcept                 { return numInputs; }
+
+    /** Returns the number of output channels. */
+    size_t getNumOutputChannels() const noexcept                { return numOutputs; }
+
+    //==============================================================================
+    /** Sets the gain applied when mixing an input channel into an output channel. */
+    void setGain (size_t outputChannel, size_t inputChannel, SampleType newGain) noexcept;
+
+    /** Sets all the gains at once.
+
+        The matrix must have getNumOutputChannels() rows and getNumInputChannels() columns.
+    */
+    void setGainMatrix (const Matrix<SampleType>& newGains) noexcept;
+
+    /** Returns the most recently requested gains. */
+    Matrix<SampleType> getGainMatrix() const;
+
+    /** Sets the length of the ramp used when the gains change. The default is 50ms. */
+    void setRampDurationSeconds (double newDurationSeconds) noexcept;
+
+    //==============================================================================
+    /** Initialises the processor. */
+    void prepare (const ProcessSpec& spec);
+
+    /** Resets the internal state, jumping straight to the requested gains. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Processes the input and output samples supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        processBlock (context.getInputBlock(), context.getOutputBlock(), context.isBypassed);
+    }
+
+private:
+    //==============================================================================
+    void processBlock (const AudioBlock<const SampleType>& input, const AudioBlock<SampleType>& output, bool isBypassed) noexcept;
+    void processSteady (const AudioBlock<const SampleType>& input, const AudioBlock<SampleType>& output) noexcept;
+    void processRamp (const AudioBlock<const SampleType>& input, const AudioBlock<SampleType>& output) noexcept;
+    void copyToScratch (const AudioBlock<const SampleType>& input, size_t startSample, size_t numSamples) noexcept;
+    void applyPendingGains() noexcept;
+    void updateActiveInputs() noexcept;
+
+    //==============================================================================
+    // Gains requested by the setter methods, which may be called on any thread
+    Matrix<SampleType> pendingGains { 0, 0 };
+    SpinLock pendingLock;
+    bool pendingGainsChanged = false;
+
+    // State owned by the audio thread
+    Matrix<SampleType> currentGains { 0, 0 }, targetGains { 0, 0 }, gainIncrements { 0, 0 };
+    std::vector<std::vector<size_t>> activeInputs;
+    size_t numActiveGains = 0;
+    AudioBuffer<SampleType> scratch;
+
+    size_t numInputs = 0, numOutputs = 0;
+    double sampleRate = 44100.0, rampDurationSeconds = 0.05;
+    int rampLengthSamples = 0, remainingRampSamples = 0;
+
+    // The number of samples processed at a time on the sparse and ramping paths, so
+    // that the input channels being mixed stay in the cache
+    static constexpr int tileSize = 128;
+};
+
+} // namespace juce::dsp
@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+class MatrixMixerTest final : public UnitTest
+{
+public:
+    MatrixMixerTest()
+        : UnitTest ("MatrixMixer", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        runForAllTypes<SteadyTest> ("Dense and sparse gains match a reference mix");
+        runForAllTypes<InPlaceTest> ("In-place processing");
+        runForAllTypes<RampTest> ("Gain changes ramp to their target values");
+        runForAllTypes<BypassTest> ("Bypassed processing copies the inputs");
+    }
+
+private:
+    template <typename SampleType>
+    struct TestData
+    {
+        TestData (Random& random, size_t numInputChannels, size_t numOutputChannels, size_t numSamplesIn)
+            : numInputs (numInputChannels), numOutputs (numOutputChannels), numSamples (numSamplesIn),
+              input (inputData, numInputs, numSamples),
+              output (outputData, numOutputs, numSamples)
+        {
+            for (size_t ch = 0; ch < numInputs; ++ch)
+                for (size_t i = 0; i < numSamples; ++i)
+                    input.setSample ((int) ch, (int) i, (SampleType) (random.nextDouble() * 2.0 - 1.0));
+
+            output.clear();
+        }
+
+        SampleType getExpected (const Matrix<SampleType>& gains, size_t outputChannel, size_t sample) const
+        {
+            SampleType sum = 0;
+
+            for (size_t in = 0; in < numInputs; ++in)
+                sum += gains (outputChannel, in) * input.getSample ((int) in, (int) sample);
+
+            return sum;
+        }
+
+        bool matches (const Matrix<SampleType>& gains, const AudioBlock<SampleType>& block) const
+        {
+            for (size_t out = 0; out < numOutputs; ++out)
+                for (size_t i = 0; i < numSamples; ++i)
+                    if (std::abs (block.getSample ((int) out, (int) i) - getExpected (gains, out, i)) > (SampleType) 1e-4)
+                        return false;
+
+            return true;
+        }
+
+        size_t numInputs, numOutputs, numSamples;
+        HeapBlock<char> inputData, outputData;
+        AudioBlock<SampleType> input, output;
+    };
+
+    template <typename SampleType>
+    static Matrix<SampleType> createGains (Random& random, size_t numOutputs, size_t numInputs, double density)
+    {
+        Matrix<SampleType> gains (numOutputs, numInputs);
+
+        for (auto& g : gains)
+            if (random.nextDouble() < density)
+                g = (SampleType) (random.nextDouble() * 2.0 - 1.0);
+
+        return gains;
+    }
+
+    static ProcessSpec createSpec (size_t numChannels)
+    {
+        return { 48000.0, 512, (uint32) numChannels };
+    }
+
+    struct SteadyTest
+    {
+        template <typename SampleType>
+        static void run (MatrixMixerTest& u)
+        {
+            auto random = u.getRandom();
+
+            for (auto [numInputs, numOutputs] : { std::make_pair (64, 64), std::make_pair (128, 16),
+                                                  std::make_pair (3, 5), std::make_pair (1, 2) })
+            {
+                for (auto density : { 1.0, 0.1, 0.0 })
+                {
+                    TestData<SampleType> data (random, (size_t) numInputs, (size_t) numOutputs, 300);
+                    const auto gains = createGains<SampleType> (random, (size_t) numOutputs, (size_t) numInputs, density);
+
+                    MatrixMixer<SampleType> mixer ((size_t) numInputs, (size_t) numOutputs);
+                    mixer.setGainMatrix (gains);
+                    mixer.prepare (createSpec ((size_t) jmax (numInputs, numOutputs)));
+
+                    mixer.process (ProcessContextNonReplacing<SampleType> (data.input, data.output));
+                    u.expect (data.matches (gains, data.output));
+                }
+            }
+        }
+    };
+
+    struct InPlaceTest
+    {
+        template <typename SampleType>
+        static void run (MatrixMixerTest& u)
+        {
+            auto random = u.getRandom();
+
+            for (auto density : { 1.0, 0.2 })
+            {
+                constexpr size_t numChannels = 16;
+
+                TestData<SampleType> data (random, numChannels, numChannels, 1000);
+                const auto gains = createGains<SampleType> (random, numChannels, numChannels, density);
+
+                MatrixMixer<SampleType> mixer (numChannels, numChannels);
+                mixer.setGainMatrix (gains);
+                mixer.prepare (createSpec (numChannels));
+
+                data.output.copyFrom (data.input);
+                mixer.process (ProcessContextReplacing<SampleType> (data.output));
+                u.expect (data.matches (gains, data.output));
+            }
+        }
+    };
+
+    struct RampTest
+    {
+        template <typename SampleType>
+        static void run (MatrixMixerTest& u)
+        {
+            auto random = u.getRandom();
+
+            constexpr size_t numInputs = 4, numOutputs = 3, numSamples = 1000;
+            TestData<SampleType> data (random, numInputs, numOutputs, numSamples);
+
+            MatrixMixer<SampleType> mixer (numInputs, numOutputs);
+            mixer.prepare (createSpec (numInputs));
+            mixer.setRampDurationSeconds (0.01);
+
+            const auto gains = createGains<SampleType> (random, numOutputs, numInputs, 0.5);
+            mixer.setGainMatrix (gains);
+            u.expect (mixer.getGainMatrix() == gains);
+
+            // The ramp lasts 480 samples, so the first block is only partly mixed
+            mixer.process (ProcessContextNonReplacing<SampleType> (data.input, data.output));
+
+            const auto identity = [&]
+            {
+                Matrix<SampleType> m (numOutputs, numInputs);
+
+                for (size_t i = 0; i < numOutputs; ++i)
+                    m (i, i) = 1;
+
+                return m;
+            }();
+
+            for (size_t out = 0; out < numOutputs; ++out)
+            {
+                // Halfway through the ramp, the gains are halfway between the old and new values
+                const auto halfway = (identity + gains) * (SampleType) 0.5;
+                u.expectWithinAbsoluteError (data.output.getSample ((int) out, 239),
+                                             data.getExpected (halfway, out, 239),
+                                             (SampleType) 1e-4);
+
+                u.expectWithinAbsoluteError (data.output.getSample ((int) out, 600),
+                                             data.getExpected (gains, out, 600),
+                                             (SampleType) 1e-4);
+            }
+
+            data.output.clear();
+            mixer.process (ProcessContextNonReplacing<SampleType> (data.input, data.output));
+            u.expect (data.matches (gains, data.output));
+
+            // Changing a single gain with no ramp takes effect immediately
+            mixer.setRampDurationSeconds (0.0);
+            auto newGains = gains;
+            newGains (1, 2) = (SampleType) 0.75;
+            mixer.setGain (1, 2, (SampleType) 0.75);
+
+            mixer.process (ProcessContextNonReplacing<SampleType> (data.input, data.output));
+            u.expect (data.matches (newGains, data.output));
+        }
+    };
+
+    struct BypassTest
+    {
+        template <typename SampleType>
+        static void run (MatrixMixerTest& u)
+        {
+            auto random = u.getRandom();
+
+            constexpr size_t numInputs = 2, numOutputs = 4, numSamples = 100;
+            TestData<SampleType> data (random, numInputs, numOutputs, numSamples);
+            data.output.fill ((SampleType) 1);
+
+            MatrixMixer<SampleType> mixer (numInputs, numOutputs);
+            mixer.setGainMatrix (createGains<SampleType> (random, numOutputs, numInputs, 1.0));
+            mixer.prepare (createSpec (numOutputs));
+
+            ProcessContextNonReplacing<SampleType> context (data.input, data.output);
+            context.isBypassed = true;
+            mixer.process (context);
+
+            Matrix<SampleType> identity (numOutputs, numInputs);
+            identity (0, 0) = identity (1, 1) = 1;
+            u.expect (data.matches (identity, data.output));
+
+            // Empty blocks, and mixers without any inputs, have no channel data to compare
+            auto emptyOutput = data.output.getSubBlock (0, 0);
+            ProcessContextReplacing<SampleType> emptyContext (emptyOutput);
+            emptyContext.isBypassed = true;
+            mixer.process (emptyContext);
+
+            MatrixMixer<SampleType> noInputs (0, numOutputs);
+            noInputs.prepare (createSpec (numOutputs));
+            noInputs.process (context);
+
+            for (size_t ch = 0; ch < numOutputs; ++ch)
+                for (size_t i = 0; i < numSamples; ++i)
+                    u.expect (exactlyEqual (data.output.getSample ((int) ch, (int) i), (SampleType) 0));
+        }
+    };
+
+    template <class TheTest>
+    void runForAllTypes (const char* testName)
+    {
+        beginTest (testName);
+
+        TheTest::template run<float> (*this);
+        TheTest::template run<double> (*this);
+    }
+};
+
+static MatrixMixerTest matrixMixerTest;
+
+} // namespace juce::dsp
@@ -110,16 +110,94 @@ struct OversamplingDummy final : public Oversampling<SampleType>::OversamplingSt
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OversamplingDummy)
 };
 
+//==============================================================================
+/** Helper used by the oversampling stages to process several channels at once,
+    one channel per SIMD lane.
+
+    The channels of a block are split into groups of numLanes channels, and each
+    group is interleaved into a buffer of registers so that the filters can run
+    on all the channels of a group with a single instruction stream. When SIMD
+    is not available, a group contains a single channel.
+*/
+template <typename SampleType>
+struct OversamplingLanes
+{
+   #if JUCE_USE_SIMD
+    using Register = SIMDRegister<SampleType>;
+   #else
+    using Register = SampleType;
+   #endif
+
+    static constexpr size_t numLanes = sizeof (Register) / sizeof (SampleType);
+
+    static size_t getNumGroups (size_t numChannels) noexcept
+    {
+        return (numChannels + numLanes - 1) / numLanes;
+    }
+
+    static size_t getNumChannelsInGroup (size_t numChannels, size_t group) noexcept
+    {
+        return jmin (numLanes, numChannels - group * numLanes);
+    }
+
+    template <typename BlockType>
+    static void interleave (const BlockType& block, size_t group, Register* dest, size_t numSamples) noexcept
+    {
+        auto* raw = reinterpret_cast<SampleType*> (dest);
+        auto numChannelsInGroup = getNumChannelsInGroup (block.getNumChannels(), group);
+
+        if (numChannelsInGroup < numLanes)
+            std::fill (raw, raw + numSamples * numLanes, static_cast<SampleType> (0));
+
+        for (size_t lane = 0; lane < numChannelsInGroup; ++lane)
+        {
+            auto* samples = block.getChannelPointer (group * numLanes + lane);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                raw[i * numLanes + lane] = samples[i];
+        }
+    }
+
+    static void deinterleave (const Register* source, AudioBlock<SampleType>& block, size_t group, size_t numSamples) noexcept
+    {
+        auto* raw = reinterpret_cast<const SampleType*> (source);
+        auto numChannelsInGroup = getNumChannelsInGroup (block.getNumChannels(), group);
+
+        for (size_t lane = 0; lane < numChannelsInGroup; ++lane)
+        {
+            auto* samples = block.getChannelPointer (group * numLanes + lane);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                samples[i] = raw[i * numLanes + lane];
+        }
+    }
+
+    static void snapToZero (std::vector<Register>& state) noexcept
+    {
+        auto* raw = reinterpret_cast<SampleType*> (state.data());
+
+        for (size_t i = 0; i < state.size() * numLanes; ++i)
+            util::snapToZero (raw[i]);
+    }
+};
+
 //==============================================================================
 /** Oversampling stage class performing 2 times oversampling using the Filter
     Design FIR Equiripple method. The resulting filter is linear phase,
     symmetric, and has every two samples but the middle one equal to zero,
     leading to specific processing optimizations.
+
+    The filters are run in their polyphase form: only the non-zero taps are
+    stored, the two halves of the symmetric impulse response are folded
+    together, and the histories are kept in mirrored circular buffers so that
+    no samples have to be shifted. Channels are processed in SIMD lanes.
 */
 template <typename SampleType>
 struct Oversampling2TimesEquirippleFIR final : public Oversampling<SampleType>::OversamplingStage
 {
     using ParentType = typename Oversampling<SampleType>::OversamplingStage;
+    using Lanes = OversamplingLanes<SampleType>;
+    using Register = typename Lanes::Register;
 
     Oversampling2TimesEquirippleFIR (size_t numChans,
                                      SampleType normalisedTransitionWidthUp,
@@ -128,37 +206,41 @@ struct Oversampling2TimesEquirippleFIR final : public Oversampling<SampleType>::
                                      SampleType stopbandAmplitudedBDown)
         : ParentType (numChans, 2)
     {
-        coefficientsUp   = *FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidthUp,   stopbandAmplitudedBUp);
-        coefficientsDown = *FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidthDown, stopbandAmplitudedBDown);
+        auto coefficientsUp   = *FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidthUp,   stopbandAmplitudedBUp);
+        auto coefficientsDown = *FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (normalisedTransitionWidthDown, stopbandAmplitudedBDown);
 
-        auto N = coefficientsUp.getFilterOrder() + 1;
-        stateUp.setSize (static_cast<int> (this->numChannels), static_cast<int> (N));
+        orderUp   = coefficientsUp.getFilterOrder();
+        orderDown = coefficientsDown.getFilterOrder();
 
-        N = coefficientsDown.getFilterOrder() + 1;
-        auto Ndiv2 = N / 2;
-        auto Ndiv4 = Ndiv2 / 2;
+        up.setCoefficients   (coefficientsUp);
+        down.setCoefficients (coefficientsDown);
 
-        stateDown.setSize  (static_cast<int> (this->numChannels), static_cast<int> (N));
-        stateDown2.setSize (static_cast<int> (this->numChannels), static_cast<int> (Ndiv4 + 1));
+        auto numGroups = Lanes::getNumGroups (this->numChannels);
 
-        position.resize (static_cast<int> (this->numChannels));
+        up.allocate (numGroups, 0);
+        down.allocate (numGroups, down.getNumTaps());
     }
 
     //==============================================================================
     SampleType getLatencyInSamples() const override
     {
-        return static_cast<SampleType> (coefficientsUp.getFilterOrder() + coefficientsDown.getFilterOrder()) * 0.5f;
+        return static_cast<SampleType> (orderUp + orderDown) * 0.5f;
+    }
+
+    void initProcessing (size_t maximumNumberOfSamplesBeforeOversampling) override
+    {
+        ParentType::initProcessing (maximumNumberOfSamplesBeforeOversampling);
+
+        interleavedInput .resize (maximumNumberOfSamplesBeforeOversampling * ParentType::factor);
+        interleavedOutput.resize (maximumNumberOfSamplesBeforeOversampling * ParentType::factor);
     }
 
     void reset() override
     {
         ParentType::reset();
 
-        stateUp.clear();
-        stateDown.clear();
-        stateDown2.clear();
-
-        position.fill (0);
+        up.reset();
+        down.reset();
     }
 
     void processSamplesUp (const AudioBlock<const SampleType>& inputBlock) override
@@ -167,37 +249,47 @@ struct Oversampling2TimesEquirippleFIR final : public Oversampling<SampleType>::
         jassert (inputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
 
         // Initialization
-        auto fir = coefficientsUp.getRawCoefficients();
-        auto N = coefficientsUp.getFilterOrder() + 1;
-        auto Ndiv2 = N / 2;
+        auto taps = up.taps.data();
+        auto numTaps = up.getNumTaps();
+        auto historyLength = up.historyLength;
+        auto centreTap = up.centreTap;
+        auto centreOffset = historyLength - numTaps;
         auto numSamples = inputBlock.getNumSamples();
+        auto outputBlock = AudioBlock<SampleType> (ParentType::buffer).getSubsetChannelBlock (0, inputBlock.getNumChannels());
 
         // Processing
-        for (size_t channel = 0; channel < inputBlock.getNumChannels(); ++channel)
+        for (size_t group = 0; group < Lanes::getNumGroups (inputBlock.getNumChannels()); ++group)
         {
-            auto bufferSamples = ParentType::buffer.getWritePointer (static_cast<int> (channel));
-            auto buf = stateUp.getWritePointer (static_cast<int> (channel));
-            auto samples = inputBlock.getChannelPointer (channel);
+            Lanes::interleave (inputBlock, group, interleavedInput.data(), numSamples);
+
+            auto samples = interleavedInput.data();
+            auto bufferSamples = interleavedOutput.data();
+            auto history = up.getHistory (group);
+            auto pos = up.positions[group];
 
             for (size_t i = 0; i < numSamples; ++i)
             {
                 // Input
-                buf[N - 1] = 2 * samples[i];
+                history[pos] = history[pos + historyLength] = samples[i] * static_cast<SampleType> (2);
+                auto window = history + pos + 1;
 
-                // Convolution
-                auto out = static_cast<SampleType> (0.0);
+                // Convolution, folding the symmetric halves of the impulse response
+                auto out = Register (static_cast<SampleType> (0.0));
 
-                for (size_t k = 0; k < Ndiv2; k += 2)
-                    out += (buf[k] + buf[N - k - 1]) * fir[k];
+                for (size_t k = 0; k < numTaps; ++k)
+                    out += (window[k] + window[historyLength - 1 - k]) * taps[k];
 
                 // Outputs
                 bufferSamples[i << 1] = out;
-                bufferSamples[(i << 1) + 1] = buf[Ndiv2 + 1] * fir[Ndiv2];
+                bufferSamples[(i << 1) + 1] = window[centreOffset] * centreTap;
 
-                // Shift data
-                for (size_t k = 0; k < N - 2; k += 2)
-                    buf[k] = buf[k + 2];
+                // Circular buffer
+                pos = (pos + 1 == historyLength ? 0 : pos + 1);
             }
+
+            up.positions[group] = pos;
+
+            Lanes::deinterleave (interleavedOutput.data(), outputBlock, group, numSamples << 1);
         }
     }
 
@@ -207,56 +299,114 @@ struct Oversampling2TimesEquirippleFIR final : public Oversampling<SampleType>::
         jassert (outputBlock.getNumSamples() * ParentType::factor <= static_cast<size_t> (ParentType::buffer.getNumSamples()));
 
         // Initialization
-        auto fir = coefficientsDown.getRawCoefficients();
-        auto N = coefficientsDown.getFilterOrder() + 1;
-        auto Ndiv2 = N / 2;
-        auto Ndiv4 = Ndiv2 / 2;
+        auto taps = down.taps.data();
+        auto numTaps = down.getNumTaps();
+        auto historyLength = down.historyLength;
+        auto centreTap = down.centreTap;
         auto numSamples = outputBlock.getNumSamples();
+        auto inputBlock = AudioBlock<const SampleType> (ParentType::buffer).getSubsetChannelBlock (0, outputBlock.getNumChannels());
 
         // Processing
-        for (size_t channel = 0; channel < outputBlock.getNumChannels(); ++channel)
+        for (size_t group = 0; group < Lanes::getNumGroups (outputBlock.getNumChannels()); ++group)
         {
-            auto bufferSamples = ParentType::buffer.getWritePointer (static_cast<int> (channel));
-            auto buf = stateDown.getWritePointer (static_cast<int> (channel));
-            auto buf2 = stateDown2.getWritePointer (static_cast<int> (channel));
-            auto samples = outputBlock.getChannelPointer (channel);
-            auto pos = position.getUnchecked (static_cast<int> (channel));
+            Lanes::interleave (inputBlock, group, interleavedInput.data(), numSamples << 1);
+
+            auto bufferSamples = interleavedInput.data();
+            auto samples = interleavedOutput.data();
+            auto history = down.getHistory (group);
+            auto delayed = down.getDelayLine (group);
+            auto pos = down.positions[group];
+            auto delayPos = down.delayPositions[group];
 
             for (size_t i = 0; i < numSamples; ++i)
             {
                 // Input
-                buf[N - 1] = bufferSamples[i << 1];
+                history[pos] = history[pos + historyLength] = bufferSamples[i << 1];
+                auto window = history + pos + 1;
 
-                // Convolution
-                auto out = static_cast<SampleType> (0.0);
+                // Convolution, folding the symmetric halves of the impulse response
+                auto out = Register (static_cast<SampleType> (0.0));
 
-                for (size_t k = 0; k < Ndiv2; k += 2)
-                    out += (buf[k] + buf[N - k - 1]) * fir[k];
+                for (size_t k = 0; k < numTaps; ++k)
+                    out += (window[k] + window[historyLength - 1 - k]) * taps[k];
 
-                // Output
-                out += buf2[pos] * fir[Ndiv2];
-                buf2[pos] = bufferSamples[(i << 1) + 1];
+                // Output, with the odd samples only going through the centre tap
+                out += delayed[delayPos] * centreTap;
+                delayed[delayPos] = bufferSamples[(i << 1) + 1];
 
                 samples[i] = out;
 
-                // Shift data
-                for (size_t k = 0; k < N - 2; ++k)
-                    buf[k] = buf[k + 2];
-
-                // Circular buffer
-                pos = (pos == 0 ? Ndiv4 : pos - 1);
+                // Circular buffers
+                pos = (pos + 1 == historyLength ? 0 : pos + 1);
+                delayPos = (delayPos + 1 == numTaps ? 0 : delayPos + 1);
             }
 
-            position.setUnchecked (static_cast<int> (channel), pos);
-        }
+            down.positions[group] = pos;
+            down.delayPositions[group] = delayPos;
 
+            Lanes::deinterleave (interleavedOutput.data(), outputBlock, group, numSamples);
+        }
     }
 
 private:
     //==============================================================================
-    FIR::Coefficients<SampleType> coefficientsUp, coefficientsDown;
-    AudioBuffer<SampleType> stateUp, stateDown, stateDown2;
-    Array<size_t> position;
+    /** The polyphase decomposition of a half-band FIR filter and its state.
+
+        For a half-band filter of order 2 * c with c odd, the even phase of the
+        filter only has (c + 1) / 2 distinct non-zero taps, applied to a history of
+        c + 1 samples, and the odd phase reduces to the centre tap.
+    */
+    struct HalfBandFilter
+    {
+        void setCoefficients (const FIR::Coefficients<SampleType>& coefficients)
+        {
+            auto fir = coefficients.getRawCoefficients();
+            auto N = coefficients.getFilterOrder() + 1;
+            auto Ndiv2 = N / 2;
+
+            taps.clear();
+
+            for (size_t k = 0; k < Ndiv2; k += 2)
+                taps.push_back (fir[k]);
+
+            centreTap = fir[Ndiv2];
+            historyLength = Ndiv2 + 1;
+        }
+
+        size_t getNumTaps() const noexcept      { return taps.size(); }
+
+        void allocate (size_t numGroups, size_t delayLineLength)
+        {
+            history.resize (numGroups * historyLength * 2);
+            delayLines.resize (numGroups * delayLineLength);
+            positions.resize (numGroups);
+            delayPositions.resize (numGroups);
+            reset();
+        }
+
+        void reset()
+        {
+            std::fill (history.begin(), history.end(), Register (static_cast<SampleType> (0)));
+            std::fill (delayLines.begin(), delayLines.end(), Register (static_cast<SampleType> (0)));
+            std::fill (positions.begin(), positions.end(), 0);
+            std::fill (delayPositions.begin(), delayPositions.end(), 0);
+        }
+
+        Register* getHistory (size_t group) noexcept    { return history.data() + group * historyLength * 2; }
+        Register* getDelayLine (size_t group) noexcept  { return delayLines.data() + group * getNumTaps(); }
+
+        std::vector<SampleType> taps;
+        SampleType centreTap = 0;
+        size_t historyLength = 0;
+
+        std::vector<Register> history, delayLines;
+        std::vector<size_t> positions, delayPositions;
+    };
+
+    //==============================================================================
+    size_t orderUp = 0, orderDown = 0;
+    HalfBandFilter up, down;
+    std::vector<Register> interleavedInput, interleavedOutput;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampling2TimesEquirippleFIR)
@@ -267,11 +417,16 @@ private:
 /** Oversampling stage class performing 2 times oversampling using the Filter
     Design IIR Polyphase Allpass Cascaded method. The resulting filter is minimum
     phase, and provided with a method to get the exact resulting latency.
+
+    The allpass cascades are recursive, so instead of vectorising along time
+    the channels are processed in SIMD lanes.
 */
 template <typename SampleType>
 struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::OversamplingStage
 {
     using ParentType = typename Oversampling<SampleType>::OversamplingStage;
+    using Lanes = OversamplingLanes<SampleType>;
+    using Register = typename Lanes::Register;
 
     Oversampling2TimesPolyphaseIIR (size_t numChans,
                                     SampleType normalisedTransitionWidthUp,
@@ -300,9 +455,11 @@ struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::O
         for (auto i = 1; i < structureDown.delayedPath.size(); ++i)
             coefficientsDown.add (structureDown.delayedPath.getObjectPointer (i)->coefficients[0]);
 
-        v1Up.setSize   (static_cast<int> (this->numChannels), coefficientsUp.size());
-        v1Down.setSize (static_cast<int> (this->numChannels), coefficientsDown.size());
-        delayDown.resize (static_cast<int> (this->numChannels));
+        auto numGroups = Lanes::getNumGroups (this->numChannels);
+
+        v1Up  .resize (numGroups * static_cast<size_t> (coefficientsUp.size()));
+        v1Down.resize (numGroups * static_cast<size_t> (coefficientsDown.size()));
+        delayDown.resize (numGroups);
     }
 
     //==============================================================================
@@ -311,12 +468,21 @@ struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::O
         return latency;
     }
 
+    void initProcessing (size_t maximumNumberOfSamplesBeforeOversampling) override
+    {
+        ParentType::initProcessing (maximumNumberOfSamplesBeforeOversampling);
+
+        interleavedInput .resize (maximumNumberOfSamplesBeforeOversampling * ParentType::factor);
+        interleavedOutput.resize (maximumNumberOfSamplesBeforeOversampling * ParentType::factor);
+    }
+
     void reset() override
     {
         ParentType::reset();
-        v1Up.clear();
-        v1Down.clear();
-        delayDown.fill (0);
+
+        std::fill (v1Up.begin(),      v1Up.end(),      Register (static_cast<SampleType> (0)));
+        std::fill (v1Down.begin(),    v1Down.end(),    Register (static_cast<SampleType> (0)));
+        std::fill (delayDown.begin(), delayDown.end(), Register (static_cast<SampleType> (0)));
     }
 
     void processSamplesUp (const AudioBlock<const SampleType>& inputBlock) override
@@ -330,13 +496,16 @@ struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::O
         auto delayedStages = numStages / 2;
         auto directStages = numStages - delayedStages;
         auto numSamples = inputBlock.getNumSamples();
+        auto outputBlock = AudioBlock<SampleType> (ParentType::buffer).getSubsetChannelBlock (0, inputBlock.getNumChannels());
 
         // Processing
-        for (size_t channel = 0; channel < inputBlock.getNumChannels(); ++channel)
+        for (size_t group = 0; group < Lanes::getNumGroups (inputBlock.getNumChannels()); ++group)
         {
-            auto bufferSamples = ParentType::buffer.getWritePointer (static_cast<int> (channel));
-            auto lv1 = v1Up.getWritePointer (static_cast<int> (channel));
-            auto samples = inputBlock.getChannelPointer (channel);
+            Lanes::interleave (inputBlock, group, interleavedInput.data(), numSamples);
+
+            auto samples = interleavedInput.data();
+            auto bufferSamples = interleavedOutput.data();
+            auto lv1 = v1Up.data() + group * static_cast<size_t> (numStages);
 
             for (size_t i = 0; i < numSamples; ++i)
             {
@@ -346,8 +515,8 @@ struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::O
                 for (auto n = 0; n < directStages; ++n)
                 {
                     auto alpha = coeffs[n];
-                    auto output = alpha * input + lv1[n];
-                    lv1[n] = input - alpha * output;
+                    auto output = input * alpha + lv1[n];
+                    lv1[n] = input - output * alpha;
                     input = output;
                 }
 
@@ -360,14 +529,16 @@ struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::O
                 for (auto n = directStages; n < numStages; ++n)
                 {
                     auto alpha = coeffs[n];
-                    auto output = alpha * input + lv1[n];
-                    lv1[n] = input - alpha * output;
+                    auto output = input * alpha + lv1[n];
+                    lv1[n] = input - output * alpha;
                     input = output;
                 }
 
                 // Output
                 bufferSamples[(i << 1) + 1] = input;
             }
+
+            Lanes::deinterleave (interleavedOutput.data(), outputBlock, group, numSamples << 1);
         }
 
        #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
@@ -386,14 +557,17 @@ struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::O
         auto delayedStages = numStages / 2;
         auto directStages = numStages - delayedStages;
         auto numSamples = outputBlock.getNumSamples();
+        auto inputBlock = AudioBlock<const SampleType> (ParentType::buffer).getSubsetChannelBlock (0, outputBlock.getNumChannels());
 
         // Processing
-        for (size_t channel = 0; channel < outputBlock.getNumChannels(); ++channel)
+        for (size_t group = 0; group < Lanes::getNumGroups (outputBlock.getNumChannels()); ++group)
         {
-            auto bufferSamples = ParentType::buffer.getWritePointer (static_cast<int> (channel));
-            auto lv1 = v1Down.getWritePointer (static_cast<int> (channel));
-            auto samples = outputBlock.getChannelPointer (channel);
-            auto delay = delayDown.getUnchecked (static_cast<int> (channel));
+            Lanes::interleave (inputBlock, group, interleavedInput.data(), numSamples << 1);
+
+            auto bufferSamples = interleavedInput.data();
+            auto samples = interleavedOutput.data();
+            auto lv1 = v1Down.data() + group * static_cast<size_t> (numStages);
+            auto delay = delayDown[group];
 
             for (size_t i = 0; i < numSamples; ++i)
             {
@@ -403,8 +577,8 @@ struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::O
                 for (auto n = 0; n < directStages; ++n)
                 {
                     auto alpha = coeffs[n];
-                    auto output = alpha * input + lv1[n];
-                    lv1[n] = input - alpha * output;
+                    auto output = input * alpha + lv1[n];
+                    lv1[n] = input - output * alpha;
                     input = output;
                 }
 
@@ -416,8 +590,8 @@ struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::O
                 for (auto n = directStages; n < numStages; ++n)
                 {
                     auto alpha = coeffs[n];
-                    auto output = alpha * input + lv1[n];
-                    lv1[n] = input - alpha * output;
+                    auto output = input * alpha + lv1[n];
+                    lv1[n] = input - output * alpha;
                     input = output;
                 }
 
@@ -426,7 +600,9 @@ struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::O
                 delay = input;
             }
 
-            delayDown.setUnchecked (static_cast<int> (channel), delay);
+            delayDown[group] = delay;
+
+            Lanes::deinterleave (interleavedOutput.data(), outputBlock, group, numSamples);
         }
 
        #if JUCE_DSP_ENABLE_SNAP_TO_ZERO
@@ -437,27 +613,9 @@ struct Oversampling2TimesPolyphaseIIR final : public Oversampling<SampleType>::O
     void snapToZero (bool snapUpProcessing)
     {
         if (snapUpProcessing)
-        {
-            for (auto channel = 0; channel < ParentType::buffer.getNumChannels(); ++channel)
-            {
-                auto lv1 = v1Up.getWritePointer (channel);
-                auto numStages = coefficientsUp.size();
-
-                for (auto n = 0; n < numStages; ++n)
-                    util::snapToZero (lv1[n]);
-            }
-        }
+            Lanes::snapToZero (v1Up);
         else
-        {
-            for (auto channel = 0; channel < ParentType::buffer.getNumChannels(); ++channel)
-            {
-                auto lv1 = v1Down.getWritePointer (channel);
-                auto numStages = coefficientsDown.size();
-
-                for (auto n = 0; n < numStages; ++n)
-                    util::snapToZero (lv1[n]);
-            }
-        }
+            Lanes::snapToZero (v1Down);
     }
 
 private:
@@ -527,8 +685,8 @@ private:
     Array<SampleType> coefficientsUp, coefficientsDown;
     SampleType latency;
 
-    AudioBuffer<SampleType> v1Up, v1Down;
-    Array<SampleType> delayDown;
+    std::vector<Register> v1Up, v1Down, delayDown;
+    std::vector<Register> interleavedInput, interleavedOutput;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampling2TimesPolyphaseIIR)
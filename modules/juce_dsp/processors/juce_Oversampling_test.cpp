@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+class OversamplingTest final : public UnitTest
+{
+public:
+    OversamplingTest()
+        : UnitTest ("Oversampling", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("FIR stage matches a direct convolution with the half-band filter");
+        {
+            checkFIRStageAgainstConvolution<float>  (1e-5);
+            checkFIRStageAgainstConvolution<double> (1e-12);
+        }
+
+        beginTest ("Channels processed together give the same results as channels processed alone");
+        {
+            for (auto type : { Oversampling<float>::filterHalfBandFIREquiripple, Oversampling<float>::filterHalfBandPolyphaseIIR })
+                for (size_t factor = 1; factor <= 3; ++factor)
+                    for (size_t numChannels : { 1u, 2u, 3u, 5u, 9u })
+                        checkChannelsAreIndependent<float> (numChannels, factor, type);
+
+            for (auto type : { Oversampling<double>::filterHalfBandFIREquiripple, Oversampling<double>::filterHalfBandPolyphaseIIR })
+                checkChannelsAreIndependent<double> (3, 2, type);
+        }
+    }
+
+private:
+    static constexpr size_t maxBlockSize = 64;
+
+    template <typename SampleType>
+    void checkFIRStageAgainstConvolution (double tolerance)
+    {
+        constexpr auto twUp = 0.1f, dBUp = -90.0f, twDown = 0.12f, dBDown = -75.0f;
+
+        Oversampling<SampleType> oversampling (1);
+        oversampling.clearOversamplingStages();
+        oversampling.addOversamplingStage (Oversampling<SampleType>::filterHalfBandFIREquiripple, twUp, dBUp, twDown, dBDown);
+        oversampling.initProcessing (maxBlockSize);
+
+        auto upFilter   = FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (twUp,   dBUp);
+        auto downFilter = FilterDesign<SampleType>::designFIRLowpassHalfBandEquirippleMethod (twDown, dBDown);
+
+        constexpr size_t numBlocks = 8;
+        auto random = getRandom();
+
+        std::vector<SampleType> input (numBlocks * maxBlockSize), upsampled, oversampledInput, output;
+
+        for (auto& sample : input)
+            sample = static_cast<SampleType> (random.nextFloat() * 2.0f - 1.0f);
+
+        for (size_t block = 0; block < numBlocks; ++block)
+        {
+            auto* inputData = input.data() + block * maxBlockSize;
+            AudioBlock<const SampleType> inputBlock (&inputData, 1, maxBlockSize);
+            auto oversampledBlock = oversampling.processSamplesUp (inputBlock);
+
+            for (size_t i = 0; i < oversampledBlock.getNumSamples(); ++i)
+            {
+                upsampled.push_back (oversampledBlock.getSample (0, (int) i));
+
+                auto newSample = static_cast<SampleType> (random.nextFloat() * 2.0f - 1.0f);
+                oversampledInput.push_back (newSample);
+                oversampledBlock.setSample (0, (int) i, newSample);
+            }
+
+            std::vector<SampleType> outputData (maxBlockSize);
+            auto* outputPtr = outputData.data();
+            AudioBlock<SampleType> outputBlock (&outputPtr, 1, maxBlockSize);
+            oversampling.processSamplesDown (outputBlock);
+            output.insert (output.end(), outputData.begin(), outputData.end());
+        }
+
+        const auto convolve = [] (const FIR::Coefficients<SampleType>& filter, auto&& getInput, size_t n)
+        {
+            auto* h = filter.getRawCoefficients();
+            auto result = static_cast<SampleType> (0);
+
+            for (size_t j = 0; j <= jmin (n, filter.getFilterOrder()); ++j)
+                result += h[j] * getInput (n - j);
+
+            return result;
+        };
+
+        auto maxUpError = 0.0, maxDownError = 0.0;
+
+        for (size_t n = 0; n < upsampled.size(); ++n)
+        {
+            auto expected = convolve (*upFilter, [&] (size_t k) { return (k & 1) == 0 ? 2 * input[k >> 1] : SampleType(); }, n);
+            maxUpError = jmax (maxUpError, (double) std::abs (expected - upsampled[n]));
+        }
+
+        for (size_t n = 0; n < output.size(); ++n)
+        {
+            auto expected = convolve (*downFilter, [&] (size_t k) { return oversampledInput[k]; }, n << 1);
+            maxDownError = jmax (maxDownError, (double) std::abs (expected - output[n]));
+        }
+
+        expectLessThan (maxUpError, tolerance);
+        expectLessThan (maxDownError, tolerance);
+    }
+
+    template <typename SampleType>
+    void checkChannelsAreIndependent (size_t numChannels, size_t factor, typename Oversampling<SampleType>::FilterType type)
+    {
+        Oversampling<SampleType> multichannel (numChannels, factor, type);
+        multichannel.initProcessing (maxBlockSize);
+
+        OwnedArray<Oversampling<SampleType>> mono;
+
+        for (size_t channel = 0; channel < numChannels; ++channel)
+        {
+            mono.add (new Oversampling<SampleType> (1, factor, type));
+            mono.getLast()->initProcessing (maxBlockSize);
+        }
+
+        auto random = getRandom();
+        AudioBuffer<SampleType> input ((int) numChannels, (int) maxBlockSize), output ((int) numChannels, (int) maxBlockSize);
+        auto maxError = 0.0;
+
+        for (auto blockSize : { maxBlockSize, (size_t) 17, (size_t) 1, (size_t) 40, maxBlockSize })
+        {
+            for (int channel = 0; channel < (int) numChannels; ++channel)
+                for (int i = 0; i < (int) blockSize; ++i)
+                    input.setSample (channel, i, static_cast<SampleType> (random.nextFloat() * 2.0f - 1.0f));
+
+            auto inputBlock = AudioBlock<const SampleType> (input).getSubBlock (0, blockSize);
+            auto outputBlock = AudioBlock<SampleType> (output).getSubBlock (0, blockSize);
+
+            auto oversampled = multichannel.processSamplesUp (inputBlock);
+
+            for (size_t channel = 0; channel < numChannels; ++channel)
+            {
+                auto monoOversampled = mono[(int) channel]->processSamplesUp (inputBlock.getSingleChannelBlock (channel));
+
+                for (size_t i = 0; i < oversampled.getNumSamples(); ++i)
+                    maxError = jmax (maxError, (double) std::abs (oversampled.getSample ((int) channel, (int) i)
+                                                                  - monoOversampled.getSample (0, (int) i)));
+
+                auto monoOutput = outputBlock.getSingleChannelBlock (channel);
+                mono[(int) channel]->processSamplesDown (monoOutput);
+            }
+
+            AudioBuffer<SampleType> monoResults;
+            monoResults.makeCopyOf (output);
+
+            multichannel.processSamplesDown (outputBlock);
+
+            for (int channel = 0; channel < (int) numChannels; ++channel)
+                for (int i = 0; i < (int) blockSize; ++i)
+                    maxError = jmax (maxError, (double) std::abs (output.getSample (channel, i) - monoResults.getSample (channel, i)));
+        }
+
+        expectEquals (maxError, 0.0);
+    }
+};
+
+static OversamplingTest oversamplingUnitTest;
+
+} // namespace juce::dsp
@@ -0,0 +1,299 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+// Lets the oscillator code be written once for SIMD registers and plain floats
+struct OscillatorBankLanes
+{
+    template <typename Type> static Type get (Type r, size_t) noexcept                  { return r; }
+    template <typename Type> static void set (Type& r, size_t, Type value) noexcept     { r = value; }
+    template <typename Type> static Type truncate (Type x) noexcept                     { return std::trunc (x); }
+    template <typename Type> static Type max (Type a, Type b) noexcept                  { return jmax (a, b); }
+    template <typename Type> static Type abs (Type x) noexcept                          { return std::abs (x); }
+    template <typename Type> static Type sum (Type x) noexcept                          { return x; }
+    template <typename Type> static bool isAllZero (Type x) noexcept                    { return exactlyEqual (x, Type()); }
+
+   #if JUCE_USE_SIMD
+    template <typename Type> static Type get (SIMDRegister<Type> r, size_t lane) noexcept                   { return r[lane]; }
+    template <typename Type> static void set (SIMDRegister<Type>& r, size_t lane, Type value) noexcept      { r[lane] = value; }
+    template <typename Type> static SIMDRegister<Type> truncate (SIMDRegister<Type> x) noexcept             { return SIMDRegister<Type>::truncate (x); }
+    template <typename Type> static SIMDRegister<Type> max (SIMDRegister<Type> a, SIMDRegister<Type> b) noexcept { return SIMDRegister<Type>::max (a, b); }
+    template <typename Type> static SIMDRegister<Type> abs (SIMDRegister<Type> x) noexcept                  { return SIMDRegister<Type>::abs (x); }
+    template <typename Type> static Type sum (SIMDRegister<Type> x) noexcept                                { return x.sum(); }
+    template <typename Type> static bool isAllZero (SIMDRegister<Type> x) noexcept                          { return x == Type(); }
+   #endif
+};
+
+//==============================================================================
+template <typename SampleType>
+OscillatorBank<SampleType>::OscillatorBank (size_t numOscillatorsToUse)
+{
+    setNumOscillators (numOscillatorsToUse);
+}
+
+template <typename SampleType>
+void OscillatorBank<SampleType>::setNumOscillators (size_t newNumOscillators)
+{
+    const auto firstToClear = jmin (numOscillators, newNumOscillators);
+
+    numOscillators = newNumOscillators;
+    groups.resize ((numOscillators + registerSize - 1) / registerSize);
+
+    // Unused lanes are left silent, so that whole registers can always be processed
+    for (auto i = firstToClear; i < groups.size() * registerSize; ++i)
+    {
+        auto& group = groups[i / registerSize];
+        const auto lane = i % registerSize;
+
+        OscillatorBankLanes::set (group.phases, lane, SampleType());
+        OscillatorBankLanes::set (group.increments, lane, SampleType());
+        OscillatorBankLanes::set (group.inverseIncrements, lane, SampleType());
+        OscillatorBankLanes::set (group.gains, lane, SampleType());
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void OscillatorBank<SampleType>::setFrequency (size_t oscillatorIndex, SampleType newFrequencyHz) noexcept
+{
+    jassert (oscillatorIndex < numOscillators);
+    jassert (newFrequencyHz >= 0 && newFrequencyHz <= sampleRate / 2);
+
+    auto& group = groups[oscillatorIndex / registerSize];
+    const auto lane = oscillatorIndex % registerSize;
+    const auto increment = jlimit (SampleType(), SampleType (0.5), newFrequencyHz / sampleRate);
+
+    OscillatorBankLanes::set (group.increments, lane, increment);
+    OscillatorBankLanes::set (group.inverseIncrements, lane, increment > 0 ? 1 / increment : SampleType());
+}
+
+template <typename SampleType>
+SampleType OscillatorBank<SampleType>::getFrequency (size_t oscillatorIndex) const noexcept
+{
+    jassert (oscillatorIndex < numOscillators);
+    return OscillatorBankLanes::get (groups[oscillatorIndex / registerSize].increments, oscillatorIndex % registerSize) * sampleRate;
+}
+
+template <typename SampleType>
+void OscillatorBank<SampleType>::setGain (size_t oscillatorIndex, SampleType newGain) noexcept
+{
+    jassert (oscillatorIndex < numOscillators);
+    OscillatorBankLanes::set (groups[oscillatorIndex / registerSize].gains, oscillatorIndex % registerSize, newGain);
+}
+
+template <typename SampleType>
+SampleType OscillatorBank<SampleType>::getGain (size_t oscillatorIndex) const noexcept
+{
+    jassert (oscillatorIndex < numOscillators);
+    return OscillatorBankLanes::get (groups[oscillatorIndex / registerSize].gains, oscillatorIndex % registerSize);
+}
+
+template <typename SampleType>
+void OscillatorBank<SampleType>::setPhase (size_t oscillatorIndex, SampleType newPhase) noexcept
+{
+    jassert (oscillatorIndex < numOscillators);
+    jassert (newPhase >= 0 && newPhase < 1);
+
+    OscillatorBankLanes::set (groups[oscillatorIndex / registerSize].phases, oscillatorIndex % registerSize, newPhase);
+}
+
+//==============================================================================
+template <typename SampleType>
+void OscillatorBank<SampleType>::prepare (const ProcessSpec& spec) noexcept
+{
+    jassert (spec.sampleRate > 0);
+
+    // Keep the frequencies the same at the new sample rate
+    const auto newSampleRate = static_cast<SampleType> (spec.sampleRate);
+    const auto ratio = sampleRate / newSampleRate;
+
+    for (size_t i = 0; i < numOscillators; ++i)
+    {
+        auto& group = groups[i / registerSize];
+        const auto lane = i % registerSize;
+        const auto increment = OscillatorBankLanes::get (group.increments, lane) * ratio;
+
+        OscillatorBankLanes::set (group.increments, lane, increment);
+        OscillatorBankLanes::set (group.inverseIncrements, lane, increment > 0 ? 1 / increment : SampleType());
+    }
+
+    sampleRate = newSampleRate;
+    reset();
+}
+
+template <typename SampleType>
+void OscillatorBank<SampleType>::reset() noexcept
+{
+    for (auto& group : groups)
+        group.phases = Register (SampleType());
+}
+
+//==============================================================================
+template <typename SampleType>
+template <OscillatorBankWaveform shape>
+void OscillatorBank<SampleType>::render (Register* sums, size_t numSamples) noexcept
+{
+    using Lanes = OscillatorBankLanes;
+
+    const Register zero (SampleType (0)), one (SampleType (1));
+
+    // Folds the phase into a quarter cycle either side of zero, then uses a polynomial
+    // that is accurate to better than 1e-9 in that range
+    const auto sine = [&] (Register phase)
+    {
+        auto shifted = phase + SampleType (0.75);
+        shifted = shifted - Lanes::truncate (shifted);
+
+        const auto x = (Lanes::abs (shifted - SampleType (0.5)) - SampleType (0.25)) * MathConstants<SampleType>::twoPi;
+        const auto x2 = x * x;
+
+        auto polynomial = x2 * SampleType (1.0 / 6227020800.0) - SampleType (1.0 / 39916800.0);
+        polynomial = polynomial * x2 + SampleType (1.0 / 362880.0);
+        polynomial = polynomial * x2 - SampleType (1.0 / 5040.0);
+        polynomial = polynomial * x2 + SampleType (1.0 / 120.0);
+        polynomial = polynomial * x2 - SampleType (1.0 / 6.0);
+        polynomial = polynomial * x2 + SampleType (1);
+
+        return x * polynomial;
+    };
+
+    // A naive sawtooth, with a PolyBLEP correction that smooths the discontinuity over
+    // the samples either side of it
+    const auto saw = [&] (Register phase, Register inverseIncrement)
+    {
+        const auto before = Lanes::max (zero, one - (one - phase) * inverseIncrement);
+        const auto after  = Lanes::max (zero, one - phase * inverseIncrement);
+
+        return phase * SampleType (2) - SampleType (1) - (before * before - after * after);
+    };
+
+    for (auto& group : groups)
+    {
+        auto phase = group.phases;
+        const auto increment = group.increments;
+
+        // Silent groups only need their phases updating
+        if (Lanes::isAllZero (group.gains))
+        {
+            phase += increment * (SampleType) numSamples;
+            group.phases = phase - Lanes::truncate (phase);
+            continue;
+        }
+
+        const auto inverseIncrement = group.inverseIncrements;
+        const auto gain = group.gains;
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            if constexpr (shape == OscillatorBankWaveform::sine)
+            {
+                sums[i] += gain * sine (phase);
+            }
+            else if constexpr (shape == OscillatorBankWaveform::saw)
+            {
+                sums[i] += gain * saw (phase, inverseIncrement);
+            }
+            else
+            {
+                auto shifted = phase + SampleType (0.5);
+                shifted = shifted - Lanes::truncate (shifted);
+
+                sums[i] += gain * (saw (shifted, inverseIncrement) - saw (phase, inverseIncrement));
+            }
+
+            phase += increment;
+            phase = phase - Lanes::truncate (phase);
+        }
+
+        group.phases = phase;
+    }
+}
+
+template <typename SampleType>
+void OscillatorBank<SampleType>::processBlock (const AudioBlock<const SampleType>& input,
+                                               const AudioBlock<SampleType>& output) noexcept
+{
+    // The oscillators are summed across the register lanes for a chunk of samples at a
+    // time, so each sample only needs one horizontal addition
+    constexpr size_t chunkSize = 64;
+    Register sums[chunkSize];
+    SampleType results[chunkSize];
+
+    const auto numSamples = output.getNumSamples();
+
+    for (size_t start = 0; start < numSamples; start += chunkSize)
+    {
+        const auto num = jmin (chunkSize, numSamples - start);
+
+        std::fill (sums, sums + num, Register (SampleType()));
+
+        switch (waveform)
+        {
+            case OscillatorBankWaveform::sine:    render<OscillatorBankWaveform::sine>   (sums, num); break;
+            case OscillatorBankWaveform::saw:     render<OscillatorBankWaveform::saw>    (sums, num); break;
+            case OscillatorBankWaveform::square:  render<OscillatorBankWaveform::square> (sums, num); break;
+        }
+
+        for (size_t i = 0; i < num; ++i)
+            results[i] = OscillatorBankLanes::sum (sums[i]);
+
+        for (size_t ch = 0; ch < output.getNumChannels(); ++ch)
+        {
+            auto* dest = output.getChannelPointer (ch) + start;
+
+            if (ch < input.getNumChannels())
+                FloatVectorOperations::add (dest, input.getChannelPointer (ch) + start, results, num);
+            else
+                FloatVectorOperations::copy (dest, results, num);
+        }
+    }
+}
+
+template <typename SampleType>
+void OscillatorBank<SampleType>::skip (size_t numSamples) noexcept
+{
+    for (auto& group : groups)
+    {
+        auto phase = group.phases + group.increments * (SampleType) numSamples;
+        group.phases = phase - OscillatorBankLanes::truncate (phase);
+    }
+}
+
+//==============================================================================
+template class OscillatorBank<float>;
+template class OscillatorBank<double>;
+
+} // namespace juce::dsp
@@ -0,0 +1,174 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+/** The waveforms that can be generated by an OscillatorBank.
+
+    @tags{DSP}
+*/
+enum class OscillatorBankWaveform
+{
+    sine,       /**< A sine wave. */
+    saw,        /**< A rising sawtooth, band-limited using PolyBLEP. */
+    square      /**< A square wave, band-limited using PolyBLEP. */
+};
+
+//==============================================================================
+/**
+    Generates the sum of many oscillators, each with its own frequency, gain and phase.
+
+    This is intended for things like additive synthesis, where rendering hundreds of
+    separate Oscillator objects would be expensive. The oscillators are processed in
+    groups using SIMD registers, and the waveforms are calculated directly rather than
+    through a user-supplied function, so the whole inner loop can be inlined.
+
+    All the oscillators share the same waveform. The sawtooth and square waveforms are
+    band-limited using PolyBLEP, which removes most of the aliasing caused by their
+    discontinuities.
+
+    As with Oscillator, the generated signal is added to the input channels, and written
+    to any output channels that don't have a corresponding input.
+
+    @see Oscillator
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class OscillatorBank
+{
+public:
+    //==============================================================================
+    /** Creates an oscillator bank with no oscillators. */
+    OscillatorBank() = default;
+
+    /** Creates an oscillator bank with a number of silent oscillators. */
+    explicit OscillatorBank (size_t numOscillators);
+
+    //==============================================================================
+    /** Changes the number of oscillators.
+
+        This allocates memory, so it must not be called while processing. Any new
+        oscillators have a frequency and gain of zero.
+    */
+    void setNumOscillators (size_t newNumOscillators);
+
+    /** Returns the number of oscillators. */
+    size_t getNumOscillators() const noexcept                   { return numOscillators; }
+
+    /** Sets the waveform used by all of the oscillators. */
+    void setWaveform (OscillatorBankWaveform newWaveform) noexcept  { waveform = newWaveform; }
+
+    /** Returns the waveform used by all of the oscillators. */
+    OscillatorBankWaveform getWaveform() const noexcept         { return waveform; }
+
+    //==============================================================================
+    /** Sets the frequency of one of the oscillators, in Hz.
+
+        The frequency must be between zero and half the sample rate.
+    */
+    void setFrequency (size_t oscillatorIndex, SampleType newFrequencyHz) noexcept;
+
+    /** Returns the frequency of one of the oscillators, in Hz. */
+    SampleType getFrequency (size_t oscillatorIndex) const noexcept;
+
+    /** Sets the gain of one of the oscillators. */
+    void setGain (size_t oscillatorIndex, SampleType newGain) noexcept;
+
+    /** Returns the gain of one of the oscillators. */
+    SampleType getGain (size_t oscillatorIndex) const noexcept;
+
+    /** Sets the phase of one of the oscillators, as a proportion of a cycle in the
+        range 0 to 1.
+    */
+    void setPhase (size_t oscillatorIndex, SampleType newPhase) noexcept;
+
+    //==============================================================================
+    /** Called before processing starts. */
+    void prepare (const ProcessSpec& spec) noexcept;
+
+    /** Resets the phases of all the oscillators to zero. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Processes the input and output buffers supplied in the processing context. */
+    template <typename ProcessContext>
+    void process (const ProcessContext& context) noexcept
+    {
+        const auto& inputBlock = context.getInputBlock();
+        const auto& outputBlock = context.getOutputBlock();
+
+        jassert (inputBlock.getNumSamples() == outputBlock.getNumSamples());
+
+        if (context.isBypassed)
+        {
+            outputBlock.clear();
+            skip (outputBlock.getNumSamples());
+            return;
+        }
+
+        processBlock (inputBlock, outputBlock);
+    }
+
+private:
+    //==============================================================================
+    void processBlock (const AudioBlock<const SampleType>& input, const AudioBlock<SampleType>& output) noexcept;
+    void skip (size_t numSamples) noexcept;
+
+    //==============================================================================
+   #if JUCE_USE_SIMD
+    using Register = SIMDRegister<SampleType>;
+    static constexpr size_t registerSize = Register::SIMDNumElements;
+   #else
+    using Register = SampleType;
+    static constexpr size_t registerSize = 1;
+   #endif
+
+    // Each register holds the state of a group of oscillators, in its lanes
+    struct Group
+    {
+        Register phases, increments, inverseIncrements, gains;
+    };
+
+    template <OscillatorBankWaveform>
+    void render (Register* sums, size_t numSamples) noexcept;
+
+    std::vector<Group> groups;
+    size_t numOscillators = 0;
+    SampleType sampleRate = 48000;
+    OscillatorBankWaveform waveform = OscillatorBankWaveform::sine;
+};
+
+} // namespace juce::dsp
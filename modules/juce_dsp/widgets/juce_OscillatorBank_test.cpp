@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::dsp
+{
+
+class OscillatorBankTest final : public UnitTest
+{
+public:
+    OscillatorBankTest()
+        : UnitTest ("OscillatorBank", UnitTestCategories::dsp)
+    {}
+
+    void runTest() override
+    {
+        runForAllTypes<SineTest> ("Sine oscillators match a reference");
+        runForAllTypes<BandLimitedTest> ("Sawtooth and square waves");
+        runForAllTypes<ChannelsTest> ("Input channels and bypass");
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+
+    template <typename SampleType>
+    static void render (OscillatorBank<SampleType>& bank, AudioBuffer<SampleType>& buffer)
+    {
+        buffer.clear();
+        AudioBlock<SampleType> block (buffer);
+        bank.process (ProcessContextReplacing<SampleType> (block));
+    }
+
+    struct SineTest
+    {
+        template <typename SampleType>
+        static void run (OscillatorBankTest& u)
+        {
+            auto random = u.getRandom();
+
+            // Not a multiple of any register size, so some lanes are unused
+            constexpr size_t numOscillators = 37;
+            std::vector<double> frequencies, gains, phases;
+
+            OscillatorBank<SampleType> bank (numOscillators);
+            bank.prepare ({ sampleRate, 1000, 1 });
+
+            for (size_t i = 0; i < numOscillators; ++i)
+            {
+                frequencies.push_back (random.nextDouble() * 20000.0);
+                gains.push_back (random.nextDouble() / (double) numOscillators);
+                phases.push_back (random.nextDouble() * 0.99);
+
+                bank.setFrequency (i, (SampleType) frequencies.back());
+                bank.setGain (i, (SampleType) gains.back());
+                bank.setPhase (i, (SampleType) phases.back());
+            }
+
+            u.expectWithinAbsoluteError (bank.getFrequency (3), (SampleType) frequencies[3], (SampleType) 1e-2);
+            u.expectEquals (bank.getGain (5), (SampleType) gains[5]);
+
+            AudioBuffer<SampleType> buffer (1, 1000);
+            render (bank, buffer);
+
+            auto maxError = 0.0;
+
+            for (int n = 0; n < buffer.getNumSamples(); ++n)
+            {
+                auto expected = 0.0;
+
+                for (size_t i = 0; i < numOscillators; ++i)
+                    expected += gains[i] * std::sin (MathConstants<double>::twoPi * (phases[i] + frequencies[i] * n / sampleRate));
+
+                maxError = jmax (maxError, std::abs (expected - (double) buffer.getSample (0, n)));
+            }
+
+            u.expect (maxError < (std::is_same_v<SampleType, float> ? 1e-3 : 1e-6));
+
+            // Changing the sample rate keeps the frequencies the same
+            bank.prepare ({ sampleRate * 2, 1000, 1 });
+            u.expectWithinAbsoluteError (bank.getFrequency (3), (SampleType) frequencies[3], (SampleType) 1e-2);
+        }
+    };
+
+    struct BandLimitedTest
+    {
+        template <typename SampleType>
+        static void run (OscillatorBankTest& u)
+        {
+            // 480 Hz gives exactly 100 samples per cycle
+            OscillatorBank<SampleType> bank (1);
+            bank.prepare ({ sampleRate, 1000, 1 });
+            bank.setFrequency (0, (SampleType) 480);
+            bank.setGain (0, (SampleType) 1);
+
+            AudioBuffer<SampleType> buffer (1, 1000);
+
+            bank.setWaveform (OscillatorBankWaveform::saw);
+            render (bank, buffer);
+
+            for (int n = 0; n < buffer.getNumSamples(); ++n)
+            {
+                const auto position = n % 100;
+
+                // Only the samples next to the discontinuity are changed by the correction
+                if (position != 0 && position != 99)
+                    u.expectWithinAbsoluteError (buffer.getSample (0, n), (SampleType) (position / 50.0 - 1.0), (SampleType) 1e-3);
+
+                u.expect (std::abs (buffer.getSample (0, n)) <= (SampleType) 1);
+            }
+
+            bank.reset();
+            bank.setWaveform (OscillatorBankWaveform::square);
+            render (bank, buffer);
+
+            for (int n = 0; n < buffer.getNumSamples(); ++n)
+            {
+                const auto position = n % 50;
+
+                if (position != 0 && position != 49)
+                    u.expectWithinAbsoluteError (std::abs (buffer.getSample (0, n)), (SampleType) 1, (SampleType) 1e-3);
+            }
+
+            u.expect (buffer.getSample (0, 10) > 0 && buffer.getSample (0, 60) < 0);
+        }
+    };
+
+    struct ChannelsTest
+    {
+        template <typename SampleType>
+        static void run (OscillatorBankTest& u)
+        {
+            OscillatorBank<SampleType> bank (2);
+            bank.prepare ({ sampleRate, 100, 2 });
+            bank.setFrequency (0, (SampleType) 1000);
+            bank.setGain (0, (SampleType) 0.5);
+
+            AudioBuffer<SampleType> reference (1, 100);
+            render (bank, reference);
+
+            bank.reset();
+
+            AudioBuffer<SampleType> input (1, 100), output (2, 100);
+            for (int n = 0; n < 100; ++n)
+                input.setSample (0, n, (SampleType) 0.25);
+
+            AudioBlock<SampleType> inputBlock (input), outputBlock (output);
+            bank.process (ProcessContextNonReplacing<SampleType> (inputBlock, outputBlock));
+
+            for (int n = 0; n < 100; ++n)
+            {
+                u.expectWithinAbsoluteError (output.getSample (0, n), reference.getSample (0, n) + (SampleType) 0.25, (SampleType) 1e-6);
+                u.expectWithinAbsoluteError (output.getSample (1, n), reference.getSample (0, n), (SampleType) 1e-6);
+            }
+
+            // Bypassing clears the output, but the phases still advance
+            bank.reset();
+
+            auto firstHalf = outputBlock.getSubBlock (0, 50), secondHalf = outputBlock.getSubBlock (50, 50);
+
+            ProcessContextNonReplacing<SampleType> bypassed (inputBlock.getSubBlock (0, 50), firstHalf);
+            bypassed.isBypassed = true;
+            bank.process (bypassed);
+            u.expect (exactlyEqual (output.getMagnitude (0, 50), (SampleType) 0));
+
+            output.clear();
+            bank.process (ProcessContextNonReplacing<SampleType> (inputBlock.getSubBlock (0, 50), secondHalf));
+
+            for (int n = 50; n < 100; ++n)
+                u.expectWithinAbsoluteError (output.getSample (1, n), reference.getSample (0, n), (SampleType) 1e-4);
+        }
+    };
+
+    template <class TheTest>
+    void runForAllTypes (const char* testName)
+    {
+        beginTest (testName);
+
+        TheTest::template run<float> (*this);
+        TheTest::template run<double> (*this);
+    }
+};
+
+static OscillatorBankTest oscillatorBankTest;
+
+} // namespace juce::dsp
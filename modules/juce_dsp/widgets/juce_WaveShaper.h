@@ -35,9 +35,23 @@
 namespace juce::dsp
 {
 
+namespace detail
+{
+    template <typename Fn, typename FloatType, typename = void>
+    constexpr auto hasBlockProcessing = false;
+
+    template <typename Fn, typename FloatType>
+    constexpr auto hasBlockProcessing<Fn, FloatType, std::void_t<decltype (std::declval<const Fn&>().process (std::declval<const FloatType*>(),
+                                                                                                             std::declval<FloatType*>(),
+                                                                                                             size_t{}))>> = true;
+} // namespace detail
+
 /**
     Applies waveshaping to audio samples as single samples or AudioBlocks.
 
+    If the function has a member function that processes a whole array of samples,
+    like LookupTableTransform::process(), that will be used when processing blocks.
+
     @tags{DSP}
 */
 template <typename FloatType, typename Function = FloatType (*) (FloatType)>
@@ -66,6 +80,19 @@ struct WaveShaper
             if (context.usesSeparateInputAndOutputBlocks())
                 context.getOutputBlock().copyFrom (context.getInputBlock());
         }
+        else if constexpr (detail::hasBlockProcessing<Function, FloatType>)
+        {
+            const auto& inputBlock = context.getInputBlock();
+            const auto& outputBlock = context.getOutputBlock();
+
+            jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+            jassert (inputBlock.getNumSamples() == outputBlock.getNumSamples());
+
+            for (size_t ch = 0; ch < outputBlock.getNumChannels(); ++ch)
+                functionToUse.process (inputBlock.getChannelPointer (ch),
+                                       outputBlock.getChannelPointer (ch),
+                                       outputBlock.getNumSamples());
+        }
         else
         {
             AudioBlock<FloatType>::process (context.getInputBlock(),
@@ -35,6 +35,237 @@
 namespace juce
 {
 
+/*  Holds on to the blurred masks of recently-drawn path shadows, so that repainting the same
+    shadow doesn't need to fill and blur the path again.
+
+    The masks are single-channel images that don't depend on the shadow's colour or offset.
+    Shapes are also compared relative to their integer bounds, so an entry can be shared by
+    every shadow with the same radius whose path only differs by a whole number of pixels.
+    The least-recently used entries are discarded once there are too many of them, or once
+    the total size of the cached images grows too large.
+*/
+class DropShadowCache final : private DeletedAtShutdown
+{
+public:
+    DropShadowCache() = default;
+
+    ~DropShadowCache() override
+    {
+        clearSingletonInstance();
+    }
+
+    JUCE_DECLARE_SINGLETON_INLINE (DropShadowCache, false)
+
+    /* Shadows covering more pixels than this are drawn without being cached. */
+    static constexpr int64 maxPixelsPerImage = 1 << 20;
+
+    /* A path and blur radius, with the path measured from the given integer origin. */
+    struct Shape
+    {
+        Shape (const Path& p, Point<int> o, int r)
+            : path (p), origin (o.toFloat()), radius (r), hash (createHash (p, origin, r)) {}
+
+        bool matches (const Path& otherPath, Point<float> otherOrigin, int otherRadius) const
+        {
+            if (radius != otherRadius || path.isUsingNonZeroWinding() != otherPath.isUsingNonZeroWinding())
+                return false;
+
+            bool isEqual = true;
+            Path::Iterator other (otherPath);
+
+            forEachPoint (path, origin, [&] (const Path::Iterator& i, Point<float> point, int pointIndex)
+            {
+                if (! isEqual)
+                    return;
+
+                if (pointIndex <= 0 && (! other.next() || other.elementType != i.elementType))
+                {
+                    isEqual = false;
+                    return;
+                }
+
+                if (pointIndex >= 0)
+                    isEqual = (point - getPoint (other, pointIndex, otherOrigin)).isOrigin();
+            });
+
+            return isEqual && ! other.next();
+        }
+
+        const Path& path;
+        const Point<float> origin;
+        const int radius;
+        const size_t hash;
+    };
+
+    Image get (const Shape& shape)
+    {
+        const ScopedLock sl (lock);
+
+        const auto [begin, end] = index.equal_range (shape.hash);
+
+        for (auto it = begin; it != end; ++it)
+        {
+            const auto& item = *it->second;
+
+            if (shape.matches (item.path, item.origin, item.radius))
+            {
+                items.splice (items.end(), items, it->second);
+                return item.image;
+            }
+        }
+
+        return {};
+    }
+
+    /* Shadows that aren't completely visible are only worth caching once they have been
+       missed before, so that a shape that keeps moving doesn't push everything else out. */
+    bool wasMissedRecently (const Shape& shape)
+    {
+        const ScopedLock sl (lock);
+
+        if (std::find (recentMisses.begin(), recentMisses.end(), shape.hash) != recentMisses.end())
+            return true;
+
+        recentMisses[nextMissIndex] = shape.hash;
+        nextMissIndex = (nextMissIndex + 1) % recentMisses.size();
+        return false;
+    }
+
+    void add (const Shape& shape, const Image& image)
+    {
+        const ScopedLock sl (lock);
+
+        const auto it = items.insert (items.end(), { shape.path, shape.origin, shape.radius, shape.hash, image });
+        index.emplace (shape.hash, it);
+        numPixelsStored += getNumPixels (image);
+
+        while (items.size() > maxNumItems || numPixelsStored > maxPixelsToStore)
+            removeOldestItem();
+    }
+
+private:
+    struct Item
+    {
+        Path path;
+        Point<float> origin;
+        int radius;
+        size_t hash;
+        Image image;
+    };
+
+    static Point<float> getPoint (const Path::Iterator& i, int pointIndex, Point<float> origin)
+    {
+        switch (pointIndex)
+        {
+            case 0:  return Point<float> (i.x1, i.y1) - origin;
+            case 1:  return Point<float> (i.x2, i.y2) - origin;
+            default: return Point<float> (i.x3, i.y3) - origin;
+        }
+    }
+
+    // Calls fn (iterator, point, pointIndex) for each point of each element. Elements without
+    // any points are visited once, with a point index of -1.
+    template <typename Fn>
+    static void forEachPoint (const Path& path, Point<float> origin, Fn&& fn)
+    {
+        Path::Iterator i (path);
+
+        while (i.next())
+        {
+            const auto numPoints = [&]
+            {
+                switch (i.elementType)
+                {
+                    case Path::Iterator::startNewSubPath:
+                    case Path::Iterator::lineTo:        return 1;
+                    case Path::Iterator::quadraticTo:   return 2;
+                    case Path::Iterator::cubicTo:       return 3;
+                    case Path::Iterator::closePath:     break;
+                }
+
+                return 0;
+            }();
+
+            if (numPoints == 0)
+                fn (i, Point<float>(), -1);
+
+            for (auto pointIndex = 0; pointIndex < numPoints; ++pointIndex)
+                fn (i, getPoint (i, pointIndex, origin), pointIndex);
+        }
+    }
+
+    static size_t createHash (const Path& path, Point<float> origin, int radius)
+    {
+        uint64 hash = 14695981039346656037ull;
+
+        const auto addToHash = [&hash] (uint32 value)
+        {
+            hash = (hash ^ value) * 1099511628211ull;
+        };
+
+        const auto addFloatToHash = [&addToHash] (float value)
+        {
+            uint32 bits;
+            std::memcpy (&bits, &value, sizeof (bits));
+            addToHash (bits);
+        };
+
+        addToHash ((uint32) radius);
+        addToHash (path.isUsingNonZeroWinding() ? 1u : 0u);
+
+        forEachPoint (path, origin, [&] (const Path::Iterator& i, Point<float> point, int pointIndex)
+        {
+            if (pointIndex <= 0)
+                addToHash ((uint32) i.elementType);
+
+            if (pointIndex >= 0)
+            {
+                addFloatToHash (point.x);
+                addFloatToHash (point.y);
+            }
+        });
+
+        return (size_t) hash;
+    }
+
+    static int64 getNumPixels (const Image& image)
+    {
+        return (int64) image.getWidth() * image.getHeight();
+    }
+
+    void removeOldestItem()
+    {
+        const auto oldest = items.begin();
+        const auto [begin, end] = index.equal_range (oldest->hash);
+
+        for (auto it = begin; it != end; ++it)
+        {
+            if (it->second == oldest)
+            {
+                index.erase (it);
+                break;
+            }
+        }
+
+        numPixelsStored -= getNumPixels (oldest->image);
+        items.erase (oldest);
+    }
+
+    static constexpr size_t maxNumItems = 256;
+    static constexpr int64 maxPixelsToStore = 1 << 23;
+
+    // The items are kept in order of use, with the most recently used at the end
+    std::list<Item> items;
+    std::unordered_multimap<size_t, std::list<Item>::iterator> index;
+    std::array<size_t, 32> recentMisses {};
+    size_t nextMissIndex = 0;
+    int64 numPixelsStored = 0;
+    CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE (DropShadowCache)
+};
+
+//==============================================================================
 DropShadow::DropShadow (Colour shadowColour, const int r, Point<int> o) noexcept
     : colour (shadowColour), radius (r), offset (o)
 {
@@ -57,31 +288,60 @@ void DropShadow::drawForImage (Graphics& g, const Image& srcImage) const
     g.drawImageAt (blurred, offset.x, offset.y, true);
 }
 
+static Image createBlurredPathImage (const Path& path, Rectangle<int> area, int radius)
+{
+    Image pathImage { Image::SingleChannel, area.getWidth(), area.getHeight(), true };
+
+    {
+        Graphics g2 (pathImage);
+        g2.setColour (Colours::white);
+        g2.fillPath (path, AffineTransform::translation ((float) -area.getX(), (float) -area.getY()));
+    }
+
+    Image blurred;
+    ImageEffects::applySingleChannelBoxBlurEffect (radius, pathImage, blurred);
+    return blurred;
+}
+
 void DropShadow::drawForPath (Graphics& g, const Path& path) const
 {
     jassert (radius > 0);
 
-    auto area = (path.getBounds().getSmallestIntegerContainer() + offset)
-            .expanded (radius + 1)
-            .getIntersection (g.getClipBounds().expanded (radius + 1));
+    const auto pathArea = path.getBounds().getSmallestIntegerContainer().expanded (radius + 1);
+
+    // The box blur makes 2 * radius passes, so pixels that far outside the clip region
+    // can still affect the visible part of the shadow
+    const auto visibleArea = (pathArea + offset).getIntersection (g.getClipBounds().expanded (2 * radius + 1));
+
+    if (visibleArea.getWidth() <= 2 || visibleArea.getHeight() <= 2)
+        return;
+
+    g.setColour (colour);
 
-    if (area.getWidth() > 2 && area.getHeight() > 2)
+    if ((int64) pathArea.getWidth() * pathArea.getHeight() <= DropShadowCache::maxPixelsPerImage)
     {
-        Image pathImage { Image::SingleChannel, area.getWidth(), area.getHeight(), true };
+        auto& cache = *DropShadowCache::getInstance();
+        const DropShadowCache::Shape shape (path, pathArea.getPosition(), radius);
 
+        if (auto cached = cache.get (shape); cached.isValid())
         {
-            Graphics g2 (pathImage);
-            g2.setColour (Colours::white);
-            g2.fillPath (path, AffineTransform::translation ((float) (offset.x - area.getX()),
-                                                             (float) (offset.y - area.getY())));
+            g.drawImageAt (cached, pathArea.getX() + offset.x, pathArea.getY() + offset.y, true);
+            return;
         }
 
-        Image blurred;
-        ImageEffects::applySingleChannelBoxBlurEffect (radius, pathImage, blurred);
-
-        g.setColour (colour);
-        g.drawImageAt (blurred, area.getX(), area.getY(), true);
+        if (visibleArea == pathArea + offset || cache.wasMissedRecently (shape))
+        {
+            const auto blurred = createBlurredPathImage (path, pathArea, radius);
+            cache.add (shape, blurred);
+            g.drawImageAt (blurred, pathArea.getX() + offset.x, pathArea.getY() + offset.y, true);
+            return;
+        }
     }
+
+    // Shadows that are very large, or that aren't worth caching yet, only have their
+    // visible part rendered
+    const auto blurred = createBlurredPathImage (path, visibleArea - offset, radius);
+    g.drawImageAt (blurred, visibleArea.getX(), visibleArea.getY(), true);
 }
 
 static void drawShadowSection (Graphics& g, ColourGradient& cg, Rectangle<float> area,
@@ -149,4 +409,131 @@ void DropShadowEffect::applyEffect (Image& image, Graphics& g, float scaleFactor
     g.drawImageAt (image, 0, 0);
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class DropShadowTests final : public UnitTest
+{
+public:
+    DropShadowTests()
+        : UnitTest ("DropShadow", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Cached path shadows match the shapes that were drawn");
+        {
+            Path rectangle, ellipse;
+            rectangle.addRectangle (10.0f, 10.0f, 30.0f, 20.0f);
+            ellipse.addEllipse (10.0f, 10.0f, 30.0f, 20.0f);
+
+            const DropShadow first (Colours::black, 5, { 2, 3 });
+            const DropShadow second (Colours::red.withAlpha (0.5f), 5, { -4, 1 });
+
+            // The second attempt at each shadow may be drawn from the cache. Paths with equal
+            // bounds, and shadows with different colours and offsets, must still be drawn correctly.
+            for (auto attempt = 0; attempt < 2; ++attempt)
+            {
+                for (const auto* path : { &rectangle, &ellipse })
+                {
+                    for (const auto& shadow : { first, second })
+                    {
+                        expect (countDifferences (drawShadow (shadow, *path, {}),
+                                                  drawReferenceShadow (shadow, *path)) == 0);
+                    }
+                }
+            }
+
+            // A partial repaint should match the same area of a full repaint
+            const auto full = drawShadow (first, ellipse, {});
+            const auto partial = drawShadow (first, ellipse, Rectangle<int> (0, 0, 25, 60));
+            expect (countDifferences (full.getClippedImage ({ 0, 0, 25, 60 }),
+                                      partial.getClippedImage ({ 0, 0, 25, 60 })) == 0);
+        }
+
+        beginTest ("Moved path shadows match the shapes that were drawn");
+        {
+            Path roundedRectangle, triangle;
+            roundedRectangle.addRoundedRectangle (5.25f, 8.5f, 20.0f, 15.0f, 3.0f);
+            triangle.addTriangle (5.25f, 8.5f, 25.0f, 12.75f, 10.5f, 23.5f);
+            const DropShadow shadow (Colours::black, 4, { 1, 2 });
+
+            // Whole-pixel moves of the triangle share a cached mask, because its coordinates
+            // stay exact. The other moves can't share one, but still have to be drawn correctly.
+            for (const auto* shape : { &roundedRectangle, &triangle })
+            {
+                for (const auto& move : { Point<float> (7.0f, 5.0f), Point<float> (-3.0f, 11.0f), Point<float> (0.5f, 0.25f) })
+                {
+                    auto translated = *shape;
+                    translated.applyTransform (AffineTransform::translation (move));
+
+                    // Partly-visible shadows are rendered without the cache until they've been missed before
+                    const auto clip = Rectangle<int> (0, 0, 20, imageSize);
+
+                    for (auto attempt = 0; attempt < 2; ++attempt)
+                        expect (countDifferences (drawShadow (shadow, translated, clip).getClippedImage (clip),
+                                                  drawReferenceShadow (shadow, translated).getClippedImage (clip)) == 0);
+
+                    expect (countDifferences (drawShadow (shadow, translated, {}),
+                                              drawReferenceShadow (shadow, translated)) == 0);
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr int imageSize = 60;
+
+    static Image drawShadow (const DropShadow& shadow, const Path& path, std::optional<Rectangle<int>> clip)
+    {
+        Image image (Image::ARGB, imageSize, imageSize, true, SoftwareImageType{});
+        Graphics g (image);
+
+        if (clip.has_value())
+            g.reduceClipRegion (*clip);
+
+        shadow.drawForPath (g, path);
+        return image;
+    }
+
+    static Image drawReferenceShadow (const DropShadow& shadow, const Path& path)
+    {
+        const auto area = path.getBounds().getSmallestIntegerContainer().expanded (shadow.radius + 1);
+
+        Image mask (Image::SingleChannel, area.getWidth(), area.getHeight(), true, SoftwareImageType{});
+
+        {
+            Graphics g (mask);
+            g.setColour (Colours::white);
+            g.fillPath (path, AffineTransform::translation ((float) -area.getX(), (float) -area.getY()));
+        }
+
+        Image blurred;
+        ImageEffects::applySingleChannelBoxBlurEffect (shadow.radius, mask, blurred);
+
+        Image image (Image::ARGB, imageSize, imageSize, true, SoftwareImageType{});
+        Graphics g (image);
+        g.setColour (shadow.colour);
+        g.drawImageAt (blurred, area.getX() + shadow.offset.x, area.getY() + shadow.offset.y, true);
+        return image;
+    }
+
+    static int countDifferences (const Image& a, const Image& b)
+    {
+        int numDifferences = 0;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (a.getPixelAt (x, y) != b.getPixelAt (x, y))
+                    ++numDifferences;
+
+        return numDifferences;
+    }
+};
+
+static DropShadowTests dropShadowTests;
+
+#endif
+
 } // namespace juce
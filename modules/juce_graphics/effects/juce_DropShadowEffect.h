@@ -52,7 +52,12 @@ struct JUCE_API  DropShadow
     /** Renders a drop-shadow based on the alpha-channel of the given image. */
     void drawForImage (Graphics& g, const Image& srcImage) const;
 
-    /** Renders a drop-shadow based on the shape of a path. */
+    /** Renders a drop-shadow based on the shape of a path.
+
+        The blurred shapes of recently-drawn paths are cached, so repeatedly drawing shadows for
+        the same path and radius (e.g. when repainting a component) is much cheaper than the
+        first time. The cache is shared between shadows with different colours and offsets.
+    */
     void drawForPath (Graphics& g, const Path& path) const;
 
     /** Renders a drop-shadow for a rectangle.
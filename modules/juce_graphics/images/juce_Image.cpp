@@ -836,6 +836,92 @@ void Image::moveImageSection (int dx, int dy,
     }
 }
 
+/*  Produces the same result as applying the kernel from ImageConvolutionKernel::createGaussianBlur()
+    with ImageConvolutionKernel::applyToImage(), to within rounding errors.
+
+    A Gaussian kernel is the product of two one-dimensional kernels, so rather than visiting
+    size * size source pixels for each destination pixel, the image is blurred horizontally
+    and then vertically. Each pass runs along whole rows so that the inner loops vectorise.
+    Only the horizontally-blurred rows that the vertical pass still needs are kept around.
+*/
+static void applySeparableGaussianBlur (float radius, const Image& input, Image& result)
+{
+    const auto size = roundToInt (radius * 2.0f);
+
+    if (size <= 0)
+    {
+        result.clear (result.getBounds());
+        return;
+    }
+
+    const auto centre = size >> 1;
+    const auto radiusFactor = -1.0 / (radius * radius * 2);
+
+    HeapBlock<float> kernel ((size_t) size);
+    double total = 0.0;
+
+    for (int i = 0; i < size; ++i)
+    {
+        const auto offset = i - centre;
+        kernel[i] = (float) std::exp (radiusFactor * (offset * offset));
+        total += kernel[i];
+    }
+
+    for (int i = 0; i < size; ++i)
+        kernel[i] = (float) (kernel[i] / total);
+
+    const Image::BitmapData src (input, Image::BitmapData::readOnly);
+    const Image::BitmapData dst (result, Image::BitmapData::writeOnly);
+
+    const auto width = src.width, height = src.height, pixelStride = src.pixelStride;
+    const auto rowLength = width * pixelStride;
+
+    HeapBlock<float> blurredRows ((size_t) (size * rowLength)), sum ((size_t) rowLength);
+    const auto getBlurredRow = [&] (int y) { return blurredRows + (y % size) * rowLength; };
+
+    const auto blurRow = [&] (int y)
+    {
+        const auto* source = src.getLinePointer (y);
+        auto* dest = getBlurredRow (y);
+        std::fill (dest, dest + rowLength, 0.0f);
+
+        for (int i = 0; i < size; ++i)
+        {
+            const auto weight = kernel[i];
+            const auto delta = (i - centre) * pixelStride;
+            const auto start = jmax (0, -delta), end = jmin (rowLength, rowLength - delta);
+
+            for (int n = start; n < end; ++n)
+                dest[n] += weight * (float) source[n + delta];
+        }
+    };
+
+    for (int y = 0, nextRowToBlur = 0; y < height; ++y)
+    {
+        const auto firstRow = jmax (0, y - centre);
+        const auto endRow = jmin (height, y - centre + size);
+
+        for (; nextRowToBlur < endRow; ++nextRowToBlur)
+            blurRow (nextRowToBlur);
+
+        std::fill (sum.get(), sum + rowLength, 0.0f);
+
+        for (int sy = firstRow; sy < endRow; ++sy)
+        {
+            const auto weight = kernel[sy - y + centre];
+            const auto* row = getBlurredRow (sy);
+
+            for (int n = 0; n < rowLength; ++n)
+                sum[n] += weight * row[n];
+        }
+
+        auto* dest = dst.getLinePointer (y);
+
+        for (int n = 0; n < rowLength; ++n)
+            dest[n] = (uint8) jmin (0xff, roundToInt (sum[n]));
+    }
+}
+
 void ImageEffects::applyGaussianBlurEffect (float radius, const Image& input, Image& result)
 {
     auto image = input.getPixelData();
@@ -857,48 +943,103 @@ void ImageEffects::applyGaussianBlurEffect (float radius, const Image& input, Im
 
     const auto tie = [] (const auto& x) { return std::tuple (x.getFormat(), x.getWidth(), x.getHeight()); };
 
-    if (tie (input) != tie (result))
-        result = Image { input.getFormat(), input.getWidth(), input.getHeight(), false };
-
-    ImageConvolutionKernel blurKernel (roundToInt (radius * 2.0f));
+    // Holding a reference to the input's data means that it's left intact if result refers to
+    // the same image
+    const auto source = input;
 
-    blurKernel.createGaussianBlur (radius);
+    if (tie (source) != tie (result))
+        result = Image { source.getFormat(), source.getWidth(), source.getHeight(), false };
+    else if (result == source)
+        result.duplicateIfShared();
 
-    blurKernel.applyToImage (result, input, result.getBounds());
+    applySeparableGaussianBlur (radius, source, result);
 }
 
-static void blurDataTriplets (uint8* d, int num, const int delta) noexcept
+/*  A single pass of a three-tap box blur. The values at each end only have one neighbour, but
+    are still divided by three, so the edges of the image fade out slightly.
+*/
+static void blurTriplets (const uint8* src, uint8* dst, int num) noexcept
 {
-    uint32 last = d[0];
-    d[0] = (uint8) ((d[0] + d[delta] + 1) / 3);
-    d += delta;
+    dst[0] = (uint8) ((src[0] + src[1] + 1) / 3);
 
-    num -= 2;
+    for (int i = 1; i < num - 1; ++i)
+        dst[i] = (uint8) ((src[i - 1] + src[i] + src[i + 1] + 1) / 3);
 
-    do
-    {
-        const uint32 newLast = d[0];
-        d[0] = (uint8) ((last + d[0] + d[delta] + 1) / 3);
-        d += delta;
-        last = newLast;
-    }
-    while (--num > 0);
+    dst[num - 1] = (uint8) ((src[num - 2] + src[num - 1] + 1) / 3);
+}
 
-    d[0] = (uint8) ((last + d[0] + 1) / 3);
+static void blurTripletRows (const uint8* above, const uint8* row, const uint8* below, uint8* dst, int num) noexcept
+{
+    for (int i = 0; i < num; ++i)
+        dst[i] = (uint8) ((above[i] + row[i] + below[i] + 1) / 3);
 }
 
+/*  Applies a number of three-tap box blurs horizontally, and then the same number vertically.
+
+    Each pass reads the output of the previous one from a separate buffer, so the loops have no
+    dependencies between neighbouring pixels and can be vectorised. The vertical passes work on
+    strips of columns, so that all the repetitions over a strip stay in the cache, and each row
+    of a strip is blurred in one go rather than walking down the columns one at a time.
+*/
 static void blurSingleChannelImage (uint8* const data, const int width, const int height,
-                                    const int lineStride, const int repetitions) noexcept
+                                    const int lineStride, const int repetitions)
 {
     jassert (width > 2 && height > 2);
 
-    for (int y = 0; y < height; ++y)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + lineStride * y, width, 1);
+    if (width < 2 || height < 2 || repetitions <= 0)
+        return;
+
+    {
+        HeapBlock<uint8> buffers ((size_t) width * 2);
+        uint8* const scratch[] { buffers.get(), buffers + width };
+
+        for (int y = 0; y < height; ++y)
+        {
+            auto* line = data + lineStride * y;
+            const uint8* source = line;
+
+            for (int i = 0; i < repetitions; ++i)
+            {
+                auto* dest = scratch[i & 1];
+                blurTriplets (source, dest, width);
+                source = dest;
+            }
 
-    for (int x = 0; x < width; ++x)
-        for (int i = repetitions; --i >= 0;)
-            blurDataTriplets (data + x, height, lineStride);
+            std::memcpy (line, source, (size_t) width);
+        }
+    }
+
+    // Each strip buffer has an extra row of zeros above and below the image data
+    constexpr int stripWidth = 64;
+    const auto stripSize = (size_t) stripWidth * (size_t) (height + 2);
+    HeapBlock<uint8> buffers (stripSize * 2, true);
+    uint8* const strips[] { buffers.get(), buffers + stripSize };
+
+    for (int x = 0; x < width; x += stripWidth)
+    {
+        const auto numColumns = jmin (stripWidth, width - x);
+
+        for (int y = 0; y < height; ++y)
+            std::memcpy (strips[0] + (y + 1) * stripWidth, data + lineStride * y + x, (size_t) numColumns);
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            const auto* source = strips[i & 1];
+            auto* dest = strips[(i + 1) & 1];
+
+            for (int y = 0; y < height; ++y)
+                blurTripletRows (source + y * stripWidth,
+                                 source + (y + 1) * stripWidth,
+                                 source + (y + 2) * stripWidth,
+                                 dest + (y + 1) * stripWidth,
+                                 numColumns);
+        }
+
+        const auto* result = strips[repetitions & 1];
+
+        for (int y = 0; y < height; ++y)
+            std::memcpy (data + lineStride * y + x, result + (y + 1) * stripWidth, (size_t) numColumns);
+    }
 }
 
 static void blurSingleChannelImage (Image& image, int radius)
@@ -941,6 +1082,128 @@ void ImageEffects::applySingleChannelBoxBlurEffect (int radius, const Image& inp
     blurSingleChannelImage (result, radius);
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageEffectsTests final : public UnitTest
+{
+public:
+    ImageEffectsTests()
+        : UnitTest ("ImageEffects", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        beginTest ("Box blur matches a column-by-column implementation");
+        {
+            for (const auto& [width, height] : { std::pair { 3, 3 }, { 17, 5 }, { 64, 10 }, { 150, 37 }, { 7, 200 } })
+            {
+                for (auto radius = 1; radius <= 6; radius += 2)
+                {
+                    const auto input = createRandomImage (Image::SingleChannel, width, height, r);
+
+                    Image result;
+                    ImageEffects::applySingleChannelBoxBlurEffect (radius, input, result);
+
+                    auto expected = input.createCopy();
+                    applyReferenceBoxBlur (expected, radius);
+
+                    expect (countDifferences (result, expected, 0) == 0);
+                }
+            }
+        }
+
+        beginTest ("Gaussian blur matches a convolution kernel");
+        {
+            for (const auto format : { Image::SingleChannel, Image::RGB, Image::ARGB })
+            {
+                for (const auto radius : { 0.2f, 0.7f, 2.5f, 4.0f })
+                {
+                    const auto input = createRandomImage (format, 41, 23, r);
+
+                    Image result;
+                    ImageEffects::applyGaussianBlurEffect (radius, input, result);
+
+                    Image expected (format, input.getWidth(), input.getHeight(), false, SoftwareImageType{});
+                    ImageConvolutionKernel kernel (roundToInt (radius * 2.0f));
+                    kernel.createGaussianBlur (radius);
+                    kernel.applyToImage (expected, input, expected.getBounds());
+
+                    // The separable blur accumulates in a different order, so it may round differently
+                    expect (countDifferences (result, expected, 1) == 0);
+
+                    // Blurring an image into itself shouldn't modify other images sharing its data
+                    const auto original = input.createCopy();
+                    auto inPlace = input;
+                    ImageEffects::applyGaussianBlurEffect (radius, inPlace, inPlace);
+                    expect (countDifferences (inPlace, result, 0) == 0);
+                    expect (countDifferences (input, original, 0) == 0);
+                }
+            }
+        }
+    }
+
+private:
+    static Image createRandomImage (Image::PixelFormat format, int width, int height, Random& r)
+    {
+        Image image (format, width, height, false, SoftwareImageType{});
+        const Image::BitmapData data (image, Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width * data.pixelStride; ++x)
+                data.getLinePointer (y)[x] = (uint8) r.nextInt (256);
+
+        return image;
+    }
+
+    static int countDifferences (const Image& a, const Image& b, int tolerance)
+    {
+        const Image::BitmapData dataA (a, Image::BitmapData::readOnly);
+        const Image::BitmapData dataB (b, Image::BitmapData::readOnly);
+        int numDifferences = 0;
+
+        for (int y = 0; y < dataA.height; ++y)
+            for (int x = 0; x < dataA.width * dataA.pixelStride; ++x)
+                if (std::abs (dataA.getLinePointer (y)[x] - dataB.getLinePointer (y)[x]) > tolerance)
+                    ++numDifferences;
+
+        return numDifferences;
+    }
+
+    static void applyReferenceBoxBlur (Image& image, int radius)
+    {
+        const Image::BitmapData data (image, Image::BitmapData::readWrite);
+
+        const auto blur = [] (uint8* d, int num, int delta)
+        {
+            uint32 last = 0;
+
+            for (int i = 0; i < num; ++i, d += delta)
+            {
+                const uint32 current = d[0];
+                const uint32 next = i < num - 1 ? d[delta] : 0;
+                d[0] = (uint8) ((last + current + next + 1) / 3);
+                last = current;
+            }
+        };
+
+        for (int y = 0; y < data.height; ++y)
+            for (int i = 2 * radius; --i >= 0;)
+                blur (data.getLinePointer (y), data.width, 1);
+
+        for (int x = 0; x < data.width; ++x)
+            for (int i = 2 * radius; --i >= 0;)
+                blur (data.data + x, data.height, data.lineStride);
+    }
+};
+
+static ImageEffectsTests imageEffectsTests;
+
+#endif
+
 //==============================================================================
 #if JUCE_ALLOW_STATIC_NULL_VARIABLES
 
@@ -41,10 +41,8 @@ public:
     CodeDocumentLine (const String::CharPointerType startOfLine,
                       const String::CharPointerType endOfLine,
                       const int lineLen,
-                      const int numNewLineChars,
-                      const int startInFile)
+                      const int numNewLineChars)
         : line (startOfLine, endOfLine),
-          lineStartInFile (startInFile),
           lineLength (lineLen),
           lineLengthWithoutNewLines (lineLen - numNewLineChars)
     {
@@ -59,7 +57,6 @@ public:
         while (! (finished || t.isEmpty()))
         {
             auto startOfLine = t;
-            auto startOfLineInFile = charNumInFile;
             int lineLength = 0;
             int numNewLineChars = 0;
 
@@ -98,8 +95,7 @@ public:
                 }
             }
 
-            newLines.add (new CodeDocumentLine (startOfLine, t, lineLength,
-                                                numNewLineChars, startOfLineInFile));
+            newLines.add (new CodeDocumentLine (startOfLine, t, lineLength, numNewLineChars));
         }
 
         jassert (charNumInFile == text.length());
@@ -130,7 +126,405 @@ public:
     }
 
     String line;
-    int lineStartInFile, lineLength, lineLengthWithoutNewLines;
+    int lineLength, lineLengthWithoutNewLines;
+};
+
+//==============================================================================
+/*  Holds the lines of a CodeDocument.
+
+    The lines are kept in blocks of a bounded size, and the number of lines and characters
+    in each block are indexed by a pair of Fenwick trees. That means that finding a line by
+    its index or by a character position only costs a tree search plus a scan of one block,
+    and an edit only has to touch the blocks that it affects, rather than every line after it.
+*/
+class CodeDocumentLineList
+{
+public:
+    CodeDocumentLineList() = default;
+
+    int size() const noexcept                       { return numLines; }
+    int getNumCharacters() const noexcept           { return numChars; }
+
+    CodeDocumentLine* operator[] (int index) const noexcept
+    {
+        if (! isPositiveAndBelow (index, numLines))
+            return nullptr;
+
+        // Lines are usually read in sequence, so try the block that was used last time first
+        if (const auto hint = lastBlockUsed.load (std::memory_order_relaxed); hint != noBlockUsed)
+        {
+            const auto hintBlock = (int) (hint >> 32);
+            const auto hintStart = (int) (uint32) hint;
+
+            if (isPositiveAndBelow (hintBlock, blocks.size()))
+            {
+                const auto& lines = blocks.getUnchecked (hintBlock)->lines;
+
+                if (isPositiveAndBelow (index - hintStart, lines.size()))
+                    return lines.getUnchecked (index - hintStart);
+            }
+        }
+
+        const auto [block, indexInBlock] = findBlock (lineCounts, index);
+        lastBlockUsed.store (((uint64) (uint32) block << 32) | (uint32) (index - indexInBlock), std::memory_order_relaxed);
+        return blocks.getUnchecked (block)->lines.getUnchecked (indexInBlock);
+    }
+
+    CodeDocumentLine* getLast() const noexcept
+    {
+        if (auto* last = blocks.getLast())
+            return last->lines.getLast();
+
+        return nullptr;
+    }
+
+    /** Returns the number of characters that come before the given line. */
+    int getLineStart (int index) const noexcept
+    {
+        if (index <= 0)
+            return 0;
+
+        if (index >= numLines)
+            return numChars;
+
+        const auto [block, indexInBlock] = findBlock (lineCounts, index);
+        auto start = getPrefixSum (charCounts, block);
+        const auto& lines = blocks.getUnchecked (block)->lines;
+
+        for (int i = 0; i < indexInBlock; ++i)
+            start += lines.getUnchecked (i)->lineLength;
+
+        return start;
+    }
+
+    /** Returns the index of the line containing a character position, and that line's start.
+        Positions beyond the end of the document are treated as being in the last line.
+    */
+    int findLineContaining (int position, int& lineStart) const noexcept
+    {
+        jassert (numLines > 0);
+
+        if (position >= numChars)
+        {
+            lineStart = numChars - getLast()->lineLength;
+            return numLines - 1;
+        }
+
+        auto [block, offset] = findBlock (charCounts, jmax (0, position));
+        auto lineIndex = getPrefixSum (lineCounts, block);
+        lineStart = jmax (0, position) - offset;
+
+        for (auto* l : blocks.getUnchecked (block)->lines)
+        {
+            if (offset < l->lineLength)
+                break;
+
+            offset -= l->lineLength;
+            lineStart += l->lineLength;
+            ++lineIndex;
+        }
+
+        return lineIndex;
+    }
+
+    int getMaximumLineLength() const noexcept
+    {
+        int result = 0;
+
+        for (auto* b : blocks)
+        {
+            if (b->maximumLineLength < 0)
+            {
+                int blockMaximum = 0;
+
+                for (auto* l : b->lines)
+                    blockMaximum = jmax (blockMaximum, l->lineLength);
+
+                b->maximumLineLength = blockMaximum;
+            }
+
+            result = jmax (result, b->maximumLineLength);
+        }
+
+        return result;
+    }
+
+    /** Calls a function for each line in turn, starting at the given index, until
+        the function returns false.
+    */
+    template <typename Callback>
+    void forEachLineFrom (int firstLine, Callback&& callback) const
+    {
+        if (! isPositiveAndBelow (firstLine, numLines))
+            return;
+
+        auto [block, indexInBlock] = findBlock (lineCounts, firstLine);
+
+        for (; block < blocks.size(); ++block, indexInBlock = 0)
+        {
+            const auto& lines = blocks.getUnchecked (block)->lines;
+
+            for (; indexInBlock < lines.size(); ++indexInBlock)
+                if (! callback (*lines.getUnchecked (indexInBlock)))
+                    return;
+        }
+    }
+
+    //==============================================================================
+    /** Inserts some lines before the given index, taking ownership of them. */
+    void insertLines (int index, const Array<CodeDocumentLine*>& newLines)
+    {
+        if (newLines.isEmpty())
+            return;
+
+        jassert (isPositiveAndNotGreaterThan (index, numLines));
+
+        int newChars = 0;
+
+        for (auto* l : newLines)
+            newChars += l->lineLength;
+
+        numLines += newLines.size();
+        numChars += newChars;
+        lastBlockUsed = noBlockUsed;
+
+        if (blocks.isEmpty())
+        {
+            auto* b = blocks.add (new Block());
+            b->lines.addArray (newLines);
+            b->numChars = newChars;
+            splitBlockIfNeeded (0);
+            rebuildIndex();
+            return;
+        }
+
+        auto [block, indexInBlock] = index < numLines - newLines.size() ? findBlock (lineCounts, index)
+                                                                         : std::pair { blocks.size() - 1, blocks.getLast()->lines.size() };
+        auto& b = *blocks.getUnchecked (block);
+        b.lines.insertArray (indexInBlock, newLines.getRawDataPointer(), newLines.size());
+        b.numChars += newChars;
+        b.maximumLineLength = -1;
+
+        if (splitBlockIfNeeded (block))
+        {
+            rebuildIndex();
+        }
+        else
+        {
+            addToIndex (lineCounts, block, newLines.size());
+            addToIndex (charCounts, block, newChars);
+        }
+    }
+
+    /** Replaces the line at the given index with a new one, deleting the old one. */
+    void set (int index, CodeDocumentLine* replacement)
+    {
+        jassert (isPositiveAndBelow (index, numLines));
+
+        const auto [block, indexInBlock] = findBlock (lineCounts, index);
+        auto& b = *blocks.getUnchecked (block);
+        const auto delta = replacement->lineLength - b.lines.getUnchecked (indexInBlock)->lineLength;
+        b.lines.set (indexInBlock, replacement, true);
+        lineLengthChanged (block, delta);
+    }
+
+    /** Must be called after the text of the given line has been changed in place. */
+    void lineChanged (int index, int lengthDelta)
+    {
+        lineLengthChanged (findBlock (lineCounts, index).first, lengthDelta);
+    }
+
+    void removeRange (int index, int numToRemove)
+    {
+        numToRemove = jmin (numToRemove, numLines - index);
+
+        if (numToRemove <= 0)
+            return;
+
+        auto needsRebuild = false;
+        auto [block, indexInBlock] = findBlock (lineCounts, index);
+        const auto firstBlock = block;
+        lastBlockUsed = noBlockUsed;
+
+        while (numToRemove > 0)
+        {
+            auto& b = *blocks.getUnchecked (block);
+            const auto numInBlock = jmin (numToRemove, b.lines.size() - indexInBlock);
+            int removedChars = 0;
+
+            for (int i = 0; i < numInBlock; ++i)
+                removedChars += b.lines.getUnchecked (indexInBlock + i)->lineLength;
+
+            b.lines.removeRange (indexInBlock, numInBlock);
+            b.numChars -= removedChars;
+            b.maximumLineLength = -1;
+            numLines -= numInBlock;
+            numChars -= removedChars;
+            numToRemove -= numInBlock;
+
+            if (b.lines.isEmpty())
+            {
+                blocks.remove (block);
+                needsRebuild = true;
+            }
+            else
+            {
+                if (! needsRebuild)
+                {
+                    addToIndex (lineCounts, block, -numInBlock);
+                    addToIndex (charCounts, block, -removedChars);
+                }
+
+                ++block;
+            }
+
+            indexInBlock = 0;
+        }
+
+        // Merge small neighbouring blocks so that lots of deletions don't leave the index
+        // full of tiny ones
+        if (mergeWithNextBlockIfSmall (firstBlock) || mergeWithNextBlockIfSmall (firstBlock - 1))
+            needsRebuild = true;
+
+        if (needsRebuild)
+            rebuildIndex();
+    }
+
+    void removeLast()
+    {
+        removeRange (numLines - 1, 1);
+    }
+
+private:
+    //==============================================================================
+    struct Block
+    {
+        OwnedArray<CodeDocumentLine> lines;
+        int numChars = 0;
+        mutable int maximumLineLength = -1;
+    };
+
+    static constexpr int maxLinesPerBlock = 512;
+
+    OwnedArray<Block> blocks;
+    std::vector<int> lineCounts, charCounts;
+    int numLines = 0, numChars = 0;
+
+    // The index and first line of the block found by the last lookup. These are packed into
+    // one value, so that threads reading the list at the same time can't pair one block's
+    // index with another block's start.
+    static constexpr uint64 noBlockUsed = ~(uint64) 0;
+    mutable std::atomic<uint64> lastBlockUsed { noBlockUsed };
+
+    // Returns the block which contains the given item, and the item's index within it
+    static std::pair<int, int> findBlock (const std::vector<int>& tree, int itemIndex) noexcept
+    {
+        int block = 0;
+        const auto treeSize = (int) tree.size();
+
+        for (auto step = nextPowerOfTwo (treeSize); step > 0; step >>= 1)
+        {
+            if (block + step < treeSize && tree[(size_t) (block + step)] <= itemIndex)
+            {
+                block += step;
+                itemIndex -= tree[(size_t) block];
+            }
+        }
+
+        return { block, itemIndex };
+    }
+
+    static int getPrefixSum (const std::vector<int>& tree, int numBlocks) noexcept
+    {
+        int sum = 0;
+
+        for (auto i = numBlocks; i > 0; i -= (i & -i))
+            sum += tree[(size_t) i];
+
+        return sum;
+    }
+
+    static void addToIndex (std::vector<int>& tree, int block, int delta) noexcept
+    {
+        for (auto i = block + 1; i < (int) tree.size(); i += (i & -i))
+            tree[(size_t) i] += delta;
+    }
+
+    void rebuildIndex()
+    {
+        lineCounts.assign ((size_t) blocks.size() + 1, 0);
+        charCounts.assign ((size_t) blocks.size() + 1, 0);
+
+        for (int i = 1; i <= blocks.size(); ++i)
+        {
+            auto& b = *blocks.getUnchecked (i - 1);
+            lineCounts[(size_t) i] += b.lines.size();
+            charCounts[(size_t) i] += b.numChars;
+
+            if (const auto parent = i + (i & -i); parent <= blocks.size())
+            {
+                lineCounts[(size_t) parent] += lineCounts[(size_t) i];
+                charCounts[(size_t) parent] += charCounts[(size_t) i];
+            }
+        }
+    }
+
+    void lineLengthChanged (int block, int delta)
+    {
+        auto& b = *blocks.getUnchecked (block);
+        b.numChars += delta;
+        b.maximumLineLength = -1;
+        numChars += delta;
+        addToIndex (charCounts, block, delta);
+    }
+
+    // Splits an oversized block into half-full ones, returning true if it did so
+    bool splitBlockIfNeeded (int block)
+    {
+        auto& b = *blocks.getUnchecked (block);
+
+        if (b.lines.size() <= maxLinesPerBlock)
+            return false;
+
+        const auto numToMove = b.lines.size() - maxLinesPerBlock / 2;
+
+        for (int start = maxLinesPerBlock / 2; start < b.lines.size(); start += maxLinesPerBlock / 2)
+        {
+            auto* newBlock = blocks.insert (++block, new Block());
+            const auto num = jmin (maxLinesPerBlock / 2, b.lines.size() - start);
+            newBlock->lines.addArray (b.lines, start, num);
+
+            for (auto* l : newBlock->lines)
+                newBlock->numChars += l->lineLength;
+
+            b.numChars -= newBlock->numChars;
+        }
+
+        b.lines.removeRange (maxLinesPerBlock / 2, numToMove, false);
+        b.maximumLineLength = -1;
+        return true;
+    }
+
+    bool mergeWithNextBlockIfSmall (int block)
+    {
+        if (block < 0 || block + 1 >= blocks.size())
+            return false;
+
+        auto& b = *blocks.getUnchecked (block);
+        auto& next = *blocks.getUnchecked (block + 1);
+
+        if (b.lines.size() + next.lines.size() > maxLinesPerBlock / 2)
+            return false;
+
+        b.lines.addArray (next.lines);
+        b.numChars += next.numChars;
+        b.maximumLineLength = -1;
+        next.lines.clear (false);
+        blocks.remove (block + 1);
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (CodeDocumentLineList)
 };
 
 //==============================================================================
@@ -172,7 +566,7 @@ bool CodeDocument::Iterator::reinitialiseCharPtr() const
 
     if (charPointer.getAddress() == nullptr)
     {
-        if (auto* l = document->lines[line])
+        if (auto* l = (*document->lines)[line])
             charPointer = l->line.getCharPointer();
         else
             return false;
@@ -225,7 +619,7 @@ void CodeDocument::Iterator::skipToStartOfLine() noexcept
     if (! reinitialiseCharPtr())
         return;
 
-    if (auto* l = document->lines [line])
+    if (auto* l = (*document->lines)[line])
     {
         auto startPtr = l->line.getCharPointer();
         position -= (int) startPtr.lengthUpTo (charPointer);
@@ -241,7 +635,7 @@ juce_wchar CodeDocument::Iterator::peekNextChar() const noexcept
     if (auto c = *charPointer)
         return c;
 
-    if (auto* l = document->lines [line + 1])
+    if (auto* l = (*document->lines)[line + 1])
         return l->line[0];
 
     return 0;
@@ -254,7 +648,7 @@ juce_wchar CodeDocument::Iterator::previousChar() noexcept
 
     for (;;)
     {
-        if (auto* l = document->lines[line])
+        if (auto* l = (*document->lines)[line])
         {
             if (charPointer != l->line.getCharPointer())
             {
@@ -269,7 +663,7 @@ juce_wchar CodeDocument::Iterator::previousChar() noexcept
 
         --line;
 
-        if (auto* prev = document->lines[line])
+        if (auto* prev = (*document->lines)[line])
             charPointer = prev->line.getCharPointer().findTerminatingNull();
     }
 
@@ -281,12 +675,12 @@ juce_wchar CodeDocument::Iterator::peekPreviousChar() const noexcept
     if (! reinitialiseCharPtr())
         return 0;
 
-    if (auto* l = document->lines[line])
+    if (auto* l = (*document->lines)[line])
     {
         if (charPointer != l->line.getCharPointer())
             return *(charPointer - 1);
 
-        if (auto* prev = document->lines[line - 1])
+        if (auto* prev = (*document->lines)[line - 1])
             return *(prev->line.getCharPointer().findTerminatingNull() - 1);
     }
 
@@ -301,7 +695,7 @@ void CodeDocument::Iterator::skipWhitespace() noexcept
 
 bool CodeDocument::Iterator::isEOF() const noexcept
 {
-    return charPointer.getAddress() == nullptr && line >= document->lines.size();
+    return charPointer.getAddress() == nullptr && line >= document->lines->size();
 }
 
 bool CodeDocument::Iterator::isSOF() const noexcept
@@ -311,7 +705,7 @@ bool CodeDocument::Iterator::isSOF() const noexcept
 
 CodeDocument::Position CodeDocument::Iterator::toPosition() const
 {
-    if (auto* l = document->lines[line])
+    if (auto* l = (*document->lines)[line])
     {
         reinitialiseCharPtr();
         int indexInLine = 0;
@@ -328,9 +722,9 @@ CodeDocument::Position CodeDocument::Iterator::toPosition() const
 
     if (isEOF())
     {
-        if (auto* last = document->lines.getLast())
+        if (auto* last = document->lines->getLast())
         {
-            auto lineIndex = document->lines.size() - 1;
+            auto lineIndex = document->lines->size() - 1;
             return CodeDocument::Position (*document, lineIndex, last->lineLength);
         }
     }
@@ -409,7 +803,7 @@ void CodeDocument::Position::setLineAndIndex (const int newLineNum, const int ne
 {
     jassert (owner != nullptr);
 
-    if (owner->lines.size() == 0)
+    if (owner->lines->size() == 0)
     {
         line = 0;
         indexInLine = 0;
@@ -417,26 +811,26 @@ void CodeDocument::Position::setLineAndIndex (const int newLineNum, const int ne
     }
     else
     {
-        if (newLineNum >= owner->lines.size())
+        if (newLineNum >= owner->lines->size())
         {
-            line = owner->lines.size() - 1;
+            line = owner->lines->size() - 1;
 
-            auto& l = *owner->lines.getUnchecked (line);
+            auto& l = *(*owner->lines)[line];
             indexInLine = l.lineLengthWithoutNewLines;
-            characterPos = l.lineStartInFile + indexInLine;
+            characterPos = owner->lines->getLineStart (line) + indexInLine;
         }
         else
         {
             line = jmax (0, newLineNum);
 
-            auto& l = *owner->lines.getUnchecked (line);
+            auto& l = *(*owner->lines)[line];
 
             if (l.lineLengthWithoutNewLines > 0)
                 indexInLine = jlimit (0, l.lineLengthWithoutNewLines, newIndexInLine);
             else
                 indexInLine = 0;
 
-            characterPos = l.lineStartInFile + indexInLine;
+            characterPos = owner->lines->getLineStart (line) + indexInLine;
         }
     }
 }
@@ -449,40 +843,12 @@ void CodeDocument::Position::setPosition (const int newPosition)
     indexInLine = 0;
     characterPos = 0;
 
-    if (newPosition > 0)
+    if (newPosition > 0 && owner->lines->size() > 0)
     {
         int lineStart = 0;
-        auto lineEnd = owner->lines.size();
-
-        for (;;)
-        {
-            if (lineEnd - lineStart < 4)
-            {
-                for (int i = lineStart; i < lineEnd; ++i)
-                {
-                    auto& l = *owner->lines.getUnchecked (i);
-                    auto index = newPosition - l.lineStartInFile;
-
-                    if (index >= 0 && (index < l.lineLength || i == lineEnd - 1))
-                    {
-                        line = i;
-                        indexInLine = jmin (l.lineLengthWithoutNewLines, index);
-                        characterPos = l.lineStartInFile + indexInLine;
-                    }
-                }
-
-                break;
-            }
-            else
-            {
-                auto midIndex = (lineStart + lineEnd + 1) / 2;
-
-                if (newPosition >= owner->lines.getUnchecked (midIndex)->lineStartInFile)
-                    lineStart = midIndex;
-                else
-                    lineEnd = midIndex;
-            }
-        }
+        line = owner->lines->findLineContaining (newPosition, lineStart);
+        indexInLine = jmin ((*owner->lines)[line]->lineLengthWithoutNewLines, newPosition - lineStart);
+        characterPos = lineStart + indexInLine;
     }
 }
 
@@ -495,9 +861,9 @@ void CodeDocument::Position::moveBy (int characterDelta)
         setPosition (getPosition());
 
         // If moving right, make sure we don't get stuck between the \r and \n characters..
-        if (line < owner->lines.size())
+        if (line < owner->lines->size())
         {
-            auto& l = *owner->lines.getUnchecked (line);
+            auto& l = *(*owner->lines)[line];
 
             if (indexInLine + characterDelta < l.lineLength
                  && indexInLine + characterDelta >= l.lineLengthWithoutNewLines + 1)
@@ -524,7 +890,7 @@ CodeDocument::Position CodeDocument::Position::movedByLines (const int deltaLine
 
 juce_wchar CodeDocument::Position::getCharacter() const
 {
-    if (auto* l = owner->lines [line])
+    if (auto* l = (*owner->lines)[line])
         return l->line [getIndexInLine()];
 
     return 0;
@@ -532,7 +898,7 @@ juce_wchar CodeDocument::Position::getCharacter() const
 
 String CodeDocument::Position::getLineText() const
 {
-    if (auto* l = owner->lines [line])
+    if (auto* l = (*owner->lines)[line])
         return l->line;
 
     return {};
@@ -562,7 +928,9 @@ void CodeDocument::Position::setPositionMaintained (const bool isMaintained)
 }
 
 //==============================================================================
-CodeDocument::CodeDocument() : undoManager (std::numeric_limits<int>::max(), 10000)
+CodeDocument::CodeDocument()
+    : lines (std::make_unique<CodeDocumentLineList>()),
+      undoManager (std::numeric_limits<int>::max(), 10000)
 {
 }
 
@@ -573,7 +941,7 @@ CodeDocument::~CodeDocument()
 String CodeDocument::getAllContent() const
 {
     return getTextBetween (Position (*this, 0),
-                           Position (*this, lines.size(), 0));
+                           Position (*this, lines->size(), 0));
 }
 
 String CodeDocument::getTextBetween (const Position& start, const Position& end) const
@@ -586,7 +954,7 @@ String CodeDocument::getTextBetween (const Position& start, const Position& end)
 
     if (startLine == endLine)
     {
-        if (auto* line = lines [startLine])
+        if (auto* line = (*lines)[startLine])
             return line->line.substring (start.getIndexInLine(), end.getIndexInLine());
 
         return {};
@@ -595,43 +963,36 @@ String CodeDocument::getTextBetween (const Position& start, const Position& end)
     MemoryOutputStream mo;
     mo.preallocate ((size_t) (end.getPosition() - start.getPosition() + 4));
 
-    auto maxLine = jmin (lines.size() - 1, endLine);
+    auto lineIndex = jmax (0, startLine);
 
-    for (int i = jmax (0, startLine); i <= maxLine; ++i)
+    lines->forEachLineFrom (lineIndex, [&] (const CodeDocumentLine& line)
     {
-        auto& line = *lines.getUnchecked (i);
-        auto len = line.lineLength;
-
-        if (i == startLine)
-        {
-            auto index = start.getIndexInLine();
-            mo << line.line.substring (index, len);
-        }
-        else if (i == endLine)
-        {
-            len = end.getIndexInLine();
-            mo << line.line.substring (0, len);
-        }
+        if (lineIndex == startLine)
+            mo << line.line.substring (start.getIndexInLine(), line.lineLength);
+        else if (lineIndex == endLine)
+            mo << line.line.substring (0, end.getIndexInLine());
         else
-        {
             mo << line.line;
-        }
-    }
+
+        return ++lineIndex <= endLine;
+    });
 
     return mo.toUTF8();
 }
 
 int CodeDocument::getNumCharacters() const noexcept
 {
-    if (auto* lastLine = lines.getLast())
-        return lastLine->lineStartInFile + lastLine->lineLength;
+    return lines->getNumCharacters();
+}
 
-    return 0;
+int CodeDocument::getNumLines() const noexcept
+{
+    return lines->size();
 }
 
 String CodeDocument::getLine (const int lineIndex) const noexcept
 {
-    if (auto* line = lines[lineIndex])
+    if (auto* line = (*lines)[lineIndex])
         return line->line;
 
     return {};
@@ -639,15 +1000,7 @@ String CodeDocument::getLine (const int lineIndex) const noexcept
 
 int CodeDocument::getMaximumLineLength() noexcept
 {
-    if (maximumLineLength < 0)
-    {
-        maximumLineLength = 0;
-
-        for (auto* l : lines)
-            maximumLineLength = jmax (maximumLineLength, l->lineLength);
-    }
-
-    return maximumLineLength;
+    return lines->getMaximumLineLength();
 }
 
 void CodeDocument::deleteSection (const Position& startPosition, const Position& endPosition)
@@ -709,16 +1062,18 @@ bool CodeDocument::loadFromStream (InputStream& stream)
 
 bool CodeDocument::writeToStream (OutputStream& stream)
 {
-    for (auto* l : lines)
+    bool ok = true;
+
+    lines->forEachLineFrom (0, [&] (const CodeDocumentLine& l)
     {
-        auto temp = l->line; // use a copy to avoid bloating the memory footprint of the stored string.
+        auto temp = l.line; // use a copy to avoid bloating the memory footprint of the stored string.
         const char* utf8 = temp.toUTF8();
 
-        if (! stream.write (utf8, strlen (utf8)))
-            return false;
-    }
+        ok = stream.write (utf8, strlen (utf8));
+        return ok;
+    });
 
-    return true;
+    return ok;
 }
 
 void CodeDocument::setNewLineCharacters (const String& newChars) noexcept
@@ -865,21 +1220,20 @@ void CodeDocument::findLineContaining  (const Position& pos, Position& s, Positi
 
 void CodeDocument::checkLastLineStatus()
 {
-    while (lines.size() > 0
-            && lines.getLast()->lineLength == 0
-            && (lines.size() == 1 || ! lines.getUnchecked (lines.size() - 2)->endsWithLineBreak()))
+    while (lines->size() > 0
+            && lines->getLast()->lineLength == 0
+            && (lines->size() == 1 || ! (*lines)[lines->size() - 2]->endsWithLineBreak()))
     {
         // remove any empty lines at the end if the preceding line doesn't end in a newline.
-        lines.removeLast();
+        lines->removeLast();
     }
 
-    const CodeDocumentLine* const lastLine = lines.getLast();
+    const CodeDocumentLine* const lastLine = lines->getLast();
 
     if (lastLine != nullptr && lastLine->endsWithLineBreak())
     {
         // check that there's an empty line at the end if the preceding one ends in a newline..
-        lines.add (new CodeDocumentLine (StringRef(), StringRef(), 0, 0,
-                                         lastLine->lineStartInFile + lastLine->lineLength));
+        lines->insertLines (lines->size(), { new CodeDocumentLine (StringRef(), StringRef(), 0, 0) });
     }
 }
 
@@ -931,7 +1285,7 @@ void CodeDocument::insert (const String& text, const int insertPos, const bool u
             Position pos (*this, insertPos);
             auto firstAffectedLine = pos.getLineNumber();
 
-            auto* firstLine = lines[firstAffectedLine];
+            auto* firstLine = (*lines)[firstAffectedLine];
             auto textInsideOriginalLine = text;
 
             if (firstLine != nullptr)
@@ -942,27 +1296,18 @@ void CodeDocument::insert (const String& text, const int insertPos, const bool u
                                          + firstLine->line.substring (index);
             }
 
-            maximumLineLength = -1;
             Array<CodeDocumentLine*> newLines;
             CodeDocumentLine::createLines (newLines, textInsideOriginalLine);
             jassert (newLines.size() > 0);
 
-            auto* newFirstLine = newLines.getUnchecked (0);
-            newFirstLine->lineStartInFile = firstLine != nullptr ? firstLine->lineStartInFile : 0;
-            lines.set (firstAffectedLine, newFirstLine);
-
-            if (newLines.size() > 1)
-                lines.insertArray (firstAffectedLine + 1, newLines.getRawDataPointer() + 1, newLines.size() - 1);
-
-            int lineStart = newFirstLine->lineStartInFile;
-
-            for (int i = firstAffectedLine; i < lines.size(); ++i)
+            if (firstLine != nullptr)
             {
-                auto& l = *lines.getUnchecked (i);
-                l.lineStartInFile = lineStart;
-                lineStart += l.lineLength;
+                lines->set (firstAffectedLine, newLines.getUnchecked (0));
+                newLines.remove (0);
+                ++firstAffectedLine;
             }
 
+            lines->insertLines (firstAffectedLine, newLines);
             checkLastLineStatus();
             auto newTextLength = text.length();
 
@@ -1022,34 +1367,29 @@ void CodeDocument::remove (const int startPos, const int endPos, const bool undo
         Position startPosition (*this, startPos);
         Position endPosition (*this, endPos);
 
-        maximumLineLength = -1;
         auto firstAffectedLine = startPosition.getLineNumber();
         auto endLine = endPosition.getLineNumber();
-        auto& firstLine = *lines.getUnchecked (firstAffectedLine);
+        auto& firstLine = *(*lines)[firstAffectedLine];
+        const auto oldLength = firstLine.lineLength;
 
         if (firstAffectedLine == endLine)
         {
             firstLine.line = firstLine.line.substring (0, startPosition.getIndexInLine())
                            + firstLine.line.substring (endPosition.getIndexInLine());
             firstLine.updateLength();
+            lines->lineChanged (firstAffectedLine, firstLine.lineLength - oldLength);
         }
         else
         {
-            auto& lastLine = *lines.getUnchecked (endLine);
+            auto& lastLine = *(*lines)[endLine];
 
             firstLine.line = firstLine.line.substring (0, startPosition.getIndexInLine())
                             + lastLine.line.substring (endPosition.getIndexInLine());
             firstLine.updateLength();
+            lines->lineChanged (firstAffectedLine, firstLine.lineLength - oldLength);
 
             int numLinesToRemove = endLine - firstAffectedLine;
-            lines.removeRange (firstAffectedLine + 1, numLinesToRemove);
-        }
-
-        for (int i = firstAffectedLine + 1; i < lines.size(); ++i)
-        {
-            auto& l = *lines.getUnchecked (i);
-            auto& previousLine = *lines.getUnchecked (i - 1);
-            l.lineStartInFile = previousLine.lineStartInFile + previousLine.lineLength;
+            lines->removeRange (firstAffectedLine + 1, numLinesToRemove);
         }
 
         checkLastLineStatus();
@@ -1296,6 +1636,72 @@ struct CodeDocumentTest final : public UnitTest
                 expectEquals (p3.getIndexInLine(), d.getLine (d.getNumLines() - 1).length(), comment3);
             }
         }
+
+        {
+            beginTest ("Large documents");
+
+            auto r = getRandom();
+            String original;
+
+            for (int i = 0; i < 5000; ++i)
+                original << "line " << i << "\n";
+
+            CodeDocument d;
+            d.replaceAllContent (original);
+            d.newTransaction();
+
+            auto reference = original;
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                const auto start = r.nextInt (reference.length() + 1);
+
+                if (r.nextBool())
+                {
+                    String text;
+
+                    for (int n = r.nextInt (r.nextInt (20) == 0 ? 3000 : 5); --n >= 0;)
+                        text << "abc" << (r.nextBool() ? "\n" : "");
+
+                    d.insertText (start, text);
+                    reference = reference.substring (0, start) + text + reference.substring (start);
+                }
+                else
+                {
+                    const auto end = jmin (reference.length(), start + r.nextInt (r.nextInt (20) == 0 ? 20000 : 50));
+                    d.deleteSection (start, end);
+                    reference = reference.substring (0, start) + reference.substring (end);
+                }
+            }
+
+            expectEquals (d.getNumCharacters(), reference.length());
+            expect (d.getAllContent() == reference);
+
+            int lineStart = 0, maxLength = 0;
+            auto positionsMatch = true;
+
+            for (int i = 0; i < d.getNumLines(); ++i)
+            {
+                const auto line = d.getLine (i);
+                const CodeDocument::Position p (d, lineStart);
+
+                positionsMatch = positionsMatch
+                                  && CodeDocument::Position (d, i, 0).getPosition() == lineStart
+                                  && p.getLineNumber() == i
+                                  && p.getIndexInLine() == 0;
+
+                lineStart += line.length();
+                maxLength = jmax (maxLength, line.length());
+            }
+
+            expect (positionsMatch);
+            expectEquals (lineStart, reference.length());
+            expectEquals (d.getMaximumLineLength(), maxLength);
+
+            d.undo();
+            expect (d.getAllContent() == original);
+            expectEquals (d.getNumLines(), 5001);
+        }
     }
 };
 
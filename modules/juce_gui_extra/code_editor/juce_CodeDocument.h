@@ -36,6 +36,7 @@ namespace juce
 {
 
 class CodeDocumentLine;
+class CodeDocumentLineList;
 
 
 //==============================================================================
@@ -44,8 +45,9 @@ class CodeDocumentLine;
 
     When using a CodeEditorComponent, it takes one of these as its source object.
 
-    The CodeDocument stores its content as an array of lines, which makes it
-    quick to insert and delete.
+    The CodeDocument stores its content as a list of lines, grouped into blocks which
+    are indexed by their line and character counts. This keeps insertions, deletions
+    and lookups by line or character position fast, even for very large documents.
 
     @see CodeEditorComponent
 
@@ -210,7 +212,7 @@ public:
     int getNumCharacters() const noexcept;
 
     /** Returns the number of lines in the document. */
-    int getNumLines() const noexcept                    { return lines.size(); }
+    int getNumLines() const noexcept;
 
     /** Returns the number of characters in the longest line of the document. */
     int getMaximumLineLength() noexcept;
@@ -441,11 +443,10 @@ private:
     friend class Iterator;
     friend class Position;
 
-    OwnedArray<CodeDocumentLine> lines;
+    std::unique_ptr<CodeDocumentLineList> lines;
     Array<Position*> positionsToMaintain;
     UndoManager undoManager;
     int currentActionIndex = 0, indexOfSavedState = -1;
-    int maximumLineLength = -1;
     ListenerList<Listener> listeners;
     String newLineChars { "\r\n" };
 
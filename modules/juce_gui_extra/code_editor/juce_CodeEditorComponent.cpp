@@ -69,7 +69,7 @@ private:
 
         int getTotalNumCharacters() const override
         {
-            return codeEditorComponent.document.getAllContent().length();
+            return codeEditorComponent.document.getNumCharacters();
         }
 
         Range<int> getSelection() const override
@@ -381,11 +381,13 @@ private:
 
     void codeDocumentTextInserted (const String& newText, int pos) override
     {
+        owner.keepCachedIteratorsAfterEdit (pos, pos, newText.length());
         owner.codeDocumentChanged (pos, pos + newText.length());
     }
 
     void codeDocumentTextDeleted (int start, int end) override
     {
+        owner.keepCachedIteratorsAfterEdit (start, end, start - end);
         owner.codeDocumentChanged (start, end);
     }
 
@@ -500,6 +502,7 @@ void CodeEditorComponent::loadContent (const String& newContent)
 {
     clearCachedIterators (0);
     document.replaceAllContent (newContent);
+    unverifiedIteratorPositions.clearQuick();
     document.clearUndoHistory();
     document.setSavePoint();
     caretPos.setPosition (0);
@@ -665,7 +668,10 @@ void CodeEditorComponent::codeDocumentChanged (const int startIndex, const int e
     const CodeDocument::Position affectedTextStart (document, startIndex);
     const CodeDocument::Position affectedTextEnd (document, endIndex);
 
-    retokenise (startIndex, endIndex);
+    // Unlike retokenise(), this keeps the token boundaries that keepCachedIteratorsAfterEdit()
+    // found, as the tokeniser itself hasn't changed
+    clearCachedIterators (affectedTextStart.getLineNumber());
+    rebuildLineTokensAsync();
 
     updateCaretPosition();
     columnToTryToMaintain = -1;
@@ -688,6 +694,10 @@ void CodeEditorComponent::retokenise (int startIndex, [[maybe_unused]] int endIn
 
     clearCachedIterators (affectedTextStart.getLineNumber());
 
+    // The tokeniser's output may have changed without an edit, so the token boundaries kept
+    // from earlier edits can't be trusted any more
+    unverifiedIteratorPositions.clearQuick();
+
     rebuildLineTokensAsync();
 }
 
@@ -1745,6 +1755,51 @@ void CodeEditorComponent::clearCachedIterators (const int firstLineToBeInvalid)
     cachedIterators.removeRange (jmax (0, i - 1), cachedIterators.size());
 }
 
+void CodeEditorComponent::keepCachedIteratorsAfterEdit (int start, int oldEnd, int lengthDelta)
+{
+    // The tokenisers don't carry any state between tokens, so once re-tokenising the edited
+    // text lands exactly on a token boundary that was found before the edit, everything after
+    // that point will be tokenised just as it was before. Rather than throwing away the cached
+    // positions that follow the edit, this keeps them (shifted by the change in length) so that
+    // updateCachedIterators() can re-use them as soon as the tokeniser catches up with one.
+    Array<int> positions;
+
+    for (auto p : unverifiedIteratorPositions)
+        if (p < start)
+            positions.add (p);
+
+    for (auto& i : cachedIterators)
+        if (i.getPosition() > oldEnd)
+            positions.add (i.getPosition() + lengthDelta);
+
+    for (auto p : unverifiedIteratorPositions)
+        if (p > oldEnd)
+            positions.add (p + lengthDelta);
+
+    unverifiedIteratorPositions.swapWith (positions);
+}
+
+bool CodeEditorComponent::resynchroniseCachedIterators (const CodeDocument::Iterator& source)
+{
+    const auto position = source.getPosition();
+    int numPassed = 0;
+
+    while (numPassed < unverifiedIteratorPositions.size()
+            && unverifiedIteratorPositions.getUnchecked (numPassed) < position)
+        ++numPassed;
+
+    unverifiedIteratorPositions.removeRange (0, numPassed);
+
+    if (unverifiedIteratorPositions.isEmpty() || unverifiedIteratorPositions.getFirst() != position)
+        return false;
+
+    for (int i = 1; i < unverifiedIteratorPositions.size(); ++i)
+        cachedIterators.add (CodeDocument::Iterator (CodeDocument::Position (document, unverifiedIteratorPositions.getUnchecked (i))));
+
+    unverifiedIteratorPositions.clearQuick();
+    return true;
+}
+
 void CodeEditorComponent::updateCachedIterators (int maxLineNum)
 {
     const int maxNumCachedPositions = 5000;
@@ -1770,6 +1825,9 @@ void CodeEditorComponent::updateCachedIterators (int maxLineNum)
             {
                 codeTokeniser->readNextToken (t);
 
+                if (! unverifiedIteratorPositions.isEmpty() && resynchroniseCachedIterators (t))
+                    break;
+
                 if (t.getLine() >= targetLine)
                     break;
 
@@ -457,7 +457,10 @@ private:
     void codeDocumentChanged (int start, int end);
 
     Array<CodeDocument::Iterator> cachedIterators;
+    Array<int> unverifiedIteratorPositions;
     void clearCachedIterators (int firstLineToBeInvalid);
+    void keepCachedIteratorsAfterEdit (int start, int oldEnd, int lengthDelta);
+    bool resynchroniseCachedIterators (const CodeDocument::Iterator&);
     void updateCachedIterators (int maxLineNum);
     void getIteratorForPosition (int position, CodeDocument::Iterator&);
 
@@ -35,6 +35,82 @@
 namespace juce
 {
 
+//==============================================================================
+struct JavascriptEngine::BoundFunction::State
+{
+    State (JavascriptEngine& ownerIn, detail::qjs::JSContext* contextIn, detail::qjs::JSValue functionIn, int numArguments)
+        : owner (&ownerIn),
+          context (contextIn),
+          thisObject (detail::qjs::JS_GetGlobalObject (contextIn)),
+          function (functionIn)
+    {
+        using namespace detail::qjs;
+        arguments.resize ((size_t) numArguments, JS_UNDEFINED);
+    }
+
+    ~State()
+    {
+        release();
+    }
+
+    void release()
+    {
+        if (context == nullptr)
+            return;
+
+        for (const auto& argument : arguments)
+            detail::qjs::JS_FreeValue (context, argument);
+
+        detail::qjs::JS_FreeValue (context, function);
+        detail::qjs::JS_FreeValue (context, thisObject);
+        context = nullptr;
+        owner = nullptr;
+    }
+
+    JavascriptEngine* owner = nullptr;
+    detail::qjs::JSContext* context = nullptr;
+    detail::qjs::JSValue thisObject, function;
+    std::vector<detail::qjs::JSValue> arguments;
+
+    JUCE_DECLARE_NON_COPYABLE (State)
+    JUCE_DECLARE_NON_MOVEABLE (State)
+};
+
+//==============================================================================
+struct JavascriptEngine::SharedBuffer::State
+{
+    explicit State (detail::qjs::JSContext* contextIn)
+        : context (contextIn)
+    {
+    }
+
+    ~State()
+    {
+        release();
+    }
+
+    void release()
+    {
+        if (context == nullptr)
+            return;
+
+        for (const auto& arrayBuffer : arrayBuffers)
+        {
+            detail::qjs::JS_DetachArrayBuffer (context, arrayBuffer);
+            detail::qjs::JS_FreeValue (context, arrayBuffer);
+        }
+
+        arrayBuffers.clear();
+        context = nullptr;
+    }
+
+    detail::qjs::JSContext* context = nullptr;
+    std::vector<detail::qjs::JSValue> arrayBuffers;
+
+    JUCE_DECLARE_NON_COPYABLE (State)
+    JUCE_DECLARE_NON_MOVEABLE (State)
+};
+
 //==============================================================================
 class JavascriptEngine::Impl
 {
@@ -50,6 +126,11 @@ public:
         {
             return (int64) Time::getMillisecondCounterHiRes() >= timeout;
         });
+
+        // Held on to, so that scripts replacing the global can't affect shared buffers
+        auto* ctx = engine.getQuickJSContext();
+        ValuePtr global { JS_GetGlobalObject (ctx), ctx };
+        float32ArrayConstructor.emplace (JS_GetPropertyStr (ctx, global.get(), "Float32Array"), ctx);
     }
 
     void registerNativeObject (const Identifier& name,
@@ -177,6 +258,195 @@ public:
         return var::undefined();
     }
 
+    //==============================================================================
+    CompiledScript compile (const String& code, Result* errorMessage)
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = Result::ok();
+
+        const auto sourceHash = CompiledScript::getSourceHashFor (code);
+
+        // Hashes can collide, so a cached script is only reused if its source matches
+        if (const auto iter = compiledScripts.find (sourceHash); iter != compiledScripts.end() && iter->second.getSource() == code)
+            return iter->second;
+
+        auto script = loadCachedBytecode (code, sourceHash);
+
+        if (! script.isValid())
+        {
+            auto* ctx = engine.getQuickJSContext();
+
+            ValuePtr function { JS_Eval (ctx, code.toRawUTF8(), code.getNumBytesAsUTF8(), "",
+                                         JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY), ctx };
+
+            if (detail::qjs::JS_IsException (function.get()))
+            {
+                toVarOrFail (function, errorMessage);
+                return {};
+            }
+
+            size_t size = 0;
+            auto* data = detail::qjs::JS_WriteObject (ctx, &size, function.get(), detail::qjs::JS_WRITE_OBJ_BYTECODE);
+
+            if (data == nullptr)
+            {
+                if (errorMessage != nullptr)
+                    *errorMessage = Result::fail ("Failed to serialise the compiled script");
+
+                return {};
+            }
+
+            script = CompiledScript::fromBytecode (code, MemoryBlock (data, size));
+            detail::qjs::js_free (ctx, data);
+
+            storeLoadedFunction (script, std::move (function));
+            saveCachedBytecode (script);
+        }
+
+        prepareToCache (sourceHash);
+        compiledScripts.insert_or_assign (sourceHash, script);
+        return script;
+    }
+
+    var evaluate (const CompiledScript& script, Result* errorMessage, RelativeTime maxExecTime)
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = Result::ok();
+
+        auto* ctx = engine.getQuickJSContext();
+        auto* function = getLoadedFunction (script);
+
+        if (function == nullptr)
+        {
+            if (errorMessage != nullptr)
+                *errorMessage = Result::fail ("Invalid compiled script");
+
+            return var::undefined();
+        }
+
+        resetTimeout (maxExecTime);
+
+        // JS_EvalFunction takes ownership of the function it's given, so we pass it a new
+        // reference and keep ours for subsequent calls
+        return toVarOrFail ({ detail::qjs::JS_EvalFunction (ctx, detail::qjs::JS_DupValue (ctx, function->get())), ctx },
+                            errorMessage);
+    }
+
+    void setBytecodeCacheDirectory (const File& directory)
+    {
+        bytecodeCacheDirectory = directory;
+    }
+
+    void clearCompiledScriptCache()
+    {
+        compiledScripts.clear();
+        loadedFunctions.clear();
+        cachedSourceHashes.clear();
+    }
+
+    //==============================================================================
+    std::shared_ptr<BoundFunction::State> bindFunction (JavascriptEngine& owner,
+                                                        const Identifier& function,
+                                                        int numArguments,
+                                                        Result* errorMessage)
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = Result::ok();
+
+        auto* ctx = engine.getQuickJSContext();
+        ValuePtr global { JS_GetGlobalObject (ctx), ctx };
+        ValuePtr value { JS_GetPropertyStr (ctx, global.get(), function.toString().toRawUTF8()), ctx };
+
+        if (! detail::qjs::JS_IsFunction (ctx, value.get()))
+        {
+            if (errorMessage != nullptr)
+                *errorMessage = Result::fail ("No function named " + function.toString());
+
+            return {};
+        }
+
+        auto state = std::make_shared<BoundFunction::State> (owner, ctx, value.release(), jmax (0, numArguments));
+
+        track (boundFunctions, state);
+        return state;
+    }
+
+    var call (BoundFunction::State& state, Result* errorMessage, RelativeTime maxExecTime)
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = Result::ok();
+
+        resetTimeout (maxExecTime);
+
+        auto* ctx = state.context;
+        return toVarOrFail ({ JS_Call (ctx, state.function, state.thisObject, (int) state.arguments.size(), state.arguments.data()), ctx },
+                            errorMessage);
+    }
+
+    //==============================================================================
+    std::shared_ptr<SharedBuffer::State> shareMemory (const Identifier& name, void* data, size_t numBytes)
+    {
+        auto* ctx = engine.getQuickJSContext();
+        auto state = std::make_shared<SharedBuffer::State> (ctx);
+        auto arrayBuffer = createArrayBuffer (*state, data, numBytes);
+
+        setGlobal (name, arrayBuffer.release());
+        track (sharedBuffers, state);
+        return state;
+    }
+
+    std::shared_ptr<SharedBuffer::State> shareFloatArrays (const Identifier& name,
+                                                           float* const* channels,
+                                                           int numChannels,
+                                                           size_t numElementsPerChannel,
+                                                           bool asArrayOfChannels,
+                                                           RelativeTime maxExecTime)
+    {
+        // Constructing the typed arrays runs javascript, which polls the interrupt handler
+        resetTimeout (maxExecTime);
+
+        auto* ctx = engine.getQuickJSContext();
+        auto state = std::make_shared<SharedBuffer::State> (ctx);
+
+        ValuePtr array { detail::qjs::JS_NewArray (ctx), ctx };
+
+        for (int i = 0; i < numChannels; ++i)
+        {
+            auto arrayBuffer = createArrayBuffer (*state, channels[i], numElementsPerChannel * sizeof (float));
+            auto bufferValue = arrayBuffer.get();
+
+            ValuePtr typedArray { JS_CallConstructor (ctx, float32ArrayConstructor->get(), 1, &bufferValue), ctx };
+
+            if (detail::qjs::JS_IsException (typedArray.get()))
+            {
+                ValuePtr exception { detail::qjs::JS_GetException (ctx), ctx };
+                jassertfalse;
+                continue;
+            }
+
+            if (! asArrayOfChannels)
+            {
+                setGlobal (name, typedArray.release());
+                break;
+            }
+
+            detail::qjs::JS_SetPropertyUint32 (ctx, array.get(), (uint32_t) i, typedArray.release());
+        }
+
+        if (asArrayOfChannels)
+            setGlobal (name, array.release());
+
+        track (sharedBuffers, state);
+        return state;
+    }
+
+    //==============================================================================
+    void releaseHandles()
+    {
+        releaseAll (boundFunctions);
+        releaseAll (sharedBuffers);
+    }
+
     void stop() noexcept
     {
         timeout = (int64) Time::getMillisecondCounterHiRes();
@@ -194,8 +464,186 @@ private:
         timeout = (int64) Time::getMillisecondCounterHiRes() + maxExecTime.inMilliseconds();
     }
 
+    static var toVarOrFail (const ValuePtr& value, Result* errorMessage)
+    {
+        const auto result = detail::quickJSToJuce (value);
+
+        if (auto* v = std::get_if<var> (&result))
+            return *v;
+
+        if (auto* e = std::get_if<String> (&result))
+            if (errorMessage != nullptr)
+                *errorMessage = Result::fail (*e);
+
+        return var::undefined();
+    }
+
+    template <typename State>
+    static void track (std::vector<std::weak_ptr<State>>& handles, const std::shared_ptr<State>& state)
+    {
+        handles.erase (std::remove_if (handles.begin(), handles.end(), [] (const auto& h) { return h.expired(); }),
+                       handles.end());
+        handles.push_back (state);
+    }
+
+    template <typename State>
+    static void releaseAll (std::vector<std::weak_ptr<State>>& handles)
+    {
+        for (const auto& h : handles)
+            if (auto state = h.lock())
+                state->release();
+
+        handles.clear();
+    }
+
+    ValuePtr createArrayBuffer (SharedBuffer::State& state, void* data, size_t numBytes)
+    {
+        auto* ctx = engine.getQuickJSContext();
+
+        // Passing no free function means QuickJS never takes ownership of the memory
+        ValuePtr arrayBuffer { detail::qjs::JS_NewArrayBuffer (ctx, static_cast<uint8_t*> (data), numBytes, nullptr, nullptr, false), ctx };
+        state.arrayBuffers.push_back (detail::qjs::JS_DupValue (ctx, arrayBuffer.get()));
+        return arrayBuffer;
+    }
+
+    void setGlobal (const Identifier& name, detail::qjs::JSValue value)
+    {
+        auto* ctx = engine.getQuickJSContext();
+        ValuePtr global { JS_GetGlobalObject (ctx), ctx };
+        detail::qjs::JS_SetPropertyStr (ctx, global.get(), name.toString().toRawUTF8(), value);
+    }
+
+    const ValuePtr* getLoadedFunction (const CompiledScript& script)
+    {
+        if (! script.isValid())
+            return nullptr;
+
+        if (const auto iter = loadedFunctions.find (script.getSourceHash());
+            iter != loadedFunctions.end() && iter->second.source == script.getSource())
+        {
+            return &iter->second.function;
+        }
+
+        auto* ctx = engine.getQuickJSContext();
+        const auto& bytecode = script.getBytecode();
+
+        ValuePtr function { detail::qjs::JS_ReadObject (ctx,
+                                                        static_cast<const uint8_t*> (bytecode.getData()),
+                                                        bytecode.getSize(),
+                                                        detail::qjs::JS_READ_OBJ_BYTECODE),
+                            ctx };
+
+        if (detail::qjs::JS_IsException (function.get()))
+        {
+            ValuePtr exception { detail::qjs::JS_GetException (ctx), ctx };
+            return nullptr;
+        }
+
+        return storeLoadedFunction (script, std::move (function));
+    }
+
+    const ValuePtr* storeLoadedFunction (const CompiledScript& script, ValuePtr function)
+    {
+        prepareToCache (script.getSourceHash());
+
+        // Replaces any function that was loaded from a different script with the same hash
+        loadedFunctions.erase (script.getSourceHash());
+        return &loadedFunctions.emplace (script.getSourceHash(),
+                                         LoadedFunction { script.getSource(), std::move (function) }).first->second.function;
+    }
+
+    // Makes room for a script that's about to be added to the caches, forgetting the
+    // oldest ones so that an application compiling many distinct scripts doesn't keep
+    // every one of them alive
+    void prepareToCache (const String& sourceHash)
+    {
+        if (compiledScripts.count (sourceHash) != 0 || loadedFunctions.count (sourceHash) != 0)
+            return;
+
+        while (cachedSourceHashes.size() >= maxNumCachedScripts)
+        {
+            compiledScripts.erase (cachedSourceHashes.front());
+            loadedFunctions.erase (cachedSourceHashes.front());
+            cachedSourceHashes.pop_front();
+        }
+
+        cachedSourceHashes.push_back (sourceHash);
+    }
+
+    File getCacheFile (const String& sourceHash) const
+    {
+        if (bytecodeCacheDirectory == File())
+            return {};
+
+        return bytecodeCacheDirectory.getChildFile (sourceHash).withFileExtension ("jsbytecode");
+    }
+
+    // Cache files hold the script's source as a null-terminated UTF-8 string, followed by
+    // its bytecode. A file whose source doesn't match was written for a different script
+    // with the same hash, and is treated as a miss.
+    CompiledScript loadCachedBytecode (const String& code, const String& sourceHash)
+    {
+        const auto file = getCacheFile (sourceHash);
+
+        if (! file.existsAsFile())
+            return {};
+
+        MemoryBlock contents;
+
+        if (! file.loadFileAsData (contents))
+            return {};
+
+        MemoryInputStream stream (contents, false);
+
+        if (stream.readString() != code)
+            return {};
+
+        MemoryBlock bytecode;
+        stream.readIntoMemoryBlock (bytecode);
+
+        auto script = CompiledScript::fromBytecode (code, std::move (bytecode));
+
+        // Files written by an incompatible version are replaced by recompiling the source
+        if (getLoadedFunction (script) == nullptr)
+        {
+            file.deleteFile();
+            return {};
+        }
+
+        return script;
+    }
+
+    void saveCachedBytecode (const CompiledScript& script) const
+    {
+        const auto file = getCacheFile (script.getSourceHash());
+
+        if (file == File() || ! bytecodeCacheDirectory.createDirectory())
+            return;
+
+        MemoryOutputStream stream;
+        stream.writeString (script.getSource());
+        stream << script.getBytecode();
+
+        file.replaceWithData (stream.getData(), stream.getDataSize());
+    }
+
     detail::QuickJSWrapper engine;
     std::atomic<int64> timeout{};
+
+    File bytecodeCacheDirectory;
+    std::map<String, CompiledScript> compiledScripts;
+    struct LoadedFunction
+    {
+        String source;
+        ValuePtr function;
+    };
+
+    std::map<String, LoadedFunction> loadedFunctions;
+    std::list<String> cachedSourceHashes;
+    static constexpr size_t maxNumCachedScripts = 256;
+    std::optional<ValuePtr> float32ArrayConstructor;
+    std::vector<std::weak_ptr<BoundFunction::State>> boundFunctions;
+    std::vector<std::weak_ptr<SharedBuffer::State>> sharedBuffers;
 };
 
 //==============================================================================
@@ -205,7 +653,10 @@ JavascriptEngine::JavascriptEngine()
 {
 }
 
-JavascriptEngine::~JavascriptEngine() = default;
+JavascriptEngine::~JavascriptEngine()
+{
+    impl->releaseHandles();
+}
 
 void JavascriptEngine::registerNativeObject (const Identifier& name, DynamicObject* object)
 {
@@ -229,6 +680,58 @@ var JavascriptEngine::callFunction (const Identifier& function,
     return impl->callFunction (function, args, errorMessage, maximumExecutionTime);
 }
 
+JavascriptEngine::CompiledScript JavascriptEngine::compile (const String& javascriptCode, Result* errorMessage)
+{
+    return impl->compile (javascriptCode, errorMessage);
+}
+
+Result JavascriptEngine::execute (const CompiledScript& script)
+{
+    auto result = Result::ok();
+    impl->evaluate (script, &result, maximumExecutionTime);
+    return result;
+}
+
+var JavascriptEngine::evaluate (const CompiledScript& script, Result* errorMessage)
+{
+    return impl->evaluate (script, errorMessage, maximumExecutionTime);
+}
+
+void JavascriptEngine::setBytecodeCacheDirectory (const File& directory)
+{
+    impl->setBytecodeCacheDirectory (directory);
+}
+
+void JavascriptEngine::clearCompiledScriptCache()
+{
+    impl->clearCompiledScriptCache();
+}
+
+JavascriptEngine::BoundFunction JavascriptEngine::bindFunction (const Identifier& function,
+                                                                int numArguments,
+                                                                Result* errorMessage)
+{
+    return BoundFunction { impl->bindFunction (*this, function, numArguments, errorMessage) };
+}
+
+JavascriptEngine::SharedBuffer JavascriptEngine::shareMemory (const Identifier& name, void* data, size_t numBytes)
+{
+    return SharedBuffer { impl->shareMemory (name, data, numBytes) };
+}
+
+JavascriptEngine::SharedBuffer JavascriptEngine::shareFloatArray (const Identifier& name, float* data, size_t numElements)
+{
+    return SharedBuffer { impl->shareFloatArrays (name, &data, 1, numElements, false, maximumExecutionTime) };
+}
+
+JavascriptEngine::SharedBuffer JavascriptEngine::shareFloatArrays (const Identifier& name,
+                                                                   float* const* channels,
+                                                                   int numChannels,
+                                                                   size_t numElementsPerChannel)
+{
+    return SharedBuffer { impl->shareFloatArrays (name, channels, numChannels, numElementsPerChannel, true, maximumExecutionTime) };
+}
+
 void JavascriptEngine::stop() noexcept
 {
     impl->stop();
@@ -244,4 +747,107 @@ NamedValueSet JavascriptEngine::getRootObjectProperties() const
     return getRootObject().getProperties();
 }
 
+//==============================================================================
+JavascriptEngine::CompiledScript JavascriptEngine::CompiledScript::fromBytecode (const String& javascriptCode, MemoryBlock bytecode)
+{
+    CompiledScript script;
+    script.source = javascriptCode;
+    script.sourceHash = getSourceHashFor (javascriptCode);
+    script.bytecode = std::move (bytecode);
+    return script;
+}
+
+String JavascriptEngine::CompiledScript::getSourceHashFor (const String& javascriptCode)
+{
+    // 64-bit FNV-1a of the UTF-8 source, combined with its length
+    auto hash = (uint64) 0xcbf29ce484222325ULL;
+    const auto utf8 = javascriptCode.toRawUTF8();
+    const auto numBytes = javascriptCode.getNumBytesAsUTF8();
+
+    for (size_t i = 0; i < numBytes; ++i)
+        hash = (hash ^ (uint8) utf8[i]) * 0x100000001b3ULL;
+
+    return String::toHexString ((int64) hash).paddedLeft ('0', 16) + "_" + String::toHexString ((int64) numBytes);
+}
+
+//==============================================================================
+JavascriptEngine::BoundFunction::BoundFunction() = default;
+JavascriptEngine::BoundFunction::~BoundFunction() = default;
+JavascriptEngine::BoundFunction::BoundFunction (BoundFunction&&) noexcept = default;
+JavascriptEngine::BoundFunction& JavascriptEngine::BoundFunction::operator= (BoundFunction&&) noexcept = default;
+
+JavascriptEngine::BoundFunction::BoundFunction (std::shared_ptr<State> s)
+    : state (std::move (s))
+{
+}
+
+bool JavascriptEngine::BoundFunction::isValid() const noexcept
+{
+    return state != nullptr && state->context != nullptr;
+}
+
+int JavascriptEngine::BoundFunction::getNumArguments() const noexcept
+{
+    return isValid() ? (int) state->arguments.size() : 0;
+}
+
+void JavascriptEngine::BoundFunction::setArgument (int index, const var& value)
+{
+    if (! isValid() || ! isPositiveAndBelow (index, (int) state->arguments.size()))
+    {
+        jassertfalse;
+        return;
+    }
+
+    auto& argument = state->arguments[(size_t) index];
+    detail::qjs::JS_FreeValue (state->context, argument);
+    argument = detail::juceToQuickJs (value, state->context);
+}
+
+var JavascriptEngine::BoundFunction::call (Result* errorMessage)
+{
+    if (! isValid())
+    {
+        if (errorMessage != nullptr)
+            *errorMessage = Result::fail ("Invalid bound function");
+
+        return var::undefined();
+    }
+
+    return state->owner->impl->call (*state, errorMessage, state->owner->maximumExecutionTime);
+}
+
+//==============================================================================
+JavascriptEngine::SharedBuffer::SharedBuffer() = default;
+JavascriptEngine::SharedBuffer::SharedBuffer (SharedBuffer&&) noexcept = default;
+JavascriptEngine::SharedBuffer& JavascriptEngine::SharedBuffer::operator= (SharedBuffer&& other) noexcept
+{
+    release();
+    state = std::move (other.state);
+    return *this;
+}
+
+JavascriptEngine::SharedBuffer::~SharedBuffer()
+{
+    release();
+}
+
+JavascriptEngine::SharedBuffer::SharedBuffer (std::shared_ptr<State> s)
+    : state (std::move (s))
+{
+}
+
+bool JavascriptEngine::SharedBuffer::isValid() const noexcept
+{
+    return state != nullptr && state->context != nullptr;
+}
+
+void JavascriptEngine::SharedBuffer::release()
+{
+    if (state != nullptr)
+        state->release();
+
+    state.reset();
+}
+
 } // namespace juce
@@ -93,6 +93,248 @@ public:
                       const var::NativeFunctionArgs& args,
                       Result* errorMessage = nullptr);
 
+    //==============================================================================
+    /**
+        A block of javascript code that has been compiled to bytecode.
+
+        Use JavascriptEngine::compile() to create one of these, and pass it to the
+        execute() or evaluate() methods to run it without parsing the source again.
+
+        The bytecode isn't tied to the engine that compiled it, so it can be run by any
+        JavascriptEngine, or saved and reloaded later with getBytecode() and fromBytecode().
+
+        @see JavascriptEngine::compile
+    */
+    class JUCE_API  CompiledScript
+    {
+    public:
+        /** Creates an empty, invalid script. */
+        CompiledScript() = default;
+
+        /** Recreates a script from bytecode that was previously obtained from getBytecode().
+
+            The javascriptCode should be the value returned by getSource() for the same script.
+            Engines compare it against the source of any cached script that has the same hash,
+            so that two different scripts can never be mistaken for one another.
+
+            Bytecode isn't validated when it's loaded, and malformed bytecode can crash the
+            engine or run arbitrary code, so never load data from an untrusted source. Only
+            pass in data that your own application has produced. Bytecode produced by a
+            different version of JUCE will fail to run, in which case you should compile the
+            source again.
+        */
+        static CompiledScript fromBytecode (const String& javascriptCode, MemoryBlock bytecode);
+
+        /** Returns the source code that this script was compiled from. */
+        const String& getSource() const noexcept             { return source; }
+
+        /** Returns a hash of the source code that this script was compiled from. */
+        const String& getSourceHash() const noexcept         { return sourceHash; }
+
+        /** Returns the compiled bytecode. */
+        const MemoryBlock& getBytecode() const noexcept      { return bytecode; }
+
+        /** Returns true if this script holds some bytecode. */
+        bool isValid() const noexcept                        { return ! bytecode.isEmpty(); }
+
+        /** Returns the hash that a CompiledScript would have if it were compiled from this code. */
+        static String getSourceHashFor (const String& javascriptCode);
+
+    private:
+        String source, sourceHash;
+        MemoryBlock bytecode;
+    };
+
+    /** Compiles a block of javascript code without running it.
+
+        The result can be passed to execute() or evaluate() as many times as you need,
+        which avoids the cost of parsing the code on each call.
+
+        The most recently compiled scripts are cached by the engine, so compiling the same
+        code again is cheap. If a bytecode cache directory has been set, the bytecode is also
+        loaded from and saved to that directory.
+
+        If there's a syntax error, the returned script will be invalid and the error
+        description is returned in errorMessage.
+
+        @see setBytecodeCacheDirectory, clearCompiledScriptCache
+    */
+    CompiledScript compile (const String& javascriptCode, Result* errorMessage = nullptr);
+
+    /** Runs a script that was created by compile().
+        If there's an execution error, the error description is returned in the result.
+    */
+    Result execute (const CompiledScript& script);
+
+    /** Runs a script that was created by compile(), and returns the value of its last
+        expression statement.
+        If the script can't be evaluated, the return value will be var::undefined(), and
+        the errorMessage parameter gives you a way to find out why.
+    */
+    var evaluate (const CompiledScript& script, Result* errorMessage = nullptr);
+
+    /** Sets a directory in which compile() will persist the bytecode it produces.
+
+        Each script is stored in a file named after the hash of its source, so later runs
+        of your application can skip parsing. The file also holds the full source, and is
+        ignored unless that matches the code being compiled. Pass File() to turn this off.
+
+        Files in this directory are loaded as bytecode without being validated, so it must
+        not be writable by anyone you wouldn't trust to run native code in your application.
+        Use a location that's private to your application rather than a shared temporary folder.
+
+        @see CompiledScript::fromBytecode
+    */
+    void setBytecodeCacheDirectory (const File& directory);
+
+    /** Releases the scripts that compile() has cached in memory.
+
+        The engine only keeps a limited number of recent scripts, but you can call this to
+        free them sooner. Any files in the bytecode cache directory are left untouched, and
+        existing CompiledScript objects can still be run afterwards.
+    */
+    void clearCompiledScriptCache();
+
+    //==============================================================================
+    /**
+        A handle to a function in the root namespace that can be called repeatedly.
+
+        The function is looked up once, and the arguments are held as javascript values
+        that are only converted again when you change them with setArgument(). This makes
+        it suitable for callbacks that are invoked very often with similar arguments.
+
+        A BoundFunction becomes invalid when the engine that created it is deleted.
+
+        @see JavascriptEngine::bindFunction
+    */
+    class JUCE_API  BoundFunction
+    {
+    public:
+        /** Creates an invalid BoundFunction. */
+        BoundFunction();
+
+        /** Destructor. */
+        ~BoundFunction();
+
+        /** Move constructor. */
+        BoundFunction (BoundFunction&&) noexcept;
+
+        /** Move assignment operator. */
+        BoundFunction& operator= (BoundFunction&&) noexcept;
+
+        /** Returns true if this refers to a function in a live engine. */
+        bool isValid() const noexcept;
+
+        /** Returns the number of arguments that are passed to the function. */
+        int getNumArguments() const noexcept;
+
+        /** Changes one of the arguments that will be passed on subsequent calls. */
+        void setArgument (int index, const var& value);
+
+        /** Calls the function with the current arguments, and returns the result. */
+        var call (Result* errorMessage = nullptr);
+
+    private:
+        friend class JavascriptEngine;
+        struct State;
+        std::shared_ptr<State> state;
+
+        explicit BoundFunction (std::shared_ptr<State>);
+
+        JUCE_DECLARE_NON_COPYABLE (BoundFunction)
+    };
+
+    /** Looks up a function in the root namespace and returns a handle for calling it
+        with a fixed number of arguments, which are initially all undefined.
+
+        If there's no function with this name, the handle that is returned will be invalid
+        and the error description is returned in errorMessage.
+    */
+    BoundFunction bindFunction (const Identifier& function,
+                                int numArguments,
+                                Result* errorMessage = nullptr);
+
+    //==============================================================================
+    /**
+        A handle to some native memory that has been shared with the engine's scripts.
+
+        While this object exists, scripts can read and write the memory directly through
+        the ArrayBuffer or typed arrays that were created for it, without anything being
+        copied. When it's deleted or release() is called, those buffers are detached, so
+        they appear empty to the script and the memory won't be touched again.
+
+        The memory must remain valid for as long as the SharedBuffer that refers to it.
+
+        @see JavascriptEngine::shareMemory, JavascriptEngine::shareFloatArray,
+             JavascriptEngine::shareFloatArrays
+    */
+    class JUCE_API  SharedBuffer
+    {
+    public:
+        /** Creates an invalid SharedBuffer. */
+        SharedBuffer();
+
+        /** Destructor. This detaches the buffers from the script. */
+        ~SharedBuffer();
+
+        /** Move constructor. */
+        SharedBuffer (SharedBuffer&&) noexcept;
+
+        /** Move assignment operator. */
+        SharedBuffer& operator= (SharedBuffer&&) noexcept;
+
+        /** Returns true if the script can still access the memory. */
+        bool isValid() const noexcept;
+
+        /** Detaches the buffers from the script, after which the memory can be freed. */
+        void release();
+
+    private:
+        friend class JavascriptEngine;
+        struct State;
+        std::shared_ptr<State> state;
+
+        explicit SharedBuffer (std::shared_ptr<State>);
+
+        JUCE_DECLARE_NON_COPYABLE (SharedBuffer)
+    };
+
+    /** Makes a block of memory available to scripts as an ArrayBuffer in the root namespace,
+        without copying it.
+
+        To share the contents of a MemoryBlock, pass its getData() and getSize().
+
+        @see SharedBuffer
+    */
+    [[nodiscard]] SharedBuffer shareMemory (const Identifier& name, void* data, size_t numBytes);
+
+    /** Makes an array of floats available to scripts as a Float32Array in the root namespace,
+        without copying it.
+
+        @see SharedBuffer
+    */
+    [[nodiscard]] SharedBuffer shareFloatArray (const Identifier& name, float* data, size_t numElements);
+
+    /** Makes a set of float channels available to scripts as an Array of Float32Arrays in the
+        root namespace, without copying them.
+
+        This is intended for passing the contents of an AudioBuffer to a script, e.g.
+        @code
+        auto shared = engine.shareFloatArrays ("channels",
+                                               buffer.getArrayOfWritePointers(),
+                                               buffer.getNumChannels(),
+                                               (size_t) buffer.getNumSamples());
+        engine.callFunction ("process", {});
+        @endcode
+
+        @see SharedBuffer
+    */
+    [[nodiscard]] SharedBuffer shareFloatArrays (const Identifier& name,
+                                                 float* const* channels,
+                                                 int numChannels,
+                                                 size_t numElementsPerChannel);
+
+    //==============================================================================
     /** Adds a native object to the root namespace.
         The object passed-in is reference-counted, and will be retained by the
         engine until the engine is deleted. The name must be a simple JS identifier,
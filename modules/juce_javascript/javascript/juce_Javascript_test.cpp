@@ -447,6 +447,241 @@ public:
 
             expect (numCalls == 2);
         }
+
+        beginTest ("Compiled scripts can be run repeatedly");
+        {
+            JavascriptEngine temporaryEngine;
+            auto res = Result::fail ("");
+
+            const auto script = temporaryEngine.compile ("var counter = (typeof counter === 'undefined') ? 1 : counter + 1; counter * 10;", &res);
+            expect (res.wasOk());
+            expect (script.isValid());
+
+            for (int i = 1; i <= 3; ++i)
+            {
+                const auto val = temporaryEngine.evaluate (script, &res);
+                expect (res.wasOk());
+                expectEquals ((int) val, i * 10);
+            }
+
+            const auto again = temporaryEngine.compile ("var counter = (typeof counter === 'undefined') ? 1 : counter + 1; counter * 10;");
+            expect (again.getBytecode() == script.getBytecode());
+
+            const auto broken = temporaryEngine.compile ("var x = ;", &res);
+            expect (res.failed());
+            expect (! broken.isValid());
+
+            expect (temporaryEngine.execute (broken).failed());
+        }
+
+        beginTest ("Bytecode can be run by another engine and persisted to disk");
+        {
+            const String source = "function scale (x, y) { return x * y + offset; } var offset = 0.5;";
+
+            TemporaryFile cacheDir;
+            JavascriptEngine::CompiledScript script;
+
+            {
+                JavascriptEngine first;
+                first.setBytecodeCacheDirectory (cacheDir.getFile());
+                script = first.compile (source);
+            }
+
+            const auto cachedFile = cacheDir.getFile().getChildFile (JavascriptEngine::CompiledScript::getSourceHashFor (source))
+                                                      .withFileExtension ("jsbytecode");
+            expect (cachedFile.existsAsFile());
+
+            JavascriptEngine second;
+            const auto reloaded = JavascriptEngine::CompiledScript::fromBytecode (script.getSource(), script.getBytecode());
+            expect (second.execute (reloaded).wasOk());
+            expectEquals ((double) second.evaluate ("scale (3, 2)"), 6.5);
+
+            JavascriptEngine third;
+            third.setBytecodeCacheDirectory (cacheDir.getFile());
+            expect (third.execute (third.compile (source)).wasOk());
+            expectEquals ((double) third.evaluate ("scale (4, 2)"), 8.5);
+
+            // Corrupt cache files are discarded and the source is compiled again
+            cachedFile.replaceWithText ("not bytecode");
+
+            JavascriptEngine fourth;
+            fourth.setBytecodeCacheDirectory (cacheDir.getFile());
+            expect (fourth.execute (fourth.compile (source)).wasOk());
+            expectEquals ((double) fourth.evaluate ("scale (1, 1)"), 1.5);
+
+            {
+                MemoryOutputStream corrupt;
+                corrupt.writeString (source);
+                corrupt << "not bytecode";
+                cachedFile.replaceWithData (corrupt.getData(), corrupt.getDataSize());
+            }
+
+            JavascriptEngine fifth;
+            fifth.setBytecodeCacheDirectory (cacheDir.getFile());
+            expect (fifth.execute (fifth.compile (source)).wasOk());
+            expectEquals ((double) fifth.evaluate ("scale (2, 1)"), 2.5);
+
+            cacheDir.getFile().deleteRecursively();
+        }
+
+        beginTest ("Cached bytecode is only used for the source it was compiled from");
+        {
+            const String source = "var planted = false;";
+            const String other  = "var planted = true;";
+
+            TemporaryFile cacheDir;
+            const auto cachedFile = cacheDir.getFile().getChildFile (JavascriptEngine::CompiledScript::getSourceHashFor (source))
+                                                      .withFileExtension ("jsbytecode");
+
+            {
+                // Simulates a hash collision, by storing another script under this source's key
+                JavascriptEngine first;
+                first.setBytecodeCacheDirectory (cacheDir.getFile());
+                const auto otherScript = first.compile (other);
+
+                expect (cacheDir.getFile().createDirectory());
+                expect (cacheDir.getFile().getChildFile (otherScript.getSourceHash())
+                                          .withFileExtension ("jsbytecode")
+                                          .moveFileTo (cachedFile));
+            }
+
+            JavascriptEngine second;
+            second.setBytecodeCacheDirectory (cacheDir.getFile());
+            const auto script = second.compile (source);
+
+            expect (script.getSource() == source);
+            expect (second.execute (script).wasOk());
+            expect (! (bool) second.evaluate ("planted"));
+
+            // The planted file is replaced by the bytecode for the right script
+            JavascriptEngine third;
+            third.setBytecodeCacheDirectory (cacheDir.getFile());
+            expect (third.execute (third.compile (source)).wasOk());
+            expect (! (bool) third.evaluate ("planted"));
+
+            cacheDir.getFile().deleteRecursively();
+        }
+
+        beginTest ("Compiled scripts still run after being dropped from the cache");
+        {
+            JavascriptEngine temporaryEngine;
+
+            const auto first = temporaryEngine.compile ("var counter = 1;");
+            expect (first.isValid());
+
+            for (int i = 0; i < 300; ++i)
+                expect (temporaryEngine.compile ("counter += " + String (i) + ";").isValid());
+
+            expect (temporaryEngine.execute (first).wasOk());
+            expectEquals ((int) temporaryEngine.evaluate ("counter"), 1);
+
+            const auto increment = temporaryEngine.compile ("++counter;");
+            expect (temporaryEngine.execute (increment).wasOk());
+
+            temporaryEngine.clearCompiledScriptCache();
+
+            expect (temporaryEngine.execute (increment).wasOk());
+            expect (temporaryEngine.execute (temporaryEngine.compile ("++counter;")).wasOk());
+            expectEquals ((int) temporaryEngine.evaluate ("counter"), 4);
+        }
+
+        beginTest ("Bound functions can be called with updated arguments");
+        {
+            auto res = Result::fail ("");
+            JavascriptEngine::BoundFunction invalid;
+            expect (! invalid.isValid());
+
+            {
+                JavascriptEngine temporaryEngine;
+                temporaryEngine.execute ("function add (a, b) { return a + b; }");
+
+                auto missing = temporaryEngine.bindFunction ("doesNotExist", 1, &res);
+                expect (res.failed());
+                expect (! missing.isValid());
+
+                auto add = temporaryEngine.bindFunction ("add", 2, &res);
+                expect (res.wasOk());
+                expectEquals (add.getNumArguments(), 2);
+
+                add.setArgument (0, 1.5);
+                add.setArgument (1, 2);
+                expectEquals ((double) add.call (&res), 3.5);
+                expect (res.wasOk());
+
+                add.setArgument (1, 10);
+                expectEquals ((double) add.call(), 11.5);
+
+                add.setArgument (0, "x");
+                expectEquals (add.call().toString(), String ("x10"));
+
+                invalid = std::move (add);
+                expect (invalid.isValid());
+            }
+
+            expect (! invalid.isValid());
+            expect (invalid.call (&res).isUndefined());
+            expect (res.failed());
+        }
+
+        beginTest ("Shared float arrays access native memory directly");
+        {
+            JavascriptEngine temporaryEngine;
+            auto res = Result::fail ("");
+
+            std::vector<float> data { 1.0f, 2.0f, 3.0f, 4.0f };
+
+            {
+                auto shared = temporaryEngine.shareFloatArray ("samples", data.data(), data.size());
+                expect (shared.isValid());
+
+                const auto sum = temporaryEngine.evaluate ("samples instanceof Float32Array ? samples.reduce ((a, b) => a + b, 0) : -1", &res);
+                expect (res.wasOk());
+                expectEquals ((double) sum, 10.0);
+
+                expect (temporaryEngine.execute ("for (let i = 0; i < samples.length; ++i) samples[i] *= 0.5;").wasOk());
+                expect (data == std::vector<float> { 0.5f, 1.0f, 1.5f, 2.0f });
+
+                data[0] = 8.0f;
+                expectEquals ((double) temporaryEngine.evaluate ("samples[0]"), 8.0);
+            }
+
+            // Once the handle has gone, the script sees an empty array and can't touch the memory
+            expectEquals ((int) temporaryEngine.evaluate ("samples.length"), 0);
+            expect (temporaryEngine.execute ("samples[0] = 100;").wasOk());
+            expectEquals (data[0], 8.0f);
+        }
+
+        beginTest ("Shared channel arrays and memory blocks");
+        {
+            std::vector<float> left (16, 0.25f), right (16, -0.25f);
+            float* channels[] { left.data(), right.data() };
+
+            JavascriptEngine::SharedBuffer outlivesEngine;
+
+            {
+                JavascriptEngine temporaryEngine;
+                auto sharedChannels = temporaryEngine.shareFloatArrays ("channels", channels, 2, left.size());
+
+                expect (temporaryEngine.execute ("for (const channel of channels) channel.fill (channel[0] * 2);").wasOk());
+                expect (std::all_of (left.begin(), left.end(), [] (auto x) { return exactlyEqual (x, 0.5f); }));
+                expect (std::all_of (right.begin(), right.end(), [] (auto x) { return exactlyEqual (x, -0.5f); }));
+
+                MemoryBlock block (8, true);
+                auto sharedBlock = temporaryEngine.shareMemory ("bytes", block.getData(), block.getSize());
+                expect (temporaryEngine.execute ("new Uint8Array (bytes).set ([1, 2, 3], 5);").wasOk());
+                expectEquals ((int) temporaryEngine.evaluate ("bytes.byteLength"), 8);
+                expectEquals ((int) block[7], 3);
+
+                sharedBlock.release();
+                expect (! sharedBlock.isValid());
+                expectEquals ((int) temporaryEngine.evaluate ("bytes.byteLength"), 0);
+
+                outlivesEngine = std::move (sharedChannels);
+                expect (outlivesEngine.isValid());
+            }
+
+            expect (! outlivesEngine.isValid());
+        }
     }
 };
 
@@ -177,21 +177,9 @@ std::vector<std::byte> Encodings::toMcoded7 (Span<const std::byte> bytes)
 
 std::vector<std::byte> Encodings::fromMcoded7 (Span<const std::byte> bytes)
 {
-    std::vector<std::byte> result;
-    result.reserve ((bytes.size() * 7) + 7 / 8);
-
-    for (size_t index = 0; index < bytes.size(); index += 8)
-    {
-        const auto sliceSize = std::min ((size_t) 7, bytes.size() - index - 1);
-
-        for (size_t i = 0; i < sliceSize; ++i)
-        {
-            const auto highBit = (bytes[index] & std::byte { (uint8_t) (1 << (6 - i)) }) << (i + 1);
-            result.push_back (highBit | bytes[index + 1 + i]);
-        }
-    }
-
-    return result;
+    Decoder decoder { Encoding::mcoded7 };
+    decoder.push (bytes);
+    return decoder.finish();
 }
 
 std::optional<std::vector<std::byte>> Encodings::tryEncode (Span<const std::byte> bytes, Encoding mutualEncoding)
@@ -225,50 +213,135 @@ std::optional<std::vector<std::byte>> Encodings::tryEncode (Span<const std::byte
 
 std::vector<std::byte> Encodings::decode (Span<const std::byte> bytes, Encoding mutualEncoding)
 {
-    if (mutualEncoding == Encoding::ascii)
-    {
-        // All values must be 7-bit!
-        jassert (std::none_of (bytes.begin(), bytes.end(), [] (const auto& b) { return (b & std::byte { 0x80 }) != std::byte{}; }));
-        return std::vector<std::byte> (bytes.begin(), bytes.end());
-    }
+    Decoder decoder { mutualEncoding };
+    decoder.push (bytes);
+    return decoder.finish();
+}
 
-    if (mutualEncoding == Encoding::mcoded7)
-        return fromMcoded7 (bytes);
+//==============================================================================
+/*  Decodes a single Mcoded7 group, where numBytes includes the leading byte holding the
+    high bits. A complete group of 8 bytes produces 7 output bytes.
+*/
+static void decodeMcoded7Group (const std::byte* group, size_t numBytes, std::byte* output)
+{
+    const auto highBits = (uint32_t) group[0];
 
-    if (mutualEncoding == Encoding::zlibAndMcoded7)
-    {
-        const auto mcoded = fromMcoded7 (bytes);
-        MemoryInputStream memoryStream (mcoded.data(), mcoded.size(), false);
+    for (size_t i = 1; i < numBytes; ++i)
+        output[i - 1] = std::byte ((uint8_t) ((highBits << i) & 0x80)) | group[i];
+}
 
-        GZIPDecompressorInputStream zipStream (memoryStream);
+static std::vector<std::byte> inflateZlib (Span<const std::byte> compressed)
+{
+    MemoryInputStream memoryStream (compressed.data(), compressed.size(), false);
+    GZIPDecompressorInputStream zipStream (memoryStream);
 
-        const size_t chunkSize = 1 << 8;
+    constexpr size_t chunkSize = 1 << 16;
 
-        std::vector<std::byte> result;
+    std::vector<std::byte> result;
+    result.reserve (std::max (chunkSize, compressed.size() * 4));
 
-        for (;;)
+    for (;;)
+    {
+        const auto previousSize = result.size();
+        result.resize (previousSize + chunkSize);
+        const auto read = zipStream.read (result.data() + previousSize, (int) chunkSize);
+
+        if (read < 0)
         {
-            const auto previousSize = result.size();
-            result.resize (previousSize + chunkSize);
-            const auto read = zipStream.read (result.data() + previousSize, chunkSize);
+            // Decompression failed!
+            jassertfalse;
+            return {};
+        }
 
-            if (read < 0)
-            {
-                // Decompression failed!
-                jassertfalse;
-                return {};
-            }
+        result.resize ((size_t) read + previousSize);
+
+        if (read == 0)
+            return result;
+    }
+}
 
-            result.resize ((size_t) read + previousSize);
+void Encodings::Decoder::reserve (size_t numEncodedBytes)
+{
+    if (mutualEncoding == Encoding::ascii)
+        decoded.reserve (numEncodedBytes);
+    else
+        decoded.reserve (((numEncodedBytes + 7) / 8) * 7);
+}
 
-            if (read == 0)
-                return result;
-        }
+void Encodings::Decoder::push (Span<const std::byte> bytes)
+{
+    switch (mutualEncoding)
+    {
+        case Encoding::ascii:
+            // All values must be 7-bit!
+            jassert (std::none_of (bytes.begin(), bytes.end(), [] (const auto& b) { return (b & std::byte { 0x80 }) != std::byte{}; }));
+            decoded.insert (decoded.end(), bytes.begin(), bytes.end());
+            return;
+
+        case Encoding::mcoded7:
+        case Encoding::zlibAndMcoded7:
+            pushMcoded7 (bytes);
+            return;
     }
 
     // Unknown encoding!
     jassertfalse;
-    return {};
+}
+
+void Encodings::Decoder::pushMcoded7 (Span<const std::byte> bytes)
+{
+    auto* input = bytes.data();
+    auto remaining = bytes.size();
+
+    if (numPartialBytes != 0)
+    {
+        const auto numToCopy = std::min (partialGroup.size() - numPartialBytes, remaining);
+        std::copy (input, input + numToCopy, partialGroup.begin() + numPartialBytes);
+        numPartialBytes += numToCopy;
+        input += numToCopy;
+        remaining -= numToCopy;
+
+        if (numPartialBytes != partialGroup.size())
+            return;
+
+        const auto previousSize = decoded.size();
+        decoded.resize (previousSize + 7);
+        decodeMcoded7Group (partialGroup.data(), partialGroup.size(), decoded.data() + previousSize);
+        numPartialBytes = 0;
+    }
+
+    const auto numGroups = remaining / 8;
+    const auto previousSize = decoded.size();
+    decoded.resize (previousSize + (numGroups * 7));
+
+    for (size_t i = 0; i < numGroups; ++i)
+        decodeMcoded7Group (input + (i * 8), 8, decoded.data() + previousSize + (i * 7));
+
+    input += numGroups * 8;
+    remaining -= numGroups * 8;
+
+    std::copy (input, input + remaining, partialGroup.begin());
+    numPartialBytes = remaining;
+}
+
+std::vector<std::byte> Encodings::Decoder::finish()
+{
+    if (numPartialBytes != 0)
+    {
+        const auto previousSize = decoded.size();
+        decoded.resize (previousSize + numPartialBytes - 1);
+        decodeMcoded7Group (partialGroup.data(), numPartialBytes, decoded.data() + previousSize);
+        numPartialBytes = 0;
+    }
+
+    auto result = std::exchange (decoded, {});
+
+    if (mutualEncoding != Encoding::zlibAndMcoded7)
+        return result;
+
+    // The compressed stream is decoded from Mcoded7 as it arrives, but it can only be
+    // inflated once it is complete.
+    return inflateZlib (result);
 }
 
 #if JUCE_UNIT_TESTS
@@ -355,6 +428,38 @@ public:
                 expect (rangesEqual (converted, expected));
             }
         }
+
+        beginTest ("Incremental decoding produces the same result as decoding in one go");
+        {
+            auto random = getRandom();
+
+            for (const auto encoding : { Encoding::ascii, Encoding::mcoded7, Encoding::zlibAndMcoded7 })
+            {
+                for (const auto size : { 1, 6, 7, 8, 9, 100, 10000 })
+                {
+                    std::vector<std::byte> original;
+
+                    for (auto i = 0; i < size; ++i)
+                        original.push_back (std::byte ((uint8_t) random.nextInt (encoding == Encoding::ascii ? 0x80 : 0x100)));
+
+                    const auto encoded = *Encodings::tryEncode (original, encoding);
+
+                    Encodings::Decoder decoder { encoding };
+                    decoder.reserve (encoded.size());
+
+                    for (size_t index = 0; index < encoded.size();)
+                    {
+                        const auto chunkSize = std::min ((size_t) random.nextInt (20), encoded.size() - index);
+                        decoder.push (Span (encoded.data() + index, chunkSize));
+                        index += chunkSize;
+                    }
+
+                    const auto decoded = decoder.finish();
+                    expect (rangesEqual (decoded, Encodings::decode (encoded, encoding)));
+                    expect (rangesEqual (decoded, original));
+                }
+            }
+        }
     }
 
 private:
@@ -90,6 +90,50 @@ struct Encodings
     */
     static std::vector<std::byte> decode (Span<const std::byte> bytes, Encoding mutualEncoding);
 
+    /**
+        Decodes a byte stream that arrives in pieces, such as the body of a
+        chunked property exchange message.
+
+        Pushing a message in several pieces produces the same result as passing
+        the concatenated bytes to decode(), but the encoded bytes don't need to
+        be buffered first: Mcoded7 data is decoded as soon as each complete
+        group of eight bytes is available.
+
+        @tags{Audio}
+    */
+    class Decoder
+    {
+    public:
+        /** Creates a decoder for the specified encoding. */
+        explicit Decoder (Encoding mutualEncodingIn)
+            : mutualEncoding (mutualEncodingIn) {}
+
+        /** Preallocates storage for the given number of encoded bytes. */
+        void reserve (size_t numEncodedBytes);
+
+        /** Decodes the next piece of the stream.
+
+            All bytes of the input must be 7-bit values, i.e. all most-significant bits
+            are unset.
+        */
+        void push (Span<const std::byte> bytes);
+
+        /** Decodes any remaining input and returns the decoded stream.
+
+            The result will be empty if the stream could not be decoded.
+            After calling this, the decoder is empty and may be reused.
+        */
+        std::vector<std::byte> finish();
+
+    private:
+        void pushMcoded7 (Span<const std::byte> bytes);
+
+        Encoding mutualEncoding;
+        std::vector<std::byte> decoded;
+        std::array<std::byte, 8> partialGroup{};
+        size_t numPartialBytes = 0;
+    };
+
     Encodings() = delete;
 };
 
@@ -67,15 +67,31 @@ public:
                         chunk.header.end(),
                         std::back_inserter (headerStorage),
                         [] (std::byte b) { return char (b); });
-        bodyStorage.insert (bodyStorage.end(), chunk.data.begin(), chunk.data.end());
 
         if (chunk.thisChunkNum != 0 && chunk.thisChunkNum != chunk.totalNumChunks)
+        {
+            if (decoder.has_value())
+            {
+                // The header should be sent in full in the first chunk
+                jassert (chunk.header.empty());
+                decoder->push (chunk.data);
+            }
+            else
+            {
+                // Once the header is complete, we know the encoding of the body, so the body can be
+                // decoded as each chunk arrives instead of being buffered until the final chunk
+                pendingBody.insert (pendingBody.end(), chunk.data.begin(), chunk.data.end());
+
+                if (const auto headerJson = parseHeader(); headerJson.isObject())
+                    startDecoding (headerJson, chunk);
+            }
+
             return {};
+        }
 
-        const auto headerJson = JSON::parse (String (headerStorage.data(), headerStorage.size()));
+        const auto headerJson = parseHeader();
 
         terminate();
-        const auto encodingString = headerJson.getProperty ("mutualEncoding", "ASCII").toString();
 
         if (chunk.thisChunkNum != chunk.totalNumChunks)
             return std::optional<OwningResult> { std::in_place, PropertyExchangeResult::Error::partial };
@@ -85,9 +101,11 @@ public:
         if (status == 343)
             return std::optional<OwningResult> { std::in_place, PropertyExchangeResult::Error::tooManyTransactions };
 
-        return std::optional<OwningResult> { std::in_place,
-                                             headerJson,
-                                             Encodings::decode (bodyStorage, EncodingUtils::toEncoding (encodingString.toRawUTF8()).value_or (Encoding::ascii)) };
+        if (! decoder.has_value())
+            startDecoding (headerJson, chunk);
+
+        decoder->push (chunk.data);
+        return std::optional<OwningResult> { std::in_place, headerJson, decoder->finish() };
     }
 
     std::optional<OwningResult> notify (Span<const std::byte> header)
@@ -112,8 +130,29 @@ public:
     }
 
 private:
+    var parseHeader() const
+    {
+        return JSON::parse (String (headerStorage.data(), headerStorage.size()));
+    }
+
+    void startDecoding (const var& headerJson, const Message::DynamicSizePropertyExchange& chunk)
+    {
+        const auto encodingString = headerJson.getProperty ("mutualEncoding", "ASCII").toString();
+        auto& d = decoder.emplace (EncodingUtils::toEncoding (encodingString.toRawUTF8()).value_or (Encoding::ascii));
+
+        // Assume that all chunks are about the same size as this one, but don't trust the
+        // sender with an unbounded allocation
+        constexpr size_t maxReservation = 1 << 24;
+        const auto numChunks = (size_t) std::max ((uint16_t) 1, chunk.totalNumChunks);
+        d.reserve (std::min (maxReservation, chunk.data.size() * numChunks));
+
+        d.push (pendingBody);
+        pendingBody = {};
+    }
+
     std::vector<char> headerStorage;
-    std::vector<std::byte> bodyStorage;
+    std::vector<std::byte> pendingBody;
+    std::optional<Encodings::Decoder> decoder;
     uint16_t lastChunk = 0;
     bool ongoing = true;
 };